@@ -0,0 +1,175 @@
+/**
+ * @file array_converter.cpp
+ * @brief Element-independent parsing of PostgreSQL arrays
+ *
+ * @see array_converter.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cctype>
+#include <limits>
+#include "./type_converter.h"
+
+namespace qb::pg::detail {
+
+namespace {
+
+integer
+read_integer_at(std::string_view buffer, std::size_t offset) {
+    if (offset + sizeof(integer) > buffer.size())
+        throw std::runtime_error("Truncated binary array");
+    integer value;
+    std::memcpy(&value, buffer.data() + offset, sizeof(integer));
+    return qb::endian::from_big_endian(value);
+}
+
+bool
+is_space(char c) noexcept {
+    return std::isspace(static_cast<unsigned char>(c));
+}
+
+} // namespace
+
+std::size_t
+ArrayCodec::read_header(std::string_view buffer, std::size_t &offset) {
+    const auto ndim = read_integer_at(buffer, 0);
+    // Flags and element OID are not needed to read the elements
+    offset = 3 * sizeof(integer);
+    if (ndim < 0 || ndim > 6)
+        throw std::runtime_error("Invalid number of array dimensions");
+    if (!ndim)
+        return 0;
+
+    std::size_t count = 1;
+    for (integer i = 0; i < ndim; ++i) {
+        const auto size = read_integer_at(buffer, offset);
+        if (size < 0)
+            throw std::runtime_error("Invalid array dimension");
+        const auto extent = static_cast<std::size_t>(size);
+        // Bounded by the buffer below, but only if the product did not wrap
+        if (extent && count > std::numeric_limits<std::size_t>::max() / extent)
+            throw std::runtime_error("Invalid array dimension");
+        count *= extent;
+        offset += 2 * sizeof(integer); // size and lower bound
+    }
+    if (offset > buffer.size())
+        throw std::runtime_error("Truncated binary array");
+    // Every element takes at least its length, which bounds the count
+    if (count > (buffer.size() - offset) / sizeof(integer))
+        throw std::runtime_error("Truncated binary array");
+    return count;
+}
+
+std::optional<std::string_view>
+ArrayCodec::read_element(std::string_view buffer, std::size_t &offset) {
+    const auto length = read_integer_at(buffer, offset);
+    offset += sizeof(integer);
+    if (length < 0)
+        return std::nullopt;
+    if (static_cast<std::size_t>(length) > buffer.size() - offset)
+        throw std::runtime_error("Truncated binary array");
+    const auto data = buffer.substr(offset, static_cast<std::size_t>(length));
+    offset += static_cast<std::size_t>(length);
+    return data;
+}
+
+void
+ArrayCodec::parse_text(std::string_view                         text,
+                       std::vector<std::optional<std::string>> &items) {
+    std::size_t i = 0;
+    while (i < text.size() && is_space(text[i]))
+        ++i;
+    // Optional dimensions, e.g. [0:2]={1,2,3}
+    if (i < text.size() && text[i] == '[') {
+        const auto eq = text.find('=', i);
+        if (eq == std::string_view::npos)
+            throw std::runtime_error("Invalid array dimensions");
+        i = eq + 1;
+        while (i < text.size() && is_space(text[i]))
+            ++i;
+    }
+    if (i >= text.size() || text[i] != '{')
+        throw std::runtime_error("Array text must start with '{'");
+
+    int  depth  = 0;
+    bool expect = true; // an element or a nested array may start here
+    for (; i < text.size(); ++i) {
+        const char c = text[i];
+        if (is_space(c))
+            continue;
+        if (c == '{') {
+            ++depth;
+            expect = true;
+        } else if (c == '}') {
+            if (--depth == 0) {
+                ++i;
+                break;
+            }
+            expect = false;
+        } else if (c == ',') {
+            expect = true;
+        } else if (!expect || !depth) {
+            throw std::runtime_error("Invalid array text");
+        } else if (c == '"') {
+            std::string value;
+            for (++i; i < text.size() && text[i] != '"'; ++i) {
+                if (text[i] == '\\' && i + 1 < text.size())
+                    ++i;
+                value += text[i];
+            }
+            if (i >= text.size())
+                throw std::runtime_error("Unterminated quoted array element");
+            items.emplace_back(std::move(value));
+            expect = false;
+        } else {
+            std::string value;
+            for (; i < text.size() && text[i] != ',' && text[i] != '}'; ++i) {
+                if (text[i] == '\\' && i + 1 < text.size())
+                    ++i;
+                value += text[i];
+            }
+            --i;
+            while (!value.empty() && is_space(value.back()))
+                value.pop_back();
+            if (value.size() == 4 && (value[0] == 'N' || value[0] == 'n') &&
+                (value[1] == 'U' || value[1] == 'u') && (value[2] == 'L' || value[2] == 'l') &&
+                (value[3] == 'L' || value[3] == 'l'))
+                items.emplace_back(std::nullopt);
+            else
+                items.emplace_back(std::move(value));
+            expect = false;
+        }
+    }
+    if (depth)
+        throw std::runtime_error("Unterminated array text");
+}
+
+void
+ArrayCodec::append_text(std::string &out, std::string_view value, bool quote) {
+    if (!quote) {
+        out += value;
+        return;
+    }
+    out += '"';
+    for (const char c : value) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    out += '"';
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,468 @@
+/**
+ * @file array_converter.h
+ * @brief Conversion of one-dimensional PostgreSQL arrays
+ *
+ * This file extends the TypeConverter with PostgreSQL arrays:
+ *
+ * - std::vector<T> of any scalar type, with std::optional<T> elements for NULLs
+ * - ArrayRef<T> views over contiguous memory (and std::span<const T> in C++20)
+ *   to send arrays without copying them into a vector
+ * - Binary encoding and decoding of the array wire format
+ * - Parsing and formatting of the text format, e.g. {1,2,NULL}
+ *
+ * A single array parameter replaces long IN lists: WHERE id = ANY($1) is
+ * prepared once whatever the number of keys.
+ *
+ * Included by type_converter.h after the scalar conversions.
+ *
+ * @see qb::pg::detail::TypeConverter
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Read-only view over contiguous elements sent as a PostgreSQL array
+ *
+ * The view does not own the elements: they must outlive the serialization
+ * of the parameters, which happens when the query is queued.
+ *
+ * @tparam T Element type, possibly std::optional for NULL elements
+ */
+template <typename T>
+class ArrayRef {
+    const T    *_data{nullptr};
+    std::size_t _size{0};
+
+public:
+    using value_type = T;
+
+    ArrayRef() = default;
+
+    /**
+     * @brief Constructs a view over a buffer
+     *
+     * @param data First element
+     * @param size Number of elements
+     */
+    ArrayRef(const T *data, std::size_t size) noexcept
+        : _data(data)
+        , _size(size) {}
+
+    template <typename Alloc>
+    ArrayRef(std::vector<T, Alloc> const &values) noexcept
+        : _data(values.data())
+        , _size(values.size()) {}
+
+    template <std::size_t N>
+    ArrayRef(std::array<T, N> const &values) noexcept
+        : _data(values.data())
+        , _size(N) {}
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+    template <std::size_t N>
+    ArrayRef(std::span<const T, N> values) noexcept
+        : _data(values.data())
+        , _size(values.size()) {}
+#endif
+
+    [[nodiscard]] const T *
+    data() const noexcept {
+        return _data;
+    }
+
+    [[nodiscard]] std::size_t
+    size() const noexcept {
+        return _size;
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept {
+        return !_size;
+    }
+
+    [[nodiscard]] const T *
+    begin() const noexcept {
+        return _data;
+    }
+
+    [[nodiscard]] const T *
+    end() const noexcept {
+        return _data + _size;
+    }
+};
+
+/**
+ * @brief Views a vector as a PostgreSQL array parameter
+ *
+ * Needed for std::vector<std::string>, which a bare parameter expands to
+ * one text parameter per element, and to send an empty vector as '{}'
+ * rather than NULL.
+ *
+ * @param values Elements of the array
+ * @return ArrayRef<T> View over the elements
+ */
+template <typename T, typename Alloc>
+ArrayRef<T>
+as_array(std::vector<T, Alloc> const &values) noexcept {
+    return ArrayRef<T>(values);
+}
+
+template <typename T, std::size_t N>
+ArrayRef<T>
+as_array(std::array<T, N> const &values) noexcept {
+    return ArrayRef<T>(values);
+}
+
+template <typename T>
+ArrayRef<T>
+as_array(const T *data, std::size_t size) noexcept {
+    return ArrayRef<T>(data, size);
+}
+
+/**
+ * @brief Detects the C++ types converted as PostgreSQL arrays
+ *
+ * Vectors of char and unsigned char stay bytea.
+ */
+template <typename T, typename Enable = void>
+struct array_traits : std::false_type {};
+
+template <typename T, typename Alloc>
+struct array_traits<std::vector<T, Alloc>,
+                    std::enable_if_t<!std::is_same_v<T, char> &&
+                                     !std::is_same_v<T, unsigned char>>>
+    : std::true_type {
+    using element_type = T;
+};
+
+template <typename T>
+struct array_traits<ArrayRef<T>> : std::true_type {
+    using element_type = T;
+};
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+template <typename T, std::size_t N>
+struct array_traits<std::span<T, N>> : std::true_type {
+    using element_type = std::remove_cv_t<T>;
+};
+#endif
+
+template <typename T>
+struct type_mapping<ArrayRef<T>> {
+    static constexpr integer type_oid = array_type_oid(type_mapping<T>::type_oid);
+};
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+template <typename T, std::size_t N>
+struct type_mapping<std::span<T, N>> {
+    static constexpr integer type_oid =
+        array_type_oid(type_mapping<std::remove_cv_t<T>>::type_oid);
+};
+#endif
+
+/**
+ * @brief Element-independent parts of the array formats
+ */
+struct ArrayCodec {
+    /**
+     * @brief Reads the header of a binary array
+     *
+     * Arrays of several dimensions are read flattened in row-major order.
+     *
+     * @param buffer Binary array, without its length prefix
+     * @param offset Receives the offset of the first element
+     * @return std::size_t Number of elements
+     * @throws std::runtime_error If the header is truncated or invalid
+     */
+    static std::size_t read_header(std::string_view buffer, std::size_t &offset);
+
+    /**
+     * @brief Reads the next element of a binary array
+     *
+     * @param buffer Binary array, without its length prefix
+     * @param offset Offset of the element, moved past it
+     * @return std::optional<std::string_view> Element data, or nullopt if NULL
+     * @throws std::runtime_error If the element is truncated
+     */
+    static std::optional<std::string_view> read_element(std::string_view buffer,
+                                                        std::size_t     &offset);
+
+    /**
+     * @brief Splits the text format of an array into its elements
+     *
+     * Handles quoted elements, backslash escapes, NULL, nested braces
+     * (flattened) and the optional [lower:upper]= dimension prefix.
+     *
+     * @param text Text array, e.g. {1,"a b",NULL}
+     * @param items Receives the unescaped elements, nullopt for NULL
+     * @throws std::runtime_error If the text is not a valid array
+     */
+    static void parse_text(std::string_view                         text,
+                           std::vector<std::optional<std::string>> &items);
+
+    /**
+     * @brief Appends an element to the text format of an array
+     *
+     * @param out Text array being built
+     * @param value Element text
+     * @param quote True to quote and escape the element
+     */
+    static void append_text(std::string &out, std::string_view value, bool quote);
+};
+
+/**
+ * @brief TypeConverter for PostgreSQL arrays
+ *
+ * Arrays are one-dimensional with a lower bound of 1. Decoding always
+ * produces a std::vector of the element type; a NULL element requires
+ * std::optional elements.
+ *
+ * @tparam T std::vector, ArrayRef or std::span of elements
+ */
+template <typename T>
+class TypeConverter<T, std::enable_if_t<array_traits<T>::value>> {
+public:
+    using value_type   = T;
+    using element_type = typename array_traits<T>::element_type;
+    using decoded_type = std::vector<element_type>;
+
+private:
+    template <typename E>
+    struct is_optional : std::false_type {};
+    template <typename E>
+    struct is_optional<std::optional<E>> : std::true_type {};
+
+    template <typename E>
+    struct scalar {
+        using type = E;
+    };
+    template <typename E>
+    struct scalar<std::optional<E>> {
+        using type = E;
+    };
+
+    /// Type of the elements without std::optional
+    using scalar_type = typename scalar<element_type>::type;
+
+    static constexpr bool nullable = is_optional<element_type>::value;
+
+    static void
+    write_integer(std::vector<byte> &buffer, integer value) {
+        const integer nbo = qb::endian::to_big_endian(value);
+        const auto    pos = buffer.size();
+        buffer.resize(pos + sizeof(integer));
+        std::memcpy(buffer.data() + pos, &nbo, sizeof(integer));
+    }
+
+    static void
+    write_scalar(scalar_type const &value, std::vector<byte> &buffer) {
+        if constexpr (std::is_same_v<scalar_type, float> ||
+                      std::is_same_v<scalar_type, double>) {
+            // Floating-point elements travel in network byte order
+            using bits_type = std::conditional_t<sizeof(scalar_type) == 4, uint32_t, uint64_t>;
+            bits_type bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = qb::endian::to_big_endian(bits);
+            write_integer(buffer, sizeof(bits));
+            const auto pos = buffer.size();
+            buffer.resize(pos + sizeof(bits));
+            std::memcpy(buffer.data() + pos, &bits, sizeof(bits));
+        } else
+            TypeConverter<scalar_type>::to_binary(value, buffer);
+    }
+
+    static scalar_type
+    read_scalar(std::string_view data) {
+        if constexpr (std::is_same_v<scalar_type, std::string>) {
+            return std::string(data);
+        } else {
+            if constexpr (std::is_arithmetic_v<scalar_type>) {
+                // Reject arrays of another width, e.g. int8[] read as int4
+                if (data.size() != (std::is_same_v<scalar_type, bool> ? 1 : sizeof(scalar_type)))
+                    throw std::runtime_error("Array element size does not match its type");
+            }
+            return TypeConverter<scalar_type>::from_binary(data);
+        }
+    }
+
+    static std::string
+    scalar_text(scalar_type const &value) {
+        if constexpr (std::is_same_v<scalar_type, std::string>)
+            return value;
+        else
+            return TypeConverter<scalar_type>::to_text(value);
+    }
+
+public:
+    /**
+     * @brief Gets the OID of the array type
+     *
+     * @return integer Array OID, 0 if the element type has no known array
+     */
+    static integer
+    get_oid() {
+        return array_type_oid(type_mapping<scalar_type>::type_oid);
+    }
+
+    /**
+     * @brief Appends the binary format of an array, with its length prefix
+     *
+     * An empty array is encoded with no dimension, as the server does.
+     *
+     * @param value Elements of the array
+     * @param buffer Target buffer
+     */
+    static void
+    to_binary(const value_type &value, std::vector<byte> &buffer) {
+        const auto start = buffer.size();
+        write_integer(buffer, 0); // length, patched below
+        write_integer(buffer, value.empty() ? 0 : 1);
+        const auto flags = buffer.size();
+        write_integer(buffer, 0); // has-null flag, patched below
+        write_integer(buffer, type_mapping<scalar_type>::type_oid);
+        if (!value.empty()) {
+            write_integer(buffer, static_cast<integer>(value.size()));
+            write_integer(buffer, 1);
+        }
+
+        bool has_null = false;
+        for (element_type const &element : value) {
+            if constexpr (nullable) {
+                if (!element) {
+                    write_integer(buffer, -1);
+                    has_null = true;
+                    continue;
+                }
+                write_scalar(*element, buffer);
+            } else
+                write_scalar(element, buffer);
+        }
+
+        const integer length = static_cast<integer>(buffer.size() - start - sizeof(integer));
+        const integer nbo    = qb::endian::to_big_endian(length);
+        std::memcpy(buffer.data() + start, &nbo, sizeof(integer));
+        if (has_null) {
+            const integer one = qb::endian::to_big_endian(integer{1});
+            std::memcpy(buffer.data() + flags, &one, sizeof(integer));
+        }
+    }
+
+    /**
+     * @brief Formats an array in the PostgreSQL text format
+     *
+     * @param value Elements of the array
+     * @return std::string Text array, e.g. {1,2,NULL}
+     */
+    static std::string
+    to_text(const value_type &value) {
+        std::string out(1, '{');
+        for (element_type const &element : value) {
+            if (out.size() > 1)
+                out += ',';
+            if constexpr (nullable) {
+                if (!element) {
+                    out += "NULL";
+                    continue;
+                }
+                ArrayCodec::append_text(out, scalar_text(*element),
+                                        !std::is_arithmetic_v<scalar_type>);
+            } else
+                ArrayCodec::append_text(out, scalar_text(element),
+                                        !std::is_arithmetic_v<scalar_type>);
+        }
+        out += '}';
+        return out;
+    }
+
+    /**
+     * @brief Decodes a binary array
+     *
+     * @param buffer Field data, without its length prefix
+     * @return decoded_type Elements of the array
+     * @throws std::runtime_error If the data is malformed, or contains a NULL
+     * element and the elements are not optional
+     */
+    static decoded_type
+    from_binary(std::string_view buffer) {
+        std::size_t  offset = 0;
+        const auto   count  = ArrayCodec::read_header(buffer, offset);
+        decoded_type result;
+        result.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto data = ArrayCodec::read_element(buffer, offset);
+            if (!data) {
+                if constexpr (nullable)
+                    result.emplace_back(std::nullopt);
+                else
+                    throw std::runtime_error(
+                        "NULL array element requires std::optional elements");
+            } else
+                result.emplace_back(read_scalar(*data));
+        }
+        return result;
+    }
+
+    static decoded_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
+    /**
+     * @brief Decodes a text array
+     *
+     * @param text Text array, e.g. {1,2,NULL}
+     * @return decoded_type Elements of the array
+     * @throws std::runtime_error If the text is malformed, or contains a NULL
+     * element and the elements are not optional
+     */
+    static decoded_type
+    from_text(std::string_view text) {
+        std::vector<std::optional<std::string>> items;
+        ArrayCodec::parse_text(text, items);
+        decoded_type result;
+        result.reserve(items.size());
+        for (auto &item : items) {
+            if (!item) {
+                if constexpr (nullable)
+                    result.emplace_back(std::nullopt);
+                else
+                    throw std::runtime_error(
+                        "NULL array element requires std::optional elements");
+            } else if constexpr (std::is_same_v<scalar_type, std::string>)
+                result.emplace_back(std::move(*item));
+            else
+                result.emplace_back(TypeConverter<scalar_type>::from_text(*item));
+        }
+        return result;
+    }
+};
+
+} // namespace qb::pg::detail
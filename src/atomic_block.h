@@ -0,0 +1,240 @@
+/**
+ * @file atomic_block.h
+ * @brief Transaction blocks sent in a single round trip
+ *
+ * A begin() block waits for ReadyForQuery after BEGIN, after each statement
+ * and after COMMIT, so a short write transaction costs N + 2 round trips.
+ * When every statement and its parameters are known up front, an
+ * AtomicBlock sends BEGIN, the statements and COMMIT with the extended
+ * protocol under a single Sync:
+ *
+ * - the server runs the messages in order and, on the first error, skips
+ *   the remaining ones up to the Sync, COMMIT included
+ * - the failing step is found from the number of completed commands, and
+ *   the block is then rolled back with a ROLLBACK
+ *
+ * A committed block therefore takes one round trip, a failed one two.
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./queries.h"
+#include "./typed_statement.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Statements of a transaction block sent in a single round trip
+ *
+ * Statements are either SQL text, parsed as the unnamed statement, or
+ * statements prepared beforehand on the connection. Their rows are not
+ * collected.
+ */
+class AtomicBlock {
+public:
+    /// Step reported when BEGIN or COMMIT fails
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Statement of the block
+     */
+    struct Step {
+        std::string sql;       ///< SQL text, empty for a prepared statement
+        PreparedRef statement; ///< Prepared statement, when sql is empty
+        QueryParams params;    ///< Parameters of the statement
+    };
+
+private:
+    std::vector<Step> _steps; ///< Statements, in execution order
+
+public:
+    /**
+     * @brief Adds a SQL statement
+     *
+     * @param sql SQL text, with $1..$n placeholders for the parameters
+     * @param params Parameters, their types are sent with the statement
+     * @return AtomicBlock& Reference to this block for chaining
+     */
+    AtomicBlock &
+    execute(std::string_view sql, QueryParams &&params = {}) {
+        _steps.push_back(Step{std::string(sql), {}, std::move(params)});
+        return *this;
+    }
+
+    /**
+     * @brief Adds a prepared statement, by name
+     *
+     * @param name Name of a statement prepared on the connection
+     * @param params Parameters of the statement
+     * @return AtomicBlock& Reference to this block for chaining
+     */
+    AtomicBlock &
+    execute_prepared(std::string_view name, QueryParams &&params) {
+        _steps.push_back(Step{{}, PreparedRef(std::string(name)), std::move(params)});
+        return *this;
+    }
+
+    /**
+     * @brief Adds a prepared statement, by handle
+     *
+     * @param statement Handle of a statement prepared on the connection
+     * @param params Parameters of the statement
+     * @return AtomicBlock& Reference to this block for chaining
+     */
+    AtomicBlock &
+    execute_prepared(PreparedHandle statement, QueryParams &&params) {
+        _steps.push_back(Step{{}, PreparedRef(statement), std::move(params)});
+        return *this;
+    }
+
+    /**
+     * @brief Adds a typed statement with its bound arguments
+     *
+     * @param statement Execution returned by the statement call operator
+     * @return AtomicBlock& Reference to this block for chaining
+     */
+    template <typename Ret>
+    AtomicBlock &
+    execute(BoundStatement<Ret> &&statement) {
+        return execute_prepared(statement.name(), std::move(statement.params()));
+    }
+
+    [[nodiscard]] std::size_t
+    size() const noexcept {
+        return _steps.size();
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept {
+        return _steps.empty();
+    }
+
+    [[nodiscard]] std::vector<Step> const &
+    steps() const noexcept {
+        return _steps;
+    }
+};
+
+/**
+ * @brief Query sending an AtomicBlock between BEGIN and COMMIT under one Sync
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class AtomicQuery final : public SqlQuery<CB_SUCCESS, CB_ERROR> {
+    const PreparedStorage &_storage; ///< Prepared statement storage
+    AtomicBlock const     &_block;   ///< Statements of the block
+    transaction_mode       _mode;    ///< Transaction mode (isolation level, etc.)
+
+    /**
+     * @brief Writes the Parse, Bind and Execute of a statement without name
+     */
+    static void
+    write_unnamed(pipe_writer &out, std::string_view sql, QueryParams const *params) {
+        out.begin(parse_tag);
+        out.write('\0');
+        out.write_sv(sql);
+        out.write('\0');
+        const auto *types = params ? &params->param_types() : nullptr;
+        out.write(static_cast<smallint>(types ? types->size() : 0));
+        if (types)
+            for (auto type : *types)
+                out.write(type);
+        out.end();
+
+        out.begin(bind_tag);
+        out.write('\0'); // unnamed portal
+        out.write('\0'); // unnamed statement
+        const smallint count = params ? params->param_count() : 0;
+        if (count) {
+            out.write((smallint) 1); // Number of format codes
+            out.write((smallint) 1); // Format = 1 (binary)
+            out.write(count);
+            // External values are not in the serialized buffer: gather them
+            params->gather([&out](std::string_view fragment) { out.write_sv(fragment); },
+                           sizeof(smallint));
+        } else {
+            out.write((smallint) 0); // No parameter formats
+            out.write((smallint) 0); // No parameters
+        }
+        out.write((smallint) 0); // All results in text
+        out.end();
+        out.execute();
+    }
+
+public:
+    /**
+     * @brief Constructs an atomic block query
+     *
+     * @param storage Prepared statement storage
+     * @param block Statements of the block
+     * @param mode Transaction mode
+     * @param success Success callback
+     * @param error Error callback
+     */
+    AtomicQuery(const PreparedStorage &storage, AtomicBlock const &block,
+                transaction_mode mode, CB_SUCCESS &&success, CB_ERROR &&error)
+        : SqlQuery<CB_SUCCESS, CB_ERROR>(std::forward<CB_SUCCESS>(success),
+                                         std::forward<CB_ERROR>(error))
+        , _storage(storage)
+        , _block(block)
+        , _mode(mode) {}
+
+    bool
+    is_valid() const final {
+        for (auto const &step : _block.steps()) {
+            if (step.sql.empty() && !_storage.has(step.statement.resolve(_storage))) {
+                LOG_CRIT("[pgsql] Error prepared query " << step.statement.name()
+                                                         << " not registered");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void
+    encode(pipe_writer &out) const final {
+        std::ostringstream begin;
+        begin << "BEGIN " << _mode;
+        write_unnamed(out, begin.str(), nullptr);
+        for (auto const &step : _block.steps()) {
+            if (!step.sql.empty()) {
+                write_unnamed(out, step.sql, &step.params);
+                continue;
+            }
+            out.begin(bind_tag);
+            write_bind(out, "", _storage.get(step.statement.resolve(_storage)), step.params);
+            out.end();
+            out.execute();
+        }
+        write_unnamed(out, "COMMIT", nullptr);
+        out.sync();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::transaction;
+    }
+};
+
+} // namespace qb::pg::detail
@@ -0,0 +1,180 @@
+/**
+ * @file byte_order.cpp
+ * @brief SIMD conversion of big-endian values to host byte order
+ *
+ * @see byte_order.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <qb/system/endian.h>
+#include "./byte_order.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define QBM_PGSQL_SWAP_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#define QBM_PGSQL_SWAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace qb::pg::detail {
+
+namespace {
+
+template <typename Word>
+void
+swap_scalar(byte *data, std::size_t count) noexcept {
+    for (std::size_t i = 0; i < count; ++i, data += sizeof(Word)) {
+        Word value;
+        std::memcpy(&value, data, sizeof(Word));
+        value = qb::endian::from_big_endian(value);
+        std::memcpy(data, &value, sizeof(Word));
+    }
+}
+
+void
+swap_scalar(byte *data, std::size_t count, std::size_t width) noexcept {
+    switch (width) {
+        case 2:
+            swap_scalar<uint16_t>(data, count);
+            break;
+        case 4:
+            swap_scalar<uint32_t>(data, count);
+            break;
+        case 8:
+            swap_scalar<uint64_t>(data, count);
+            break;
+        default:
+            break;
+    }
+}
+
+#if defined(QBM_PGSQL_SWAP_X86)
+
+/**
+ * @brief Builds the byte shuffle reversing each value of a 16-byte lane
+ */
+void
+shuffle_mask(std::size_t width, char (&mask)[32]) noexcept {
+    for (std::size_t i = 0; i < 32; ++i) {
+        const auto lane = i % 16;
+        mask[i]         = static_cast<char>(lane / width * width + (width - 1 - lane % width));
+    }
+}
+
+__attribute__((target("ssse3"))) void
+swap_ssse3(byte *data, std::size_t count, std::size_t width) noexcept {
+    char mask_bytes[32];
+    shuffle_mask(width, mask_bytes);
+    const __m128i     mask  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask_bytes));
+    const std::size_t bytes = count * width;
+    std::size_t       i     = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        auto *p = reinterpret_cast<__m128i *>(data + i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+    }
+    swap_scalar(data + i, (bytes - i) / width, width);
+}
+
+__attribute__((target("avx2"))) void
+swap_avx2(byte *data, std::size_t count, std::size_t width) noexcept {
+    char mask_bytes[32];
+    shuffle_mask(width, mask_bytes);
+    const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask_bytes));
+    const std::size_t bytes = count * width;
+    std::size_t       i     = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        auto *p = reinterpret_cast<__m256i *>(data + i);
+        _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+    }
+    swap_scalar(data + i, (bytes - i) / width, width);
+}
+
+/**
+ * @brief Gets the widest instruction set supported by the processor
+ *
+ * @return int 2 for AVX2, 1 for SSSE3, 0 for none
+ */
+int
+x86_level() noexcept {
+    static const int level = __builtin_cpu_supports("avx2")    ? 2
+                             : __builtin_cpu_supports("ssse3") ? 1
+                                                               : 0;
+    return level;
+}
+
+#elif defined(QBM_PGSQL_SWAP_NEON)
+
+template <uint8x16_t (*Reverse)(uint8x16_t)>
+void
+swap_neon(byte *data, std::size_t count, std::size_t width) noexcept {
+    const std::size_t bytes = count * width;
+    std::size_t       i     = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        auto *p = reinterpret_cast<uint8_t *>(data + i);
+        vst1q_u8(p, Reverse(vld1q_u8(p)));
+    }
+    swap_scalar(data + i, (bytes - i) / width, width);
+}
+
+uint8x16_t
+reverse16(uint8x16_t v) {
+    return vrev16q_u8(v);
+}
+
+uint8x16_t
+reverse32(uint8x16_t v) {
+    return vrev32q_u8(v);
+}
+
+uint8x16_t
+reverse64(uint8x16_t v) {
+    return vrev64q_u8(v);
+}
+
+#endif
+
+} // namespace
+
+void
+big_to_host(byte *data, std::size_t count, std::size_t width) noexcept {
+    if (width != 2 && width != 4 && width != 8)
+        return;
+#if defined(QBM_PGSQL_SWAP_X86)
+    switch (x86_level()) {
+        case 2:
+            return swap_avx2(data, count, width);
+        case 1:
+            return swap_ssse3(data, count, width);
+        default:
+            return swap_scalar(data, count, width);
+    }
+#elif defined(QBM_PGSQL_SWAP_NEON)
+    if (width == 2)
+        swap_neon<reverse16>(data, count, width);
+    else if (width == 4)
+        swap_neon<reverse32>(data, count, width);
+    else
+        swap_neon<reverse64>(data, count, width);
+#else
+    // Identity on big-endian hosts
+    swap_scalar(data, count, width);
+#endif
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,65 @@
+/**
+ * @file byte_order.h
+ * @brief Bulk conversion of big-endian values to host byte order
+ *
+ * Binary columns hold their values in network byte order. Once a column
+ * is gathered into a contiguous buffer, its values are converted in place
+ * with SIMD byte shuffles where available:
+ *
+ * - x86: AVX2 or SSSE3, selected at run time (GCC and Clang)
+ * - ARM: NEON on little-endian targets
+ * - Scalar conversion elsewhere, and no-op on big-endian hosts
+ *
+ * Single values are read with load_be() by decoders that check the bounds
+ * of a whole message section at once.
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <qb/system/endian.h>
+
+#include "./pg_types.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Converts contiguous big-endian values to host byte order in place
+ *
+ * @param data First value
+ * @param count Number of values
+ * @param width Size of each value: 1, 2, 4 or 8 bytes
+ */
+void big_to_host(byte *data, std::size_t count, std::size_t width) noexcept;
+
+/**
+ * @brief Reads a big-endian integer, unaligned, without bounds checking
+ *
+ * @tparam T Integer type
+ * @param data First byte of the value, sizeof(T) bytes being readable
+ * @return T Value in host byte order
+ */
+template <typename T>
+inline T
+load_be(const char *data) noexcept {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return qb::endian::from_big_endian(value);
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,339 @@
+/**
+ * @file bytea_codec.cpp
+ * @brief Conversion of bytea values to and from the PostgreSQL text formats
+ *
+ * @see bytea_codec.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include "./bytea_codec.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define QBM_PGSQL_HEX_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define QBM_PGSQL_HEX_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace qb::pg::detail {
+
+namespace {
+
+constexpr char hex_digits[] = "0123456789abcdef";
+
+/**
+ * @brief Builds the table of the values of the hexadecimal digits, -1 elsewhere
+ */
+constexpr std::array<int8_t, 256>
+make_nibbles() noexcept {
+    std::array<int8_t, 256> table{};
+    for (int c = 0; c < 256; ++c)
+        table[c] = static_cast<int8_t>(c >= '0' && c <= '9'   ? c - '0'
+                                       : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                                       : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                                              : -1);
+    return table;
+}
+
+constexpr std::array<int8_t, 256> nibbles = make_nibbles();
+
+void
+encode_scalar(const byte *data, std::size_t size, char *out) noexcept {
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto value = static_cast<uint8_t>(data[i]);
+        out[2 * i]       = hex_digits[value >> 4];
+        out[2 * i + 1]   = hex_digits[value & 0x0F];
+    }
+}
+
+bool
+decode_scalar(const char *hex, std::size_t size, byte *out) noexcept {
+    for (std::size_t i = 0; i < size; ++i) {
+        const int high = nibbles[static_cast<uint8_t>(hex[2 * i])];
+        const int low  = nibbles[static_cast<uint8_t>(hex[2 * i + 1])];
+        if ((high | low) < 0)
+            return false;
+        out[i] = static_cast<byte>(high << 4 | low);
+    }
+    return true;
+}
+
+#if defined(QBM_PGSQL_HEX_X86)
+
+__attribute__((target("ssse3"))) void
+encode_ssse3(const byte *data, std::size_t size, char *out) noexcept {
+    const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hex_digits));
+    const __m128i mask   = _mm_set1_epi8(0x0F);
+    std::size_t   i      = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i high =
+            _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(value, 4), mask));
+        const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(value, mask));
+        auto         *dst = reinterpret_cast<__m128i *>(out + 2 * i);
+        _mm_storeu_si128(dst, _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(high, low));
+    }
+    encode_scalar(data + i, size - i, out + 2 * i);
+}
+
+__attribute__((target("avx2"))) void
+encode_avx2(const byte *data, std::size_t size, char *out) noexcept {
+    const __m256i digits = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(hex_digits)));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    std::size_t   i    = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256i high =
+            _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(value, 4), mask));
+        const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(value, mask));
+        // Pairs of each 128-bit lane, reordered across the lanes
+        const __m256i first  = _mm256_unpacklo_epi8(high, low);
+        const __m256i second = _mm256_unpackhi_epi8(high, low);
+        auto         *dst    = reinterpret_cast<__m256i *>(out + 2 * i);
+        _mm256_storeu_si256(dst, _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    encode_ssse3(data + i, size - i, out + 2 * i);
+}
+
+/**
+ * @brief Converts 16 hexadecimal digits to their values
+ *
+ * @return bool False if a character is not a digit
+ */
+__attribute__((target("ssse3"))) inline bool
+nibbles_sse(__m128i chars, __m128i &values) noexcept {
+    const __m128i digit    = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i alpha =
+        _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    const __m128i letter   = _mm_add_epi8(alpha, _mm_set1_epi8(10));
+    values = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_alpha, letter));
+    return _mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) == 0xFFFF;
+}
+
+__attribute__((target("ssse3"))) bool
+decode_ssse3(const char *hex, std::size_t size, byte *out) noexcept {
+    // Multiply-add of each pair of nibbles: high * 16 + low
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    std::size_t   i       = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m128i values;
+        if (!nibbles_sse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hex + 2 * i)),
+                         values))
+            return false;
+        const __m128i bytes =
+            _mm_packus_epi16(_mm_maddubs_epi16(values, weights), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), bytes);
+    }
+    return decode_scalar(hex + 2 * i, size - i, out + i);
+}
+
+__attribute__((target("avx2"))) bool
+decode_avx2(const char *hex, std::size_t size, byte *out) noexcept {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    std::size_t   i       = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hex + 2 * i));
+        const __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+        const __m256i is_digit =
+            _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+        const __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)),
+                                              _mm256_set1_epi8('a'));
+        const __m256i is_alpha =
+            _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+        if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)) != -1)
+            return false;
+        const __m256i letter = _mm256_add_epi8(alpha, _mm256_set1_epi8(10));
+        const __m256i values = _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                                               _mm256_and_si256(is_alpha, letter));
+        // 8 bytes at the bottom of each lane, gathered in the low 128 bits
+        const __m256i bytes = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_maddubs_epi16(values, weights), _mm256_setzero_si256()),
+            0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm256_castsi256_si128(bytes));
+    }
+    return decode_ssse3(hex + 2 * i, size - i, out + i);
+}
+
+/**
+ * @brief Gets the widest instruction set supported by the processor
+ *
+ * @return int 2 for AVX2, 1 for SSSE3, 0 for none
+ */
+int
+x86_level() noexcept {
+    static const int level = __builtin_cpu_supports("avx2")    ? 2
+                             : __builtin_cpu_supports("ssse3") ? 1
+                                                               : 0;
+    return level;
+}
+
+#elif defined(QBM_PGSQL_HEX_NEON)
+
+void
+encode_neon(const byte *data, std::size_t size, char *out) noexcept {
+    const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t *>(hex_digits));
+    std::size_t      i      = 0;
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t value = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+        uint8x16x2_t     pairs;
+        pairs.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(value, 4));
+        pairs.val[1] = vqtbl1q_u8(digits, vandq_u8(value, vdupq_n_u8(0x0F)));
+        vst2q_u8(reinterpret_cast<uint8_t *>(out + 2 * i), pairs);
+    }
+    encode_scalar(data + i, size - i, out + 2 * i);
+}
+
+/**
+ * @brief Converts 16 hexadecimal digits to their values
+ *
+ * @return uint8x16_t 0xFF in the lanes holding a digit
+ */
+inline uint8x16_t
+nibbles_neon(uint8x16_t chars, uint8x16_t &values) noexcept {
+    const uint8x16_t digit    = vsubq_u8(chars, vdupq_n_u8('0'));
+    const uint8x16_t is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+    const uint8x16_t alpha    = vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    values = vbslq_u8(is_digit, digit, vaddq_u8(alpha, vdupq_n_u8(10)));
+    return vorrq_u8(is_digit, vcleq_u8(alpha, vdupq_n_u8(5)));
+}
+
+bool
+decode_neon(const char *hex, std::size_t size, byte *out) noexcept {
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        // Deinterleaved: high nibbles in val[0], low nibbles in val[1]
+        const uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t *>(hex + 2 * i));
+        uint8x16_t         high, low;
+        const uint8x16_t   valid =
+            vandq_u8(nibbles_neon(chars.val[0], high), nibbles_neon(chars.val[1], low));
+        if (vminvq_u8(valid) != 0xFF)
+            return false;
+        vst1q_u8(reinterpret_cast<uint8_t *>(out + i), vorrq_u8(vshlq_n_u8(high, 4), low));
+    }
+    return decode_scalar(hex + 2 * i, size - i, out + i);
+}
+
+#endif
+
+/**
+ * @brief Value of an octal digit, or -1
+ */
+constexpr int
+octal_digit(char c) noexcept {
+    return c >= '0' && c <= '7' ? c - '0' : -1;
+}
+
+/**
+ * @brief Parses the escape format of bytea
+ */
+void
+unescape(std::string_view text, std::vector<byte> &out) {
+    // The bytes are never more than the characters
+    out.resize(text.size());
+    byte       *dst = out.data();
+    const char *src = text.data();
+    const char *end = src + text.size();
+    while (src != end) {
+        if (*src != '\\') {
+            *dst++ = *src++;
+            continue;
+        }
+        if (end - src >= 2 && src[1] == '\\') {
+            *dst++ = '\\';
+            src += 2;
+            continue;
+        }
+        const int high   = end - src >= 4 ? octal_digit(src[1]) : -1;
+        const int middle = high >= 0 ? octal_digit(src[2]) : -1;
+        const int low    = middle >= 0 ? octal_digit(src[3]) : -1;
+        if (low < 0 || high > 3)
+            throw std::runtime_error("Invalid escape sequence in bytea");
+        *dst++ = static_cast<byte>(high << 6 | middle << 3 | low);
+        src += 4;
+    }
+    out.resize(static_cast<std::size_t>(dst - out.data()));
+}
+
+} // namespace
+
+void
+ByteaCodec::encode_hex(const byte *data, std::size_t size, char *out) noexcept {
+#if defined(QBM_PGSQL_HEX_X86)
+    switch (x86_level()) {
+        case 2:
+            return encode_avx2(data, size, out);
+        case 1:
+            return encode_ssse3(data, size, out);
+        default:
+            return encode_scalar(data, size, out);
+    }
+#elif defined(QBM_PGSQL_HEX_NEON)
+    encode_neon(data, size, out);
+#else
+    encode_scalar(data, size, out);
+#endif
+}
+
+bool
+ByteaCodec::decode_hex(const char *hex, std::size_t size, byte *out) noexcept {
+#if defined(QBM_PGSQL_HEX_X86)
+    switch (x86_level()) {
+        case 2:
+            return decode_avx2(hex, size, out);
+        case 1:
+            return decode_ssse3(hex, size, out);
+        default:
+            return decode_scalar(hex, size, out);
+    }
+#elif defined(QBM_PGSQL_HEX_NEON)
+    return decode_neon(hex, size, out);
+#else
+    return decode_scalar(hex, size, out);
+#endif
+}
+
+std::string
+ByteaCodec::to_text(const byte *data, std::size_t size) {
+    std::string result(2 + 2 * size, '\0');
+    result[0] = '\\';
+    result[1] = 'x';
+    encode_hex(data, size, result.data() + 2);
+    return result;
+}
+
+void
+ByteaCodec::from_text(std::string_view text, std::vector<byte> &out) {
+    if (text.size() < 2 || text[0] != '\\' || text[1] != 'x')
+        return unescape(text, out);
+
+    const std::string_view hex = text.substr(2);
+    if (hex.size() % 2)
+        throw std::runtime_error("Odd number of hex digits in bytea");
+    out.resize(hex.size() / 2);
+    if (!decode_hex(hex.data(), out.size(), out.data()))
+        throw std::runtime_error("Invalid hex character in bytea");
+}
+
+} // namespace qb::pg::detail
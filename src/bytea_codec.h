@@ -0,0 +1,86 @@
+/**
+ * @file bytea_codec.h
+ * @brief Conversion of bytea values to and from the PostgreSQL text formats
+ *
+ * In text format, bytea values are sent in the hex format (`\x` followed
+ * by two hexadecimal digits per byte) or, with `bytea_output = escape`, in
+ * the escape format. Multi-megabyte values are common, so the hex digits
+ * are converted with SIMD instructions where available:
+ *
+ * - x86: AVX2 or SSSE3, selected at run time (GCC and Clang)
+ * - ARM: NEON on AArch64
+ * - Scalar conversion elsewhere and for the tail of the values
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./pg_types.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Conversions between bytea values and their text formats
+ */
+struct ByteaCodec {
+    /**
+     * @brief Writes the lower-case hexadecimal digits of bytes
+     *
+     * @param data Bytes to encode
+     * @param size Number of bytes
+     * @param out Destination, at least 2 * size characters
+     */
+    static void encode_hex(const byte *data, std::size_t size, char *out) noexcept;
+
+    /**
+     * @brief Reads bytes from pairs of hexadecimal digits, in any case
+     *
+     * @param hex Digits, 2 * size characters
+     * @param size Number of bytes to decode
+     * @param out Destination, at least size bytes
+     * @return bool False if a character is not a hexadecimal digit
+     */
+    static bool decode_hex(const char *hex, std::size_t size, byte *out) noexcept;
+
+    /**
+     * @brief Formats bytes in the hex format, `\x` prefix included
+     *
+     * @param data Bytes to encode
+     * @param size Number of bytes
+     * @return std::string Text value
+     */
+    static std::string to_text(const byte *data, std::size_t size);
+
+    /**
+     * @brief Parses a bytea in the hex or the escape format
+     *
+     * A text starting with `\x` is in the hex format. Otherwise it is in
+     * the escape format, where `\\` is a backslash and `\nnn` the byte of
+     * octal value nnn; other characters stand for themselves.
+     *
+     * @param text Text value
+     * @param out Receives the bytes, replacing its content
+     * @throws std::runtime_error If the text is not a valid bytea
+     */
+    static void from_text(std::string_view text, std::vector<byte> &out);
+};
+
+} // namespace qb::pg::detail
@@ -0,0 +1,118 @@
+/**
+ * @file capture.cpp
+ * @brief Capture of the wire protocol traffic of a connection
+ *
+ * @see capture.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./capture.h"
+
+#include <iterator>
+
+#include "./error.h"
+
+namespace qb::pg::detail {
+
+WireRecorder::WireRecorder(std::filesystem::path const &path)
+    : _file(path, std::ios::binary | std::ios::trunc) {
+    if (!_file.is_open())
+        throw error::client_error{"cannot create capture file: " + path.string()};
+    _file.write(WireCapture::magic.data(), static_cast<std::streamsize>(WireCapture::magic.size()));
+}
+
+void
+WireRecorder::write_varint(std::uint64_t value) {
+    char        buffer[10];
+    std::size_t size = 0;
+    do {
+        buffer[size] = static_cast<char>(value & 0x7F);
+        value >>= 7;
+        if (value)
+            buffer[size] = static_cast<char>(buffer[size] | 0x80);
+        ++size;
+    } while (value);
+    _file.write(buffer, static_cast<std::streamsize>(size));
+}
+
+void
+WireRecorder::record(wire_direction direction, const char *data, std::size_t size) {
+    const auto now   = std::chrono::steady_clock::now();
+    const auto delta = _frames ? now - _last : std::chrono::steady_clock::duration::zero();
+    _last            = now;
+    _file.put(static_cast<char>(direction));
+    write_varint(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count()));
+    write_varint(size);
+    _file.write(data, static_cast<std::streamsize>(size));
+    ++_frames;
+    _bytes += size;
+}
+
+void
+WireRecorder::flush() {
+    _file.flush();
+}
+
+WireCapture::WireCapture(std::filesystem::path const &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw error::client_error{"cannot open capture file: " + path.string()};
+    _data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (std::string_view(_data).substr(0, magic.size()) != magic)
+        throw error::client_error{"not a capture file: " + path.string()};
+    rewind();
+}
+
+std::uint64_t
+WireCapture::read_varint() {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (_pos >= _data.size())
+            break;
+        const auto byte = static_cast<unsigned char>(_data[_pos++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw error::client_error{"truncated capture frame"};
+}
+
+bool
+WireCapture::next(WireFrame &frame) {
+    if (_pos >= _data.size())
+        return false;
+    const auto direction = static_cast<wire_direction>(_data[_pos++]);
+    if (direction != wire_direction::backend && direction != wire_direction::frontend)
+        throw error::client_error{"malformed capture frame"};
+    _clock += std::chrono::nanoseconds(static_cast<std::int64_t>(read_varint()));
+    const auto size = read_varint();
+    if (size > _data.size() - _pos)
+        throw error::client_error{"truncated capture frame"};
+    frame.direction = direction;
+    frame.at        = _clock;
+    frame.bytes     = std::string_view(_data.data() + _pos, static_cast<std::size_t>(size));
+    _pos += static_cast<std::size_t>(size);
+    return true;
+}
+
+void
+WireCapture::rewind() noexcept {
+    _pos   = magic.size();
+    _clock = std::chrono::nanoseconds(0);
+}
+
+} // namespace qb::pg::detail
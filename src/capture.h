@@ -0,0 +1,165 @@
+/**
+ * @file capture.h
+ * @brief Capture of the wire protocol traffic of a connection
+ *
+ * A WireRecorder attached to a connection writes the messages it receives
+ * and the bytes it sends to a compact binary file, with the time elapsed
+ * between them. A WireCapture reads the file back, so the traffic of a
+ * production workload can be replayed offline, through the protocol
+ * framing and the handlers of a Database, without a server (see
+ * WireReplay).
+ *
+ * File layout, integers in unsigned LEB128:
+ *
+ * - the 8 bytes "QBPGCAP" followed by the format version (1)
+ * - per frame: the direction ('B' received, 'F' sent), the nanoseconds
+ *   since the previous frame, the size of the frame, then its bytes
+ *
+ * A received frame is one backend message; a sent frame holds the messages
+ * of one send, e.g. Parse, Bind, Execute and Sync.
+ *
+ * @see qb::pg::detail::Database::capture
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Direction of a captured frame
+ */
+enum class wire_direction : char {
+    backend  = 'B', ///< Message received from the server
+    frontend = 'F', ///< Bytes sent to the server
+};
+
+/**
+ * @brief Frame read from a capture
+ */
+struct WireFrame {
+    wire_direction           direction{wire_direction::backend}; ///< Sender of the frame
+    std::chrono::nanoseconds at{0};  ///< Time since the first frame of the capture
+    std::string_view         bytes;  ///< Content, valid while the capture is alive
+};
+
+/**
+ * @brief Writes the frames of a connection to a capture file
+ *
+ * Not thread-safe: a recorder belongs to one connection.
+ */
+class WireRecorder {
+    std::ofstream                         _file;      ///< Capture file
+    std::chrono::steady_clock::time_point _last{};    ///< Time of the previous frame
+    std::size_t                           _frames{0}; ///< Frames written
+    std::size_t                           _bytes{0};  ///< Frame bytes written
+
+    void write_varint(std::uint64_t value);
+
+public:
+    /**
+     * @brief Creates a capture file, replacing any existing one
+     *
+     * @param path Path of the file
+     * @throws error::client_error If the file cannot be created
+     */
+    explicit WireRecorder(std::filesystem::path const &path);
+
+    /**
+     * @brief Appends a frame, timestamped now
+     *
+     * @param direction Sender of the frame
+     * @param data Content of the frame
+     * @param size Size of the content in bytes
+     */
+    void record(wire_direction direction, const char *data, std::size_t size);
+
+    /**
+     * @brief Writes the buffered frames to the file
+     */
+    void flush();
+
+    /**
+     * @brief Gets the number of frames written
+     */
+    [[nodiscard]] std::size_t
+    frames() const noexcept {
+        return _frames;
+    }
+
+    /**
+     * @brief Gets the number of frame bytes written, without the framing
+     */
+    [[nodiscard]] std::size_t
+    bytes() const noexcept {
+        return _bytes;
+    }
+};
+
+/**
+ * @brief Capture file loaded in memory, read frame by frame
+ */
+class WireCapture {
+    std::string              _data;      ///< Content of the file
+    std::size_t              _pos{0};    ///< Offset of the next frame
+    std::chrono::nanoseconds _clock{0};  ///< Time of the last frame read
+
+    std::uint64_t read_varint();
+
+public:
+    /// Magic bytes starting a capture file, format version included
+    static constexpr std::string_view magic{"QBPGCAP\x01", 8};
+
+    /**
+     * @brief Loads a capture file
+     *
+     * @param path Path of the file
+     * @throws error::client_error If the file cannot be read or is not a capture
+     */
+    explicit WireCapture(std::filesystem::path const &path);
+
+    /**
+     * @brief Reads the next frame
+     *
+     * @param frame Receives the frame
+     * @return bool False at the end of the capture
+     * @throws error::client_error If the capture is truncated
+     */
+    bool next(WireFrame &frame);
+
+    /**
+     * @brief Goes back to the first frame
+     */
+    void rewind() noexcept;
+
+    /**
+     * @brief Gets the size of the capture file in bytes
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept {
+        return _data.size();
+    }
+};
+
+} // namespace qb::pg::detail
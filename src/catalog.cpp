@@ -0,0 +1,80 @@
+/**
+ * @file catalog.cpp
+ * @brief Statement catalog shared by the connections of a process
+ *
+ * @see catalog.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdexcept>
+#include "./catalog.h"
+
+namespace qb::pg::detail {
+
+StatementCatalog::StatementCatalog()
+    : _statements(std::make_shared<statements_type const>()) {}
+
+StatementCatalog &
+StatementCatalog::add(std::string_view name, std::string_view expr, type_oid_sequence types) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (auto existing = find(*_statements, name)) {
+        if (existing->query.expression != expr)
+            throw std::runtime_error("statement " + std::string(name) +
+                                     " already declared with another expression");
+        return *this;
+    }
+    auto statements = std::make_shared<statements_type>(*_statements);
+    statements->push_back(
+        {PreparedQuery{std::string(name), std::string(expr), std::move(types), {}}, false});
+    _statements = std::move(statements);
+    return *this;
+}
+
+void
+StatementCatalog::learn(PreparedQuery const &query) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto existing = find(*_statements, query.name);
+    if (!existing || existing->described || existing->query.expression != query.expression)
+        return;
+    // Snapshots held by connections are never modified
+    auto statements = std::make_shared<statements_type>(*_statements);
+    auto &statement = (*statements)[existing - _statements->data()];
+    statement.query.param_types     = query.param_types;
+    statement.query.row_description = query.row_description;
+    statement.described             = true;
+    _statements = std::move(statements);
+}
+
+StatementCatalog::snapshot_type
+StatementCatalog::snapshot() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statements;
+}
+
+std::size_t
+StatementCatalog::size() const {
+    return snapshot()->size();
+}
+
+StatementCatalog::Statement const *
+StatementCatalog::find(statements_type const &statements, std::string_view name) noexcept {
+    for (auto const &statement : statements)
+        if (statement.query.name == name)
+            return &statement;
+    return nullptr;
+}
+
+} // namespace qb::pg::detail
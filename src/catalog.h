@@ -0,0 +1,119 @@
+/**
+ * @file catalog.h
+ * @brief Statement catalog shared by the connections of a process
+ *
+ * Each Database keeps its own PreparedStorage, and preparing a statement
+ * costs a Parse + Describe round trip. With a StatementCatalog attached,
+ * every new or reconnected session prepares the catalog statements right
+ * after authentication, pipelined in one flight:
+ *
+ * - a statement already described by a connection is parsed again without
+ *   Describe, its parameter types and row description coming from the
+ *   catalog
+ * - the first connection preparing a statement describes it and records
+ *   the description in the catalog for the others
+ *
+ * The catalog is thread-safe. Connections read immutable snapshots, so a
+ * warm-up never holds the lock while queuing its statements.
+ *
+ * @see qb::pg::detail::Database::catalog
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "./queries.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Process-wide definitions of prepared statements
+ */
+class StatementCatalog {
+public:
+    /**
+     * @brief Statement of the catalog
+     */
+    struct Statement {
+        PreparedQuery query;            ///< Definition, with its description once known
+        bool          described{false}; ///< Parameter types and row description are known
+    };
+
+    using statements_type = std::vector<Statement>;
+    /// Immutable state of the catalog
+    using snapshot_type = std::shared_ptr<statements_type const>;
+
+private:
+    mutable std::mutex _mutex;      ///< Guards the replacement of _statements
+    snapshot_type      _statements; ///< Current snapshot
+
+public:
+    StatementCatalog();
+
+    StatementCatalog(StatementCatalog const &)            = delete;
+    StatementCatalog &operator=(StatementCatalog const &) = delete;
+
+    /**
+     * @brief Declares a statement
+     *
+     * Sessions started after this call prepare it. Declaring the same
+     * statement again does nothing.
+     *
+     * @param name Name of the statement
+     * @param expr SQL expression with parameter placeholders
+     * @param types Types of the parameters, empty to let the server infer them
+     * @return StatementCatalog& Reference to this catalog for chaining
+     * @throws std::runtime_error If the name is declared with another expression
+     */
+    StatementCatalog &add(std::string_view name, std::string_view expr,
+                          type_oid_sequence types = {});
+
+    /**
+     * @brief Records the description of a statement, the first time only
+     *
+     * @param query Statement as prepared and described by a connection
+     */
+    void learn(PreparedQuery const &query);
+
+    /**
+     * @brief Gets the current statements
+     *
+     * @return snapshot_type Statements, in declaration order
+     */
+    [[nodiscard]] snapshot_type snapshot() const;
+
+    /**
+     * @brief Gets the number of statements
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Finds a statement in a snapshot
+     *
+     * @param statements Snapshot of the catalog
+     * @param name Name of the statement
+     * @return Statement const* Statement, or nullptr if not declared
+     */
+    [[nodiscard]] static Statement const *find(statements_type const &statements,
+                                               std::string_view       name) noexcept;
+};
+
+} // namespace qb::pg::detail
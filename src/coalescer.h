@@ -0,0 +1,433 @@
+/**
+ * @file coalescer.h
+ * @brief Coalescing of single-row inserts into multi-row INSERT or COPY
+ *
+ * Many actors sharing a connection often insert one row at a time into the
+ * same few tables, each insert being a separate command. A Coalescer sits in
+ * front of the Database and gathers the rows of each registered target for a
+ * short window:
+ *
+ * - the window closes after a delay (1 ms by default) or once it holds a
+ *   number of rows (500 by default), whichever comes first
+ * - its rows are then sent as multi-row INSERT statements, prepared once per
+ *   power-of-two row count, or as a single binary COPY
+ * - the outcome of the statement carrying a row is handed back to the
+ *   callbacks of that row
+ *
+ * Throughput grows with the size of the batches while the latency of each
+ * insert stays bounded by the window.
+ *
+ * Included by pgsql.h after the definition of Database.
+ *
+ * @see qb::pg::detail::Database
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Statement used to write the rows of a coalesced target
+ */
+enum class coalesce_method {
+    insert, ///< Multi-row INSERT ... VALUES, through prepared statements
+    copy    ///< COPY ... FROM STDIN in binary format
+};
+
+/**
+ * @brief Handle of a target registered on a Coalescer
+ */
+class CoalesceTarget {
+    std::size_t _index; ///< Index of the target in its coalescer
+
+public:
+    explicit constexpr CoalesceTarget(std::size_t index) noexcept
+        : _index(index) {}
+
+    [[nodiscard]] constexpr std::size_t
+    index() const noexcept {
+        return _index;
+    }
+};
+
+/**
+ * @brief Gathers single-row inserts of one connection into batches
+ *
+ * A coalescer is bound to one connection and, like it, must be used from
+ * the thread running its I/O loop; the connection must outlive it. Rows
+ * are QueryParams holding one value per column, with the same types for
+ * every row of a target.
+ *
+ * A batch succeeds or fails as a whole: when a statement fails, every row
+ * it carried receives its error.
+ *
+ * @tparam QB_IO_ I/O handler type of the connection
+ */
+template <typename QB_IO_>
+class Coalescer {
+public:
+    using database_type = Database<QB_IO_>;
+    /// Callback run once the row is written
+    using success_type = std::function<void()>;
+    /// Callback run if the statement carrying the row fails
+    using error_type = std::function<void(error::db_error const &)>;
+
+private:
+    /// Parameters of a Bind message, whose count is a signed 16-bit integer
+    static constexpr std::size_t max_params = 0x7FFF;
+
+    /**
+     * @brief Row waiting for its window to close
+     */
+    struct Row {
+        QueryParams  params;     ///< Values of the row
+        success_type on_success; ///< Success callback of the caller
+        error_type   on_error;   ///< Error callback of the caller
+    };
+
+    using batch_type = std::shared_ptr<std::vector<Row>>;
+
+    /**
+     * @brief Registered target and its open window
+     */
+    struct Target {
+        std::string          table;          ///< Destination table
+        std::string          columns;        ///< Column list, comma separated
+        std::size_t          width;          ///< Number of columns
+        coalesce_method      method;         ///< Statement writing the rows
+        std::vector<integer> types{};        ///< Column types, taken from the first row
+        std::vector<Row>     rows{};         ///< Rows of the open window
+        std::uint64_t        window{0};      ///< Generation of the open window
+        std::uint32_t        prepared{0};    ///< Bit n set once 2^n rows are prepared
+    };
+
+    database_type                &_db;             ///< Connection writing the batches
+    std::vector<Target>           _targets;        ///< Registered targets
+    std::size_t                   _max_rows{500};  ///< Rows closing a window
+    std::chrono::microseconds     _max_delay{1000}; ///< Delay closing a window
+    std::shared_ptr<bool>         _alive = std::make_shared<bool>(true); ///< Guards loop callbacks
+
+    /**
+     * @brief Gets the name of the INSERT statement of a target for 2^rank rows
+     */
+    static std::string
+    statement_name(std::size_t index, unsigned rank) {
+        return "qb_coalesce_" + std::to_string(index) + "_" + std::to_string(1u << rank);
+    }
+
+    /**
+     * @brief Builds the INSERT statement of a target for a number of rows
+     */
+    static std::string
+    insert_statement(Target const &target, std::size_t rows) {
+        std::string sql = "INSERT INTO " + target.table + " (" + target.columns + ") VALUES ";
+        std::size_t param = 0;
+        for (std::size_t row = 0; row < rows; ++row) {
+            sql += row ? ", (" : "(";
+            for (std::size_t column = 0; column < target.width; ++column) {
+                if (column)
+                    sql += ", ";
+                sql += '$';
+                sql += std::to_string(++param);
+            }
+            sql += ')';
+        }
+        return sql;
+    }
+
+    /**
+     * @brief Concatenates the values of consecutive rows into one parameter set
+     */
+    static QueryParams
+    merge(std::vector<Row> const &rows, std::size_t first, std::size_t count, std::size_t width) {
+        std::size_t size = sizeof(smallint);
+        for (std::size_t i = first; i < first + count; ++i)
+            size += rows[i].params.get().size() - sizeof(smallint);
+
+        std::vector<byte> buffer;
+        buffer.reserve(size);
+        const auto params = qb::endian::to_big_endian(static_cast<smallint>(count * width));
+        const auto bytes  = reinterpret_cast<const byte *>(&params);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(params));
+        for (std::size_t i = first; i < first + count; ++i) {
+            auto const &values = rows[i].params.get();
+            buffer.insert(buffer.end(), values.begin() + sizeof(smallint), values.end());
+        }
+        return QueryParams::encoded(std::move(buffer));
+    }
+
+    /**
+     * @brief Hands the outcome of a statement to the rows it carried
+     */
+    static void
+    succeed(std::vector<Row> const &rows, std::size_t first, std::size_t count) {
+        for (std::size_t i = first; i < first + count; ++i)
+            if (rows[i].on_success)
+                rows[i].on_success();
+    }
+
+    static void
+    fail(std::vector<Row> const &rows, std::size_t first, std::size_t count,
+         error::db_error const &err) {
+        for (std::size_t i = first; i < first + count; ++i)
+            if (rows[i].on_error)
+                rows[i].on_error(err);
+    }
+
+    /**
+     * @brief Sends the rows of a batch as multi-row INSERT statements
+     *
+     * The batch is cut into power-of-two chunks, largest first, so a target
+     * never needs more than one prepared statement per bit of max_rows.
+     */
+    void
+    write_insert(std::size_t index, Target &target, batch_type const &batch) {
+        std::size_t limit = 1;
+        while (limit * 2 <= _max_rows && limit * 2 * target.width <= max_params)
+            limit *= 2;
+
+        const auto total = batch->size();
+        for (std::size_t first = 0; first < total;) {
+            unsigned    rank  = 0;
+            std::size_t count = 1;
+            while (count * 2 <= std::min(limit, total - first)) {
+                count *= 2;
+                ++rank;
+            }
+
+            const auto name = statement_name(index, rank);
+            if (!(target.prepared & (1u << rank))) {
+                type_oid_sequence types;
+                types.reserve(count * target.width);
+                for (std::size_t row = 0; row < count; ++row)
+                    for (auto type : target.types)
+                        types.push_back(static_cast<oid>(type));
+                target.prepared |= 1u << rank;
+                // Prepared again by the next batch if the Parse fails
+                _db.prepare(
+                    name, insert_statement(target, count), std::move(types),
+                    [](Transaction &, PreparedQuery const &) {},
+                    [this, alive = std::weak_ptr<bool>(_alive), index,
+                     rank](error::db_error const &) {
+                        if (!alive.expired())
+                            _targets[index].prepared &= ~(1u << rank);
+                    });
+            }
+            _db.execute(
+                name, merge(*batch, first, count, target.width),
+                [batch, first, count](Transaction &) { succeed(*batch, first, count); },
+                [batch, first, count](error::db_error const &err) {
+                    fail(*batch, first, count, err);
+                });
+            first += count;
+        }
+    }
+
+    /**
+     * @brief Sends the rows of a batch with a single binary COPY
+     *
+     * A serialized parameter set is laid out as a binary COPY tuple, so the
+     * rows are copied to the stream as they are.
+     */
+    void
+    write_copy(Target const &target, batch_type const &batch) {
+        constexpr std::size_t rows_per_message = 256;
+        _db.copy_in(
+            "COPY " + target.table + " (" + target.columns + ") FROM STDIN (FORMAT binary)",
+            [batch, next = std::size_t{0}](CopyWriter &out) mutable {
+                const auto last = std::min(batch->size(), next + rows_per_message);
+                for (; next < last; ++next) {
+                    auto const &values = (*batch)[next].params.get();
+                    out.write(std::string_view(values.data(), values.size()));
+                }
+                return next < batch->size();
+            },
+            [batch](Transaction &) { succeed(*batch, 0, batch->size()); },
+            [batch](error::db_error const &err) { fail(*batch, 0, batch->size(), err); });
+    }
+
+    /**
+     * @brief Closes the window of a target and sends its rows
+     */
+    void
+    flush(std::size_t index) {
+        auto &target = _targets[index];
+        ++target.window;
+        if (target.rows.empty())
+            return;
+
+        auto batch = std::make_shared<std::vector<Row>>(std::move(target.rows));
+        target.rows.clear();
+        if (target.method == coalesce_method::copy)
+            write_copy(target, batch);
+        else
+            write_insert(index, target, batch);
+    }
+
+    /**
+     * @brief Closes the window of a target once its delay expires
+     */
+    void
+    arm(std::size_t index) {
+        // Deferred on the connection, so that its await() waits for the window
+        static_cast<Transaction &>(_db).defer(
+            [this, alive = std::weak_ptr<bool>(_alive), index,
+             window = _targets[index].window]() {
+                if (!alive.expired() && _targets[index].window == window)
+                    flush(index);
+            },
+            std::chrono::duration<double>(_max_delay).count());
+    }
+
+    /**
+     * @brief Gets a registered target
+     *
+     * @throws std::out_of_range If the target was not registered here
+     */
+    Target &
+    target(CoalesceTarget handle) {
+        return _targets.at(handle.index());
+    }
+
+public:
+    /**
+     * @brief Constructs a coalescer over a connection
+     *
+     * @param db Connection writing the batches, must outlive the coalescer
+     */
+    explicit Coalescer(database_type &db) noexcept
+        : _db(db) {}
+
+    Coalescer(Coalescer const &)            = delete;
+    Coalescer &operator=(Coalescer const &) = delete;
+
+    /**
+     * @brief Sends the rows still waiting in a window
+     */
+    ~Coalescer() {
+        flush();
+    }
+
+    /**
+     * @brief Sets the limits closing a window
+     *
+     * @param max_rows Rows sent as soon as they are gathered, at least 1
+     * @param max_delay Longest wait of the first row of a window
+     * @return Coalescer& Reference to this coalescer for chaining
+     */
+    Coalescer &
+    window(std::size_t max_rows, std::chrono::microseconds max_delay) noexcept {
+        _max_rows  = max_rows ? max_rows : 1;
+        _max_delay = max_delay;
+        return *this;
+    }
+
+    /**
+     * @brief Registers a destination of coalesced rows
+     *
+     * @param table Table name, quoted by the caller if needed
+     * @param columns Column names, in the order of the row values
+     * @param method Statement writing the rows
+     * @return CoalesceTarget Handle passed to insert()
+     * @throws std::invalid_argument If no column is given
+     */
+    CoalesceTarget
+    add_target(std::string table, std::vector<std::string> const &columns,
+               coalesce_method method = coalesce_method::insert) {
+        if (columns.empty() || columns.size() > max_params)
+            throw std::invalid_argument("coalesced target needs 1 to 32767 columns");
+        std::string list;
+        for (auto const &column : columns) {
+            if (!list.empty())
+                list += ", ";
+            list += column;
+        }
+        _targets.push_back(Target{std::move(table), std::move(list), columns.size(), method});
+        return CoalesceTarget(_targets.size() - 1);
+    }
+
+    /**
+     * @brief Adds a row to the open window of a target
+     *
+     * The first row of a window starts its delay; the row reaching max_rows
+     * sends the window at once. External values are copied into the row.
+     *
+     * @param handle Target of the row
+     * @param row One value per column
+     * @param on_success Callback run once the row is written
+     * @param on_error Callback run if the statement carrying the row fails
+     * @throws std::invalid_argument If the values do not match the columns
+     * or the types of the previous rows
+     */
+    void
+    insert(CoalesceTarget handle, QueryParams &&row, success_type on_success = {},
+           error_type on_error = {}) {
+        auto &target = this->target(handle);
+        if (static_cast<std::size_t>(row.param_count()) != target.width)
+            throw std::invalid_argument("coalesced row does not match the target columns");
+        if (target.types.empty())
+            target.types = row.param_types();
+        else if (row.param_types() != target.types)
+            throw std::invalid_argument("coalesced row does not match the target types");
+
+        // Rows are merged into one buffer, and may outlive borrowed values
+        row.inline_external();
+        target.rows.push_back(Row{std::move(row), std::move(on_success), std::move(on_error)});
+        if (target.rows.size() >= _max_rows)
+            flush(handle.index());
+        else if (target.rows.size() == 1)
+            arm(handle.index());
+    }
+
+    /**
+     * @brief Sends the open window of a target now
+     */
+    void
+    flush(CoalesceTarget handle) {
+        this->target(handle);
+        flush(handle.index());
+    }
+
+    /**
+     * @brief Sends the open windows of every target now
+     */
+    void
+    flush() {
+        for (std::size_t index = 0; index < _targets.size(); ++index)
+            flush(index);
+    }
+
+    /**
+     * @brief Gets the number of rows waiting in the window of a target
+     */
+    [[nodiscard]] std::size_t
+    pending(CoalesceTarget handle) const {
+        return _targets.at(handle.index()).rows.size();
+    }
+};
+
+} // namespace qb::pg::detail
@@ -31,6 +31,9 @@
 
 #pragma once
 
+#include <optional>
+
+#include "./copy.h"
 #include "./result_impl.h"
 #include "./resultset.h"
 #include "./transaction.h"
@@ -61,6 +64,11 @@ public:
         : Transaction(parent)
         , _on_error(std::forward<CB_ERROR>(on_error)) {}
 
+    [[nodiscard]] bool
+    closes_block() const noexcept final {
+        return true;
+    }
+
     /**
      * @brief Gets the error callback
      *
@@ -160,8 +168,252 @@ public:
     on_sub_command_status(bool status) final {
         _result &= status;
     }
+
+    /**
+     * @brief Disables the result cache for the statements of the block
+     */
+    ResultCache *
+    result_cache() final {
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Attempts of a transaction block begun with a retry policy
+ *
+ * Shared by the RetryBegin and RetryEnd commands of every attempt, it
+ * queues a new attempt on the root transaction while the block fails on a
+ * retryable error and attempts remain. The attempts keep the slot of the
+ * block in the queue: the commands queued behind it run once it settled.
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class RetryBlock : public std::enable_shared_from_this<RetryBlock<CB_SUCCESS, CB_ERROR>> {
+    Transaction                   &_root;       ///< Transaction receiving the attempts
+    RetryPolicy                    _policy;     ///< Retry policy of the block
+    transaction_mode               _mode;       ///< Transaction mode (isolation level, etc.)
+    CB_SUCCESS                     _on_success; ///< Callback queueing the block
+    CB_ERROR                       _on_error;   ///< Callback of the final failure
+    unsigned                       _attempts{0}; ///< Number of failed attempts
+    std::optional<error::db_error> _failure;    ///< First error of the current attempt
+    Transaction const             *_holding{nullptr}; ///< End command waiting for the backoff
+
+public:
+    RetryBlock(Transaction &root, RetryPolicy policy, transaction_mode mode,
+               CB_SUCCESS on_success, CB_ERROR on_error)
+        : _root(root)
+        , _policy(std::move(policy))
+        , _mode(mode)
+        , _on_success(std::move(on_success))
+        , _on_error(std::move(on_error)) {}
+
+    /**
+     * @brief Queues an attempt of the block
+     *
+     * @param after Command to queue the attempt behind, nullptr for the back of the queue
+     */
+    void start(Transaction const *after = nullptr);
+
+    /**
+     * @brief Queues the statements of the block in the transaction of an attempt
+     */
+    void
+    run(Transaction &tr) {
+        _on_success(tr);
+    }
+
+    /**
+     * @brief Records an error of the current attempt, the first one is kept
+     */
+    void
+    record(error::db_error const &err) {
+        if (!_failure)
+            _failure = err;
+    }
+
+    /**
+     * @brief Ends the current attempt with a COMMIT
+     *
+     * Errors recorded in savepoints that recovered from them are forgotten.
+     */
+    void
+    committed() noexcept {
+        _failure.reset();
+    }
+
+    /**
+     * @brief Ends the current attempt with a failure, then retries or reports it
+     *
+     * A retried block holds the queue with the end command of the failed
+     * attempt during the backoff, then queues the next attempt behind it.
+     *
+     * @param end End command of the failed attempt
+     * @param cause Error of the COMMIT or ROLLBACK, nullptr once rolled back
+     */
+    void
+    failed(Transaction const &end, error::db_error const *cause) {
+        const error::db_error err =
+            cause ? *cause
+                  : _failure ? *_failure
+                             : (error::db_error) error::query_error(
+                                   "rollback processed due to a query failure");
+        _failure.reset();
+        if (++_attempts < _policy.max_attempts && _policy.retryable(err)) {
+            _holding = &end;
+            _root.defer(
+                [self = this->shared_from_this()]() {
+                    self->start(std::exchange(self->_holding, nullptr));
+                },
+                _policy.backoff(_attempts));
+            return;
+        }
+        _on_error(err);
+    }
+
+    /**
+     * @brief Checks if an end command holds the queue until the next attempt
+     */
+    [[nodiscard]] bool
+    holding(Transaction const &end) const noexcept {
+        return _holding == &end;
+    }
+
+    /**
+     * @brief Forgets an end command destroyed before the next attempt was queued
+     */
+    void
+    release(Transaction const &end) noexcept {
+        if (_holding == &end)
+            _holding = nullptr;
+    }
+
+    [[nodiscard]] transaction_mode
+    mode() const noexcept {
+        return _mode;
+    }
+};
+
+/**
+ * @brief Command ending an attempt of a retried transaction block
+ *
+ * Like End, commits or rolls back the attempt, then reports its outcome to
+ * the RetryBlock.
+ *
+ * @tparam BLOCK Type of the RetryBlock
+ */
+template <typename BLOCK>
+class RetryEnd final : public Transaction {
+    std::shared_ptr<BLOCK> _block; ///< Attempts of the block
+
+public:
+    RetryEnd(Transaction *parent, std::shared_ptr<BLOCK> block)
+        : Transaction(parent)
+        , _block(std::move(block)) {}
+
+    ~RetryEnd() {
+        _block->release(*this);
+    }
+
+    [[nodiscard]] bool
+    closes_block() const noexcept final {
+        return true;
+    }
+
+    [[nodiscard]] bool
+    holds_queue() const noexcept final {
+        return _block->holding(*this);
+    }
+
+    /**
+     * @brief Queues the COMMIT or ROLLBACK of the attempt
+     *
+     * @param commit True if every statement of the attempt succeeded
+     */
+    void
+    close(bool commit) {
+        auto on_error = [this](error::db_error const &err) { _block->failed(*this, &err); };
+        push_query(commit ? std::unique_ptr<ISqlQuery>(new CommitQuery(
+                                [block = _block]() { block->committed(); }, std::move(on_error)))
+                          : std::unique_ptr<ISqlQuery>(new RollbackQuery(
+                                [this]() { _block->failed(*this, nullptr); },
+                                std::move(on_error))));
+    }
+};
+
+/**
+ * @brief Command beginning an attempt of a retried transaction block
+ *
+ * Like Begin, sends BEGIN and queues the statements of the block, and
+ * records the first server error of the attempt for the RetryBlock.
+ *
+ * @tparam BLOCK Type of the RetryBlock
+ */
+template <typename BLOCK>
+class RetryBegin final : public Transaction {
+    std::shared_ptr<BLOCK> _block; ///< Attempts of the block
+    RetryEnd<BLOCK>       *_end;   ///< End command of this attempt
+
+public:
+    RetryBegin(Transaction *parent, std::shared_ptr<BLOCK> block, RetryEnd<BLOCK> *end)
+        : Transaction(parent)
+        , _block(std::move(block))
+        , _end(end) {
+        push_query(std::unique_ptr<ISqlQuery>(new BeginQuery(
+            _block->mode(),
+            [this]() {
+                try {
+                    _block->run(*this);
+                } catch (std::exception const &e) {
+                    _result = false;
+                    _block->record((error::db_error) error::client_error{e.what()});
+                }
+            },
+            [](auto const &) {
+                // recorded by on_query_error()
+            })));
+    }
+
+    ~RetryBegin() {
+        _end->close(_result);
+    }
+
+    void
+    on_sub_command_status(bool status) final {
+        _result &= status;
+    }
+
+    void
+    on_query_error(error::db_error const &err) final {
+        _block->record(err);
+        Transaction::on_query_error(err);
+    }
+
+    ResultCache *
+    result_cache() final {
+        return nullptr;
+    }
 };
 
+template <typename CB_SUCCESS, typename CB_ERROR>
+void
+RetryBlock<CB_SUCCESS, CB_ERROR>::start(Transaction const *after) {
+    using command = RetryBlock<CB_SUCCESS, CB_ERROR>;
+    auto self  = this->shared_from_this();
+    auto end   = new RetryEnd<command>(&_root, self);
+    auto begin = std::unique_ptr<Transaction>(new RetryBegin<command>(&_root, self, end));
+    if (after) {
+        // In the slot of the failed attempt, still at the head of the queue
+        auto first = begin.get();
+        _root.push_transaction_after(after, std::move(begin));
+        _root.push_transaction_after(first, std::unique_ptr<Transaction>(end));
+        return;
+    }
+    _root.push_transaction(std::move(begin));
+    _root.push_transaction(std::unique_ptr<Transaction>(end));
+}
+
 /**
  * @brief Command for ending a savepoint
  *
@@ -348,8 +600,8 @@ public:
         : Transaction(parent)
         , _on_success(std::forward<CB_SUCCESS>(on_success))
         , _on_error(std::forward<CB_ERROR>(on_error)) {
-        push_query(std::unique_ptr<ISqlQuery>(new SimpleQuery(
-            std::move(expr),
+        push_query(make_simple_query(
+            _query_storage, std::move(expr),
             [this]() {
                 try {
                     _on_success(*this);
@@ -366,7 +618,7 @@ public:
                 _on_error(err);
                 if (_parent)
                     _parent->on_sub_command_status(false); // Propager l'erreur au parent
-            })));
+            }));
     }
 
     //    void
@@ -375,6 +627,87 @@ public:
     //    }
 };
 
+/**
+ * @brief Enforces the result limits of a query collecting a result set
+ *
+ * Resolves the limits of the command at its first row, then checks the
+ * result set after each appended row. Once a limit is exceeded, the rows
+ * are handed to the overflow callback or the query is cancelled; either way
+ * they are released.
+ */
+class ResultBudget {
+    std::optional<ResultLimits>    _limits;          ///< Limits, resolved at the first row
+    bool                           _overflow{false}; ///< Rows go to the overflow callback
+    std::optional<error::db_error> _error;           ///< Error that failed the query
+
+    /**
+     * @brief Describes the limit exceeded by a result set
+     */
+    std::string
+    exceeded(result_impl const &results) const {
+        if (_limits->max_rows && results.size() > _limits->max_rows)
+            return "more than " + std::to_string(_limits->max_rows) + " rows";
+        return "more than " + std::to_string(_limits->max_bytes) + " bytes";
+    }
+
+public:
+    /**
+     * @brief Appends a data row to the result set, within the limits
+     *
+     * @param command Command receiving the row, which owns @p results
+     * @param results Result set of the command
+     * @param msg DataRow message
+     * @return false if the row could not be decoded
+     */
+    bool
+    append_row(Transaction &command, result_impl &results, message_view &msg) {
+        if (_error)
+            return true; // the query is being cancelled, drain its rows
+        if (qb::unlikely(!results.fits(msg.available()))) {
+            // Larger slabs would wrap the 32-bit field offsets
+            _error = error::client_error{"result set larger than " +
+                                         std::to_string(result_impl::max_data_size) + " bytes"};
+            command.cancel_query();
+            results.clear_rows();
+            return true;
+        }
+        if (!results.append_row(msg))
+            return false;
+        if (!_limits)
+            _limits = command.result_limits();
+        if (qb::likely(_limits->unlimited()))
+            return true;
+        if (!_overflow && (!_limits->max_rows || results.size() <= _limits->max_rows) &&
+            (!_limits->max_bytes || results.memory_size() <= _limits->max_bytes))
+            return true;
+
+        if (_limits->on_overflow) {
+            _overflow = true;
+            try {
+                resultset rows(&results);
+                for (std::size_t i = 0; i < rows.size(); ++i)
+                    _limits->on_overflow(rows[i]);
+            } catch (std::exception const &e) {
+                _error = error::client_error{e.what()};
+                command.cancel_query();
+            }
+        } else {
+            _error = error::result_limit_exceeded{exceeded(results)};
+            command.cancel_query();
+        }
+        results.clear_rows();
+        return true;
+    }
+
+    /**
+     * @brief Gets the error that failed the query, if any
+     */
+    std::optional<error::db_error> const &
+    error() const noexcept {
+        return _error;
+    }
+};
+
 /**
  * @brief Command for executing a query that returns results
  *
@@ -385,9 +718,23 @@ public:
  */
 template <typename CB_SUCCESS, typename CB_ERROR>
 class ResultQuery final : public Transaction {
-    CB_SUCCESS  _on_success; ///< Success callback
-    CB_ERROR    _on_error;   ///< Error callback
-    result_impl _results;    ///< Result data storage
+    CB_SUCCESS   _on_success; ///< Success callback
+    CB_ERROR     _on_error;   ///< Error callback
+    result_impl  _results;    ///< Result data storage
+    ResultBudget _budget;     ///< Result limits of the query
+
+    /**
+     * @brief Reports an error and propagates the failure to the parent
+     *
+     * @param err Error information
+     */
+    void
+    on_failure(error::db_error const &err) {
+        _result = false;
+        _on_error(err);
+        if (_parent)
+            _parent->on_sub_command_status(false);
+    }
 
 public:
     /**
@@ -402,26 +749,25 @@ public:
                 CB_ERROR &&on_error)
         : Transaction(parent)
         , _on_success(std::forward<CB_SUCCESS>(on_success))
-        , _on_error(std::forward<CB_ERROR>(on_error)) {
-        push_query(std::unique_ptr<ISqlQuery>(new SimpleQuery(
-            std::move(expr),
+        , _on_error(std::forward<CB_ERROR>(on_error))
+        , _results(memory_resource()) {
+        push_query(make_simple_query(
+            _query_storage, std::move(expr),
             [this]() {
+                // The query completed before its cancellation
+                if (_budget.error())
+                    return on_failure(*_budget.error());
                 try {
                     _on_success(*this, resultset(&_results));
-                    _parent->results() = std::move(_results);
+                    if (_results.memory_resource() == _parent->memory_resource())
+                        _parent->results() = std::move(_results);
                 } catch (std::exception const &e) {
-                    _result = false;
-                    _on_error((error::db_error) error::client_error{e.what()});
-                    if (_parent)
-                        _parent->on_sub_command_status(false);
+                    on_failure((error::db_error) error::client_error{e.what()});
                 }
             },
             [this](auto const &err) {
-                _result = false;
-                _on_error(err);
-                if (_parent)
-                    _parent->on_sub_command_status(false);
-            })));
+                on_failure(_budget.error() ? *_budget.error() : err);
+            }));
     }
 
     /**
@@ -439,13 +785,15 @@ public:
     /**
      * @brief Handles a data row from the query result
      *
-     * Adds a row of data to the result set.
+     * Decodes the row directly into the result set storage, within the
+     * result limits of the query.
      *
-     * @param data Row data
+     * @param msg DataRow message
+     * @return true if the row was decoded
      */
-    void
-    on_new_data_row(row_data &&data) final {
-        _results.rows().push_back(std::move(data));
+    bool
+    on_new_data_row(message_view &msg) final {
+        return _budget.append_row(*this, _results, msg);
     }
 };
 
@@ -561,9 +909,11 @@ public:
      * @param query Prepared query definition
      * @param on_success Callback for successful preparation
      * @param on_error Callback for preparation errors
+     * @param describe False for a query whose parameter types and row
+     * description are already set, to skip the Describe
      */
     Prepare(Transaction *parent, PreparedQuery &&query, CB_SUCCESS &&on_success,
-            CB_ERROR &&on_error)
+            CB_ERROR &&on_error, bool describe = true)
         : Transaction(parent)
         , _query(std::move(query))
         , _on_success(std::forward<CB_SUCCESS>(on_success))
@@ -578,7 +928,7 @@ public:
                     _on_error((error::db_error) error::client_error{e.what()});
                 }
             },
-            [this](auto const &err) { _on_error(err); })));
+            [this](auto const &err) { _on_error(err); }, describe)));
     }
 
     /**
@@ -592,6 +942,43 @@ public:
     on_new_row_description(row_description_type &&desc) {
         _query.row_description = std::move(desc);
     }
+
+    /**
+     * @brief Handles the parameter types inferred by the server
+     *
+     * Keeps them when the query did not declare its parameter types, so the
+     * statement is prepared again with the same types.
+     *
+     * @param types Types of the parameters
+     */
+    void
+    on_new_parameter_types(type_oid_sequence &&types) final {
+        if (_query.param_types.empty())
+            _query.param_types = std::move(types);
+    }
+};
+
+/**
+ * @brief Command closing the statements evicted from the statement cache
+ *
+ * Queued when the capacity of the cache shrinks. A failure only leaves the
+ * statements open until the session ends.
+ */
+class CloseEvicted final : public Transaction {
+public:
+    /**
+     * @brief Constructs a CloseEvicted command
+     *
+     * @param parent Parent transaction
+     */
+    explicit CloseEvicted(Transaction *parent)
+        : Transaction(parent) {
+        push_query(std::unique_ptr<ISqlQuery>(new EvictQuery(
+            _query_storage.statements(), []() {},
+            [](error::db_error const &err) {
+                LOG_WARN("[pgsql] Failed to close evicted statements: " << err.what());
+            })));
+    }
 };
 
 /**
@@ -605,7 +992,7 @@ public:
  */
 template <typename CB_SUCCESS, typename CB_ERROR>
 class ExecutePrepared final : public Transaction {
-    const std::string _query_name; ///< Name of the prepared query
+    const PreparedRef _statement;  ///< Prepared statement
     CB_SUCCESS        _on_success; ///< Success callback
     CB_ERROR          _on_error;   ///< Error callback
 
@@ -614,19 +1001,19 @@ public:
      * @brief Constructs an ExecutePrepared command
      *
      * @param parent Parent transaction
-     * @param query_name Name of the prepared query
+     * @param statement Prepared statement, by name or handle
      * @param params Parameter values for the query
      * @param on_success Callback for successful execution
      * @param on_error Callback for execution errors
      */
-    ExecutePrepared(Transaction *parent, std::string &&query_name, QueryParams &&params,
+    ExecutePrepared(Transaction *parent, PreparedRef &&statement, QueryParams &&params,
                     CB_SUCCESS &&on_success, CB_ERROR &&on_error)
         : Transaction(parent)
-        , _query_name(std::move(query_name))
+        , _statement(std::move(statement))
         , _on_success(std::forward<CB_SUCCESS>(on_success))
         , _on_error(std::forward<CB_ERROR>(on_error)) {
         push_query(std::unique_ptr<ISqlQuery>(new ExecuteQuery(
-            _query_storage, _query_name, std::move(params),
+            _query_storage, _statement, std::move(params),
             [this]() {
                 try {
                     _on_success(*this);
@@ -640,45 +1027,68 @@ public:
 };
 
 /**
- * @brief Command for executing a prepared query with result retrieval
+ * @brief Extracts the row count of a CommandComplete tag
  *
- * Executes a previously prepared query with the specified parameters
- * and collects the result rows for processing.
+ * @param command_tag Command tag such as "INSERT 0 1", "UPDATE 3" or "COPY 10"
+ * @return std::size_t Number of rows, 0 if the tag carries none
+ */
+inline std::size_t
+command_tag_rows(std::string_view command_tag) {
+    const auto pos = command_tag.find_last_of(' ');
+    if (pos == std::string_view::npos)
+        return 0;
+    std::size_t rows = 0;
+    for (auto c : command_tag.substr(pos + 1)) {
+        if (c < '0' || c > '9')
+            return 0;
+        rows = rows * 10 + static_cast<std::size_t>(c - '0');
+    }
+    return rows;
+}
+
+/**
+ * @brief Command for executing a prepared query over many parameter sets
  *
- * @tparam CB_SUCCESS Type of success callback that receives the result set
+ * Sends every execution in a single message with one trailing Sync and
+ * reports the total number of affected rows once the batch completes. The
+ * batch is atomic: the first failing execution rolls back the whole batch.
+ *
+ * @tparam CB_SUCCESS Type of success callback, optionally receiving the row count
  * @tparam CB_ERROR Type of error callback
  */
 template <typename CB_SUCCESS, typename CB_ERROR>
-class QueryPrepared final : public Transaction {
-    CB_SUCCESS        _on_success; ///< Success callback
-    CB_ERROR          _on_error;   ///< Error callback
-    const std::string _query_name; ///< Name of the prepared query
-    result_impl       _results;    ///< Result data storage
+class ExecuteBatch final : public Transaction {
+    const PreparedRef _statement;   ///< Prepared statement
+    CB_SUCCESS        _on_success;  ///< Success callback
+    CB_ERROR          _on_error;    ///< Error callback
+    std::size_t       _affected{0}; ///< Rows affected by the executions
 
 public:
     /**
-     * @brief Constructs a QueryPrepared command
+     * @brief Constructs an ExecuteBatch command
      *
      * @param parent Parent transaction
-     * @param query_name Name of the prepared query
-     * @param params Parameter values for the query
-     * @param on_success Callback for successful execution with results
+     * @param statement Prepared statement, by name or handle
+     * @param params Parameter sets, one per execution
+     * @param on_success Callback for successful execution of the batch
      * @param on_error Callback for execution errors
      */
-    QueryPrepared(Transaction *parent, std::string const &query_name,
-                  QueryParams &&params, CB_SUCCESS &&on_success, CB_ERROR &&on_error)
+    ExecuteBatch(Transaction *parent, PreparedRef &&statement,
+                 std::vector<QueryParams> &&params, CB_SUCCESS &&on_success,
+                 CB_ERROR &&on_error)
         : Transaction(parent)
+        , _statement(std::move(statement))
         , _on_success(std::forward<CB_SUCCESS>(on_success))
-        , _on_error(std::forward<CB_ERROR>(on_error))
-        , _query_name(query_name) {
-        push_query(std::unique_ptr<ISqlQuery>(new ExecuteQuery(
-            _query_storage, _query_name, std::move(params),
+        , _on_error(std::forward<CB_ERROR>(on_error)) {
+        push_query(std::unique_ptr<ISqlQuery>(new BatchQuery(
+            _query_storage, _statement, std::move(params),
             [this]() {
                 try {
-                    _results.row_description() =
-                        _query_storage.get(_query_name).row_description;
-                    _on_success(*this, resultset(&_results));
-                    _parent->results() = std::move(_results);
+                    if constexpr (std::is_invocable_v<CB_SUCCESS, Transaction &,
+                                                      std::size_t>)
+                        _on_success(*this, _affected);
+                    else
+                        _on_success(*this);
                 } catch (std::exception const &e) {
                     _result = false;
                     _on_error((error::db_error) error::client_error{e.what()});
@@ -688,18 +1098,1007 @@ public:
     }
 
     /**
-     * @brief Handles a data row from the query result
+     * @brief Accumulates the row count of each completed execution
+     *
+     * @param command_tag Command tag such as "INSERT 0 1" or "UPDATE 3"
+     */
+    void
+    on_new_command_complete(std::string_view command_tag) final {
+        _affected += command_tag_rows(command_tag);
+    }
+};
+
+/**
+ * @brief Command executing an AtomicBlock in a single round trip
+ *
+ * Counts the completed commands to find the failing step, and rolls the
+ * block back before reporting its error.
+ *
+ * @tparam CB_SUCCESS Type of success callback, (Transaction &) or
+ * (Transaction &, std::size_t affected_rows)
+ * @tparam CB_ERROR Type of error callback, (error::db_error const &) or
+ * (error::db_error const &, std::size_t step)
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class ExecuteAtomic final : public Transaction {
+    const AtomicBlock _block;        ///< Statements of the block
+    CB_SUCCESS        _on_success;   ///< Success callback
+    CB_ERROR          _on_error;     ///< Error callback
+    std::size_t       _completed{0}; ///< Commands completed, BEGIN included
+    std::size_t       _affected{0};  ///< Rows affected by the statements
+
+    /**
+     * @brief Reports an error with its step
+     */
+    void
+    fail(error::db_error const &err, std::size_t step) {
+        if constexpr (std::is_invocable_v<CB_ERROR, error::db_error const &, std::size_t>)
+            _on_error(err, step);
+        else
+            _on_error(err);
+    }
+
+    /**
+     * @brief Gets the statement being executed when the block failed
+     */
+    [[nodiscard]] std::size_t
+    failed_step() const noexcept {
+        return _completed && _completed <= _block.size() ? _completed - 1 : AtomicBlock::npos;
+    }
+
+public:
+    /**
+     * @brief Constructs an ExecuteAtomic command
+     *
+     * @param parent Parent transaction
+     * @param block Statements of the block
+     * @param mode Transaction mode
+     * @param on_success Callback for the committed block
+     * @param on_error Callback for the rolled back block
+     */
+    ExecuteAtomic(Transaction *parent, AtomicBlock &&block, transaction_mode mode,
+                  CB_SUCCESS &&on_success, CB_ERROR &&on_error)
+        : Transaction(parent)
+        , _block(std::move(block))
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error)) {
+        push_query(std::unique_ptr<ISqlQuery>(new AtomicQuery(
+            _query_storage, _block, mode,
+            [this]() {
+                try {
+                    if constexpr (std::is_invocable_v<CB_SUCCESS, Transaction &,
+                                                      std::size_t>)
+                        _on_success(*this, _affected);
+                    else
+                        _on_success(*this);
+                } catch (std::exception const &e) {
+                    _result = false;
+                    fail((error::db_error) error::client_error{e.what()}, AtomicBlock::npos);
+                }
+            },
+            [this](auto const &err) {
+                // The server skipped the COMMIT, the block is left aborted
+                const auto step = failed_step();
+                push_query(std::unique_ptr<ISqlQuery>(new RollbackQuery(
+                    [this, err, step]() { fail(err, step); },
+                    [this, err, step](auto const &) { fail(err, step); })));
+            })));
+    }
+
+    /**
+     * @brief Counts the completed commands and their affected rows
      *
-     * Adds a row of data to the result set.
+     * @param command_tag Command tag such as "BEGIN" or "INSERT 0 1"
+     */
+    void
+    on_new_command_complete(std::string_view command_tag) final {
+        if (_completed && _completed <= _block.size())
+            _affected += command_tag_rows(command_tag);
+        ++_completed;
+    }
+};
+
+/**
+ * @brief Command for executing a prepared query with result retrieval
+ *
+ * Executes a previously prepared query with the specified parameters
+ * and collects the result rows for processing.
+ *
+ * @tparam CB_SUCCESS Type of success callback that receives the result set
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class QueryPrepared final : public Transaction {
+    CB_SUCCESS        _on_success; ///< Success callback
+    CB_ERROR          _on_error;   ///< Error callback
+    const PreparedRef _statement;  ///< Prepared statement
+    result_impl       _results;    ///< Result data storage
+    ResultBudget      _budget;     ///< Result limits of the query
+    std::unique_ptr<CacheFill> _fill; ///< Cache entry filled with the result, if cacheable
+
+    /**
+     * @brief Sets the row description of the prepared statement, once
+     *
+     * Takes a kept result of the statement when it recycles its results
+     * and the rows are allocated from the resource of the connection.
+     */
+    void
+    describe() {
+        if (!_results.row_description().empty())
+            return;
+        const auto handle = _statement.resolve(_query_storage);
+        if (_query_storage.recycles(handle) && connection_memory()) {
+            _results = _query_storage.acquire(handle);
+            // Kept under an earlier resource of the connection
+            _results.memory_resource(memory_resource());
+        } else
+            _results.row_description() = _query_storage.get(handle).row_description;
+    }
+
+    /**
+     * @brief Hands the result to the parent, as the last result of the connection
+     *
+     * When the statement recycles its results, the result it replaces is
+     * given back to the statement instead of being freed. Rows allocated
+     * from another resource than the one of the parent are not handed over.
+     */
+    void
+    keep_results() {
+        if (_results.memory_resource() != _parent->memory_resource())
+            return;
+        const auto handle = _statement.resolve(_query_storage);
+        if (_query_storage.recycles(handle) && connection_memory()) {
+            std::swap(_parent->results(), _results);
+            if (_results.memory_resource() == memory_resource())
+                _query_storage.release(handle, std::move(_results));
+        } else
+            _parent->results() = std::move(_results);
+    }
+
+public:
+    /**
+     * @brief Constructs a QueryPrepared command
+     *
+     * @param parent Parent transaction
+     * @param statement Prepared statement, by name or handle
+     * @param params Parameter values for the query
+     * @param on_success Callback for successful execution with results
+     * @param on_error Callback for execution errors
+     * @param fill Cache entry to fill with the result, for a cacheable statement
+     */
+    QueryPrepared(Transaction *parent, PreparedRef &&statement, QueryParams &&params,
+                  CB_SUCCESS &&on_success, CB_ERROR &&on_error,
+                  std::unique_ptr<CacheFill> fill = nullptr)
+        : Transaction(parent)
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error))
+        , _statement(std::move(statement))
+        , _results(memory_resource())
+        , _fill(std::move(fill)) {
+        push_query(std::unique_ptr<ISqlQuery>(new ExecuteQuery(
+            _query_storage, _statement, std::move(params),
+            [this]() {
+                // The query completed before its cancellation
+                if (_budget.error()) {
+                    _result = false;
+                    _on_error(*_budget.error());
+                    return;
+                }
+                try {
+                    describe();
+                    if (_fill && connection_memory()) {
+                        // The rows move to the cache and are handed out from there
+                        auto shared = _fill->cache->store(_fill->statement, _fill->params,
+                                                          std::move(_results));
+                        if (shared) {
+                            _on_success(*this, resultset(const_cast<result_impl *>(shared.get())));
+                            return;
+                        }
+                    }
+                    _on_success(*this, resultset(&_results));
+                    keep_results();
+                } catch (std::exception const &e) {
+                    _result = false;
+                    _on_error((error::db_error) error::client_error{e.what()});
+                }
+            },
+            [this](auto const &err) {
+                if (_budget.error())
+                    _on_error(*_budget.error());
+                else
+                    _on_error(err);
+            })));
+    }
+
+    /**
+     * @brief Handles a data row from the query result
+     *
+     * Decodes the row directly into the result set storage, within the
+     * result limits of the query. Rows handed to an overflow callback need
+     * the row description, which is set before the first one.
+     *
+     * @param msg DataRow message
+     * @return true if the row was decoded
+     */
+    bool
+    on_new_data_row(message_view &msg) final {
+        if (_results.empty())
+            describe();
+        return _budget.append_row(*this, _results, msg);
+    }
+};
+
+/**
+ * @brief Command serving a cached result of a prepared statement
+ *
+ * Sends nothing to the server. Like Then, the callback runs when the command
+ * is reached and released, so a hit is served in queue order, after the
+ * commands queued before it, and not at all if the parent failed meanwhile.
+ *
+ * @tparam CB_SUCCESS Type of success callback that receives the result set
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class CacheHit final : public Transaction {
+    CB_SUCCESS                 _on_success; ///< Success callback
+    CB_ERROR                   _on_error;   ///< Error callback
+    ResultCache::shared_result _hit;        ///< Cached rows
+
+public:
+    /**
+     * @brief Constructs a CacheHit command
+     *
+     * @param parent Parent transaction
+     * @param hit Cached rows of the statement
+     * @param on_success Callback receiving the cached rows
+     * @param on_error Callback for exceptions thrown by on_success
+     */
+    CacheHit(Transaction *parent, ResultCache::shared_result hit, CB_SUCCESS &&on_success,
+             CB_ERROR &&on_error)
+        : Transaction(parent)
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error))
+        , _hit(std::move(hit)) {}
+
+    /**
+     * @brief Destructor
+     *
+     * Hands the cached rows to the success callback if the parent
+     * transaction has a successful result status.
+     */
+    ~CacheHit() {
+        if (!parent()->result())
+            return;
+        try {
+            _on_success(*parent(), resultset(const_cast<result_impl *>(_hit.get())));
+        } catch (std::exception const &e) {
+            _on_error((error::db_error) error::client_error{e.what()});
+        }
+    }
+};
+
+/**
+ * @brief Command executing a prepared query whose rows are decoded on workers
+ *
+ * Collects the rows like QueryPrepared, then freezes them in a shared
+ * immutable result and hands ranges of rows to the executor of the
+ * ResultOffload. The command completes at once, so the connection serves
+ * the next queries while the rows are decoded; the root transaction polls
+ * the workers and runs the callbacks once every range is done.
+ *
+ * @tparam Row Type of the decoded rows
+ * @tparam CB_SUCCESS Type of success callback, (Transaction &, std::vector<Row>)
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename Row, typename CB_SUCCESS, typename CB_ERROR>
+class OffloadPrepared final : public Transaction {
+    /**
+     * @brief Callbacks waiting for the workers, once the command is gone
+     */
+    struct Pending {
+        std::shared_ptr<OffloadedRows<Row>> rows;       ///< Rows being decoded
+        CB_SUCCESS                          on_success; ///< Success callback
+        CB_ERROR                            on_error;   ///< Error callback
+    };
+
+    CB_SUCCESS        _on_success; ///< Success callback
+    CB_ERROR          _on_error;   ///< Error callback
+    const PreparedRef _statement;  ///< Prepared statement
+    ResultOffload     _offload;    ///< Executor and ranges of the decoding
+    result_impl       _results;    ///< Result data storage
+    ResultBudget      _budget;     ///< Result limits of the query
+
+    void
+    describe() {
+        if (_results.row_description().empty())
+            _results.row_description() =
+                _query_storage.get(_statement.resolve(_query_storage)).row_description;
+    }
+
+    /**
+     * @brief Runs the callbacks on the event loop, once the workers are done
+     *
+     * @param root Root transaction, the connection
+     * @param pending Rows and callbacks
+     */
+    static void
+    complete(Transaction &root, Pending &pending) {
+        if (pending.rows->failed)
+            return pending.on_error((error::db_error) error::client_error{pending.rows->error});
+        try {
+            pending.on_success(root, std::move(pending.rows->rows));
+        } catch (std::exception const &e) {
+            pending.on_error((error::db_error) error::client_error{e.what()});
+        }
+    }
+
+    /**
+     * @brief Hands the rows to the workers, or decodes a small result in place
+     */
+    void
+    dispatch() {
+        const auto count = _results.size();
+        if (!count || count < _offload.min_rows || !_offload.executor) {
+            _on_success(*this, decode_rows<Row>(resultset(&_results)));
+            return;
+        }
+
+        Transaction *root = this;
+        while (root->parent())
+            root = root->parent();
+        auto pending = std::make_shared<Pending>(Pending{
+            nullptr, std::forward<CB_SUCCESS>(_on_success), std::forward<CB_ERROR>(_on_error)});
+        // The last task to finish posts the callbacks back to the event loop
+        auto post = std::make_shared<const std::function<void()>>(
+            root->loop_poster([root, pending]() { complete(*root, *pending); }));
+        if (!*post) {
+            // No event loop to post to: decode in place
+            try {
+                pending->on_success(*this, decode_rows<Row>(resultset(&_results)));
+            } catch (std::exception const &e) {
+                _result = false;
+                pending->on_error((error::db_error) error::client_error{e.what()});
+            }
+            return;
+        }
+
+        auto       result  = std::make_shared<const result_impl>(std::move(_results));
+        auto       decoder = std::make_shared<const RowDecoder<Row>>(result->row_description());
+        const auto per     = std::max<std::size_t>(_offload.rows_per_task, 1);
+        const auto tasks   = (count + per - 1) / per;
+        auto       rows    = std::make_shared<OffloadedRows<Row>>(std::move(result), tasks);
+        pending->rows      = rows;
+
+        for (std::size_t first = 0; first < count; first += per) {
+            const auto last = std::min(count, first + per);
+            auto       task = [rows, decoder, post, first, last]() {
+                try {
+                    // The result is only read, by every task at once
+                    const resultset view(const_cast<result_impl *>(rows->result.get()));
+                    for (std::size_t i = first; i < last; ++i)
+                        rows->rows[i] = (*decoder)(view[static_cast<resultset::size_type>(i)]);
+                } catch (std::exception const &e) {
+                    rows->fail(e.what());
+                } catch (...) {
+                    rows->fail("offloaded decoding failed");
+                }
+                if (rows->finish())
+                    (*post)();
+            };
+            try {
+                _offload.executor(std::move(task));
+            } catch (std::exception const &e) {
+                rows->fail(e.what());
+                if (rows->finish())
+                    (*post)();
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an OffloadPrepared command
+     *
+     * @param parent Parent transaction
+     * @param statement Prepared statement, by name or handle
+     * @param params Parameter values for the query
+     * @param offload Executor and ranges of the decoding
+     * @param on_success Callback receiving the decoded rows
+     * @param on_error Callback for execution and decoding errors
+     */
+    OffloadPrepared(Transaction *parent, PreparedRef &&statement, QueryParams &&params,
+                    ResultOffload offload, CB_SUCCESS &&on_success, CB_ERROR &&on_error)
+        : Transaction(parent)
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error))
+        , _statement(std::move(statement))
+        , _offload(std::move(offload)) {
+        push_query(std::unique_ptr<ISqlQuery>(new ExecuteQuery(
+            _query_storage, _statement, std::move(params),
+            [this]() {
+                if (_budget.error()) {
+                    _result = false;
+                    _on_error(*_budget.error());
+                    return;
+                }
+                try {
+                    describe();
+                    dispatch();
+                } catch (std::exception const &e) {
+                    _result = false;
+                    _on_error((error::db_error) error::client_error{e.what()});
+                }
+            },
+            [this](auto const &err) {
+                if (_budget.error())
+                    _on_error(*_budget.error());
+                else
+                    _on_error(err);
+            })));
+    }
+
+    bool
+    on_new_data_row(message_view &msg) final {
+        if (_results.empty())
+            describe();
+        return _budget.append_row(*this, _results, msg);
+    }
+};
+
+/**
+ * @brief Command for streaming query results row by row
+ *
+ * Executes a simple query or a prepared query and hands each row to a
+ * callback as soon as its DataRow message arrives. Rows are decoded into a
+ * single-row result set that is reused for the whole query, so peak memory
+ * is one row whatever the size of the result.
+ *
+ * If the row callback throws, the remaining rows are drained without being
+ * delivered and the error callback is invoked once the query completes.
+ *
+ * With a FieldStream, the designated columns are forwarded to its sink while
+ * each DataRow is read, and read as empty values in the row callback.
+ *
+ * @tparam CB_ROW Type of row callback that receives a resultset::row
+ * @tparam CB_SUCCESS Type of completion callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+class StreamQuery final : public Transaction {
+    CB_ROW                         _on_row;         ///< Row callback
+    CB_SUCCESS                     _on_success;     ///< Completion callback
+    CB_ERROR                       _on_error;       ///< Error callback
+    const PreparedRef              _statement;      ///< Prepared statement, if any
+    result_impl                    _row;            ///< Storage of the current row
+    resultset                      _view{&_row};    ///< Result set over the current row
+    bool                           _described{false}; ///< Row description is known
+    std::optional<error::db_error> _row_error;      ///< Error raised while streaming
+    std::optional<FieldStream>     _fields;         ///< Columns streamed to a sink
+
+    /**
+     * @brief Completes the command once the query is done
+     */
+    void
+    on_complete() {
+        if (_row_error) {
+            on_failure(*_row_error);
+            return;
+        }
+        try {
+            _on_success(*this);
+        } catch (std::exception const &e) {
+            on_failure((error::db_error) error::client_error{e.what()});
+        }
+    }
+
+    /**
+     * @brief Reports an error and propagates the failure to the parent
+     *
+     * @param err Error information
+     */
+    void
+    on_failure(error::db_error const &err) {
+        _result = false;
+        _on_error(err);
+        if (_parent)
+            _parent->on_sub_command_status(false);
+    }
+
+public:
+    /**
+     * @brief Constructs a StreamQuery command for a simple query
+     *
+     * @param parent Parent transaction
+     * @param expr SQL expression to execute
+     * @param on_row Callback invoked for each row
+     * @param on_success Callback invoked once all rows were delivered
+     * @param on_error Callback for query execution errors
+     * @param fields Columns streamed to a sink, if any
+     */
+    StreamQuery(Transaction *parent, std::string &&expr, CB_ROW &&on_row,
+                CB_SUCCESS &&on_success, CB_ERROR &&on_error,
+                std::optional<FieldStream> fields = std::nullopt)
+        : Transaction(parent)
+        , _on_row(std::forward<CB_ROW>(on_row))
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error))
+        , _row(memory_resource())
+        , _fields(std::move(fields)) {
+        push_query(make_simple_query(
+            _query_storage, std::move(expr), [this]() { on_complete(); },
+            [this](auto const &err) { on_failure(err); }));
+    }
+
+    /**
+     * @brief Constructs a StreamQuery command for a prepared query
+     *
+     * @param parent Parent transaction
+     * @param query_name Name of the prepared query
+     * @param params Parameter values for the query
+     * @param on_row Callback invoked for each row
+     * @param on_success Callback invoked once all rows were delivered
+     * @param on_error Callback for query execution errors
+     * @param fields Columns streamed to a sink, if any
+     */
+    StreamQuery(Transaction *parent, std::string const &query_name, QueryParams &&params,
+                CB_ROW &&on_row, CB_SUCCESS &&on_success, CB_ERROR &&on_error,
+                std::optional<FieldStream> fields = std::nullopt)
+        : Transaction(parent)
+        , _on_row(std::forward<CB_ROW>(on_row))
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error))
+        , _statement(query_name)
+        , _row(memory_resource())
+        , _fields(std::move(fields)) {
+        push_query(std::unique_ptr<ISqlQuery>(new ExecuteQuery(
+            _query_storage, _statement, std::move(params), [this]() { on_complete(); },
+            [this](auto const &err) { on_failure(err); })));
+    }
+
+    /**
+     * @brief Handles row description from the query result
+     *
+     * @param desc Row description metadata
+     */
+    void
+    on_new_row_description(row_description_type &&desc) final {
+        _row.row_description() = std::move(desc);
+        _described             = true;
+    }
+
+    /**
+     * @brief Decodes a data row and hands it to the row callback
+     *
+     * @param msg DataRow message
+     * @return true if the row was decoded
+     */
+    bool
+    on_new_data_row(message_view &msg) final {
+        if (_row_error)
+            return true;
+        if (!_described) {
+            // Prepared statements are described once, at prepare time
+            _row.row_description() =
+                _query_storage.get(_statement.resolve(_query_storage)).row_description;
+            _described             = true;
+        }
+
+        _row.clear_rows();
+        if (!_row.append_row(msg)) {
+            _row_error = error::client_error{"failed to decode data row"};
+            return false;
+        }
+        if (_fields && _fields->failed()) {
+            _row_error = error::client_error{_fields->error()};
+            return true;
+        }
+        try {
+            _on_row(_view[0]);
+        } catch (std::exception const &e) {
+            _row_error = error::client_error{e.what()};
+            // The next values are not wanted either
+            if (_fields)
+                _fields->stop(e.what());
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gets the columns streamed to a sink
+     *
+     * @return FieldStream* Streamed columns, or nullptr
+     */
+    FieldStream *
+    field_stream() final {
+        return _fields ? &*_fields : nullptr;
+    }
+};
+
+/**
+ * @brief Command for fetching a prepared query in chunks over a named portal
+ *
+ * Binds the prepared statement to a portal named after it and executes it
+ * with a row limit. The server suspends the portal after each chunk; rows of
+ * the chunk are handed to the chunk callback, and the next chunk is only
+ * requested when the caller invokes Portal::fetch(). Once the portal is
+ * exhausted or closed it is released and the transaction synchronized.
+ *
+ * If the chunk callback throws, the portal is closed and the error callback
+ * is invoked once the query completes.
+ *
+ * @tparam CB_CHUNK Type of chunk callback that receives (Portal &, resultset)
+ * @tparam CB_SUCCESS Type of completion callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_CHUNK, typename CB_SUCCESS, typename CB_ERROR>
+class FetchQuery final : public Portal {
+    CB_CHUNK                       _on_chunk;         ///< Chunk callback
+    CB_SUCCESS                     _on_success;       ///< Completion callback
+    CB_ERROR                       _on_error;         ///< Error callback
+    const PreparedRef              _statement;        ///< Prepared statement
+    result_impl                    _chunk;            ///< Rows of the current chunk
+    bool                           _described{false}; ///< Row description is known
+    std::optional<error::db_error> _row_error;        ///< Error raised while fetching
+
+    /**
+     * @brief Hands the current chunk to the chunk callback and resets it
+     */
+    void
+    deliver() {
+        if (_row_error)
+            return;
+        if (!_described) {
+            // Prepared statements are described once, at prepare time
+            _chunk.row_description() =
+                _query_storage.get(_statement.resolve(_query_storage)).row_description;
+            _described               = true;
+        }
+        try {
+            _on_chunk(static_cast<Portal &>(*this), resultset(&_chunk));
+        } catch (std::exception const &e) {
+            _row_error = error::client_error{e.what()};
+            close();
+        }
+        _chunk.clear_rows();
+    }
+
+    /**
+     * @brief Completes the command once the portal is released
+     */
+    void
+    on_complete() {
+        if (_row_error) {
+            on_failure(*_row_error);
+            return;
+        }
+        try {
+            _on_success(*this);
+        } catch (std::exception const &e) {
+            on_failure((error::db_error) error::client_error{e.what()});
+        }
+    }
+
+    /**
+     * @brief Reports an error and propagates the failure to the parent
+     *
+     * @param err Error information
+     */
+    void
+    on_failure(error::db_error const &err) {
+        _result    = false;
+        _suspended = false;
+        _on_error(err);
+        if (_parent)
+            _parent->on_sub_command_status(false);
+    }
+
+public:
+    /**
+     * @brief Constructs a FetchQuery command
+     *
+     * @param parent Parent transaction
+     * @param query_name Name of the prepared query
+     * @param params Parameter values for the query
+     * @param fetch_size Maximum number of rows per chunk
+     * @param on_chunk Callback invoked for each chunk of rows
+     * @param on_success Callback invoked once the portal is released
+     * @param on_error Callback for query execution errors
+     */
+    FetchQuery(Transaction *parent, std::string const &query_name, QueryParams &&params,
+               integer fetch_size, CB_CHUNK &&on_chunk, CB_SUCCESS &&on_success,
+               CB_ERROR &&on_error)
+        : Portal(parent)
+        , _on_chunk(std::forward<CB_CHUNK>(on_chunk))
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error))
+        , _statement(query_name)
+        , _chunk(memory_resource()) {
+        push_query(std::unique_ptr<ISqlQuery>(new PortalQuery(
+            _query_storage, _statement, _statement.name(), std::move(params), fetch_size,
+            [this]() { on_complete(); }, [this](auto const &err) { on_failure(err); })));
+    }
+
+    /**
+     * @brief Stores a data row into the current chunk
+     *
+     * @param msg DataRow message
+     * @return true if the row was decoded
+     */
+    bool
+    on_new_data_row(message_view &msg) final {
+        if (_row_error)
+            return true;
+        if (!_chunk.append_row(msg)) {
+            _row_error = error::client_error{"failed to decode data row"};
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Delivers the chunk and waits for the caller to fetch or close
+     */
+    void
+    on_new_portal_suspended() final {
+        _suspended = true;
+        deliver();
+        if (_row_error)
+            close();
+    }
+
+    /**
+     * @brief Delivers the last chunk and releases the portal
+     */
+    void
+    on_new_command_complete(std::string_view) final {
+        deliver();
+        resume_query(false);
+    }
+};
+
+/**
+ * @brief Command for bulk loading data with COPY FROM STDIN
+ *
+ * Runs a COPY ... FROM STDIN statement and, once the server is in COPY
+ * mode, calls the producer to fill one CopyData message at a time. The
+ * connection only asks for the next chunk while its output buffer is below
+ * the COPY window, so a fast producer cannot outrun the socket.
+ *
+ * If the producer throws, the copy is aborted with CopyFail and the error
+ * callback receives the exception message.
+ *
+ * @tparam CB_PRODUCER Type of producer, bool(CopyWriter &) returning false at the end
+ * @tparam CB_SUCCESS Type of success callback, optionally receiving the row count
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_PRODUCER, typename CB_SUCCESS, typename CB_ERROR>
+class CopyIn final : public Transaction {
+    CB_PRODUCER                    _producer;      ///< Data producer
+    CB_SUCCESS                     _on_success;    ///< Success callback
+    CB_ERROR                       _on_error;      ///< Error callback
+    CopyWriter                     _writer;        ///< Encoder of the COPY data
+    bool                           _binary{false}; ///< Server expects binary data
+    std::size_t                    _rows{0};       ///< Rows reported by the server
+    std::optional<error::db_error> _copy_error;    ///< Error raised by the producer
+
+    /**
+     * @brief Completes the command once the copy is done
+     */
+    void
+    on_complete() {
+        try {
+            if constexpr (std::is_invocable_v<CB_SUCCESS, Transaction &, std::size_t>)
+                _on_success(*this, _rows);
+            else
+                _on_success(*this);
+        } catch (std::exception const &e) {
+            on_failure((error::db_error) error::client_error{e.what()});
+        }
+    }
+
+    /**
+     * @brief Reports an error and propagates the failure to the parent
+     *
+     * @param err Error information
+     */
+    void
+    on_failure(error::db_error const &err) {
+        _result = false;
+        _on_error(_copy_error ? *_copy_error : err);
+        if (_parent)
+            _parent->on_sub_command_status(false);
+    }
+
+public:
+    /**
+     * @brief Constructs a CopyIn command
+     *
+     * @param parent Parent transaction
+     * @param expr COPY ... FROM STDIN statement
+     * @param producer Callback filling each chunk of data
+     * @param on_success Callback invoked once the data is committed
+     * @param on_error Callback for copy errors
+     */
+    CopyIn(Transaction *parent, std::string &&expr, CB_PRODUCER &&producer,
+           CB_SUCCESS &&on_success, CB_ERROR &&on_error)
+        : Transaction(parent)
+        , _producer(std::forward<CB_PRODUCER>(producer))
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error)) {
+        _writer.options(expr);
+        push_query(std::unique_ptr<ISqlQuery>(
+            new CopyQuery(std::move(expr), [this]() { on_complete(); },
+                          [this](auto const &err) { on_failure(err); })));
+    }
+
+    /**
+     * @brief Records the COPY format announced by the server
+     *
+     * @param binary True for binary COPY data
+     */
+    void
+    on_new_copy_response(bool binary) final {
+        _binary = binary;
+    }
+
+    /**
+     * @brief Fills the next CopyData message from the producer
+     *
+     * @param data CopyData message to fill
+     * @return bool True if the producer has more data
+     */
+    bool
+    on_copy_in(message &data) final {
+        _writer.attach(data, _binary);
+        bool more = false;
+        try {
+            more = _producer(_writer);
+        } catch (std::exception const &e) {
+            _copy_error = error::client_error{e.what()};
+            message fail(copy_fail_tag);
+            fail.write(std::string(e.what()));
+            data.pack(fail);
+            return false;
+        }
+        if (!more) {
+            _writer.finish();
+            data.pack(message(copy_done_tag));
+        }
+        return more;
+    }
+
+    /**
+     * @brief Stores the number of rows copied
+     *
+     * @param command_tag Command tag ("COPY n")
+     */
+    void
+    on_new_command_complete(std::string_view command_tag) final {
+        _rows = command_tag_rows(command_tag);
+    }
+};
+
+/**
+ * @brief Command for exporting data with COPY TO STDOUT
+ *
+ * Runs a COPY ... TO STDOUT statement and hands every CopyData message to
+ * the sink as it arrives, so memory stays bounded to one message whatever
+ * the size of the export. A sink taking a CopyRow receives binary tuples
+ * decoded in place by a CopyReader.
+ *
+ * If the sink throws, the remaining data is drained without being
+ * delivered and the error callback is invoked once the copy completes.
+ *
+ * @tparam CB_SINK Type of sink, void(std::string_view) or void(CopyRow const &)
+ * @tparam CB_SUCCESS Type of success callback, optionally receiving the row count
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SINK, typename CB_SUCCESS, typename CB_ERROR>
+class CopyOut final : public Transaction {
+    static constexpr bool typed = std::is_invocable_v<CB_SINK, CopyRow const &>;
+
+    CB_SINK                        _sink;       ///< Data sink
+    CB_SUCCESS                     _on_success; ///< Success callback
+    CB_ERROR                       _on_error;   ///< Error callback
+    CopyReader                     _reader;     ///< Decoder of binary tuples
+    std::size_t                    _rows{0};    ///< Rows reported by the server
+    std::optional<error::db_error> _copy_error; ///< Error raised while exporting
+
+    /**
+     * @brief Completes the command once the copy is done
+     */
+    void
+    on_complete() {
+        if (_copy_error) {
+            on_failure(*_copy_error);
+            return;
+        }
+        try {
+            if constexpr (std::is_invocable_v<CB_SUCCESS, Transaction &, std::size_t>)
+                _on_success(*this, _rows);
+            else
+                _on_success(*this);
+        } catch (std::exception const &e) {
+            on_failure((error::db_error) error::client_error{e.what()});
+        }
+    }
+
+    /**
+     * @brief Reports an error and propagates the failure to the parent
+     *
+     * @param err Error information
+     */
+    void
+    on_failure(error::db_error const &err) {
+        _result = false;
+        _on_error(err);
+        if (_parent)
+            _parent->on_sub_command_status(false);
+    }
+
+public:
+    /**
+     * @brief Constructs a CopyOut command
+     *
+     * @param parent Parent transaction
+     * @param expr COPY ... TO STDOUT statement
+     * @param sink Callback receiving the exported data
+     * @param on_success Callback invoked once the export is complete
+     * @param on_error Callback for copy errors
+     */
+    CopyOut(Transaction *parent, std::string &&expr, CB_SINK &&sink,
+            CB_SUCCESS &&on_success, CB_ERROR &&on_error)
+        : Transaction(parent)
+        , _sink(std::forward<CB_SINK>(sink))
+        , _on_success(std::forward<CB_SUCCESS>(on_success))
+        , _on_error(std::forward<CB_ERROR>(on_error)) {
+        push_query(std::unique_ptr<ISqlQuery>(
+            new CopyQuery(std::move(expr), [this]() { on_complete(); },
+                          [this](auto const &err) { on_failure(err); })));
+    }
+
+    /**
+     * @brief Checks that typed sinks receive binary COPY data
+     *
+     * @param binary True for binary COPY data
+     */
+    void
+    on_new_copy_response(bool binary) final {
+        if (typed && !binary)
+            _copy_error = error::client_error{"copy_out with rows requires FORMAT binary"};
+    }
+
+    /**
+     * @brief Hands one CopyData message to the sink
+     *
+     * @param data Message payload
+     */
+    void
+    on_new_copy_data(std::string_view data) final {
+        if (_copy_error)
+            return;
+        try {
+            if constexpr (typed)
+                _reader.read(data, _sink);
+            else
+                _sink(data);
+        } catch (std::exception const &e) {
+            _copy_error = error::client_error{e.what()};
+        }
+    }
+
+    /**
+     * @brief Stores the number of rows copied
      *
-     * @param data Row data
+     * @param command_tag Command tag ("COPY n")
      */
     void
-    on_new_data_row(row_data &&data) final {
-        _results.rows().push_back(std::move(data));
+    on_new_command_complete(std::string_view command_tag) final {
+        _rows = command_tag_rows(command_tag);
     }
 };
 
 } // namespace qb::pg::detail
 
-#include "./transaction.inl"
\ No newline at end of file
+#include "./transaction.inl"
+#include "./coroutine.h"
@@ -0,0 +1,322 @@
+/**
+ * @file copy.cpp
+ * @brief Implementation of PostgreSQL COPY data encoding
+ *
+ * This file implements the non-template parts of CopyWriter (raw writes,
+ * text escaping, binary COPY header and trailer) and the binary COPY tuple
+ * decoding of CopyReader.
+ *
+ * @see copy.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <qb/system/endian.h>
+
+#include "./copy.h"
+
+namespace qb::pg::detail {
+
+namespace {
+
+/// Signature, flags and header extension length of a binary COPY stream
+constexpr std::string_view binary_copy_header{"PGCOPY\n\377\r\n\0"
+                                              "\0\0\0\0"
+                                              "\0\0\0\0",
+                                              19};
+
+/// Field count of -1 terminating a binary COPY stream
+constexpr std::string_view binary_copy_trailer{"\377\377", 2};
+
+/// Size of the signature of a binary COPY stream
+constexpr std::size_t binary_copy_signature_size = 11;
+
+/**
+ * @brief Reads a big-endian integer and advances the view
+ *
+ * @tparam T Integer type
+ * @param data View to read from
+ * @param value Decoded value
+ * @return bool False if the view is too short
+ */
+template <typename T>
+bool
+read_big_endian(std::string_view &data, T &value) {
+    if (data.size() < sizeof(T))
+        return false;
+    std::memcpy(&value, data.data(), sizeof(T));
+    value = qb::endian::from_big_endian(value);
+    data.remove_prefix(sizeof(T));
+    return true;
+}
+
+/**
+ * @brief Word, quoted value or punctuation of a COPY statement
+ */
+struct Token {
+    std::string_view text;         ///< Token, without its quotes
+    bool             quoted{false}; ///< Quoted literal or identifier
+};
+
+/**
+ * @brief Reads the next token of a statement, skipping spaces and comments
+ *
+ * @param sql Statement
+ * @param pos Position in the statement, advanced past the token
+ * @return Token Next token, empty at the end of the statement
+ */
+Token
+next_token(std::string_view sql, std::size_t &pos) {
+    while (pos < sql.size()) {
+        const char c = sql[pos];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++pos;
+        } else if (c == '-' && pos + 1 < sql.size() && sql[pos + 1] == '-') {
+            while (pos < sql.size() && sql[pos] != '\n')
+                ++pos;
+        } else if (c == '/' && pos + 1 < sql.size() && sql[pos + 1] == '*') {
+            const auto end = sql.find("*/", pos + 2);
+            pos            = end == std::string_view::npos ? sql.size() : end + 2;
+        } else if (c == '\'' || c == '"') {
+            // Quotes escaped by doubling are kept in the token
+            const auto start = ++pos;
+            for (; pos < sql.size(); ++pos) {
+                if (sql[pos] == c) {
+                    if (pos + 1 < sql.size() && sql[pos + 1] == c)
+                        ++pos;
+                    else
+                        break;
+                }
+            }
+            const auto end = std::min(pos, sql.size());
+            ++pos;
+            return {sql.substr(start, end - start), true};
+        } else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+            const auto start = pos;
+            while (pos < sql.size() &&
+                   (std::isalnum(static_cast<unsigned char>(sql[pos])) || sql[pos] == '_'))
+                ++pos;
+            return {sql.substr(start, pos - start)};
+        } else {
+            return {sql.substr(pos++, 1)};
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Compares a token to an upper-case keyword, ignoring case
+ */
+bool
+is_keyword(std::string_view token, std::string_view keyword) noexcept {
+    if (token.size() != keyword.size())
+        return false;
+    for (std::size_t i = 0; i < token.size(); ++i)
+        if (std::toupper(static_cast<unsigned char>(token[i])) != keyword[i])
+            return false;
+    return true;
+}
+
+} // namespace
+
+void
+CopyWriter::options(std::string_view statement) {
+    _csv    = false;
+    _custom = false;
+    // Options follow STDIN, and come before an optional WHERE clause
+    std::size_t pos    = 0;
+    bool        options = false;
+    bool        format  = false;
+    bool        negate  = false;
+    for (auto token = next_token(statement, pos); !token.text.empty();
+         token      = next_token(statement, pos)) {
+        if (!options) {
+            options = !token.quoted && is_keyword(token.text, "STDIN");
+            continue;
+        }
+        if (format) {
+            _csv   = is_keyword(token.text, "CSV");
+            format = false;
+        } else if (token.quoted) {
+            // Value of an option
+        } else if (is_keyword(token.text, "WHERE")) {
+            break;
+        } else if (is_keyword(token.text, "FORMAT")) {
+            format = true;
+        } else if (is_keyword(token.text, "CSV")) {
+            _csv = true;
+        } else if (is_keyword(token.text, "DELIMITER") || is_keyword(token.text, "QUOTE") ||
+                   is_keyword(token.text, "ESCAPE") ||
+                   (is_keyword(token.text, "NULL") && !negate)) {
+            // FORCE NOT NULL names columns, it does not change the encoding
+            _custom = true;
+        }
+        negate = !token.quoted && is_keyword(token.text, "NOT");
+    }
+}
+
+bool
+CopyWriter::binary() const {
+    return _binary;
+}
+
+bool
+CopyWriter::csv() const {
+    return _csv;
+}
+
+std::size_t
+CopyWriter::rows() const {
+    return _rows;
+}
+
+CopyWriter &
+CopyWriter::write(std::string_view data) {
+    std::copy(data.begin(), data.end(), _out->output());
+    return *this;
+}
+
+void
+CopyWriter::write_text(std::string_view value) {
+    auto out = _out->output();
+    for (char c : value) {
+        switch (c) {
+            case '\\':
+                *out++ = '\\';
+                *out++ = '\\';
+                break;
+            case '\t':
+                *out++ = '\\';
+                *out++ = 't';
+                break;
+            case '\n':
+                *out++ = '\\';
+                *out++ = 'n';
+                break;
+            case '\r':
+                *out++ = '\\';
+                *out++ = 'r';
+                break;
+            default:
+                *out++ = c;
+        }
+    }
+}
+
+void
+CopyWriter::write_csv(std::string_view value) {
+    // The end-of-data marker and empty strings must be quoted as well
+    const bool quote = value.empty() || value == "\\." ||
+                       value.find_first_of(",\"\r\n") != std::string_view::npos;
+    if (!quote) {
+        write(value);
+        return;
+    }
+    auto out = _out->output();
+    *out++   = '"';
+    for (char c : value) {
+        if (c == '"')
+            *out++ = '"';
+        *out++ = c;
+    }
+    *out++ = '"';
+}
+
+void
+CopyWriter::attach(message &out, bool binary) {
+    _out    = &out;
+    _binary = binary;
+    if (_binary && !_started)
+        write(binary_copy_header);
+    _started = true;
+}
+
+void
+CopyWriter::finish() {
+    if (_binary)
+        write(binary_copy_trailer);
+}
+
+std::size_t
+CopyRow::size() const {
+    return _fields.size();
+}
+
+bool
+CopyRow::is_null(std::size_t index) const {
+    return !_fields.at(index);
+}
+
+std::string_view
+CopyRow::view(std::size_t index) const {
+    auto const &field = _fields.at(index);
+    return field ? *field : std::string_view{};
+}
+
+bool
+CopyReader::done() const {
+    return _done;
+}
+
+bool
+CopyReader::next(std::string_view &data) {
+    if (_done || data.empty())
+        return false;
+
+    if (!_header) {
+        if (data.substr(0, binary_copy_signature_size) !=
+            binary_copy_header.substr(0, binary_copy_signature_size))
+            throw error::client_error{"malformed binary COPY header"};
+        data.remove_prefix(binary_copy_signature_size);
+
+        integer flags(0), extension(0);
+        if (!read_big_endian(data, flags) || !read_big_endian(data, extension) ||
+            extension < 0 || data.size() < static_cast<std::size_t>(extension))
+            throw error::client_error{"malformed binary COPY header"};
+        data.remove_prefix(static_cast<std::size_t>(extension));
+        _header = true;
+        if (data.empty())
+            return false;
+    }
+
+    smallint count(0);
+    if (!read_big_endian(data, count))
+        throw error::client_error{"malformed binary COPY tuple"};
+    if (count == -1) {
+        _done = true;
+        return false;
+    }
+
+    _row._fields.clear();
+    for (smallint i = 0; i < count; ++i) {
+        integer length(0);
+        if (!read_big_endian(data, length))
+            throw error::client_error{"malformed binary COPY tuple"};
+        if (length < 0) {
+            _row._fields.emplace_back();
+            continue;
+        }
+        if (data.size() < static_cast<std::size_t>(length))
+            throw error::client_error{"malformed binary COPY tuple"};
+        _row._fields.emplace_back(data.substr(0, static_cast<std::size_t>(length)));
+        data.remove_prefix(static_cast<std::size_t>(length));
+    }
+    return true;
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,391 @@
+/**
+ * @file copy.h
+ * @brief PostgreSQL COPY data encoding
+ *
+ * This file defines the helpers used to stream data through the COPY
+ * sub-protocol:
+ *
+ * - CopyWriter: encodes rows into CopyData messages for COPY FROM STDIN,
+ *   in text format or in binary format through ParamSerializer
+ * - CopyRow / CopyReader: decode binary COPY TO STDOUT tuples in place,
+ *   through the TypeConverter binary decoders
+ *
+ * @see qb::pg::detail::Transaction::copy_in
+ * @see qb::pg::detail::Transaction::copy_out
+ * @see https://www.postgresql.org/docs/current/sql-copy.html
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./error.h"
+#include "./protocol.h"
+#include "./protocol_io_traits.h"
+#include "./queries.h"
+#include "./type_converter.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Encoder of COPY FROM STDIN data
+ *
+ * Handed to the producer of Transaction::copy_in(). Everything written
+ * during one producer call is sent as a single CopyData message.
+ *
+ * - write() appends raw bytes, for pre-formatted data
+ * - row() encodes one row in the format of the statement: tab separated
+ *   text, comma separated CSV, or binary tuples encoded with ParamSerializer
+ *
+ * In binary format the file header and trailer are written automatically.
+ */
+class CopyWriter {
+    message    *_out{nullptr};  ///< CopyData message being filled
+    bool        _binary{false}; ///< Server expects binary COPY data
+    bool        _csv{false};    ///< The statement announces FORMAT csv
+    bool        _custom{false}; ///< CSV with a DELIMITER, QUOTE, ESCAPE or NULL option
+    bool        _started{false}; ///< Binary header already written
+    std::size_t _rows{0};       ///< Number of rows written with row()
+
+    /**
+     * @brief Appends a text field, escaping COPY special characters
+     *
+     * @param value Field value
+     */
+    void write_text(std::string_view value);
+
+    /**
+     * @brief Appends a CSV field, quoted when needed
+     *
+     * Values containing a comma, a quote or a line break are quoted, as are
+     * empty strings, which would read as NULL otherwise.
+     *
+     * @param value Field value
+     */
+    void write_csv(std::string_view value);
+
+    /**
+     * @brief Appends the NULL marker of the text format
+     */
+    void
+    write_null() {
+        if (!_csv)
+            write("\\N");
+    }
+
+    /**
+     * @brief Appends one value of a text row
+     *
+     * @tparam T Value type
+     * @param value Field value
+     */
+    template <typename T>
+    void
+    write_text_field(T const &value) {
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            write_null();
+        } else if constexpr (std::is_same_v<T, bool>) {
+            write(value ? "t" : "f");
+        } else if constexpr (std::is_integral_v<T>) {
+            write(std::to_string(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            char      buffer[32];
+            const int size = std::snprintf(buffer, sizeof(buffer), "%.17g",
+                                           static_cast<double>(value));
+            write(std::string_view(buffer, static_cast<std::size_t>(size)));
+        } else if constexpr (std::is_convertible_v<T const &, std::string_view>) {
+            if (_csv)
+                write_csv(std::string_view(value));
+            else
+                write_text(std::string_view(value));
+        } else {
+            static_assert(!sizeof(T), "Unsupported COPY text value type");
+        }
+    }
+
+    /**
+     * @brief Appends one value of a text row, NULL when empty
+     *
+     * @tparam T Value type
+     * @param value Optional field value
+     */
+    template <typename T>
+    void
+    write_text_field(std::optional<T> const &value) {
+        if (value)
+            write_text_field(*value);
+        else
+            write_null();
+    }
+
+    /**
+     * @brief Passes a value of a binary row to ParamSerializer
+     *
+     * C strings are forwarded as views, everything else (nullptr included) as is.
+     *
+     * @tparam T Value type
+     * @param value Field value
+     */
+    template <typename T>
+    static decltype(auto)
+    binary_value(T const &value) {
+        if constexpr (!std::is_same_v<T, std::nullptr_t> &&
+                      std::is_convertible_v<T const &, const char *>)
+            return std::string_view(value);
+        else
+            return (value);
+    }
+
+public:
+    /**
+     * @brief Reads the format of the rows from the COPY statement
+     *
+     * The server announces binary or textual data only, so the CSV format
+     * is read from the options of the statement: `(FORMAT csv)`, or the
+     * older `CSV` keyword.
+     *
+     * @param statement COPY ... FROM STDIN statement
+     */
+    void options(std::string_view statement);
+
+    /**
+     * @brief Checks if the server expects binary COPY data
+     *
+     * @return bool True for FORMAT binary, false for text and CSV
+     */
+    [[nodiscard]] bool binary() const;
+
+    /**
+     * @brief Checks if the statement announces CSV rows
+     *
+     * @return bool True for FORMAT csv
+     */
+    [[nodiscard]] bool csv() const;
+
+    /**
+     * @brief Gets the number of rows written with row()
+     *
+     * @return std::size_t Row count
+     */
+    [[nodiscard]] std::size_t rows() const;
+
+    /**
+     * @brief Appends raw bytes to the COPY stream
+     *
+     * @param data Bytes to send as is
+     * @return CopyWriter& Reference to this writer for chaining
+     */
+    CopyWriter &write(std::string_view data);
+
+    /**
+     * @brief Encodes one row in the COPY format of the statement
+     *
+     * Text rows are tab separated and newline terminated, CSV rows comma
+     * separated; nullptr and empty optionals are NULL. Binary rows use the
+     * binary encoding of query parameters, so their values must match the
+     * column types.
+     *
+     * CSV rows are encoded with the default delimiter, quote and NULL
+     * string only: with a DELIMITER, QUOTE, ESCAPE or NULL option, format
+     * the rows and send them with write().
+     *
+     * @tparam Args Value types
+     * @param values Field values, in column order
+     * @return CopyWriter& Reference to this writer for chaining
+     * @throws error::client_error for CSV with custom delimiter, quote, escape or NULL
+     */
+    template <typename... Args>
+    CopyWriter &
+    row(Args const &...values) {
+        if (_binary) {
+            // A binary tuple is a field count followed by length-prefixed values,
+            // which is exactly the layout of a serialized parameter set
+            QueryParams params(binary_value(values)...);
+            params.gather([this](std::string_view fragment) { write(fragment); });
+        } else {
+            if (_csv && _custom)
+                throw error::client_error{
+                    "COPY row() needs the default CSV options, use write()"};
+            bool first = true;
+            auto field = [this, &first](auto const &value) {
+                if (!first)
+                    write(_csv ? "," : "\t");
+                first = false;
+                write_text_field(value);
+            };
+            (field(values), ...);
+            write("\n");
+        }
+        ++_rows;
+        return *this;
+    }
+
+    /**
+     * @brief Attaches the writer to the next CopyData message
+     *
+     * Writes the binary header before the first chunk.
+     *
+     * @param out CopyData message to fill
+     * @param binary True if the server expects binary COPY data
+     */
+    void attach(message &out, bool binary);
+
+    /**
+     * @brief Terminates the COPY stream in the current message
+     *
+     * Writes the binary trailer if needed.
+     */
+    void finish();
+};
+
+/**
+ * @brief One tuple of a binary COPY TO STDOUT stream
+ *
+ * Fields are views into the CopyData message that carried the tuple, so a
+ * row is only valid during the row callback. Values are decoded on access
+ * with the TypeConverter binary decoders.
+ */
+class CopyRow {
+    friend class CopyReader;
+
+    std::vector<std::optional<std::string_view>> _fields; ///< Field values, empty for NULL
+
+public:
+    /**
+     * @brief Gets the number of fields in the row
+     *
+     * @return std::size_t Field count
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Checks if a field is NULL
+     *
+     * @param index Field index
+     * @return bool True if the field is NULL
+     * @throws std::out_of_range if the index is invalid
+     */
+    [[nodiscard]] bool is_null(std::size_t index) const;
+
+    /**
+     * @brief Gets the raw binary value of a field
+     *
+     * @param index Field index
+     * @return std::string_view Field bytes (empty for NULL)
+     * @throws std::out_of_range if the index is invalid
+     */
+    [[nodiscard]] std::string_view view(std::size_t index) const;
+
+    /**
+     * @brief Decodes a field
+     *
+     * @tparam T Requested type; std::optional<T> accepts NULL
+     * @param index Field index
+     * @return Decoded value
+     * @throws error::value_is_null if the field is NULL and T is not nullable
+     */
+    template <typename T>
+    std::decay_t<T>
+    as(std::size_t index) const {
+        using result_type = std::decay_t<T>;
+        auto const &field = _fields.at(index);
+        if constexpr (io::traits::is_nullable<result_type>::value) {
+            result_type value;
+            if (!field)
+                io::traits::nullable_traits<result_type>::set_null(value);
+            else
+                value = TypeConverter<typename result_type::value_type>::from_binary(*field);
+            return value;
+        } else {
+            if (!field)
+                throw error::value_is_null("copy field " + std::to_string(index));
+            return TypeConverter<result_type>::from_binary(*field);
+        }
+    }
+
+    /**
+     * @brief Decodes the leading fields of the row into a tuple
+     *
+     * @tparam T Requested types, in column order
+     * @return std::tuple<T...> Decoded values
+     */
+    template <typename... T>
+    std::tuple<std::decay_t<T>...>
+    as_tuple() const {
+        return as_tuple<T...>(std::index_sequence_for<T...>{});
+    }
+
+private:
+    template <typename... T, std::size_t... I>
+    std::tuple<std::decay_t<T>...>
+    as_tuple(std::index_sequence<I...>) const {
+        return std::tuple<std::decay_t<T>...>(as<T>(I)...);
+    }
+};
+
+/**
+ * @brief Decoder of a binary COPY TO STDOUT stream
+ *
+ * Fed with the payload of every CopyData message, in order. The server
+ * sends one tuple per message, so rows are decoded in place without any
+ * buffering; the file header is skipped and the trailer ends the stream.
+ */
+class CopyReader {
+    CopyRow _row;           ///< Row decoded from the current message
+    bool    _header{false}; ///< File header already consumed
+    bool    _done{false};   ///< Trailer received
+
+    /**
+     * @brief Decodes the next tuple of a CopyData payload
+     *
+     * @param data Remaining payload, advanced past the tuple
+     * @return bool True if a row was decoded
+     * @throws error::client_error on malformed data
+     */
+    bool next(std::string_view &data);
+
+public:
+    /**
+     * @brief Decodes the tuples of one CopyData payload
+     *
+     * @tparam CB_ROW Type of row callback, void(CopyRow const &)
+     * @param data CopyData payload
+     * @param on_row Callback invoked for each tuple
+     */
+    template <typename CB_ROW>
+    void
+    read(std::string_view data, CB_ROW &&on_row) {
+        while (next(data))
+            on_row(static_cast<CopyRow const &>(_row));
+    }
+
+    /**
+     * @brief Checks if the trailer of the stream was received
+     *
+     * @return bool True once the stream is complete
+     */
+    [[nodiscard]] bool done() const;
+};
+
+} // namespace qb::pg::detail
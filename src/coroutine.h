@@ -0,0 +1,907 @@
+/**
+ * @file coroutine.h
+ * @brief C++20 coroutine interface over transactions
+ *
+ * Queries can be awaited from a coroutine instead of nesting callbacks:
+ *
+ * - Transaction::async_execute() and async_prepare() queue a command at once
+ *   and return an awaiter whose co_await yields a QueryResult
+ * - Task is an eagerly started coroutine type, awaitable from other tasks
+ * - CoTransaction runs a BEGIN / COMMIT block from a coroutine
+ *
+ * The coroutine is resumed from the completion callback of its query, on the
+ * connection thread, exactly where a callback would run. Command nodes are
+ * allocated from the NodePool freelists as usual; the result and the state
+ * of an await live in the coroutine frame.
+ *
+ * Only available when compiling as C++20 with <coroutine>; included by
+ * commands.h.
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Schedules the resumption of a coroutine on the next loop turn
+ *
+ * Used when a command is destroyed without running, while its owner tree is
+ * being released: resuming the coroutine there would let it queue commands
+ * on a tree being destroyed.
+ */
+inline void
+resume_later(std::coroutine_handle<> handle) {
+    if (handle)
+        qb::io::async::callback([handle]() { handle.resume(); });
+}
+
+/**
+ * @brief Outcome of an awaited query
+ *
+ * Holds the rows collected by the query, if it returns any, or its error.
+ */
+class QueryResult {
+    result_impl                    _results; ///< Collected rows
+    std::optional<error::db_error> _error;   ///< Error that failed the query
+
+public:
+    QueryResult() = default;
+
+    /**
+     * @brief Constructs the outcome of a failed query
+     */
+    explicit QueryResult(error::db_error error)
+        : _error(std::move(error)) {}
+
+    /**
+     * @brief Constructs the outcome of a completed query
+     *
+     * @param results Collected rows
+     * @param error Error that failed the query, if any
+     */
+    QueryResult(result_impl &&results, std::optional<error::db_error> error)
+        : _results(std::move(results))
+        , _error(std::move(error)) {}
+
+    /**
+     * @brief Checks that the query succeeded
+     */
+    [[nodiscard]] explicit
+    operator bool() const noexcept {
+        return !_error;
+    }
+
+    /**
+     * @brief Gets the collected rows, empty if the query failed
+     */
+    [[nodiscard]] resultset
+    results() noexcept {
+        return {&_results};
+    }
+
+    /**
+     * @brief Gets the error that failed the query, if any
+     */
+    [[nodiscard]] std::optional<error::db_error> const &
+    error() const noexcept {
+        return _error;
+    }
+};
+
+class QueryAwaiter;
+
+/**
+ * @brief Command completing a QueryAwaiter
+ *
+ * The awaiter and its command point to each other until the first one goes
+ * away; a command never run, e.g. discarded with a closed transaction,
+ * completes its awaiter with error::transaction_closed.
+ */
+class AwaitNode : public Transaction {
+    friend class QueryAwaiter;
+
+protected:
+    QueryAwaiter *_awaiter; ///< Awaiter to complete, null once detached
+    result_impl   _results; ///< Rows collected by the query
+
+    AwaitNode(Transaction *parent, QueryAwaiter *awaiter) noexcept
+        : Transaction(parent)
+        , _awaiter(awaiter)
+        , _results(memory_resource()) {}
+
+    /**
+     * @brief Completes the awaiter, resuming its coroutine
+     *
+     * Must be the last action of the command: the coroutine may queue new
+     * commands or release the awaiter before this returns.
+     *
+     * @param error Error that failed the query, if any
+     */
+    void finish(std::optional<error::db_error> error);
+
+public:
+    ~AwaitNode();
+};
+
+/**
+ * @brief Command executing an awaited query
+ *
+ * Runs a simple query or a prepared statement and collects its rows within
+ * the result limits of its transaction, like execute() with a result
+ * callback. A failure is only reported to the awaiter: it does not fail the
+ * parent transaction.
+ */
+class AwaitQuery final : public AwaitNode {
+    const PreparedRef _statement;        ///< Prepared statement, if any
+    const bool        _prepared{false};  ///< Executes the prepared statement
+    bool              _described{false}; ///< Row description is known
+    ResultBudget      _budget;           ///< Result limits of the query
+
+    /**
+     * @brief Sets the row description of the prepared statement, once
+     */
+    void
+    describe() {
+        if (!_described) {
+            // Prepared statements are described once, at prepare time
+            _results.row_description() =
+                _query_storage.get(_statement.resolve(_query_storage)).row_description;
+            _described = true;
+        }
+    }
+
+    void
+    on_complete() {
+        // The query completed before its cancellation
+        if (_budget.error())
+            return finish(_budget.error());
+        if (_prepared)
+            describe();
+        finish(std::nullopt);
+    }
+
+    void
+    on_failure(error::db_error const &err) {
+        _result = false;
+        finish(_budget.error() ? _budget.error() : err);
+    }
+
+public:
+    /**
+     * @brief Constructs an AwaitQuery command for a simple query
+     *
+     * @param parent Parent transaction
+     * @param awaiter Awaiter to complete
+     * @param expr SQL expression to execute
+     */
+    AwaitQuery(Transaction *parent, QueryAwaiter *awaiter, std::string &&expr)
+        : AwaitNode(parent, awaiter) {
+        push_query(make_simple_query(
+            _query_storage, std::move(expr), [this]() { on_complete(); },
+            [this](auto const &err) { on_failure(err); }));
+    }
+
+    /**
+     * @brief Constructs an AwaitQuery command for a prepared query
+     *
+     * @param parent Parent transaction
+     * @param awaiter Awaiter to complete
+     * @param query_name Name of the prepared query
+     * @param params Parameter values for the query
+     */
+    AwaitQuery(Transaction *parent, QueryAwaiter *awaiter, std::string const &query_name,
+               QueryParams &&params)
+        : AwaitNode(parent, awaiter)
+        , _statement(query_name)
+        , _prepared(true) {
+        push_query(std::unique_ptr<ISqlQuery>(new ExecuteQuery(
+            _query_storage, _statement, std::move(params), [this]() { on_complete(); },
+            [this](auto const &err) { on_failure(err); })));
+    }
+
+    void
+    on_new_row_description(row_description_type &&desc) final {
+        _results.row_description() = std::move(desc);
+        _described                 = true;
+    }
+
+    bool
+    on_new_data_row(message_view &msg) final {
+        describe();
+        return _budget.append_row(*this, _results, msg);
+    }
+};
+
+/**
+ * @brief Command preparing a statement for an awaiter
+ */
+class AwaitPrepare final : public AwaitNode {
+    PreparedQuery _query; ///< Query to prepare
+
+public:
+    /**
+     * @brief Constructs an AwaitPrepare command
+     *
+     * @param parent Parent transaction
+     * @param awaiter Awaiter to complete
+     * @param query Prepared query definition
+     */
+    AwaitPrepare(Transaction *parent, QueryAwaiter *awaiter, PreparedQuery &&query)
+        : AwaitNode(parent, awaiter)
+        , _query(std::move(query)) {
+        push_query(std::unique_ptr<ISqlQuery>(new ParseQuery(
+            _query,
+            [this]() {
+                try {
+                    _query_storage.push(std::move(_query));
+                } catch (std::exception const &e) {
+                    _result = false;
+                    return finish(error::client_error{e.what()});
+                }
+                finish(std::nullopt);
+            },
+            [this](auto const &err) { finish(err); })));
+    }
+
+    void
+    on_new_row_description(row_description_type &&desc) final {
+        _query.row_description = std::move(desc);
+    }
+};
+
+/**
+ * @brief Awaiter of a single query
+ *
+ * The query is queued when the awaiter is constructed, so queries created
+ * before being awaited are pipelined. The awaiter can neither be copied nor
+ * moved: keep it in the coroutine frame until it is awaited, e.g.
+ *
+ * ```cpp
+ * auto a = db.async_execute("SELECT 1");
+ * auto b = db.async_execute("SELECT 2"); // sent without waiting for a
+ * auto ra = co_await a;
+ * auto rb = co_await b;
+ * ```
+ */
+class QueryAwaiter {
+    friend class AwaitNode;
+
+    AwaitNode                 *_node{nullptr}; ///< Command running the query
+    std::optional<QueryResult> _outcome;       ///< Outcome, once known
+    std::coroutine_handle<>    _handle;        ///< Coroutine awaiting the outcome
+    bool                      *_failed{nullptr}; ///< Flag raised on error, if any
+
+    /**
+     * @brief Stores the outcome and resumes the awaiting coroutine
+     */
+    void
+    complete(QueryResult &&outcome, bool deferred) {
+        _node = nullptr;
+        if (_failed && !outcome)
+            *_failed = true;
+        _outcome.emplace(std::move(outcome));
+        auto handle = std::exchange(_handle, {});
+        if (deferred)
+            resume_later(handle);
+        else if (handle)
+            handle.resume();
+    }
+
+public:
+    /**
+     * @brief Constructs an awaiter already holding its outcome
+     */
+    explicit QueryAwaiter(QueryResult &&outcome) noexcept
+        : _outcome(std::move(outcome)) {}
+
+    /**
+     * @brief Queues a simple query on a transaction
+     *
+     * @param target Transaction running the query
+     * @param expr SQL expression to execute
+     * @param failed Flag raised if the query fails, if any
+     */
+    QueryAwaiter(Transaction &target, std::string &&expr, bool *failed = nullptr)
+        : _failed(failed) {
+        auto node = new AwaitQuery(&target, this, std::move(expr));
+        _node     = node;
+        target.push_transaction(std::unique_ptr<Transaction>(node));
+    }
+
+    /**
+     * @brief Queues the execution of a prepared query on a transaction
+     *
+     * @param target Transaction running the query
+     * @param query_name Name of the prepared query
+     * @param params Parameter values for the query
+     * @param failed Flag raised if the query fails, if any
+     */
+    QueryAwaiter(Transaction &target, std::string const &query_name, QueryParams &&params,
+                 bool *failed = nullptr)
+        : _failed(failed) {
+        auto node = new AwaitQuery(&target, this, query_name, std::move(params));
+        _node     = node;
+        target.push_transaction(std::unique_ptr<Transaction>(node));
+    }
+
+    /**
+     * @brief Queues the preparation of a statement on a transaction
+     *
+     * @param target Transaction preparing the statement
+     * @param query Prepared query definition, its name already reserved
+     */
+    QueryAwaiter(Transaction &target, PreparedQuery &&query) {
+        auto node = new AwaitPrepare(&target, this, std::move(query));
+        _node     = node;
+        target.push_transaction(std::unique_ptr<Transaction>(node));
+    }
+
+    QueryAwaiter(QueryAwaiter const &)            = delete;
+    QueryAwaiter &operator=(QueryAwaiter const &) = delete;
+
+    ~QueryAwaiter() {
+        if (_node)
+            _node->_awaiter = nullptr;
+    }
+
+    [[nodiscard]] bool
+    await_ready() const noexcept {
+        return _outcome.has_value();
+    }
+
+    void
+    await_suspend(std::coroutine_handle<> handle) noexcept {
+        _handle = handle;
+    }
+
+    QueryResult
+    await_resume() {
+        return std::move(*_outcome);
+    }
+};
+
+inline void
+AwaitNode::finish(std::optional<error::db_error> error) {
+    if (auto awaiter = std::exchange(_awaiter, nullptr))
+        awaiter->complete(QueryResult(std::move(_results), std::move(error)), false);
+}
+
+inline AwaitNode::~AwaitNode() {
+    if (auto awaiter = std::exchange(_awaiter, nullptr))
+        awaiter->complete(QueryResult(error::transaction_closed()), true);
+}
+
+inline QueryAwaiter
+Transaction::async_execute(std::string_view expr) {
+    return QueryAwaiter(*this, std::string(expr));
+}
+
+inline QueryAwaiter
+Transaction::async_execute(std::string_view query_name, QueryParams &&params) {
+    return QueryAwaiter(*this, std::string(query_name), std::move(params));
+}
+
+inline QueryAwaiter
+Transaction::async_prepare(std::string_view query_name, std::string_view expr,
+                           type_oid_sequence &&types) {
+    // Reserve the slot now so handles can be taken before the Parse completes
+    _query_storage.reserve(query_name);
+    return QueryAwaiter(*this, PreparedQuery{std::string(query_name), std::string(expr),
+                                             std::move(types), {}});
+}
+
+template <typename T>
+class Task;
+
+/**
+ * @brief Promise state shared by every Task
+ */
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;    ///< Coroutine awaiting the task
+    std::exception_ptr      exception;       ///< Exception escaping the task
+    bool                    detached{false}; ///< The Task object is gone
+
+    /**
+     * @brief Resumes the awaiting coroutine, or releases a detached task
+     */
+    struct FinalAwaiter {
+        [[nodiscard]] bool
+        await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto &promise = handle.promise();
+            if (promise.continuation)
+                return promise.continuation;
+            if (promise.detached)
+                handle.destroy();
+            return std::noop_coroutine();
+        }
+
+        void
+        await_resume() const noexcept {}
+    };
+
+    std::suspend_never
+    initial_suspend() const noexcept {
+        return {};
+    }
+
+    FinalAwaiter
+    final_suspend() const noexcept {
+        return {};
+    }
+
+    void
+    unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value; ///< Value returned by the task
+
+    Task<T> get_return_object() noexcept;
+
+    template <typename U = T>
+    void
+    return_value(U &&result) {
+        value.emplace(std::forward<U>(result));
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void
+    return_void() const noexcept {}
+};
+
+/**
+ * @brief Coroutine running queries on the connection thread
+ *
+ * A task starts at once and runs until its first suspension; it can be
+ * awaited from another task, which yields its value or rethrows its
+ * exception. Destroying an unfinished Task detaches it: the coroutine keeps
+ * running and releases itself when it ends, dropping its value and any
+ * exception.
+ *
+ * ```cpp
+ * qb::pg::task<int> count(qb::pg::tcp::database &db) {
+ *     auto result = co_await db.async_execute("SELECT count(*) FROM users");
+ *     if (!result)
+ *         co_return -1;
+ *     co_return result.results()[0][0].as<int>();
+ * }
+ * ```
+ *
+ * @tparam T Type of the value returned by the coroutine
+ */
+template <typename T = void>
+class Task {
+public:
+    using promise_type = TaskPromise<T>;
+
+private:
+    std::coroutine_handle<promise_type> _handle;
+
+public:
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : _handle(handle) {}
+
+    Task(Task &&other) noexcept
+        : _handle(std::exchange(other._handle, {})) {}
+
+    Task &
+    operator=(Task &&other) noexcept {
+        if (this != &other) {
+            release();
+            _handle = std::exchange(other._handle, {});
+        }
+        return *this;
+    }
+
+    Task(Task const &)            = delete;
+    Task &operator=(Task const &) = delete;
+
+    ~Task() {
+        release();
+    }
+
+    /**
+     * @brief Checks whether the coroutine ended
+     */
+    [[nodiscard]] bool
+    done() const noexcept {
+        return !_handle || _handle.done();
+    }
+
+    /**
+     * @brief Gets the value of an ended task
+     *
+     * @return T Value returned by the coroutine
+     * @throws std::logic_error If the task did not end
+     * @throws Any exception escaping the coroutine
+     */
+    T
+    get() {
+        if (!_handle || !_handle.done())
+            throw std::logic_error("task is not done");
+        auto &promise = _handle.promise();
+        if (promise.exception)
+            std::rethrow_exception(promise.exception);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*promise.value);
+    }
+
+    [[nodiscard]] bool
+    await_ready() const noexcept {
+        return done();
+    }
+
+    void
+    await_suspend(std::coroutine_handle<> handle) noexcept {
+        _handle.promise().continuation = handle;
+    }
+
+    T
+    await_resume() {
+        return get();
+    }
+
+private:
+    void
+    release() noexcept {
+        if (!_handle)
+            return;
+        if (_handle.done())
+            _handle.destroy();
+        else
+            _handle.promise().detached = true;
+        _handle = {};
+    }
+};
+
+template <typename T>
+inline Task<T>
+TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void>
+TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+class CoTransaction;
+
+/**
+ * @brief End of a coroutine transaction block, sending COMMIT or ROLLBACK
+ */
+class CoEnd final : public Transaction {
+    friend class CoTransaction;
+
+    CoTransaction *_owner;            ///< Owner, null once detached
+    bool           _commit{false};    ///< COMMIT was sent
+
+    void on_done(std::optional<error::db_error> error);
+
+public:
+    CoEnd(Transaction *parent, CoTransaction *owner) noexcept
+        : Transaction(parent)
+        , _owner(owner) {}
+
+    ~CoEnd();
+
+    [[nodiscard]] bool
+    closes_block() const noexcept final {
+        return true;
+    }
+
+    /**
+     * @brief Queues the end of the block
+     *
+     * @param commit True to commit, false to roll back
+     */
+    void
+    close(bool commit) {
+        _commit = commit;
+        push_query(commit ? std::unique_ptr<ISqlQuery>(new CommitQuery(
+                                [this]() { on_done(std::nullopt); },
+                                [this](auto const &err) { on_done(err); }))
+                          : std::unique_ptr<ISqlQuery>(new RollbackQuery(
+                                [this]() { on_done(std::nullopt); },
+                                [this](auto const &err) { on_done(err); })));
+    }
+};
+
+/**
+ * @brief Coroutine transaction block, running BEGIN and holding the steps
+ *
+ * Closes when no step is queued, which ends the block with COMMIT if the
+ * coroutine asked for it and every statement succeeded, ROLLBACK otherwise.
+ */
+class CoBlock final : public Transaction {
+    friend class CoTransaction;
+
+    CoTransaction *_owner; ///< Owner, null once detached
+    CoEnd         *_end;   ///< End of the block
+
+    void on_begin(std::optional<error::db_error> error);
+
+public:
+    CoBlock(Transaction *parent, CoTransaction *owner, CoEnd *end, transaction_mode mode)
+        : Transaction(parent)
+        , _owner(owner)
+        , _end(end) {
+        push_query(std::unique_ptr<ISqlQuery>(
+            new BeginQuery(mode, [this]() { on_begin(std::nullopt); },
+                           [this](auto const &err) { on_begin(err); })));
+    }
+
+    ~CoBlock();
+
+    void
+    on_sub_command_status(bool status) final {
+        _result &= status;
+    }
+};
+
+/**
+ * @brief Transaction block driven by a coroutine
+ *
+ * Lives in the coroutine frame; each step is awaited and yields a QueryResult:
+ *
+ * ```cpp
+ * qb::pg::task<> transfer(qb::pg::tcp::database &db) {
+ *     qb::pg::co_transaction tx(db);
+ *     if (!co_await tx.begin())
+ *         co_return;
+ *     co_await tx.execute("UPDATE accounts SET balance = balance - 10 WHERE id = 1");
+ *     co_await tx.execute("UPDATE accounts SET balance = balance + 10 WHERE id = 2");
+ *     if (auto done = co_await tx.commit(); !done)
+ *         std::cerr << done.error()->what() << std::endl;
+ * }
+ * ```
+ *
+ * The block stays open while a step is queued: steps must be awaited one
+ * after the other, without awaiting anything else in between, or the block
+ * rolls back. commit() rolls back and fails if a statement of the block
+ * failed. Destroying the CoTransaction with the block open rolls it back.
+ */
+class CoTransaction {
+    friend class CoBlock;
+    friend class CoEnd;
+
+    Transaction               &_target;          ///< Transaction running the block
+    CoBlock                   *_block{nullptr};  ///< Open block, if any
+    CoEnd                     *_end{nullptr};    ///< End of the block, until it completes
+    bool                       _begun{false};    ///< BEGIN succeeded
+    bool                       _commit{false};   ///< Commit was requested
+    bool                       _failed{false};   ///< A statement of the block failed
+    bool                       _pending{false};  ///< begin() or end awaited, not completed
+    std::optional<QueryResult> _outcome;         ///< Outcome of begin() or of the end
+    std::coroutine_handle<>    _handle;          ///< Coroutine awaiting the outcome
+
+    /**
+     * @brief Stores the outcome of begin() or of the end, resuming the coroutine
+     */
+    void
+    complete(QueryResult &&outcome, bool deferred) {
+        _pending = false;
+        _outcome.emplace(std::move(outcome));
+        auto handle = std::exchange(_handle, {});
+        if (deferred)
+            resume_later(handle);
+        else if (handle)
+            handle.resume();
+    }
+
+    /**
+     * @brief Requests the end of the block
+     */
+    bool
+    request_end(bool commit) {
+        if (!_end || _pending) {
+            _outcome.emplace(error::transaction_closed());
+            return false;
+        }
+        _commit  = commit;
+        _pending = true;
+        _outcome.reset();
+        return true;
+    }
+
+public:
+    /**
+     * @brief Awaiter of begin(), commit() and rollback()
+     */
+    class Awaiter {
+        CoTransaction &_tx;
+
+    public:
+        explicit Awaiter(CoTransaction &tx) noexcept
+            : _tx(tx) {}
+
+        [[nodiscard]] bool
+        await_ready() const noexcept {
+            return _tx._outcome.has_value();
+        }
+
+        void
+        await_suspend(std::coroutine_handle<> handle) noexcept {
+            _tx._handle = handle;
+        }
+
+        QueryResult
+        await_resume() {
+            auto outcome = std::move(*_tx._outcome);
+            _tx._outcome.reset();
+            return outcome;
+        }
+    };
+
+    /**
+     * @brief Constructs a block run by a transaction, usually the database
+     */
+    explicit CoTransaction(Transaction &target) noexcept
+        : _target(target) {}
+
+    CoTransaction(CoTransaction const &)            = delete;
+    CoTransaction &operator=(CoTransaction const &) = delete;
+
+    ~CoTransaction() {
+        if (_block)
+            _block->_owner = nullptr;
+        if (_end)
+            _end->_owner = nullptr;
+    }
+
+    /**
+     * @brief Sends BEGIN
+     *
+     * @param mode Transaction mode
+     * @return Awaiter yielding the outcome of BEGIN
+     */
+    [[nodiscard]] Awaiter
+    begin(transaction_mode mode = {}) {
+        if (_end || _pending) {
+            _outcome.emplace(error::query_error("already in transaction"));
+        } else if (_target.parent()) {
+            // Nested blocks use savepoints, as with Transaction::begin()
+            _outcome.emplace(error::query_error("already in transaction"));
+        } else {
+            _begun = _commit = _failed = false;
+            _pending = true;
+            _outcome.reset();
+            auto end = std::unique_ptr<CoEnd>(new CoEnd(&_target, this));
+            _block   = new CoBlock(&_target, this, end.get(), mode);
+            _end     = end.get();
+            _target.push_transaction(std::unique_ptr<Transaction>(_block));
+            _target.push_transaction(std::move(end));
+        }
+        return Awaiter(*this);
+    }
+
+    /**
+     * @brief Executes a simple query in the block
+     */
+    [[nodiscard]] QueryAwaiter
+    execute(std::string_view expr) {
+        if (!_block || !_begun)
+            return QueryAwaiter(QueryResult(error::transaction_closed()));
+        return QueryAwaiter(*_block, std::string(expr), &_failed);
+    }
+
+    /**
+     * @brief Executes a prepared query in the block
+     */
+    [[nodiscard]] QueryAwaiter
+    execute(std::string_view query_name, QueryParams &&params) {
+        if (!_block || !_begun)
+            return QueryAwaiter(QueryResult(error::transaction_closed()));
+        return QueryAwaiter(*_block, std::string(query_name), std::move(params), &_failed);
+    }
+
+    /**
+     * @brief Commits the block once the current step, if any, completed
+     *
+     * @return Awaiter yielding the outcome of COMMIT, or a query_error if the
+     * block rolled back instead
+     */
+    [[nodiscard]] Awaiter
+    commit() {
+        request_end(true);
+        return Awaiter(*this);
+    }
+
+    /**
+     * @brief Rolls the block back once the current step, if any, completed
+     */
+    [[nodiscard]] Awaiter
+    rollback() {
+        request_end(false);
+        return Awaiter(*this);
+    }
+
+    /**
+     * @brief Checks whether steps can be executed in the block
+     */
+    [[nodiscard]] bool
+    open() const noexcept {
+        return _block && _begun;
+    }
+};
+
+inline void
+CoBlock::on_begin(std::optional<error::db_error> error) {
+    if (!_owner)
+        return;
+    _owner->_begun = !error;
+    if (_owner->_pending)
+        _owner->complete(error ? QueryResult(*error) : QueryResult(), false);
+}
+
+inline CoBlock::~CoBlock() {
+    const bool commit = _result && _owner && _owner->_commit && !_owner->_failed;
+    if (auto owner = std::exchange(_owner, nullptr)) {
+        owner->_block = nullptr;
+        // BEGIN never ran
+        if (owner->_pending && !owner->_begun && !owner->_commit)
+            owner->complete(QueryResult(error::transaction_closed()), true);
+    }
+    _end->close(commit);
+}
+
+inline void
+CoEnd::on_done(std::optional<error::db_error> error) {
+    auto owner = std::exchange(_owner, nullptr);
+    if (!owner)
+        return;
+    owner->_end = nullptr;
+    if (!owner->_pending)
+        return;
+    if (!error && owner->_commit && !_commit)
+        error = error::query_error("rollback processed due to a query failure");
+    owner->complete(error ? QueryResult(*error) : QueryResult(), false);
+}
+
+inline CoEnd::~CoEnd() {
+    if (auto owner = std::exchange(_owner, nullptr)) {
+        owner->_end = nullptr;
+        if (owner->_pending)
+            owner->complete(QueryResult(error::transaction_closed()), true);
+    }
+}
+
+} // namespace qb::pg::detail
+
+#endif
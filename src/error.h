@@ -40,6 +40,8 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "./sqlstates.h"
 
@@ -271,6 +273,64 @@ public:
         : query_error("Transaction already closed") {}
 };
 
+/**
+ * @brief Error for a query cancelled because its deadline expired
+ *
+ * Reported to the error callback of a query still running when the
+ * query timeout of the connection or the time budget of its transaction
+ * expired. The query was cancelled on the server (SQL state 57014); the
+ * server message is kept as detail.
+ *
+ * Example handling:
+ * ```cpp
+ * db.query_timeout(std::chrono::milliseconds(50))
+ *     .execute("SELECT pg_sleep(1)", on_success, [](error::db_error const &e) {
+ *         if (dynamic_cast<error::query_timeout const *>(&e))
+ *             std::cerr << "Query took too long" << std::endl;
+ *     });
+ * ```
+ */
+class query_timeout : public query_error {
+public:
+    /**
+     * @brief Constructs a query timeout error
+     *
+     * @param detail Message of the server for the cancelled query
+     */
+    explicit query_timeout(std::string detail)
+        : query_error("query deadline exceeded", "ERROR", "57014", std::move(detail)) {}
+};
+
+/**
+ * @brief Error for a query whose result exceeded its limits
+ *
+ * Reported to the error callback of a query that kept more rows or bytes
+ * than allowed by its result limits (see Transaction::result_limits()). The
+ * rows already received were released and the query was cancelled on the
+ * server; the limit that was exceeded is kept as detail.
+ *
+ * Example handling:
+ * ```cpp
+ * qb::pg::result_limits limits;
+ * limits.max_rows = 100000;
+ * db.result_limits(limits)
+ *     .execute("SELECT * FROM events", on_success, [](error::db_error const &e) {
+ *         if (dynamic_cast<error::result_limit_exceeded const *>(&e))
+ *             std::cerr << "Result too large: " << e.detail << std::endl;
+ *     });
+ * ```
+ */
+class result_limit_exceeded : public query_error {
+public:
+    /**
+     * @brief Constructs a result limit error
+     *
+     * @param detail Description of the exceeded limit
+     */
+    explicit result_limit_exceeded(std::string detail)
+        : query_error("result limit exceeded", "ERROR", "54000", std::move(detail)) {}
+};
+
 /**
  * @brief Exception caught in a callback function
  *
@@ -0,0 +1,147 @@
+/**
+ * @file external_param.h
+ * @brief Query parameters referencing caller-owned memory
+ *
+ * A bytea or text parameter is normally copied into the serialized
+ * parameters of its query, then into the output pipe when the query is
+ * sent. An ExternalParam only references its value:
+ *
+ * - the serialized parameters keep its length prefix, not its bytes
+ * - the Bind message is gathered from the serialized fragments and the
+ *   referenced values, which are copied once, into the output pipe
+ * - the value is either shared (kept alive by the parameter set) or
+ *   borrowed (the caller keeps it alive until the query callback runs)
+ *
+ * @see qb::pg::detail::QueryParams::gather
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+#include "./pg_types.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief bytea or text parameter whose value is not copied by the serializer
+ */
+class ExternalParam {
+    std::shared_ptr<const void> _owner; ///< Keeps a shared value alive, empty when borrowed
+    std::string_view            _data;  ///< Referenced value
+    integer                     _oid;   ///< bytea or text
+
+    ExternalParam(std::shared_ptr<const void> owner, std::string_view data, integer type)
+        : _owner(std::move(owner))
+        , _data(data)
+        , _oid(type) {
+        if (data.size() > static_cast<std::size_t>(std::numeric_limits<integer>::max()))
+            throw std::invalid_argument("external parameter larger than 2 GB");
+    }
+
+    template <typename Buffer>
+    static std::string_view
+    view(Buffer const &buffer) noexcept {
+        return std::string_view(reinterpret_cast<const byte *>(buffer.data()), buffer.size());
+    }
+
+public:
+    /**
+     * @brief References a bytea value kept alive by the caller
+     *
+     * @param data Value, valid until the callback of the query runs
+     * @param size Size of the value in bytes
+     */
+    static ExternalParam
+    bytea(const void *data, std::size_t size) {
+        return {nullptr, std::string_view(static_cast<const byte *>(data), size), 17};
+    }
+
+    /**
+     * @brief References a shared bytea value
+     *
+     * @tparam Buffer Contiguous container of bytes (std::vector, std::string...)
+     * @param buffer Value, kept alive by the parameter set
+     */
+    template <typename Buffer>
+    static ExternalParam
+    bytea(std::shared_ptr<Buffer> buffer) {
+        auto data = view(*buffer);
+        return {std::move(buffer), data, 17};
+    }
+
+    /**
+     * @brief References a text value kept alive by the caller
+     *
+     * @param data Value, valid until the callback of the query runs
+     */
+    static ExternalParam
+    text(std::string_view data) {
+        return {nullptr, data, 25};
+    }
+
+    /**
+     * @brief References a shared text value
+     *
+     * @tparam Buffer Contiguous container of characters (std::string...)
+     * @param buffer Value, kept alive by the parameter set
+     */
+    template <typename Buffer>
+    static ExternalParam
+    text(std::shared_ptr<Buffer> buffer) {
+        auto data = view(*buffer);
+        return {std::move(buffer), data, 25};
+    }
+
+    /**
+     * @brief Gets the referenced value
+     */
+    [[nodiscard]] std::string_view
+    data() const noexcept {
+        return _data;
+    }
+
+    /**
+     * @brief Gets the OID of the parameter
+     */
+    [[nodiscard]] integer
+    oid() const noexcept {
+        return _oid;
+    }
+
+    /**
+     * @brief Checks if the value is kept alive by the parameter
+     */
+    [[nodiscard]] bool
+    shared() const noexcept {
+        return static_cast<bool>(_owner);
+    }
+};
+
+/**
+ * @brief External parameter placed in a serialized parameter set
+ */
+struct ExternalSlice {
+    std::size_t   offset; ///< Position of the value in the serialized parameters
+    ExternalParam value;  ///< Referenced value
+};
+
+} // namespace qb::pg::detail
@@ -25,6 +25,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include "./param_unserializer.h"
 #include "./pg_types.h"
@@ -56,7 +57,7 @@ public:
      */
     template <typename T>
     static bool
-    read_buffer(bool is_null, const std::vector<byte> &buffer, T &value) {
+    read_buffer(bool is_null, std::string_view buffer, T &value) {
         if (is_null) {
             // For optional types, we can handle NULL easily
             if constexpr (is_optional_v<T>) {
@@ -72,6 +73,21 @@ public:
         return read_value(buffer, value);
     }
 
+    /**
+     * @brief Reads an owned data buffer and converts it to a typed value
+     *
+     * @tparam T Target C++ type to read into
+     * @param is_null Indicates if the field is null
+     * @param buffer Buffer containing the binary field data
+     * @param value Reference to the value to be filled
+     * @return true if reading succeeded, false otherwise
+     */
+    template <typename T>
+    static bool
+    read_buffer(bool is_null, const std::vector<byte> &buffer, T &value) {
+        return read_buffer(is_null, ParamUnserializer::view(buffer), value);
+    }
+
 private:
     /// Deserializer used for reading data
     static ParamUnserializer unserializer;
@@ -110,7 +126,7 @@ private:
      */
     template <typename T>
     static bool
-    read_value(const std::vector<byte> &, T &) {
+    read_value(std::string_view, T &) {
         // Default implementation returns false for unsupported types
         return false;
     }
@@ -126,7 +142,7 @@ private:
      * @return true if reading succeeded
      */
     static bool
-    read_value(const std::vector<byte> &buffer, smallint &value) {
+    read_value(std::string_view buffer, smallint &value) {
         try {
             value = unserializer.read_smallint(buffer);
             return true;
@@ -146,7 +162,7 @@ private:
      * @return true if reading succeeded
      */
     static bool
-    read_value(const std::vector<byte> &buffer, integer &value) {
+    read_value(std::string_view buffer, integer &value) {
         try {
             value = unserializer.read_integer(buffer);
             return true;
@@ -166,7 +182,7 @@ private:
      * @return true if reading succeeded
      */
     static bool
-    read_value(const std::vector<byte> &buffer, bigint &value) {
+    read_value(std::string_view buffer, bigint &value) {
         try {
             value = unserializer.read_bigint(buffer);
             return true;
@@ -186,7 +202,7 @@ private:
      * @return true if reading succeeded
      */
     static bool
-    read_value(const std::vector<byte> &buffer, float &value) {
+    read_value(std::string_view buffer, float &value) {
         try {
             value = unserializer.read_float(buffer);
             return true;
@@ -206,7 +222,7 @@ private:
      * @return true if reading succeeded
      */
     static bool
-    read_value(const std::vector<byte> &buffer, double &value) {
+    read_value(std::string_view buffer, double &value) {
         try {
             value = unserializer.read_double(buffer);
             return true;
@@ -226,7 +242,7 @@ private:
      * @return true if reading succeeded
      */
     static bool
-    read_value(const std::vector<byte> &buffer, bool &value) {
+    read_value(std::string_view buffer, bool &value) {
         try {
             // For a boolean, we just have a single byte with 0 or 1
             if (buffer.size() >= 1) {
@@ -250,7 +266,7 @@ private:
      * @return true if reading succeeded
      */
     static bool
-    read_value(const std::vector<byte> &buffer, std::string &value) {
+    read_value(std::string_view buffer, std::string &value) {
         try {
             value = unserializer.read_string(buffer);
             return true;
@@ -272,7 +288,7 @@ private:
      */
     template <typename T>
     static bool
-    read_value(const std::vector<byte> &buffer, std::optional<T> &value) {
+    read_value(std::string_view buffer, std::optional<T> &value) {
         T temp_value;
         if (read_value(buffer, temp_value)) {
             value = std::move(temp_value);
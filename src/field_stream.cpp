@@ -0,0 +1,194 @@
+/**
+ * @file field_stream.cpp
+ * @brief Streaming of large field values out of DataRow messages
+ *
+ * @see field_stream.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <qb/system/endian.h>
+#include "./field_stream.h"
+
+namespace qb::pg::detail {
+
+namespace {
+
+/// Tag, length and column count of a DataRow message
+constexpr std::size_t row_header_size = sizeof(byte) + sizeof(integer) + sizeof(smallint);
+
+template <typename T>
+T
+read_be(const char *data) noexcept {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return qb::endian::from_big_endian(value);
+}
+
+void
+append_be(std::string &out, integer value) {
+    const auto nbo = qb::endian::to_big_endian(value);
+    out.append(reinterpret_cast<const char *>(&nbo), sizeof(nbo));
+}
+
+} // namespace
+
+bool
+FieldStream::streams(usmallint column) const noexcept {
+    return std::find(_columns.begin(), _columns.end(), column) != _columns.end();
+}
+
+void
+FieldStream::deliver(FieldChunk const &chunk) noexcept {
+    if (_failed)
+        return;
+    try {
+        _sink(chunk);
+    } catch (std::exception const &e) {
+        _failed = true;
+        _error  = e.what();
+    } catch (...) {
+        _failed = true;
+        _error  = "field stream sink failed";
+    }
+}
+
+void
+FieldStream::stop(std::string reason) {
+    if (_failed)
+        return;
+    _failed = true;
+    _error  = std::move(reason);
+}
+
+void
+DataRowStreamer::start(FieldStream &stream) {
+    _stream = &stream;
+    _state  = state::header;
+    _row.clear();
+}
+
+DataRowStreamer::status
+DataRowStreamer::next_column() {
+    ++_column;
+    if (_column < _columns) {
+        _state = state::length;
+        return status::incomplete;
+    }
+    return finish();
+}
+
+DataRowStreamer::status
+DataRowStreamer::finish() {
+    if (_left)
+        return fail();
+
+    // The reduced message is shorter than the original one
+    const auto nbo = qb::endian::to_big_endian(static_cast<integer>(_row.size() - 1));
+    std::memcpy(_row.data() + sizeof(byte), &nbo, sizeof(nbo));
+    _stream->next_row();
+    reset();
+    return status::complete;
+}
+
+DataRowStreamer::status
+DataRowStreamer::feed(const char *data, std::size_t size, std::size_t &consumed) {
+    consumed = 0;
+    if (!_stream)
+        return fail();
+
+    auto result = status::incomplete;
+    while (result == status::incomplete) {
+        const std::size_t available = size - consumed;
+        const char       *input     = data + consumed;
+        switch (_state) {
+            case state::header: {
+                if (available < row_header_size)
+                    return status::incomplete;
+                const auto length = read_be<integer>(input + sizeof(byte));
+                if (length < static_cast<integer>(row_header_size - sizeof(byte)))
+                    return fail();
+                _left    = static_cast<std::size_t>(length) - (row_header_size - sizeof(byte));
+                _columns = read_be<usmallint>(input + sizeof(byte) + sizeof(integer));
+                _column  = 0;
+                _row.append(input, row_header_size);
+                consumed += row_header_size;
+                if (!_columns) {
+                    result = finish();
+                    break;
+                }
+                _state = state::length;
+                break;
+            }
+            case state::length: {
+                if (available < sizeof(integer))
+                    return status::incomplete;
+                if (_left < sizeof(integer))
+                    return fail();
+                _size = read_be<integer>(input);
+                consumed += sizeof(integer);
+                _left -= sizeof(integer);
+                if (_size < 0) {
+                    append_be(_row, -1);
+                    result = next_column();
+                    break;
+                }
+                if (static_cast<std::size_t>(_size) > _left)
+                    return fail();
+                _offset = 0;
+                if (_stream->streams(_column)) {
+                    append_be(_row, 0);
+                    _state = state::streamed_value;
+                } else {
+                    append_be(_row, _size);
+                    _state = state::kept_value;
+                }
+                break;
+            }
+            case state::kept_value: {
+                const auto count = std::min(available, static_cast<std::size_t>(_size) - _offset);
+                _row.append(input, count);
+                consumed += count;
+                _offset += count;
+                _left -= count;
+                if (_offset < static_cast<std::size_t>(_size))
+                    return status::incomplete;
+                result = next_column();
+                break;
+            }
+            case state::streamed_value: {
+                const auto count = std::min(available, static_cast<std::size_t>(_size) - _offset);
+                const bool last  = _offset + count == static_cast<std::size_t>(_size);
+                if (!count && !last)
+                    return status::incomplete;
+                _stream->deliver(FieldChunk{_stream->rows(), _column, _size, _offset,
+                                            std::string_view(input, count), last});
+                consumed += count;
+                _offset += count;
+                _left -= count;
+                if (!last)
+                    return status::incomplete;
+                result = next_column();
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace qb::pg::detail
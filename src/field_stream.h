@@ -0,0 +1,234 @@
+/**
+ * @file field_stream.h
+ * @brief Streaming of large field values out of DataRow messages
+ *
+ * A DataRow message is normally framed only once it is fully buffered, so a
+ * 200 MB bytea value is held in the connection input buffer before it can be
+ * decoded. With a FieldStream attached to a streaming query:
+ *
+ * - the header and the other columns of each DataRow are parsed as usual and
+ *   handed to the row callback
+ * - the bytes of the designated columns are forwarded to a sink in chunks,
+ *   as soon as they arrive, directly from the input pipe
+ *
+ * Memory per connection is then bounded by the socket read size and the
+ * small columns, whatever the size of the streamed values.
+ *
+ * @see qb::pg::detail::Transaction::execute_stream
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./protocol.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Chunk of a streamed field value
+ */
+struct FieldChunk {
+    std::size_t      row;    ///< Index of the row in the result
+    usmallint        column; ///< Index of the column in the row
+    integer          size;   ///< Total size of the value
+    std::size_t      offset; ///< Offset of the chunk in the value
+    std::string_view data;   ///< Bytes of the chunk, only valid during the call
+    bool             last;   ///< True for the last chunk of the value
+};
+
+/**
+ * @brief Columns streamed to a sink instead of being kept in the row
+ *
+ * The sink receives the chunks of each non-NULL value of the designated
+ * columns, in order; an empty value is delivered as a single empty last
+ * chunk. All chunks of a row are delivered before the row callback, in which
+ * the streamed columns read as empty values. NULL values are left in the row
+ * and not delivered.
+ *
+ * If the sink throws, the next chunks are discarded and the query fails.
+ */
+class FieldStream {
+public:
+    using sink_type = std::function<void(FieldChunk const &)>;
+
+private:
+    std::vector<usmallint> _columns;     ///< Designated columns
+    sink_type              _sink;        ///< Destination of the chunks
+    std::size_t            _rows{0};     ///< Number of rows streamed so far
+    bool                   _failed{false}; ///< Delivery was stopped
+    std::string            _error;       ///< Reason of the failure
+
+public:
+    /**
+     * @brief Constructs a stream of the given columns
+     *
+     * @param columns Indexes of the streamed columns
+     * @param sink Callback receiving the chunks
+     */
+    FieldStream(std::vector<usmallint> columns, sink_type sink)
+        : _columns(std::move(columns))
+        , _sink(std::move(sink)) {}
+
+    /**
+     * @brief Checks whether a column is streamed
+     */
+    bool streams(usmallint column) const noexcept;
+
+    /**
+     * @brief Hands a chunk to the sink, unless delivery was stopped
+     *
+     * An exception thrown by the sink stops the delivery.
+     */
+    void deliver(FieldChunk const &chunk) noexcept;
+
+    /**
+     * @brief Stops the delivery of the next chunks
+     *
+     * @param reason Error reported for the query
+     */
+    void stop(std::string reason);
+
+    /**
+     * @brief Gets the index of the row being streamed
+     */
+    std::size_t
+    rows() const noexcept {
+        return _rows;
+    }
+
+    /**
+     * @brief Moves on to the next row
+     */
+    void
+    next_row() noexcept {
+        ++_rows;
+    }
+
+    bool
+    failed() const noexcept {
+        return _failed;
+    }
+
+    std::string const &
+    error() const noexcept {
+        return _error;
+    }
+};
+
+/**
+ * @brief Incremental reader of a DataRow message with streamed columns
+ *
+ * Fed with the bytes at the head of the connection input pipe, it copies the
+ * header and the kept columns into a reduced DataRow message, where streamed
+ * values are replaced by empty ones, and forwards the streamed values to the
+ * FieldStream. Incomplete length fields are left in the pipe until more
+ * bytes arrive.
+ */
+class DataRowStreamer {
+public:
+    /**
+     * @brief Outcome of feed()
+     */
+    enum class status {
+        incomplete, ///< All available bytes were used, the row needs more
+        complete,   ///< The reduced row is available through row()
+        error       ///< The message is malformed
+    };
+
+private:
+    enum class state { header, length, kept_value, streamed_value };
+
+    FieldStream *_stream{nullptr};   ///< Stream of the row, null when inactive
+    state        _state{state::header}; ///< Part of the message being read
+    std::string  _row;               ///< Reduced DataRow message
+    std::size_t  _left{0};           ///< Bytes of the message not read yet
+    usmallint    _columns{0};        ///< Number of columns of the row
+    usmallint    _column{0};         ///< Index of the column being read
+    integer      _size{0};           ///< Size of the value being read
+    std::size_t  _offset{0};         ///< Bytes of the value read so far
+
+    /**
+     * @brief Moves on to the next column, or ends the row
+     */
+    status next_column();
+
+    /**
+     * @brief Ends the row once every column was read
+     */
+    status finish();
+
+    /**
+     * @brief Abandons a malformed row
+     */
+    status
+    fail() noexcept {
+        reset();
+        return status::error;
+    }
+
+public:
+    /**
+     * @brief Starts reading a DataRow message
+     *
+     * @param stream Stream of the designated columns, must outlive the row
+     */
+    void start(FieldStream &stream);
+
+    /**
+     * @brief Checks whether a row is being read
+     */
+    bool
+    active() const noexcept {
+        return _stream != nullptr;
+    }
+
+    /**
+     * @brief Reads the available bytes of the current row
+     *
+     * @param data Bytes at the head of the input pipe
+     * @param size Number of available bytes
+     * @param consumed Set to the number of bytes used, to release from the pipe
+     * @return status Whether the row is complete
+     */
+    status feed(const char *data, std::size_t size, std::size_t &consumed);
+
+    /**
+     * @brief Gets the reduced row once feed() returned status::complete
+     *
+     * @return message_view View valid until the next call to start()
+     */
+    message_view
+    row() const noexcept {
+        return message_view(_row.data(), _row.size());
+    }
+
+    /**
+     * @brief Abandons the current row
+     */
+    void
+    reset() noexcept {
+        _stream = nullptr;
+        _state  = state::header;
+    }
+};
+
+} // namespace qb::pg::detail
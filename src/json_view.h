@@ -0,0 +1,239 @@
+/**
+ * @file json_view.h
+ * @brief Pass-through and lazily parsed JSON values
+ *
+ * TypeConverter<qb::json> and TypeConverter<qb::jsonb> parse every value into
+ * a DOM. Services that only forward or log JSON can avoid that work:
+ *
+ * - JsonView exposes the JSON text of a json or jsonb field without parsing
+ *   it, and sends pre-encoded JSON text as a parameter without re-encoding it
+ * - LazyJson keeps the text and parses it on first access
+ *
+ * Views do not own the text: a view read from a result is valid as long as
+ * the result set, and a view sent as parameter must outlive the serialization
+ * of the parameters, which happens when the query is queued.
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Unparsed JSON text of a json or jsonb value
+ *
+ * Reading accepts json and jsonb columns, in text or binary format; the
+ * jsonb version byte of the binary format is skipped. As a parameter, the
+ * text is sent as is with the OID of the chosen type.
+ *
+ * @tparam Oid Parameter type, oid::json or oid::jsonb
+ */
+template <oid Oid>
+struct JsonView {
+    std::string_view text; ///< JSON text
+
+    constexpr JsonView() noexcept = default;
+    constexpr JsonView(std::string_view json) noexcept
+        : text(json) {}
+
+    /**
+     * @brief Parses the JSON text
+     *
+     * @return qb::json Parsed value
+     * @throws std::runtime_error If the text is not valid JSON
+     */
+    qb::json
+    parse() const {
+        try {
+            return qb::json::parse(text);
+        } catch (const std::exception &e) {
+            throw std::runtime_error(std::string("Failed to parse JSON text: ") + e.what());
+        }
+    }
+
+    bool
+    operator==(JsonView const &other) const noexcept {
+        return text == other.text;
+    }
+};
+
+/**
+ * @brief JSON text parsed on first access
+ *
+ * The parsed value is cached; a LazyJson is not safe for concurrent first
+ * accesses. It shares the lifetime rules of JsonView.
+ */
+class LazyJson {
+    std::string_view                _text;
+    mutable std::optional<qb::json> _value;
+
+public:
+    LazyJson() = default;
+    template <oid Oid>
+    LazyJson(JsonView<Oid> json) noexcept
+        : _text(json.text) {}
+
+    /**
+     * @brief Gets the JSON text without parsing it
+     */
+    std::string_view
+    raw() const noexcept {
+        return _text;
+    }
+
+    /**
+     * @brief Checks whether the text was parsed
+     */
+    bool
+    parsed() const noexcept {
+        return _value.has_value();
+    }
+
+    /**
+     * @brief Gets the parsed value, parsing the text on first access
+     *
+     * @return qb::json const& Parsed value
+     * @throws std::runtime_error If the text is not valid JSON
+     */
+    qb::json const &
+    get() const {
+        if (!_value)
+            _value = JsonView<oid::json>(_text).parse();
+        return *_value;
+    }
+
+    qb::json const &
+    operator*() const {
+        return get();
+    }
+
+    qb::json const *
+    operator->() const {
+        return &get();
+    }
+};
+
+template <oid Oid>
+struct type_mapping<JsonView<Oid>> {
+    static constexpr integer type_oid = static_cast<integer>(Oid);
+};
+
+template <>
+struct type_mapping<LazyJson> {
+    static constexpr integer type_oid = static_cast<integer>(oid::json);
+};
+
+/**
+ * @brief Converter for unparsed JSON text
+ */
+template <oid Oid>
+struct TypeConverter<JsonView<Oid>> {
+    using value_type = JsonView<Oid>;
+
+    static integer
+    get_oid() {
+        return static_cast<integer>(Oid);
+    }
+
+    /**
+     * @brief Writes the JSON text, preceded by the jsonb version for jsonb
+     */
+    static void
+    to_binary(value_type const &value, std::vector<byte> &buffer) {
+        constexpr bool jsonb = Oid == oid::jsonb;
+        const auto     size  = static_cast<integer>(value.text.size() + jsonb);
+        const auto     nbo   = qb::endian::to_big_endian(size);
+        const auto    *bytes = reinterpret_cast<const byte *>(&nbo);
+        buffer.reserve(buffer.size() + sizeof(integer) + size);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(integer));
+        if constexpr (jsonb)
+            buffer.push_back(1);
+        buffer.insert(buffer.end(), value.text.begin(), value.text.end());
+    }
+
+    static std::string
+    to_text(value_type const &value) {
+        return std::string(value.text);
+    }
+
+    /**
+     * @brief Reads the text of a binary json or jsonb field
+     *
+     * JSON text cannot start with the control character 1, which is the
+     * version byte of binary jsonb values.
+     */
+    static value_type
+    from_binary(std::string_view buffer) {
+        if (!buffer.empty() && buffer.front() == 1)
+            buffer.remove_prefix(1);
+        return value_type(buffer);
+    }
+
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
+    static value_type
+    from_text(std::string_view text) {
+        return value_type(text);
+    }
+};
+
+/**
+ * @brief Converter for lazily parsed JSON
+ */
+template <>
+struct TypeConverter<LazyJson> {
+    using value_type = LazyJson;
+
+    static integer
+    get_oid() {
+        return static_cast<integer>(oid::json);
+    }
+
+    static void
+    to_binary(value_type const &value, std::vector<byte> &buffer) {
+        TypeConverter<JsonView<oid::json>>::to_binary(value.raw(), buffer);
+    }
+
+    static std::string
+    to_text(value_type const &value) {
+        return std::string(value.raw());
+    }
+
+    static value_type
+    from_binary(std::string_view buffer) {
+        return TypeConverter<JsonView<oid::json>>::from_binary(buffer);
+    }
+
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
+    static value_type
+    from_text(std::string_view text) {
+        return JsonView<oid::json>(text);
+    }
+};
+
+} // namespace qb::pg::detail
@@ -0,0 +1,50 @@
+/**
+ * @file memory.cpp
+ * @brief Implementation of the memory tracker of the result sets
+ *
+ * @see memory.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./memory.h"
+
+namespace qb::pg::detail {
+
+void *
+MemoryTracker::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void *ptr = _upstream->allocate(bytes, alignment);
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto in_use = _in_use.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    auto       peak   = _peak.load(std::memory_order_relaxed);
+    while (peak < in_use &&
+           !_peak.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+        ;
+    return ptr;
+}
+
+void
+MemoryTracker::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) {
+    _upstream->deallocate(ptr, bytes, alignment);
+    _in_use.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool
+MemoryTracker::do_is_equal(std::pmr::memory_resource const &other) const noexcept {
+    // Each tracker accounts for its own allocations
+    return this == &other;
+}
+
+} // namespace qb::pg::detail
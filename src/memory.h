@@ -0,0 +1,201 @@
+/**
+ * @file memory.h
+ * @brief Memory resources of the result sets
+ *
+ * The rows of a result set are allocated from a std::pmr::memory_resource,
+ * chosen per Database, per Transaction or per query (see
+ * Transaction::memory_resource()). A request can then keep its whole
+ * database footprint in an arena released at once, and each tenant can be
+ * accounted for separately:
+ *
+ * - ResourceAllocator binds the containers of a result set to a resource
+ * - MemoryTracker wraps a resource and records the bytes in use and their
+ *   high-water mark
+ *
+ * @code
+ * qb::pg::memory_tracker tenant(&arena);
+ * db.memory_resource(&tenant);
+ * // ...
+ * log(tenant.in_use(), tenant.peak());
+ * @endcode
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Polymorphic allocator following its storage when it moves
+ *
+ * Like std::pmr::polymorphic_allocator, allocates from a memory resource,
+ * the default one unless given. Unlike it, the resource propagates on move
+ * assignment and swap: rows handed from a query to its caller move with
+ * their resource instead of being copied into the resource of the caller.
+ * Copies are allocated from the default resource.
+ *
+ * @tparam T Element type
+ */
+template <typename T>
+class ResourceAllocator {
+    std::pmr::memory_resource *_resource; ///< Resource of the allocations, never null
+
+    template <typename U>
+    friend class ResourceAllocator;
+
+public:
+    using value_type                             = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    ResourceAllocator() noexcept
+        : _resource(std::pmr::get_default_resource()) {}
+
+    /**
+     * @brief Constructs an allocator drawing from a resource
+     *
+     * @param resource Memory resource, nullptr for the default one
+     */
+    ResourceAllocator(std::pmr::memory_resource *resource) noexcept
+        : _resource(resource ? resource : std::pmr::get_default_resource()) {}
+
+    template <typename U>
+    ResourceAllocator(ResourceAllocator<U> const &other) noexcept
+        : _resource(other._resource) {}
+
+    T *
+    allocate(std::size_t n) {
+        return static_cast<T *>(_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void
+    deallocate(T *ptr, std::size_t n) noexcept {
+        _resource->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    /**
+     * @brief Copies of a container are allocated from the default resource
+     */
+    ResourceAllocator
+    select_on_container_copy_construction() const noexcept {
+        return {};
+    }
+
+    /**
+     * @brief Gets the resource of the allocations
+     */
+    [[nodiscard]] std::pmr::memory_resource *
+    resource() const noexcept {
+        return _resource;
+    }
+
+    template <typename U>
+    bool
+    operator==(ResourceAllocator<U> const &other) const noexcept {
+        return _resource == other._resource || _resource->is_equal(*other._resource);
+    }
+
+    template <typename U>
+    bool
+    operator!=(ResourceAllocator<U> const &other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Memory resource recording the usage of an upstream resource
+ *
+ * Forwards every allocation to the upstream resource and counts the bytes
+ * in use, their high-water mark and the number of allocations. Counters
+ * are atomic: rows released by a worker thread are accounted for too.
+ * The tracker must outlive the rows allocated through it.
+ */
+class MemoryTracker final : public std::pmr::memory_resource {
+    std::pmr::memory_resource *_upstream;       ///< Resource serving the allocations
+    std::atomic<std::size_t>   _in_use{0};      ///< Bytes allocated and not released
+    std::atomic<std::size_t>   _peak{0};        ///< Highest value of _in_use
+    std::atomic<std::uint64_t> _allocations{0}; ///< Allocations served
+
+public:
+    /**
+     * @brief Constructs a tracker over a resource
+     *
+     * @param upstream Resource serving the allocations, the default one if null
+     */
+    explicit MemoryTracker(
+        std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) noexcept
+        : _upstream(upstream ? upstream : std::pmr::get_default_resource()) {}
+
+    MemoryTracker(MemoryTracker const &) = delete;
+
+    MemoryTracker &operator=(MemoryTracker const &) = delete;
+
+    /**
+     * @brief Gets the resource serving the allocations
+     */
+    [[nodiscard]] std::pmr::memory_resource *
+    upstream() const noexcept {
+        return _upstream;
+    }
+
+    /**
+     * @brief Gets the bytes allocated and not released yet
+     */
+    [[nodiscard]] std::size_t
+    in_use() const noexcept {
+        return _in_use.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the most bytes in use at once, since construction or reset_peak()
+     */
+    [[nodiscard]] std::size_t
+    peak() const noexcept {
+        return _peak.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the number of allocations served
+     */
+    [[nodiscard]] std::uint64_t
+    allocations() const noexcept {
+        return _allocations.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Restarts the high-water mark from the bytes in use
+     */
+    void
+    reset_peak() noexcept {
+        _peak.store(in_use(), std::memory_order_relaxed);
+    }
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+
+    bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override;
+};
+
+} // namespace qb::pg::detail
@@ -0,0 +1,142 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the query instrumentation
+ *
+ * @see metrics.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./metrics.h"
+#include <algorithm>
+
+namespace qb::pg::detail {
+
+namespace {
+
+/// Connections collecting metrics on this thread
+thread_local std::size_t collectors = 0;
+
+} // namespace
+
+const char *
+to_string(query_kind kind) noexcept {
+    switch (kind) {
+        case query_kind::simple:
+            return "simple";
+        case query_kind::prepare:
+            return "prepare";
+        case query_kind::execute:
+            return "execute";
+        case query_kind::batch:
+            return "batch";
+        case query_kind::portal:
+            return "portal";
+        case query_kind::copy:
+            return "copy";
+        case query_kind::transaction:
+            return "transaction";
+    }
+    return "unknown";
+}
+
+std::chrono::microseconds
+LatencyHistogram::percentile(double quantile) const noexcept {
+    if (!_count)
+        return std::chrono::microseconds(0);
+    const auto rank = static_cast<std::uint64_t>(
+        std::clamp(quantile, 0., 1.) * static_cast<double>(_count - 1));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += _buckets[i];
+        if (seen > rank) {
+            const auto bound = std::chrono::microseconds(std::uint64_t{1} << i);
+            const auto max   = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::nanoseconds(_max_ns));
+            return std::min(bound, std::max(max, std::chrono::microseconds(1)));
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::nanoseconds(_max_ns));
+}
+
+void
+LatencyHistogram::merge(LatencyHistogram const &other) noexcept {
+    for (std::size_t i = 0; i < bucket_count; ++i)
+        _buckets[i] += other._buckets[i];
+    _count += other._count;
+    _total_ns += other._total_ns;
+    _max_ns = std::max(_max_ns, other._max_ns);
+}
+
+void
+QueryStats::merge(QueryStats const &other) noexcept {
+    queue_wait.merge(other.queue_wait);
+    server_time.merge(other.server_time);
+    decode_time.merge(other.decode_time);
+    errors += other.errors;
+}
+
+QueryStats &
+QueryMetrics::statement(std::string_view name) {
+    auto it = statements.find(name);
+    if (it == statements.end())
+        it = statements.emplace(std::string(name), QueryStats{}).first;
+    return it->second;
+}
+
+void
+QueryMetrics::error(std::string_view sqlstate) {
+    const auto sqlclass = sqlstate.substr(0, 2);
+    auto       it       = errors.find(sqlclass);
+    if (it == errors.end())
+        it = errors.emplace(std::string(sqlclass), 0).first;
+    ++it->second;
+}
+
+void
+QueryMetrics::merge(QueryMetrics const &other) {
+    for (std::size_t i = 0; i < query_kind_count; ++i)
+        kinds[i].merge(other.kinds[i]);
+    for (auto const &[name, stats] : other.statements)
+        statement(name).merge(stats);
+    for (auto const &[sqlclass, count] : other.errors)
+        errors[sqlclass] += count;
+    queries += other.queries;
+    messages_in += other.messages_in;
+    messages_out += other.messages_out;
+    bytes_in += other.bytes_in;
+    bytes_out += other.bytes_out;
+    rows += other.rows;
+    reconnects += other.reconnects;
+}
+
+bool
+QueryMetrics::collecting() noexcept {
+    return collectors != 0;
+}
+
+void
+QueryMetrics::attach() noexcept {
+    ++collectors;
+}
+
+void
+QueryMetrics::detach() noexcept {
+    if (collectors)
+        --collectors;
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,266 @@
+/**
+ * @file metrics.h
+ * @brief Opt-in query instrumentation of a connection
+ *
+ * A Database collecting metrics records, for every query it completes:
+ *
+ * - Queue wait: from the time the query was queued to the time it was sent
+ * - Server time: from the time the server could start answering it (sent,
+ *   or the previous query answered) to its completion
+ * - Decode time: time spent handling its DataRow messages
+ *
+ * Durations go to log2 histograms kept per query kind and per prepared
+ * statement, next to counters of messages, bytes, rows, errors by SQLSTATE
+ * class and reconnections. A connection is bound to the thread of its I/O
+ * loop, so its metrics are plain counters updated without locks or
+ * formatting; snapshots of several connections are combined with merge().
+ *
+ * @see qb::pg::detail::Database::metrics
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Kind of query, as sent on the wire
+ */
+enum class query_kind : std::uint8_t {
+    simple,      ///< Simple query, or ad-hoc SQL prepared automatically
+    prepare,     ///< Parse and describe of a prepared statement
+    execute,     ///< Execution of a prepared statement
+    batch,       ///< Batched executions of a prepared statement
+    portal,      ///< Execution over a named portal
+    copy,        ///< COPY FROM STDIN / TO STDOUT
+    transaction, ///< BEGIN, COMMIT, ROLLBACK and savepoints
+};
+
+/// Number of query kinds
+constexpr std::size_t query_kind_count = 7;
+
+/**
+ * @brief Gets the name of a query kind
+ *
+ * @param kind Query kind
+ * @return const char* Static name, e.g. "execute"
+ */
+const char *to_string(query_kind kind) noexcept;
+
+/**
+ * @brief Histogram of durations with power-of-two microsecond buckets
+ *
+ * Bucket 0 counts durations below 1 us, bucket i durations in
+ * [2^(i-1), 2^i) us; the last bucket also takes everything above.
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t bucket_count = 32; ///< Up to ~36 minutes
+
+    /**
+     * @brief Records a duration
+     *
+     * @param duration Duration to record, negative values count as 0
+     */
+    void
+    record(std::chrono::nanoseconds duration) noexcept {
+        const auto ns = duration.count() > 0 ? static_cast<std::uint64_t>(duration.count())
+                                             : std::uint64_t{0};
+        auto        us    = ns / 1000;
+        std::size_t index = 0;
+        while (us && index < bucket_count - 1) {
+            us >>= 1;
+            ++index;
+        }
+        ++_buckets[index];
+        ++_count;
+        _total_ns += ns;
+        if (ns > _max_ns)
+            _max_ns = ns;
+    }
+
+    /**
+     * @brief Gets the number of recorded durations
+     *
+     * @return std::uint64_t Sample count
+     */
+    [[nodiscard]] std::uint64_t
+    count() const noexcept {
+        return _count;
+    }
+
+    /**
+     * @brief Gets the sum of the recorded durations
+     *
+     * @return std::chrono::nanoseconds Total duration
+     */
+    [[nodiscard]] std::chrono::nanoseconds
+    total() const noexcept {
+        return std::chrono::nanoseconds(_total_ns);
+    }
+
+    /**
+     * @brief Gets the longest recorded duration
+     *
+     * @return std::chrono::nanoseconds Maximum duration
+     */
+    [[nodiscard]] std::chrono::nanoseconds
+    max() const noexcept {
+        return std::chrono::nanoseconds(_max_ns);
+    }
+
+    /**
+     * @brief Gets the number of durations of a bucket
+     *
+     * @param index Bucket index, below bucket_count
+     * @return std::uint64_t Samples of the bucket
+     */
+    [[nodiscard]] std::uint64_t
+    bucket(std::size_t index) const noexcept {
+        return _buckets[index];
+    }
+
+    /**
+     * @brief Gets an upper bound of a percentile
+     *
+     * @param quantile Quantile in [0, 1], e.g. 0.99
+     * @return std::chrono::microseconds Upper bound of the bucket holding
+     * the quantile, capped by max(); 0 without samples
+     */
+    [[nodiscard]] std::chrono::microseconds percentile(double quantile) const noexcept;
+
+    /**
+     * @brief Adds the samples of another histogram
+     *
+     * @param other Histogram to add
+     */
+    void merge(LatencyHistogram const &other) noexcept;
+
+private:
+    std::array<std::uint64_t, bucket_count> _buckets{}; ///< Samples per bucket
+    std::uint64_t                           _count{0};    ///< Samples
+    std::uint64_t                           _total_ns{0}; ///< Sum of the samples
+    std::uint64_t                           _max_ns{0};   ///< Longest sample
+};
+
+/**
+ * @brief Timings of the queries of one kind or one statement
+ */
+struct QueryStats {
+    LatencyHistogram queue_wait;  ///< Queued to sent
+    LatencyHistogram server_time; ///< Answerable to completed
+    LatencyHistogram decode_time; ///< Handling of the DataRow messages
+    std::uint64_t    errors{0};   ///< Queries completed with an error
+
+    /**
+     * @brief Adds the samples of other stats
+     *
+     * @param other Stats to add
+     */
+    void merge(QueryStats const &other) noexcept;
+};
+
+/**
+ * @brief Metrics of one connection, or a merge of several
+ */
+struct QueryMetrics {
+    std::array<QueryStats, query_kind_count>        kinds;      ///< Stats per query kind
+    std::map<std::string, QueryStats, std::less<>> statements; ///< Stats per prepared statement
+    std::map<std::string, std::uint64_t, std::less<>>
+        errors; ///< Server errors per SQLSTATE class (first two characters)
+    std::uint64_t queries{0};      ///< Queries sent
+    std::uint64_t messages_in{0};  ///< Backend messages received
+    std::uint64_t messages_out{0}; ///< Frontend messages sent
+    std::uint64_t bytes_in{0};     ///< Bytes received
+    std::uint64_t bytes_out{0};    ///< Bytes sent
+    std::uint64_t rows{0};         ///< Data rows received
+    std::uint64_t reconnects{0};   ///< Sessions opened after a lost one
+
+    /**
+     * @brief Gets the stats of a query kind
+     *
+     * @param kind Query kind
+     * @return QueryStats& Stats of the kind
+     */
+    QueryStats &
+    kind(query_kind kind) noexcept {
+        return kinds[static_cast<std::size_t>(kind)];
+    }
+
+    /**
+     * @brief Gets the stats of a query kind
+     *
+     * @param kind Query kind
+     * @return QueryStats const& Stats of the kind
+     */
+    [[nodiscard]] QueryStats const &
+    kind(query_kind kind) const noexcept {
+        return kinds[static_cast<std::size_t>(kind)];
+    }
+
+    /**
+     * @brief Gets the stats of a prepared statement, creating them on first use
+     *
+     * @param name Statement name
+     * @return QueryStats& Stats of the statement
+     */
+    QueryStats &statement(std::string_view name);
+
+    /**
+     * @brief Counts a server error
+     *
+     * @param sqlstate SQLSTATE code reported by the server
+     */
+    void error(std::string_view sqlstate);
+
+    /**
+     * @brief Adds the metrics of another connection
+     *
+     * @param other Metrics to add
+     */
+    void merge(QueryMetrics const &other);
+
+    /**
+     * @brief Checks if queries are timed on the calling thread
+     *
+     * True while a connection of the thread collects metrics; queued
+     * queries are only timestamped then.
+     *
+     * @return bool True if metrics are collected on this thread
+     */
+    [[nodiscard]] static bool collecting() noexcept;
+
+    /**
+     * @brief Registers a connection collecting metrics on the calling thread
+     */
+    static void attach() noexcept;
+
+    /**
+     * @brief Unregisters a connection collecting metrics on the calling thread
+     */
+    static void detach() noexcept;
+};
+
+} // namespace qb::pg::detail
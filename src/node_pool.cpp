@@ -0,0 +1,146 @@
+/**
+ * @file node_pool.cpp
+ * @brief Implementation of the thread-local node freelists
+ *
+ * Each thread owns one intrusive singly-linked freelist per size class:
+ * a released block stores the pointer to the next free block in its first
+ * bytes. The freelists are returned to the heap when the thread exits;
+ * blocks released after that (by objects outliving the thread-local
+ * storage) go straight back to the heap.
+ *
+ * @see node_pool.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./node_pool.h"
+
+namespace qb::pg::detail {
+
+namespace {
+
+constexpr std::size_t class_count = NodePool::max_size / NodePool::granularity;
+
+/**
+ * @brief Free block, linked through its own storage
+ */
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+/**
+ * @brief Freelists of one thread
+ *
+ * Trivially destructible, so it stays usable until the thread is gone.
+ */
+struct Freelists {
+    FreeBlock  *heads[class_count];
+    std::size_t counts[class_count];
+    bool        registered; ///< Reaper constructed for this thread
+    bool        finished;   ///< Thread is exiting, stop caching
+
+    void
+    clear() noexcept {
+        for (std::size_t i = 0; i < class_count; ++i) {
+            while (auto block = heads[i]) {
+                heads[i] = block->next;
+                ::operator delete(block);
+            }
+            counts[i] = 0;
+        }
+    }
+};
+
+thread_local Freelists freelists{};
+
+/**
+ * @brief Returns the blocks of the thread to the heap when it exits
+ */
+struct Reaper {
+    ~Reaper() {
+        freelists.clear();
+        freelists.finished = true;
+    }
+};
+
+thread_local Reaper reaper;
+
+/**
+ * @brief Gets the size class of a pooled size
+ *
+ * @param size Block size in bytes, 1 to max_size
+ * @return std::size_t Class index
+ */
+constexpr std::size_t
+size_class(std::size_t size) noexcept {
+    return (size - 1) / NodePool::granularity;
+}
+
+} // namespace
+
+void *
+NodePool::allocate(std::size_t size) {
+    if (!size || size > max_size)
+        return ::operator new(size ? size : 1);
+
+    auto      &lists = freelists;
+    const auto index = size_class(size);
+    if (auto block = lists.heads[index]) {
+        lists.heads[index] = block->next;
+        --lists.counts[index];
+        return block;
+    }
+    return ::operator new((index + 1) * granularity);
+}
+
+void
+NodePool::deallocate(void *ptr, std::size_t size) noexcept {
+    if (!ptr)
+        return;
+    if (!size || size > max_size) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    auto      &lists = freelists;
+    const auto index = size_class(size);
+    if (lists.finished || lists.counts[index] >= max_cached) {
+        ::operator delete(ptr);
+        return;
+    }
+    if (!lists.registered) {
+        // First cached block of the thread: make sure it is reaped at exit
+        lists.registered = true;
+        (void) &reaper;
+    }
+    auto block         = static_cast<FreeBlock *>(ptr);
+    block->next        = lists.heads[index];
+    lists.heads[index] = block;
+    ++lists.counts[index];
+}
+
+std::size_t
+NodePool::cached(std::size_t size) noexcept {
+    if (!size || size > max_size)
+        return 0;
+    return freelists.counts[size_class(size)];
+}
+
+void
+NodePool::release() noexcept {
+    freelists.clear();
+}
+
+} // namespace qb::pg::detail
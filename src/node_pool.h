@@ -0,0 +1,144 @@
+/**
+ * @file node_pool.h
+ * @brief Thread-local freelists for command and query nodes
+ *
+ * Every fluent call builds a Transaction subclass and an ISqlQuery, plus
+ * the queues holding them, and tears them down once the server answered.
+ * NodePool recycles these short-lived blocks through per-thread freelists
+ * of a few size classes, so building and releasing a command tree does not
+ * reach the general-purpose heap in steady state:
+ *
+ * - Transaction and ISqlQuery route their operator new / delete here
+ * - NodeAllocator plugs the same freelists into their std containers
+ *
+ * Connections are bound to the thread of their I/O loop, so nodes are
+ * allocated and released on one thread and the freelists need no locking.
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Size-class freelists shared by the nodes of one thread
+ *
+ * Blocks up to max_size bytes are rounded up to a multiple of granularity
+ * and kept on release, up to max_cached blocks per class; larger blocks go
+ * straight to the global heap. Blocks released on another thread than the
+ * one that allocated them simply join the freelists of that thread.
+ */
+class NodePool {
+public:
+    static constexpr std::size_t granularity = 32;   ///< Size class step in bytes
+    static constexpr std::size_t max_size    = 1024; ///< Largest pooled block
+    static constexpr std::size_t max_cached  = 512;  ///< Blocks kept per class
+
+    /**
+     * @brief Allocates a block
+     *
+     * @param size Block size in bytes
+     * @return void* Block, suitably aligned for any fundamental type
+     * @throws std::bad_alloc if the heap is exhausted
+     */
+    static void *allocate(std::size_t size);
+
+    /**
+     * @brief Releases a block
+     *
+     * @param ptr Block returned by allocate()
+     * @param size Size given to allocate()
+     */
+    static void deallocate(void *ptr, std::size_t size) noexcept;
+
+    /**
+     * @brief Gets the number of free blocks kept for a size
+     *
+     * @param size Block size in bytes
+     * @return std::size_t Cached blocks of the size class, 0 if not pooled
+     */
+    [[nodiscard]] static std::size_t cached(std::size_t size) noexcept;
+
+    /**
+     * @brief Returns every cached block of the calling thread to the heap
+     */
+    static void release() noexcept;
+};
+
+/**
+ * @brief Standard allocator drawing from NodePool
+ *
+ * Used by the queues of Transaction, whose map and chunk allocations come
+ * and go with each node.
+ *
+ * @tparam T Element type
+ */
+template <typename T>
+class NodeAllocator {
+public:
+    using value_type = T;
+
+    NodeAllocator() noexcept = default;
+
+    template <typename U>
+    NodeAllocator(NodeAllocator<U> const &) noexcept {}
+
+    T *
+    allocate(std::size_t n) {
+        return static_cast<T *>(NodePool::allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *ptr, std::size_t n) noexcept {
+        NodePool::deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool
+    operator==(NodeAllocator<U> const &) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool
+    operator!=(NodeAllocator<U> const &) const noexcept {
+        return false;
+    }
+};
+
+/**
+ * @brief Base routing the allocations of a polymorphic node to NodePool
+ *
+ * The sized operator delete receives the size of the most derived type
+ * through the virtual destructor of the node, so it finds the size class
+ * without any header in the block.
+ */
+struct PooledNode {
+    static void *
+    operator new(std::size_t size) {
+        return NodePool::allocate(size);
+    }
+
+    static void
+    operator delete(void *ptr, std::size_t size) noexcept {
+        NodePool::deallocate(ptr, size);
+    }
+};
+
+} // namespace qb::pg::detail
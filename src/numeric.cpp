@@ -0,0 +1,353 @@
+/**
+ * @file numeric.cpp
+ * @brief Fixed-point decimals and the binary NUMERIC format
+ *
+ * @see numeric.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include "./type_converter.h"
+
+namespace qb::pg::detail {
+
+namespace {
+
+using rep = Decimal::rep;
+#if defined(__SIZEOF_INT128__)
+using urep = unsigned __int128;
+#else
+using urep = uint64_t;
+#endif
+
+constexpr urep     urep_max      = ~urep(0);
+constexpr urep     rep_max       = urep_max >> 1;
+constexpr uint16_t numeric_pos   = 0x0000;
+constexpr uint16_t numeric_neg   = 0x4000;
+constexpr uint16_t numeric_nan   = 0xC000;
+constexpr uint16_t numeric_pinf  = 0xD000;
+constexpr uint16_t numeric_ninf  = 0xF000;
+constexpr int      numeric_base  = 10000;
+constexpr int      header_size   = 4 * sizeof(uint16_t);
+
+[[noreturn]] void
+out_of_range() {
+    throw std::runtime_error("NUMERIC value out of range for Decimal");
+}
+
+/**
+ * @brief Multiplies with overflow detection
+ */
+bool
+mul_add(urep &value, urep factor, urep addend) noexcept {
+    if (value > (urep_max - addend) / factor)
+        return false;
+    value = value * factor + addend;
+    return true;
+}
+
+/**
+ * @brief Multiplies by 10^exponent, with overflow detection
+ */
+bool
+scale_up(urep &value, int exponent) noexcept {
+    for (; exponent > 0 && value; --exponent) {
+        if (!mul_add(value, 10, 0))
+            return false;
+    }
+    return true;
+}
+
+rep
+to_signed(urep magnitude, bool negative) {
+    if (magnitude > rep_max + negative)
+        out_of_range();
+    return negative ? static_cast<rep>(~magnitude + 1) : static_cast<rep>(magnitude);
+}
+
+urep
+magnitude(rep value) noexcept {
+    return value < 0 ? ~static_cast<urep>(value) + 1 : static_cast<urep>(value);
+}
+
+uint16_t
+read_uint16(std::string_view buffer, std::size_t offset) noexcept {
+    uint16_t value;
+    std::memcpy(&value, buffer.data() + offset, sizeof(value));
+    return qb::endian::from_big_endian(value);
+}
+
+void
+write_uint16(std::vector<byte> &buffer, uint16_t value) {
+    const auto nbo   = qb::endian::to_big_endian(value);
+    const auto bytes = reinterpret_cast<const byte *>(&nbo);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(nbo));
+}
+
+/**
+ * @brief Binary NUMERIC header
+ */
+struct Header {
+    int      ndigits;
+    int      weight;
+    uint16_t sign;
+    int      dscale;
+};
+
+Header
+read_header(std::string_view buffer) {
+    if (buffer.size() < header_size)
+        throw std::runtime_error("Invalid NUMERIC binary format: buffer too small");
+    Header header{read_uint16(buffer, 0), static_cast<int16_t>(read_uint16(buffer, 2)),
+                  read_uint16(buffer, 4), read_uint16(buffer, 6)};
+    if (buffer.size() != header_size + header.ndigits * sizeof(uint16_t))
+        throw std::runtime_error("Invalid NUMERIC binary format: wrong number of digits");
+    return header;
+}
+
+/**
+ * @brief Appends a value below 10000 as exactly four digits
+ */
+void
+append_group(std::string &out, unsigned group) {
+    const char digits[4] = {static_cast<char>('0' + group / 1000),
+                            static_cast<char>('0' + group / 100 % 10),
+                            static_cast<char>('0' + group / 10 % 10),
+                            static_cast<char>('0' + group % 10)};
+    out.append(digits, 4);
+}
+
+} // namespace
+
+Decimal
+Decimal::rescale(smallint scale) const {
+    if (scale < 0)
+        throw std::runtime_error("Negative Decimal scale");
+    const bool negative = _unscaled < 0;
+    urep       value    = magnitude(_unscaled);
+    if (scale >= _scale) {
+        if (!scale_up(value, scale - _scale))
+            out_of_range();
+    } else {
+        urep remainder = 0;
+        for (int i = _scale; i > scale; --i) {
+            remainder = value % 10;
+            value /= 10;
+        }
+        // The most significant discarded digit decides, as in PostgreSQL's round()
+        if (remainder >= 5)
+            ++value;
+    }
+    return Decimal(to_signed(value, negative), scale);
+}
+
+double
+Decimal::to_double() const noexcept {
+    double value = static_cast<double>(_unscaled);
+    for (int i = 0; i < _scale; ++i)
+        value /= 10;
+    return value;
+}
+
+std::string
+Decimal::to_string() const {
+    char  digits[48];
+    char *end = digits + sizeof(digits);
+    char *p   = end;
+    urep  value = magnitude(_unscaled);
+    do {
+        *--p = static_cast<char>('0' + static_cast<int>(value % 10));
+        value /= 10;
+    } while (value);
+
+    const auto  count = static_cast<std::size_t>(end - p);
+    std::string out;
+    out.reserve(count + _scale + 3);
+    if (_unscaled < 0)
+        out += '-';
+    if (count <= static_cast<std::size_t>(_scale)) {
+        out += "0.";
+        out.append(_scale - count, '0');
+        out.append(p, count);
+    } else {
+        out.append(p, count - _scale);
+        if (_scale) {
+            out += '.';
+            out.append(end - _scale, _scale);
+        }
+    }
+    return out;
+}
+
+Decimal
+Decimal::parse(std::string_view text) {
+    while (!text.empty() && text.front() == ' ')
+        text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ')
+        text.remove_suffix(1);
+
+    bool negative = false;
+    if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+        negative = text.front() == '-';
+        text.remove_prefix(1);
+    }
+
+    urep     value  = 0;
+    int      scale  = 0;
+    bool     digits = false;
+    bool     point  = false;
+    for (const char c : text) {
+        if (c >= '0' && c <= '9') {
+            if (!mul_add(value, 10, static_cast<urep>(c - '0')))
+                out_of_range();
+            digits = true;
+            scale += point;
+        } else if (c == '.' && !point) {
+            point = true;
+        } else {
+            throw std::runtime_error("Invalid NUMERIC text: " + std::string(text));
+        }
+    }
+    if (!digits)
+        throw std::runtime_error("Invalid NUMERIC text: " + std::string(text));
+    return Decimal(to_signed(value, negative), static_cast<smallint>(scale));
+}
+
+bool
+Decimal::operator==(Decimal const &other) const noexcept {
+    // Compare without trailing fraction zeros, which cannot overflow
+    auto normalize = [](Decimal value) {
+        while (value._scale > 0 && value._unscaled % 10 == 0) {
+            value._unscaled /= 10;
+            --value._scale;
+        }
+        return value;
+    };
+    const auto lhs = normalize(*this);
+    const auto rhs = normalize(other);
+    return lhs._unscaled == rhs._unscaled && lhs._scale == rhs._scale;
+}
+
+Decimal
+NumericCodec::read_binary(std::string_view buffer) {
+    const auto header = read_header(buffer);
+    if (header.sign != numeric_pos && header.sign != numeric_neg)
+        throw std::runtime_error("NUMERIC value is not finite");
+    if (header.dscale > 0x3FFF)
+        throw std::runtime_error("Invalid NUMERIC display scale");
+
+    urep value = 0;
+    for (int i = 0; i < header.ndigits; ++i) {
+        const auto group = read_uint16(buffer, header_size + i * sizeof(uint16_t));
+        if (!mul_add(value, numeric_base, group))
+            out_of_range();
+    }
+
+    // The groups hold value * 10000^(weight - ndigits + 1)
+    const int exponent = 4 * (header.weight - header.ndigits + 1) + header.dscale;
+    if (exponent >= 0) {
+        if (!scale_up(value, exponent))
+            out_of_range();
+    } else {
+        // Digits beyond the display scale are zero
+        for (int i = exponent; i < 0 && value; ++i)
+            value /= 10;
+    }
+    return Decimal(to_signed(value, header.sign == numeric_neg),
+                   static_cast<smallint>(header.dscale));
+}
+
+void
+NumericCodec::write_binary(Decimal const &value, std::vector<byte> &buffer) {
+    // Align the fraction on digit groups
+    const int pad   = (4 - value.scale() % 4) % 4;
+    urep      units = magnitude(value.unscaled());
+    if (!scale_up(units, pad))
+        out_of_range();
+    const int fraction_groups = (value.scale() + pad) / 4;
+
+    // Groups from the least significant
+    uint16_t groups[16];
+    int      count = 0;
+    for (; units; units /= numeric_base)
+        groups[count++] = static_cast<uint16_t>(units % numeric_base);
+
+    int first = 0; // trailing zero groups are implied
+    while (first < count && !groups[first])
+        ++first;
+    const int ndigits = count - first;
+    const int weight  = ndigits ? count - 1 - fraction_groups : 0;
+
+    const auto length = static_cast<integer>(header_size + ndigits * sizeof(uint16_t));
+    const auto nbo    = qb::endian::to_big_endian(length);
+    const auto bytes  = reinterpret_cast<const byte *>(&nbo);
+    buffer.reserve(buffer.size() + sizeof(integer) + length);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(integer));
+    write_uint16(buffer, static_cast<uint16_t>(ndigits));
+    write_uint16(buffer, static_cast<uint16_t>(static_cast<int16_t>(weight)));
+    write_uint16(buffer, value.unscaled() < 0 ? numeric_neg : numeric_pos);
+    write_uint16(buffer, static_cast<uint16_t>(value.scale()));
+    for (int i = count - 1; i >= first; --i)
+        write_uint16(buffer, groups[i]);
+}
+
+std::string
+NumericCodec::to_text(std::string_view buffer) {
+    const auto header = read_header(buffer);
+    switch (header.sign) {
+        case numeric_pos:
+        case numeric_neg:
+            break;
+        case numeric_nan:
+            return "NaN";
+        case numeric_pinf:
+            return "Infinity";
+        case numeric_ninf:
+            return "-Infinity";
+        default:
+            throw std::runtime_error("Invalid NUMERIC sign");
+    }
+
+    auto group = [&](int i) -> unsigned {
+        return i >= 0 && i < header.ndigits
+                   ? read_uint16(buffer, header_size + i * sizeof(uint16_t))
+                   : 0;
+    };
+
+    std::string out;
+    out.reserve(2 + 4 * (header.weight > 0 ? header.weight + 1 : 1) + 1 + header.dscale);
+    if (header.sign == numeric_neg && header.ndigits)
+        out += '-';
+    if (header.weight < 0) {
+        out += '0';
+    } else {
+        out += std::to_string(group(0));
+        for (int i = 1; i <= header.weight; ++i)
+            append_group(out, group(i));
+    }
+    if (header.dscale > 0) {
+        out += '.';
+        const auto start = out.size();
+        for (int i = header.weight + 1; out.size() - start < static_cast<std::size_t>(header.dscale);
+             ++i)
+            append_group(out, group(i));
+        out.resize(start + header.dscale);
+    }
+    return out;
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,200 @@
+/**
+ * @file numeric.h
+ * @brief Fixed-point decimals and the binary NUMERIC format
+ *
+ * NUMERIC values are sent in binary as base-10000 digit groups with a weight,
+ * a sign and a display scale. Decimal holds them as a scaled integer,
+ * backed by __int128 where the compiler provides it (38 significant digits)
+ * and by int64_t otherwise (18 significant digits):
+ *
+ * - Decimal values are decoded and encoded without going through text
+ * - Values that do not fit, NaN and infinities throw std::runtime_error
+ * - field.as<std::string>() formats binary NUMERIC fields exactly, whatever
+ *   their precision
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Fixed-point decimal number: unscaled() / 10^scale()
+ */
+class Decimal {
+public:
+#if defined(__SIZEOF_INT128__)
+    using rep = __int128;
+    /// Number of significant digits always representable
+    static constexpr int max_digits = 38;
+#else
+    using rep = int64_t;
+    /// Number of significant digits always representable
+    static constexpr int max_digits = 18;
+#endif
+
+private:
+    rep      _unscaled{0};
+    smallint _scale{0};
+
+public:
+    constexpr Decimal() noexcept = default;
+
+    /**
+     * @brief Constructs unscaled / 10^scale
+     *
+     * @param unscaled Unscaled value, e.g. 12345 for 123.45
+     * @param scale Number of digits after the decimal point, non-negative
+     */
+    constexpr Decimal(rep unscaled, smallint scale) noexcept
+        : _unscaled(unscaled)
+        , _scale(scale) {}
+
+    constexpr rep
+    unscaled() const noexcept {
+        return _unscaled;
+    }
+
+    constexpr smallint
+    scale() const noexcept {
+        return _scale;
+    }
+
+    /**
+     * @brief Changes the scale, rounding half away from zero
+     *
+     * @param scale New scale
+     * @return Decimal Value with the new scale
+     * @throws std::runtime_error If the value does not fit
+     */
+    Decimal rescale(smallint scale) const;
+
+    /**
+     * @brief Gets the closest double, for display or statistics
+     */
+    double to_double() const noexcept;
+
+    /**
+     * @brief Formats the value with exactly scale() fraction digits
+     */
+    std::string to_string() const;
+
+    /**
+     * @brief Parses a decimal number, e.g. "-123.4500"
+     *
+     * The scale is the number of fraction digits of the text.
+     *
+     * @throws std::runtime_error If the text is not a finite number or does not fit
+     */
+    static Decimal parse(std::string_view text);
+
+    /**
+     * @brief Compares values, whatever their scales
+     */
+    bool operator==(Decimal const &other) const noexcept;
+
+    bool
+    operator!=(Decimal const &other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+inline std::ostream &
+operator<<(std::ostream &os, Decimal const &value) {
+    return os << value.to_string();
+}
+
+/**
+ * @brief Codec of the binary NUMERIC format
+ */
+struct NumericCodec {
+    /**
+     * @brief Decodes a binary NUMERIC value
+     *
+     * @param buffer Field value, without its length
+     * @return Decimal Value with the display scale of the field
+     * @throws std::runtime_error If the value is malformed, not finite or does not fit
+     */
+    static Decimal read_binary(std::string_view buffer);
+
+    /**
+     * @brief Encodes a Decimal, preceded by its length
+     *
+     * @param value Value
+     * @param buffer Destination buffer
+     */
+    static void write_binary(Decimal const &value, std::vector<byte> &buffer);
+
+    /**
+     * @brief Formats a binary NUMERIC value exactly, whatever its precision
+     *
+     * @param buffer Field value, without its length
+     * @return std::string Text as PostgreSQL prints it, including NaN and Infinity
+     * @throws std::runtime_error If the value is malformed
+     */
+    static std::string to_text(std::string_view buffer);
+};
+
+template <>
+struct type_mapping<Decimal> {
+    static constexpr integer type_oid = 1700;
+}; // numeric
+
+/**
+ * @brief Converter for fixed-point decimals
+ */
+template <>
+struct TypeConverter<Decimal> {
+    using value_type = Decimal;
+
+    static integer
+    get_oid() {
+        return static_cast<integer>(oid::numeric);
+    }
+
+    static void
+    to_binary(Decimal const &value, std::vector<byte> &buffer) {
+        NumericCodec::write_binary(value, buffer);
+    }
+
+    static std::string
+    to_text(Decimal const &value) {
+        return value.to_string();
+    }
+
+    static value_type
+    from_binary(std::string_view buffer) {
+        return NumericCodec::read_binary(buffer);
+    }
+
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
+    static value_type
+    from_text(std::string_view text) {
+        return Decimal::parse(text);
+    }
+};
+
+} // namespace qb::pg::detail
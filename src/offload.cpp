@@ -0,0 +1,67 @@
+/**
+ * @file offload.cpp
+ * @brief Decoding of large results on worker threads
+ *
+ * @see offload.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./offload.h"
+
+namespace qb::pg::detail {
+
+DecodePool::DecodePool(std::size_t threads) {
+    _threads.reserve(threads ? threads : 1);
+    for (std::size_t i = 0; i < (threads ? threads : 1); ++i)
+        _threads.emplace_back([this] { run(); });
+}
+
+DecodePool::~DecodePool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _ready.notify_all();
+    for (auto &thread : _threads)
+        thread.join();
+}
+
+void
+DecodePool::post(task_type task) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+    _ready.notify_one();
+}
+
+void
+DecodePool::run() {
+    for (;;) {
+        task_type task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _ready.wait(lock, [this] { return _stop || !_tasks.empty(); });
+            if (_tasks.empty())
+                return;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace qb::pg::detail
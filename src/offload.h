@@ -0,0 +1,183 @@
+/**
+ * @file offload.h
+ * @brief Decoding of large results on worker threads
+ *
+ * The rows of a result are normally converted to objects in the success
+ * callback, on the I/O thread owning the connection, and every other query
+ * of the connection waits meanwhile. With a ResultOffload:
+ *
+ * - the received rows are frozen in an immutable result shared with the
+ *   workers, without any copy
+ * - ranges of rows are decoded in parallel by an executor, with the row
+ *   decoders of typed statements (RowBinder, TypeConverter)
+ * - the I/O thread serves the next queries, and hands the decoded rows to
+ *   the success callback once every range is done
+ *
+ * The executor is any callable running a task on another thread: a
+ * DecodePool, or a function posting the task to a worker actor.
+ *
+ * @see qb::pg::detail::Transaction::execute_offload
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "./result_impl.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Fixed set of threads running decoding tasks
+ *
+ * Tasks are taken in submission order by the first idle thread. Pending
+ * tasks are still run when the pool is destroyed.
+ */
+class DecodePool {
+public:
+    using task_type = std::function<void()>;
+
+private:
+    std::mutex              _mutex;          ///< Guards the tasks and the stop flag
+    std::condition_variable _ready;          ///< Signals a task or the stop
+    std::deque<task_type>   _tasks;          ///< Tasks not started yet
+    bool                    _stop{false};    ///< Set by the destructor
+    std::vector<std::thread> _threads;       ///< Worker threads
+
+    /**
+     * @brief Runs the tasks until the pool is destroyed
+     */
+    void run();
+
+public:
+    /**
+     * @brief Starts the worker threads
+     *
+     * @param threads Number of threads, at least 1
+     */
+    explicit DecodePool(std::size_t threads);
+
+    DecodePool(DecodePool const &)            = delete;
+    DecodePool &operator=(DecodePool const &) = delete;
+
+    /**
+     * @brief Runs the pending tasks and joins the threads
+     */
+    ~DecodePool();
+
+    /**
+     * @brief Adds a task, from any thread
+     *
+     * @param task Task to run on a worker thread
+     */
+    void post(task_type task);
+
+    /**
+     * @brief Gets the number of worker threads
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept {
+        return _threads.size();
+    }
+};
+
+/**
+ * @brief Options of the decoding of a result on worker threads
+ */
+struct ResultOffload {
+    /// Runs a task on another thread
+    using executor_type = std::function<void(std::function<void()>)>;
+
+    executor_type executor;             ///< Executor of the decoding tasks
+    std::size_t   rows_per_task{4096};  ///< Rows decoded by each task
+    std::size_t   min_rows{4096};       ///< Smaller results are decoded on the I/O thread
+
+    ResultOffload() = default;
+
+    /**
+     * @brief Offloads to an executor
+     *
+     * @param exec Executor of the decoding tasks
+     */
+    explicit ResultOffload(executor_type exec)
+        : executor(std::move(exec)) {}
+
+    /**
+     * @brief Offloads to a DecodePool
+     *
+     * @param pool Pool running the decoding tasks, must outlive the queries
+     */
+    explicit ResultOffload(DecodePool &pool)
+        : executor([&pool](std::function<void()> task) { pool.post(std::move(task)); }) {}
+};
+
+/**
+ * @brief Rows being decoded by the workers, shared with the I/O thread
+ *
+ * Each task writes a disjoint range of rows; the last task to finish
+ * hands them to the I/O thread.
+ *
+ * @tparam Row Type of the decoded rows, not bool: std::vector<bool> packs
+ * neighbouring rows in the same word, written by several tasks at once
+ */
+template <typename Row>
+struct OffloadedRows {
+    static_assert(!std::is_same_v<Row, bool>,
+                  "offloaded rows of bool share words across tasks, decode std::tuple<bool>");
+
+    std::shared_ptr<const result_impl> result;    ///< Rows received from the server
+    std::vector<Row>                   rows;      ///< Decoded rows, one slot per row
+    std::atomic<std::size_t>           remaining; ///< Tasks not finished yet
+    std::atomic<bool>                  failed{false}; ///< A task failed
+    std::string                        error;     ///< Error of the first failed task
+
+    OffloadedRows(std::shared_ptr<const result_impl> res, std::size_t tasks)
+        : result(std::move(res))
+        , rows(result->size())
+        , remaining(tasks) {}
+
+    /**
+     * @brief Records the error of a task, keeping the first one
+     */
+    void
+    fail(std::string reason) {
+        if (!failed.exchange(true, std::memory_order_acq_rel))
+            error = std::move(reason);
+    }
+
+    /**
+     * @brief Records the end of a task, from any thread
+     *
+     * @return bool True for the last task, which hands the rows over
+     */
+    [[nodiscard]] bool
+    finish() noexcept {
+        return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+};
+
+} // namespace qb::pg::detail
@@ -39,6 +39,7 @@
 #include <variant>
 #include <vector>
 
+#include "./external_param.h"
 #include "./pg_types.h"
 #include "./type_converter.h"
 #include "./type_mapping.h"
@@ -63,7 +64,8 @@ public:
     ParamSerializer()
         : format_codes_buffer_{}
         , params_buffer_{}
-        , param_types_{} {}
+        , param_types_{}
+        , external_{} {}
 
     /**
      * @brief Get the serialized format codes buffer
@@ -96,6 +98,36 @@ public:
         return param_types_;
     }
 
+    /**
+     * @brief Move the serialized parameters buffer out of the serializer
+     *
+     * @return std::vector<byte> Buffer containing serialized parameter data
+     */
+    std::vector<byte>
+    release_params_buffer() noexcept {
+        return std::move(params_buffer_);
+    }
+
+    /**
+     * @brief Move the parameter OID types out of the serializer
+     *
+     * @return std::vector<integer> Vector of PostgreSQL OIDs for each parameter
+     */
+    std::vector<integer>
+    release_param_types() noexcept {
+        return std::move(param_types_);
+    }
+
+    /**
+     * @brief Move the external parameters out of the serializer
+     *
+     * @return std::vector<ExternalSlice> Values left out of the parameters buffer
+     */
+    std::vector<ExternalSlice>
+    release_external() noexcept {
+        return std::move(external_);
+    }
+
     /**
      * @brief Get the number of parameters
      *
@@ -116,6 +148,7 @@ public:
         format_codes_buffer_.clear();
         params_buffer_.clear();
         param_types_.clear();
+        external_.clear();
     }
 
     /**
@@ -302,6 +335,21 @@ public:
         write_byte_array(data, size);
     }
 
+    /**
+     * @brief Add a parameter referencing caller-owned memory
+     *
+     * Only the length of the value is written to the parameters buffer; the
+     * value is recorded at its position, to be gathered when the query is sent.
+     *
+     * @param param External bytea or text value
+     */
+    void
+    add_external(const ExternalParam &param) {
+        param_types_.push_back(param.oid());
+        write_integer(params_buffer_, static_cast<integer>(param.data().size()));
+        external_.push_back(ExternalSlice{params_buffer_.size(), param});
+    }
+
     /**
      * @brief Add an optional parameter
      *
@@ -395,6 +443,12 @@ public:
             return;
         }
 
+        // Special case: value left out of the buffer
+        if constexpr (std::is_same_v<value_type, ExternalParam>) {
+            add_external(param);
+            return;
+        }
+
         // Standard case: use TypeConverter
         // 1. Add the OID type
         param_types_.push_back(TypeConverter<value_type>::get_oid());
@@ -407,12 +461,8 @@ public:
             }
         }
 
-        // 3. Serialize to binary
-        std::vector<byte> buffer;
-        TypeConverter<value_type>::to_binary(param, buffer);
-
-        // 4. Add the result to the parameter buffer
-        params_buffer_.insert(params_buffer_.end(), buffer.begin(), buffer.end());
+        // 3. Serialize to binary, appending to the parameter buffer
+        TypeConverter<value_type>::to_binary(param, params_buffer_);
     }
 
     /**
@@ -457,31 +507,17 @@ public:
         // Reserve space for parameters (estimate)
         params_buffer_.reserve(sizeof(smallint) + expected_count * 32);
 
-        // Do not write the number of parameters at the beginning of the buffer,
-        // as this number may change for string vectors.
-        // We will add this information later.
+        // The number of parameters may change for string vectors: its slot is
+        // reserved at the beginning of the buffer and written last
+        params_buffer_.resize(sizeof(smallint));
 
         // Process each parameter
         if constexpr (expected_count > 0) {
             (add_param(std::forward<Args>(args)), ...);
         }
 
-        // Get the actual number of parameters
-        smallint actual_count = param_count();
-
-        // Create a new buffer with the correct number of parameters at the beginning
-        std::vector<byte> final_buffer;
-        final_buffer.reserve(sizeof(smallint) + params_buffer_.size());
-
-        // Write the number of parameters at the beginning
-        write_smallint(final_buffer, actual_count);
-
-        // Copy the rest of the buffer
-        final_buffer.insert(final_buffer.end(), params_buffer_.begin(),
-                            params_buffer_.end());
-
-        // Replace the original buffer
-        params_buffer_ = std::move(final_buffer);
+        // Write the actual number of parameters in its slot
+        write_smallint_at(params_buffer_, 0, param_count());
     }
 
     /**
@@ -523,6 +559,7 @@ private:
     std::vector<byte>    format_codes_buffer_;
     std::vector<byte>    params_buffer_;
     std::vector<integer> param_types_;
+    std::vector<ExternalSlice> external_;
 
     /**
      * @brief Add a format code to the format codes buffer
@@ -768,7 +805,9 @@ private:
     /**
      * @brief Add a generic vector as a PostgreSQL array
      *
-     * This method serializes any std::vector into a PostgreSQL array format
+     * Serializes the vector as a one-dimensional binary array of its element
+     * type; std::optional elements are sent as NULL elements. An empty
+     * vector is sent as a NULL array, as_array() sends it as '{}'.
      *
      * @tparam VecType The vector type to serialize
      * @param vector The vector to serialize
@@ -776,46 +815,7 @@ private:
     template <typename VecType>
     void
     add_vector(const VecType &vector) {
-        using element_type = typename VecType::value_type;
-
-        // Get array element OID type from the element type
-        integer element_oid = TypeConverter<element_type>::get_oid();
-
-        // Determine the array OID based on element type OID
-        // This is a simplification; PostgreSQL array OIDs typically follow a pattern
-        // but a proper implementation would use a mapping from element OID to array OID
-        integer array_oid = 0;
-
-        // Array type determination - common array OIDs
-        switch (element_oid) {
-            case 16:
-                array_oid = 1000;
-                break; // boolean array
-            case 21:
-                array_oid = 1005;
-                break; // int2 array
-            case 23:
-                array_oid = 1007;
-                break; // int4 array
-            case 20:
-                array_oid = 1016;
-                break; // int8 array
-            case 700:
-                array_oid = 1021;
-                break; // float4 array
-            case 701:
-                array_oid = 1022;
-                break; // float8 array
-            case 25:
-                array_oid = 1009;
-                break; // text array
-            default:
-                array_oid = 2277;
-                break; // Use anyarray as fallback
-        }
-
-        // Add the array OID type
-        param_types_.push_back(array_oid);
+        param_types_.push_back(TypeConverter<VecType>::get_oid());
 
         // For empty vectors, write NULL
         if (vector.empty()) {
@@ -823,50 +823,7 @@ private:
             return;
         }
 
-        // Prepare a binary buffer for the array
-        std::vector<byte> array_buffer;
-
-        // PostgreSQL array binary format:
-        // int32 number of dimensions (1 for 1D array)
-        // int32 has nulls flag (1 if array has nulls, 0 otherwise)
-        // int32 element type OID
-        // int32 dimension size
-        // int32 dimension lower bound (typically 1)
-        // followed by each element with int32 length prefix and data
-
-        // We'll start with a 1D array header (20 bytes)
-        // Number of dimensions
-        write_integer(array_buffer, 1);
-
-        // Has nulls flag (0 = no nulls, check or implement if needed)
-        write_integer(array_buffer, 0);
-
-        // Element type OID
-        write_integer(array_buffer, element_oid);
-
-        // Dimension size
-        write_integer(array_buffer, static_cast<integer>(vector.size()));
-
-        // Lower bound (typically 1 for PostgreSQL arrays)
-        write_integer(array_buffer, 1);
-
-        // Now serialize each element
-        for (const auto &elem : vector) {
-            // For each element, use TypeConverter to serialize it
-            std::vector<byte> elem_buffer;
-            TypeConverter<element_type>::to_binary(elem, elem_buffer);
-
-            // Add element data to array buffer
-            array_buffer.insert(array_buffer.end(), elem_buffer.begin(),
-                                elem_buffer.end());
-        }
-
-        // Write the total array length
-        write_integer(params_buffer_, static_cast<integer>(array_buffer.size()));
-
-        // Write the array data
-        params_buffer_.insert(params_buffer_.end(), array_buffer.begin(),
-                              array_buffer.end());
+        TypeConverter<VecType>::to_binary(vector, params_buffer_);
     }
 };
 
@@ -26,6 +26,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "./common.h"
@@ -40,6 +41,9 @@ namespace qb::pg::detail {
  * PostgreSQL's binary wire format into C++ native types. It handles the
  * low-level binary data parsing and conversion, supporting both text and
  * binary protocol formats.
+ *
+ * Readers operate on a std::string_view over the field bytes, so values can
+ * be decoded in place from the result set storage without copying.
  */
 class ParamUnserializer {
 public:
@@ -80,7 +84,7 @@ public:
      * @param buffer The buffer containing binary data
      * @return smallint The extracted 2-byte integer value
      */
-    smallint read_smallint(const std::vector<byte> &buffer);
+    smallint read_smallint(std::string_view buffer);
 
     /**
      * @brief Read a 4-byte integer from a binary buffer
@@ -91,7 +95,7 @@ public:
      * @param buffer The buffer containing binary data
      * @return integer The extracted 4-byte integer value
      */
-    integer read_integer(const std::vector<byte> &buffer);
+    integer read_integer(std::string_view buffer);
 
     /**
      * @brief Read an 8-byte integer from a binary buffer
@@ -102,7 +106,7 @@ public:
      * @param buffer The buffer containing binary data
      * @return bigint The extracted 8-byte integer value
      */
-    bigint read_bigint(const std::vector<byte> &buffer);
+    bigint read_bigint(std::string_view buffer);
 
     /**
      * @brief Read a single-precision floating point value from a binary buffer
@@ -113,7 +117,7 @@ public:
      * @param buffer The buffer containing binary data
      * @return float The extracted single-precision floating point value
      */
-    float read_float(const std::vector<byte> &buffer);
+    float read_float(std::string_view buffer);
 
     /**
      * @brief Read a double-precision floating point value from a binary buffer
@@ -124,7 +128,7 @@ public:
      * @param buffer The buffer containing binary data
      * @return double The extracted double-precision floating point value
      */
-    double read_double(const std::vector<byte> &buffer);
+    double read_double(std::string_view buffer);
 
     /**
      * @brief Read a string from a binary buffer
@@ -135,7 +139,7 @@ public:
      * @param buffer The buffer containing string data
      * @return std::string The extracted string value
      */
-    std::string read_string(const std::vector<byte> &buffer);
+    std::string read_string(std::string_view buffer);
 
     /**
      * @brief Read a string in text format from a binary buffer
@@ -146,7 +150,7 @@ public:
      * @param buffer The buffer containing text-formatted string data
      * @return std::string The extracted string value
      */
-    std::string read_text_string(const std::vector<byte> &buffer);
+    std::string read_text_string(std::string_view buffer);
 
     /**
      * @brief Read a string in binary format from a binary buffer
@@ -157,7 +161,7 @@ public:
      * @param buffer The buffer containing binary-formatted string data
      * @return std::string The extracted string value
      */
-    std::string read_binary_string(const std::vector<byte> &buffer);
+    std::string read_binary_string(std::string_view buffer);
 
     /**
      * @brief Read a boolean value from a binary buffer
@@ -168,7 +172,7 @@ public:
      * @param buffer The buffer containing boolean data
      * @return bool The extracted boolean value
      */
-    bool read_bool(const std::vector<byte> &buffer);
+    bool read_bool(std::string_view buffer);
 
     /**
      * @brief Read binary data (bytea) from a binary buffer
@@ -179,7 +183,66 @@ public:
      * @param buffer The buffer containing bytea data
      * @return std::vector<byte> The extracted binary data
      */
-    std::vector<byte> read_bytea(const std::vector<byte> &buffer);
+    std::vector<byte> read_bytea(std::string_view buffer);
+
+    /**
+     * @name Vector overloads
+     * Convenience overloads for callers holding an owned copy of the field
+     * bytes; they forward to the view-based readers without copying.
+     */
+    ///@{
+    smallint
+    read_smallint(const std::vector<byte> &buffer) {
+        return read_smallint(view(buffer));
+    }
+    integer
+    read_integer(const std::vector<byte> &buffer) {
+        return read_integer(view(buffer));
+    }
+    bigint
+    read_bigint(const std::vector<byte> &buffer) {
+        return read_bigint(view(buffer));
+    }
+    float
+    read_float(const std::vector<byte> &buffer) {
+        return read_float(view(buffer));
+    }
+    double
+    read_double(const std::vector<byte> &buffer) {
+        return read_double(view(buffer));
+    }
+    std::string
+    read_string(const std::vector<byte> &buffer) {
+        return read_string(view(buffer));
+    }
+    std::string
+    read_text_string(const std::vector<byte> &buffer) {
+        return read_text_string(view(buffer));
+    }
+    std::string
+    read_binary_string(const std::vector<byte> &buffer) {
+        return read_binary_string(view(buffer));
+    }
+    bool
+    read_bool(const std::vector<byte> &buffer) {
+        return read_bool(view(buffer));
+    }
+    std::vector<byte>
+    read_bytea(const std::vector<byte> &buffer) {
+        return read_bytea(view(buffer));
+    }
+    ///@}
+
+    /**
+     * @brief Builds a non-owning view over a byte vector
+     *
+     * @param buffer The buffer to view
+     * @return std::string_view View over the buffer contents
+     */
+    static std::string_view
+    view(const std::vector<byte> &buffer) {
+        return std::string_view(buffer.data(), buffer.size());
+    }
 };
 
 } // namespace qb::pg::detail
@@ -0,0 +1,638 @@
+/**
+ * @file pool.h
+ * @brief Core-local pool of PostgreSQL connections
+ *
+ * This file defines the Pool class, which keeps a fixed number of Database
+ * connections bound to the I/O loop of the thread that owns it (one pool
+ * per qb core), and routes each command to the least loaded connection:
+ *
+ * - Connections are warmed up front with connect(), then set up once
+ *   (typically to prepare the statements of the service)
+ * - Broken connections are recycled in place: commands not sent yet stay
+ *   queued and run on the new session
+ * - Under saturation, work can be handed to an overflow handler, e.g. one
+ *   forwarding it to the pool of another core
+ *
+ * Included by pgsql.h after the definition of Database.
+ *
+ * @see qb::pg::detail::Database
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Pool of database connections owned by one I/O thread
+ *
+ * A pool is not thread-safe: it must be created, connected and used from
+ * the thread running its I/O loop, so queries never cross threads on the
+ * hot path. Services running on several cores keep one pool per core.
+ *
+ * @tparam QB_IO_ I/O handler type of the connections
+ */
+template <typename QB_IO_>
+class Pool {
+public:
+    using database_type = Database<QB_IO_>;
+    /// Work routed to a connection
+    using task_type = std::function<void(Transaction &)>;
+    /// Setup run once on each connection after its first connection
+    using setup_type = std::function<void(database_type &)>;
+    /// Handler accepting work the pool is too busy for; returns false to refuse it
+    using overflow_type = std::function<bool(task_type &)>;
+    /// Callback receiving the plans of the slow queries
+    using plan_type = std::function<void(SlowQuery const &)>;
+
+private:
+    /**
+     * @brief Pooled connection and its setup state
+     */
+    struct Slot {
+        std::unique_ptr<database_type> db;           ///< Connection
+        bool                           ready{false}; ///< Setup already run
+    };
+
+    std::string       _conn_opts;   ///< Connection string
+    std::vector<Slot> _connections; ///< Pooled connections
+    setup_type        _setup;       ///< Connection setup
+    overflow_type     _overflow;    ///< Overflow handler
+    std::size_t _max_load{0};  ///< Queued commands per connection before overflowing
+    std::size_t _next{0};      ///< First connection examined by the next lookup
+    std::size_t _bulk{0};      ///< Trailing connections reserved to bulk work
+    bool        _broken{false}; ///< A connection was lost since the last recycle
+    std::chrono::milliseconds             _retry_interval{1000}; ///< Delay between reconnections
+    std::chrono::steady_clock::time_point _retry_at{}; ///< Earliest next reconnection
+    SlowQueryOptions _slow;          ///< Settings of the slow-query sampler
+    plan_type        _on_plan;       ///< Receives the plans of the slow queries
+    std::size_t      _explaining{0}; ///< Plans being captured
+    std::size_t      _dropped{0};    ///< Picked queries without an idle connection to explain them
+
+    /**
+     * @brief Finds the least loaded connected connection of a scheduling class
+     *
+     * Lookups start one connection further each time, so equally loaded
+     * connections share the work. Bulk work goes to the connections reserved
+     * by bulk_connections(), the other classes to the remaining ones; a class
+     * without any connected connection uses the whole pool.
+     *
+     * @param lane Scheduling class of the work
+     * @return database_type* Connection, or nullptr if none is connected
+     */
+    database_type *
+    least_loaded(priority lane = priority::normal) noexcept {
+        const auto count = _connections.size();
+        if (_bulk && _bulk < count) {
+            const auto from = lane == priority::bulk ? count - _bulk : 0;
+            if (auto db = least_loaded(from, lane == priority::bulk ? count : count - _bulk))
+                return db;
+        }
+        return least_loaded(0, count);
+    }
+
+    /**
+     * @brief Finds the least loaded connected connection in a range
+     *
+     * @param from First connection of the range
+     * @param to End of the range
+     * @return database_type* Connection, or nullptr if none is connected
+     */
+    database_type *
+    least_loaded(std::size_t from, std::size_t to) noexcept {
+        database_type *best  = nullptr;
+        const auto     count = to - from;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto &db = *_connections[from + (_next + i) % count].db;
+            if (db.is_connected() && (!best || db.load() < best->load())) {
+                best = &db;
+                if (!best->load())
+                    break;
+            }
+        }
+        if (count)
+            _next = (_next + 1) % count;
+        return best;
+    }
+
+    /**
+     * @brief Finds a connection with nothing queued, other than a given one
+     *
+     * @param busy Connection excluded from the lookup
+     * @return database_type* Idle connection, or nullptr if none is idle
+     */
+    database_type *
+    idle(database_type const &busy) noexcept {
+        for (auto &slot : _connections)
+            if (slot.db.get() != &busy && slot.db->is_connected() && !slot.db->load())
+                return slot.db.get();
+        return nullptr;
+    }
+
+    /**
+     * @brief Explains a query picked on a connection, on another idle one
+     *
+     * @param source Connection that ran the query
+     * @param query Picked query
+     */
+    void
+    explain_slow(database_type &source, SlowQuery &&query) {
+        auto target = _explaining < _slow.max_in_flight ? idle(source) : nullptr;
+        if (!target) {
+            ++_dropped;
+            return;
+        }
+        ++_explaining;
+        explain(*target, std::move(query), _slow.mode, [this](SlowQuery &plan) {
+            --_explaining;
+            if (_on_plan)
+                _on_plan(plan);
+        });
+    }
+
+    /**
+     * @brief Connects one pooled connection, running its setup the first time
+     *
+     * @param slot Connection to connect
+     * @return bool True if the connection is established
+     */
+    bool
+    open(Slot &slot) {
+        if (!slot.db->connect())
+            return false;
+        prepare(slot);
+        return true;
+    }
+
+    /**
+     * @brief Reconnects one pooled connection without blocking the I/O loop
+     *
+     * The connection rejoins the pool once its session is ready; a failure
+     * leaves it to the next recycle().
+     *
+     * @param slot Lost connection
+     */
+    void
+    reopen(Slot &slot) {
+        slot.db->async_connect([this, &slot](database_type &) { prepare(slot); },
+                               [this](database_type &, error::db_error const &) {
+                                   _broken = true;
+                               });
+    }
+
+    /**
+     * @brief Runs the setup of a connection the first time it is connected
+     *
+     * @param slot Connected connection
+     */
+    void
+    prepare(Slot &slot) {
+        if (!slot.ready && _setup)
+            _setup(*slot.db);
+        slot.ready = true;
+    }
+
+public:
+    /**
+     * @brief Constructs a pool without connecting it
+     *
+     * @param conn_opts Connection string of every pooled connection
+     * @param size Number of connections
+     */
+    Pool(std::string conn_opts, std::size_t size)
+        : _conn_opts(std::move(conn_opts)) {
+        _connections.reserve(size ? size : 1);
+        for (std::size_t i = 0; i < (size ? size : 1); ++i) {
+            auto db = std::make_unique<database_type>(_conn_opts);
+            db->on_disconnected([this](database_type &) { _broken = true; });
+            _connections.push_back({std::move(db)});
+        }
+    }
+
+    Pool(Pool const &)            = delete;
+    Pool &operator=(Pool const &) = delete;
+
+    /**
+     * @brief Sets the setup run on each connection once connected
+     *
+     * Runs once per connection: prepared statements are restored
+     * automatically when a connection is recycled.
+     *
+     * @param setup Callback receiving the connection
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    setup(setup_type setup) {
+        _setup = std::move(setup);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the handler receiving work under saturation
+     *
+     * When every connection has at least @p max_load queued commands,
+     * dispatch() offers the work to this handler before queueing it locally.
+     * The handler runs on the pool thread and must move the task to its
+     * destination (e.g. an event for the actor owning another pool).
+     *
+     * @param max_load Queued commands per connection that saturate it
+     * @param overflow Handler returning true if it accepted the task
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    overflow(std::size_t max_load, overflow_type overflow) {
+        _max_load = max_load;
+        _overflow = std::move(overflow);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the minimum delay between two reconnection attempts
+     *
+     * @param interval Delay between reconnections
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    retry_interval(std::chrono::milliseconds interval) noexcept {
+        _retry_interval = interval;
+        return *this;
+    }
+
+    /**
+     * @brief Reserves connections to bulk work
+     *
+     * Work dispatched with priority::bulk runs on the last @p count
+     * connections, all other work on the remaining ones, so batch jobs never
+     * queue ahead of latency-critical work. A class whose connections are
+     * all down falls back to the whole pool.
+     *
+     * @param count Connections reserved to bulk work, 0 to share them all
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    bulk_connections(std::size_t count) noexcept {
+        _bulk = count;
+        return *this;
+    }
+
+    /**
+     * @brief Sets the wait promoting a queued command one scheduling class
+     *
+     * @see Database::lane_aging
+     *
+     * @param aging Wait per class, 0 to never promote
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    lane_aging(std::chrono::milliseconds aging) noexcept {
+        for (auto &slot : _connections)
+            slot.db->lane_aging(aging);
+        return *this;
+    }
+
+    /**
+     * @brief Warms up the pool by connecting every connection
+     *
+     * Blocks on the I/O loop until each connection is established or has
+     * failed. Failed connections are retried by recycle().
+     *
+     * @return std::size_t Number of connections established
+     */
+    std::size_t
+    connect() {
+        std::size_t connected = 0;
+        for (auto &slot : _connections) {
+            if (slot.db->is_connected() || open(slot))
+                ++connected;
+            else
+                _broken = true;
+        }
+        return connected;
+    }
+
+    /**
+     * @brief Warms up the pool without blocking the I/O loop
+     *
+     * Opens every connection in parallel with Database::async_connect(),
+     * so the warm-up lasts one connection time instead of one per
+     * connection. Each connection runs its setup once connected; failed
+     * ones are retried by recycle().
+     *
+     * @param on_done Called once every connection is established or has
+     * failed, with the number of connections established
+     * @param timeout TCP connection timeout in seconds, 0 for none
+     */
+    void
+    async_connect(std::function<void(std::size_t)> on_done, double timeout = 0.) {
+        struct Warmup {
+            std::size_t                      connected{0};
+            std::size_t                      pending;
+            std::function<void(std::size_t)> done;
+        };
+        // One extra pending count, released below, so that connections
+        // completing immediately cannot finish the warm-up early
+        auto warmup     = std::make_shared<Warmup>();
+        warmup->pending = _connections.size() + 1;
+        warmup->done    = std::move(on_done);
+        auto settle     = [warmup]() {
+            if (!--warmup->pending && warmup->done)
+                warmup->done(warmup->connected);
+        };
+
+        for (auto &slot : _connections) {
+            if (slot.db->is_connected()) {
+                ++warmup->connected;
+                settle();
+                continue;
+            }
+            slot.db->async_connect(
+                [this, &slot, warmup, settle](database_type &) {
+                    prepare(slot);
+                    ++warmup->connected;
+                    settle();
+                },
+                [this, settle](database_type &, error::db_error const &) {
+                    _broken = true;
+                    settle();
+                },
+                timeout);
+        }
+        settle();
+    }
+
+    /**
+     * @brief Reconnects the connections that were lost
+     *
+     * Called by acquire() and dispatch() once a connection was lost, at
+     * most once per retry interval. Lost connections are reconnected with
+     * Database::async_connect(), so the I/O loop is never blocked: they
+     * rejoin the pool once their session is ready, and commands queued on
+     * them run then.
+     *
+     * @return std::size_t Number of connections still down, reconnecting ones included
+     */
+    std::size_t
+    recycle() {
+        const auto now = std::chrono::steady_clock::now();
+        if (!_broken || now < _retry_at)
+            return _broken ? broken() : 0;
+
+        _broken   = false;
+        _retry_at = now + _retry_interval;
+        for (auto &slot : _connections) {
+            if (slot.db->is_connected() || slot.db->is_connecting())
+                continue;
+            LOG_INFO("[pgsql] Recycling pooled connection");
+            reopen(slot);
+        }
+        return broken();
+    }
+
+    /**
+     * @brief Gets the connection that should run the next command
+     *
+     * @return database_type& Least loaded connected connection
+     * @throws error::connection_error if no connection is available
+     */
+    database_type &
+    acquire() {
+        if (_broken)
+            recycle();
+        auto db = least_loaded();
+        if (!db)
+            throw error::connection_error{"no pooled connection available"};
+        return *db;
+    }
+
+    /**
+     * @brief Routes work to a connection, or to the overflow handler
+     *
+     * @param task Work receiving the connection
+     * @return bool False if no connection is available and the overflow
+     * handler refused the task
+     */
+    bool
+    dispatch(task_type task) {
+        return dispatch(std::move(task), priority::normal);
+    }
+
+    /**
+     * @brief Routes work of a scheduling class to a connection
+     *
+     * The work is queued with Database::prioritize() on a connection of its
+     * class, see bulk_connections(). The overflow handler receives the task
+     * alone and chooses the class it runs with.
+     *
+     * @param task Work receiving the connection
+     * @param lane Scheduling class of the work
+     * @return bool False if no connection is available and the overflow
+     * handler refused the task
+     */
+    bool
+    dispatch(task_type task, priority lane) {
+        if (_broken)
+            recycle();
+        auto db = least_loaded(lane);
+        if (_overflow && (!db || (_max_load && db->load() >= _max_load)) &&
+            _overflow(task))
+            return true;
+        if (!db)
+            return false;
+        if (lane == priority::normal)
+            task(*db);
+        else
+            db->prioritize(lane, task);
+        return true;
+    }
+
+    /**
+     * @brief Executes a query on the least loaded connection
+     *
+     * Accepts the same arguments as Transaction::execute().
+     *
+     * @return Transaction& Connection the query was queued on
+     */
+    template <typename... Args>
+    Transaction &
+    execute(Args &&...args) {
+        return acquire().execute(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Begins a transaction on the least loaded connection
+     *
+     * Accepts the same arguments as Transaction::begin().
+     *
+     * @return Transaction& Connection the transaction was queued on
+     */
+    template <typename... Args>
+    Transaction &
+    begin(Args &&...args) {
+        return acquire().begin(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Visits every pooled connection
+     *
+     * @tparam Func Type of visitor, void(database_type &)
+     * @param func Visitor invoked for each connection
+     */
+    template <typename Func>
+    void
+    for_each(Func &&func) {
+        for (auto &slot : _connections)
+            func(*slot.db);
+    }
+
+    /**
+     * @brief Gets the number of pooled connections
+     *
+     * @return std::size_t Pool size
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept {
+        return _connections.size();
+    }
+
+    /**
+     * @brief Gets the number of connections currently down
+     *
+     * @return std::size_t Disconnected connections
+     */
+    [[nodiscard]] std::size_t
+    broken() const noexcept {
+        std::size_t down = 0;
+        for (auto const &slot : _connections)
+            down += !slot.db->is_connected();
+        return down;
+    }
+
+    /**
+     * @brief Gets the number of commands queued on all connections
+     *
+     * @return std::size_t Pending top-level commands
+     */
+    [[nodiscard]] std::size_t
+    load() const noexcept {
+        std::size_t total = 0;
+        for (auto const &slot : _connections)
+            total += slot.db->load();
+        return total;
+    }
+
+    /**
+     * @brief Shares a statement catalog with every connection
+     *
+     * Connections, including recycled ones, prepare the catalog statements
+     * in one flight when their session starts. Set it before connect() so the
+     * first sessions use it too.
+     *
+     * @param catalog Catalog shared by the connections
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    catalog(std::shared_ptr<StatementCatalog> catalog) {
+        for (auto &slot : _connections)
+            slot.db->catalog(catalog);
+        return *this;
+    }
+
+    /**
+     * @brief Enables or disables the collection of metrics on every connection
+     *
+     * @param enable True to collect metrics
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    metrics(bool enable) {
+        for (auto &slot : _connections)
+            slot.db->metrics(enable);
+        return *this;
+    }
+
+    /**
+     * @brief Gets the metrics of the pool
+     *
+     * @return QueryMetrics Merge of the metrics of every connection
+     */
+    [[nodiscard]] QueryMetrics
+    metrics() const {
+        QueryMetrics total;
+        for (auto const &slot : _connections)
+            total.merge(slot.db->metrics());
+        return total;
+    }
+
+    /**
+     * @brief Captures the plans of the slow queries of every connection
+     *
+     * Enables the collection of metrics. Each query picked by the sampler
+     * of a connection is explained on another pooled connection with
+     * nothing queued, never on the connection that ran it; when no
+     * connection is idle, or max_in_flight plans are being captured, the
+     * query is dropped and counted.
+     *
+     * @param options Threshold, sampling rate and plan to capture
+     * @param on_plan Callback receiving each query with its plan, empty to stop sampling
+     * @return Pool& Reference to this pool for chaining
+     */
+    Pool &
+    slow_queries(SlowQueryOptions const &options, plan_type on_plan) {
+        _slow    = options;
+        _on_plan = std::move(on_plan);
+        for (auto &slot : _connections) {
+            if (_on_plan)
+                slot.db->slow_queries(options, [this](database_type &source, SlowQuery &&query) {
+                    explain_slow(source, std::move(query));
+                });
+            else
+                slot.db->slow_queries(options, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Gets the number of picked queries left unexplained
+     *
+     * @return std::size_t Queries dropped for lack of an idle connection
+     */
+    [[nodiscard]] std::size_t
+    dropped_samples() const noexcept {
+        return _dropped;
+    }
+
+    /**
+     * @brief Disconnects every connection
+     *
+     * Connections are not recycled afterwards until connect() is called.
+     */
+    void
+    disconnect() {
+        for (auto &slot : _connections)
+            if (slot.db->is_connected())
+                slot.db->disconnect();
+        _broken = false;
+    }
+};
+
+} // namespace qb::pg::detail
@@ -25,13 +25,16 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <exception>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <qb/system/endian.h>
 #include <sstream>
 
+#include "./byte_order.h"
 #include "./protocol.h"
 #include "./protocol_io_traits.h"
 
@@ -47,13 +50,13 @@ namespace detail {
  */
 namespace {
 /** @brief Set of allowed message tags for frontend (client) */
-tag_set_type FRONTEND_COMMANDS{empty_tag,         bind_tag,      close_tag,
+constexpr tag_set_type FRONTEND_COMMANDS{empty_tag,         bind_tag,      close_tag,
                                copy_data_tag,     copy_done_tag, copy_fail_tag,
                                describe_tag,      execute_tag,   flush_tag,
                                function_call_tag, parse_tag,     password_message_tag,
                                query_tag,         sync_tag,      terminate_tag};
 /** @brief Set of allowed message tags for backend (server) */
-tag_set_type BACKEND_COMMANDS{
+constexpr tag_set_type BACKEND_COMMANDS{
     authentication_tag,     backend_key_data_tag,   bind_complete_tag,
     close_complete_tag,     command_complete_tag,   copy_data_tag,
     copy_done_tag,          copy_in_response_tag,   copy_out_response_tag,
@@ -105,10 +108,20 @@ message::message()
 message::message(message_tag tag)
     : payload(5, 0)
     , packed_(false) {
-    // TODO Check the tag
+    assert(FRONTEND_COMMANDS.contains(tag) && "Not a frontend message tag");
     payload[0] = (char) tag;
 }
 
+/**
+ * @brief Construct message from already encoded frames
+ *
+ * @param data First byte of the encoded frames
+ * @param size Total size of the frames
+ */
+message::message(const char *data, std::size_t size)
+    : payload(data, data + size)
+    , packed_(true) {}
+
 /**
  * @brief Move constructor
  *
@@ -116,7 +129,7 @@ message::message(message_tag tag)
  */
 message::message(message &&rhs)
     : payload{::std::move(rhs.payload)}
-    , curr_{rhs.curr_}
+    , reader_{rhs.reader_}
     , packed_{rhs.packed_} {}
 
 /**
@@ -208,7 +221,7 @@ message::buffer_size() const {
  */
 message::const_iterator
 message::input() const {
-    return curr_;
+    return payload.cbegin() + (reader_.input() - payload.data());
 }
 
 /**
@@ -224,15 +237,13 @@ message::output() {
 /**
  * @brief Move the read iterator to the beginning of actual payload
  *
- * Positions the read cursor after the message header.
+ * Rebinds the read cursor to the current payload and positions it after
+ * the message header.
  */
 void
 message::reset_read() {
-    if (payload.size() <= 5) {
-        curr_ = payload.end();
-    } else {
-        curr_ = payload.begin() + 5;
-    }
+    reader_ = message_view(payload.data(), payload.size());
+    reader_.reset_read();
 }
 
 /**
@@ -243,11 +254,7 @@ message::reset_read() {
  */
 bool
 message::read(char &c) {
-    if (curr_ != payload.end()) {
-        c = *curr_++;
-        return true;
-    }
-    return false;
+    return reader_.read(c);
 }
 
 /**
@@ -261,11 +268,9 @@ template <typename T>
 void
 write_int(message::buffer_type &payload, T val) {
     // Manual conversion instead of using protocol_write
-    T              converted = qb::endian::to_big_endian(val);
-    unsigned char *p         = reinterpret_cast<unsigned char *>(&converted);
-    for (size_t i = 0; i < sizeof(T); ++i) {
-        payload.push_back(p[i]);
-    }
+    T           converted = qb::endian::to_big_endian(val);
+    const char *p         = reinterpret_cast<const char *>(&converted);
+    payload.insert(payload.end(), p, p + sizeof(T));
 }
 
 /**
@@ -276,12 +281,7 @@ write_int(message::buffer_type &payload, T val) {
  */
 bool
 message::read(smallint &val) {
-    const_iterator c =
-        io::protocol_read<pg::protocol_data_format::Binary>(curr_, payload.cend(), val);
-    if (curr_ == c)
-        return false;
-    curr_ = c;
-    return true;
+    return reader_.read(val);
 }
 
 /**
@@ -292,12 +292,7 @@ message::read(smallint &val) {
  */
 bool
 message::read(integer &val) {
-    const_iterator c =
-        io::protocol_read<pg::protocol_data_format::Binary>(curr_, payload.cend(), val);
-    if (curr_ == c)
-        return false;
-    curr_ = c;
-    return true;
+    return reader_.read(val);
 }
 
 /**
@@ -308,12 +303,7 @@ message::read(integer &val) {
  */
 bool
 message::read(std::string &val) {
-    const_iterator c =
-        io::protocol_read<pg::protocol_data_format::Text>(curr_, payload.cend(), val);
-    if (curr_ == c)
-        return false;
-    curr_ = c;
-    return true;
+    return reader_.read(val);
 }
 
 /**
@@ -325,103 +315,40 @@ message::read(std::string &val) {
  */
 bool
 message::read(std::string &val, size_t n) {
-    if (payload.end() - curr_ >= ::std::make_signed<size_t>::type(n)) {
-        for (size_t i = 0; i < n; ++i) {
-            val.push_back(*curr_++);
-        }
-        return true;
-    }
-    return false;
+    return reader_.read(val, n);
 }
 
 /**
  * @brief Read field description from the message buffer
  *
- * Reads a complete field description structure from the message.
- *
  * @param fd Reference to field description to store the result
  * @return true if the operation was successful
  */
 bool
 message::read(field_description &fd) {
-    field_description tmp;
-    tmp.max_size = 0;
-    integer  type_oid;
-    smallint fmt;
-    if (read(tmp.name) && read(tmp.table_oid) && read(tmp.attribute_number) &&
-        read(type_oid) && read(tmp.type_size) && read(tmp.type_mod) && read(fmt)) {
-        tmp.type_oid    = static_cast<oid>(type_oid);
-        tmp.format_code = static_cast<protocol_data_format>(fmt);
-        fd              = tmp;
-        return true;
-    }
-    return false;
+    return reader_.read(fd);
 }
 
 /**
  * @brief Read data row from the message buffer
  *
- * Parses a data row message and populates the row_data structure.
- *
  * @param row Reference to row_data to store the result
  * @return true if the operation was successful
  */
 bool
 message::read(row_data &row) {
-    size_t len = length();
-    assert(len == size() && "Invalid message length");
-    if (len < sizeof(integer) + sizeof(smallint)) {
-        std::cerr << "Size of invalid data row message is " << len << "\n";
-        assert(len >= sizeof(integer) + sizeof(smallint) && "Invalid data row message");
-    }
-    smallint col_count(0);
-    if (read(col_count)) {
-        row_data tmp;
-        tmp.offsets.reserve(col_count);
-        size_t expected_sz = len - sizeof(integer) * (col_count + 1) - sizeof(int16_t);
-        tmp.data.reserve(expected_sz);
-        for (int16_t i = 0; i < col_count; ++i) {
-            tmp.offsets.push_back(tmp.data.size());
-            integer col_size(0);
-            if (!read(col_size))
-                return false;
-            if (col_size == -1) {
-                tmp.null_map.insert(i);
-            } else if (col_size > 0) {
-                const_iterator in  = curr_;
-                auto           out = std::back_inserter(tmp.data);
-                for (; in != curr_ + col_size; ++in) {
-                    *out++ = *in;
-                }
-                curr_ = in;
-            }
-        }
-        row.swap(tmp);
-        return true;
-    }
-    return false;
+    return reader_.read(row);
 }
 
 /**
  * @brief Read a notice or error message from the message buffer
  *
- * Parses a notice or error message with field codes and values.
- *
  * @param notice Reference to notice_message to store the result
  * @return true if the operation was successful
  */
 bool
 message::read(notice_message &notice) {
-    char code(0);
-    while (read(code) && code) {
-        if (notice.has_field(code)) {
-            read(notice.field(code));
-        } else {
-            std::string fval;
-            read(fval);
-        }
-    }
-    return true;
+    return reader_.read(notice);
 }
 
 /**
@@ -463,9 +390,8 @@ message::write(integer v) {
  */
 void
 message::write(std::string const &s) {
-    // Copy string directly instead of using protocol_write
-    std::copy(s.begin(), s.end(), std::back_inserter(payload));
-    payload.push_back(0);
+    // One block copy, terminator included
+    payload.insert(payload.end(), s.c_str(), s.c_str() + s.size() + 1);
 }
 
 /**
@@ -477,8 +403,7 @@ message::write(std::string const &s) {
  */
 void
 message::write_sv(std::string_view const &s) {
-    // Copy string view directly instead of using protocol_write
-    std::copy(s.begin(), s.end(), std::back_inserter(payload));
+    payload.insert(payload.end(), s.begin(), s.end());
 }
 
 /**
@@ -492,9 +417,328 @@ void
 message::pack(message const &m) {
     buffer(); // to write the length, if hasn't been packed already
     packed_ = true;
-    payload.reserve(payload.size() + m.payload.size());
     const_range r = m.buffer();
-    std::copy(r.first, r.second, std::back_inserter(payload));
+    payload.insert(payload.end(), r.first, r.second);
+}
+
+//----------------------------------------------------------------------------
+// message_view implementation
+//----------------------------------------------------------------------------
+
+/**
+ * @brief Construct a view over a complete message
+ *
+ * @param data Pointer to the tag byte of the message
+ * @param size Total size of the message including the tag and length
+ */
+message_view::message_view(const char *data, size_t size)
+    : begin_(data)
+    , end_(data + size)
+    , curr_(data + size) {}
+
+/**
+ * @brief Get the message length encoded in the header
+ *
+ * @return size_type Length in bytes
+ */
+message_view::size_type
+message_view::length() const {
+    if (buffer_size() >= sizeof(integer) + sizeof(byte))
+        return load_be<size_type>(begin_ + 1);
+    return 0;
+}
+
+/**
+ * @brief Get size of payload, minus 1 (for the tag)
+ *
+ * @return size_t Payload size in bytes
+ */
+size_t
+message_view::size() const {
+    return begin_ == end_ ? 0 : buffer_size() - 1;
+}
+
+/**
+ * @brief Get full size of the viewed buffer including the tag
+ *
+ * @return size_t Total buffer size in bytes
+ */
+size_t
+message_view::buffer_size() const {
+    return static_cast<size_t>(end_ - begin_);
+}
+
+/**
+ * @brief Get pointer to the first byte of the message
+ *
+ * @return const char* Start of the viewed buffer
+ */
+const char *
+message_view::data() const {
+    return begin_;
+}
+
+/**
+ * @brief Get pointer to current read position
+ *
+ * @return const char* Current read position
+ */
+const char *
+message_view::input() const {
+    return curr_;
+}
+
+/**
+ * @brief Copy the viewed bytes into an owning message
+ *
+ * @return message Owning copy with the read position reset
+ */
+message
+message_view::to_message() const {
+    message m;
+    auto    out = m.output();
+    std::copy(begin_, end_, out);
+    m.reset_read();
+    return m;
+}
+
+/**
+ * @brief Move the read position to the beginning of actual payload
+ */
+void
+message_view::reset_read() {
+    if (buffer_size() <= 5) {
+        curr_ = end_;
+    } else {
+        curr_ = begin_ + 5;
+    }
+}
+
+/**
+ * @brief Read a byte from the viewed buffer
+ *
+ * @param c Reference to store the read character
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(char &c) {
+    if (curr_ != end_) {
+        c = *curr_++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Read a two-byte integer from the viewed buffer
+ *
+ * @param val Reference to store the read value
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(smallint &val) {
+    if (end_ - curr_ < static_cast<std::ptrdiff_t>(sizeof(smallint)))
+        return false;
+    val = load_be<smallint>(curr_);
+    curr_ += sizeof(smallint);
+    return true;
+}
+
+/**
+ * @brief Read a 4-byte integer from the viewed buffer
+ *
+ * @param val Reference to store the read value
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(integer &val) {
+    if (end_ - curr_ < static_cast<std::ptrdiff_t>(sizeof(integer)))
+        return false;
+    val = load_be<integer>(curr_);
+    curr_ += sizeof(integer);
+    return true;
+}
+
+/**
+ * @brief Read a null-terminated string from the viewed buffer
+ *
+ * @param val Reference to store the read string
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(std::string &val) {
+    if (curr_ == end_)
+        return false;
+    const char *c = std::find(curr_, end_, '\0');
+    val.assign(curr_, c);
+    curr_ = c == end_ ? end_ : c + 1;
+    return true;
+}
+
+/**
+ * @brief Read n bytes from the viewed buffer to the string
+ *
+ * @param val Reference to store the read string
+ * @param n Number of bytes to read
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(std::string &val, size_t n) {
+    if (static_cast<size_t>(end_ - curr_) >= n) {
+        val.append(curr_, n);
+        curr_ += n;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Get a view over a null-terminated string of the viewed buffer
+ *
+ * @param val Reference to store the view, without the terminator
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(std::string_view &val) {
+    if (curr_ == end_)
+        return false;
+    const char *c = std::find(curr_, end_, '\0');
+    val           = std::string_view(curr_, static_cast<size_t>(c - curr_));
+    curr_         = c == end_ ? end_ : c + 1;
+    return true;
+}
+
+/**
+ * @brief Get a view over the next n bytes of the viewed buffer
+ *
+ * @param val Reference to store the view
+ * @param n Number of bytes to read
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(std::string_view &val, size_t n) {
+    if (static_cast<size_t>(end_ - curr_) >= n) {
+        val = std::string_view(curr_, n);
+        curr_ += n;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Read field description from the viewed buffer
+ *
+ * Reads a complete field description structure from the message.
+ *
+ * @param fd Reference to field description to store the result
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(field_description &fd) {
+    // Table OID, attribute number, type OID, size, modifier and format code
+    constexpr size_t fixed_size = 3 * sizeof(integer) + 3 * sizeof(smallint);
+
+    // The name and the fixed part are checked once, then read in place
+    const auto *name_end =
+        static_cast<const char *>(std::memchr(curr_, '\0', static_cast<size_t>(end_ - curr_)));
+    if (!name_end || static_cast<size_t>(end_ - name_end) - 1 < fixed_size)
+        return false;
+    const char *p = name_end + 1;
+    fd.name.assign(curr_, name_end);
+    fd.table_oid        = load_be<integer>(p);
+    fd.attribute_number = load_be<smallint>(p + 4);
+    fd.type_oid         = static_cast<oid>(load_be<integer>(p + 6));
+    fd.type_size        = load_be<smallint>(p + 10);
+    fd.type_mod         = load_be<integer>(p + 12);
+    fd.format_code      = static_cast<protocol_data_format>(load_be<smallint>(p + 16));
+    fd.max_size         = 0;
+    curr_               = p + fixed_size;
+    return true;
+}
+
+/**
+ * @brief Read data row from the viewed buffer
+ *
+ * Parses a data row message and populates the row_data structure.
+ *
+ * @param row Reference to row_data to store the result
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(row_data &row) {
+    size_t len = length();
+    assert(len == size() && "Invalid message length");
+    if (len < sizeof(integer) + sizeof(smallint)) {
+        std::cerr << "Size of invalid data row message is " << len << "\n";
+        assert(len >= sizeof(integer) + sizeof(smallint) && "Invalid data row message");
+    }
+    smallint col_count(0);
+    if (!read(col_count) || col_count < 0)
+        return false;
+
+    row_data tmp;
+    tmp.offsets.reserve(static_cast<size_t>(col_count));
+    // Values never exceed the rest of the message
+    tmp.data.reserve(available());
+    const char *p = curr_;
+    for (smallint i = 0; i < col_count; ++i) {
+        if (end_ - p < static_cast<std::ptrdiff_t>(sizeof(integer)))
+            return false;
+        const integer col_size = load_be<integer>(p);
+        p += sizeof(integer);
+        tmp.offsets.push_back(tmp.data.size());
+        if (col_size == -1) {
+            tmp.null_map.insert(i);
+        } else if (col_size > 0) {
+            if (end_ - p < col_size)
+                return false;
+            tmp.data.insert(tmp.data.end(), p, p + col_size);
+            p += col_size;
+        }
+    }
+    curr_ = p;
+    row.swap(tmp);
+    return true;
+}
+
+/**
+ * @brief Read a notice or error message from the viewed buffer
+ *
+ * Parses a notice or error message with field codes and values.
+ *
+ * @param notice Reference to notice_message to store the result
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(notice_message &notice) {
+    char code(0);
+    while (read(code) && code) {
+        if (notice.has_field(code)) {
+            read(notice.field(code));
+        } else {
+            std::string fval;
+            read(fval);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Read the fields of a notice or error message as views
+ *
+ * @param notice Reference to notice_view to store the result
+ * @return true if the operation was successful
+ */
+bool
+message_view::read(notice_view &notice) {
+    char code(0);
+    while (read(code) && code) {
+        std::string_view value;
+        if (!read(value))
+            return false;
+        notice.set(code, value);
+    }
+    return true;
 }
 
 //----------------------------------------------------------------------------
@@ -580,7 +824,8 @@ row_data::field_buffer_bounds(size_type index) const {
 field_buffer
 row_data::field_data(size_type index) const {
     data_buffer_bounds bounds = field_buffer_bounds(index);
-    return field_buffer(bounds.first, bounds.second);
+    const byte        *first  = data.data() + (bounds.first - data.begin());
+    return field_buffer(first, first + (bounds.second - bounds.first));
 }
 
 //----------------------------------------------------------------------------
@@ -653,6 +898,170 @@ notice_message::field(char code) {
  * @param msg Notice message to output
  * @return std::ostream& Reference to the output stream
  */
+//----------------------------------------------------------------------------
+// pipe_writer implementation
+//----------------------------------------------------------------------------
+
+/**
+ * @brief Construct a writer appending to a pipe
+ *
+ * @param out Output pipe of the connection
+ */
+pipe_writer::pipe_writer(pipe_type &out) noexcept
+    : out_(out) {}
+
+/**
+ * @brief Start a message
+ *
+ * The offset is taken from the front of the pipe, which stays valid if the
+ * pipe reallocates while the message grows.
+ *
+ * @param tag Message type tag
+ */
+void
+pipe_writer::begin(message_tag tag) {
+    start_ = out_.size();
+    ++messages_;
+    char *p = out_.allocate_back(sizeof(char) + sizeof(integer));
+    p[0]    = static_cast<char>(tag);
+}
+
+/**
+ * @brief Terminate the current message by writing its length
+ */
+void
+pipe_writer::end() {
+    const integer len =
+        qb::endian::to_big_endian(static_cast<integer>(out_.size() - start_ - 1));
+    std::memcpy(out_.begin() + start_ + 1, &len, sizeof(len));
+}
+
+/**
+ * @brief Write a simple Query message
+ *
+ * @param sql SQL text, without terminator
+ */
+void
+pipe_writer::query(std::string_view sql) {
+    begin(query_tag);
+    write_sv(sql);
+    write('\0');
+    end();
+}
+
+namespace {
+
+// Fixed frontend messages, encoded once: tag, big-endian length, payload
+constexpr char sync_frame[]    = {'S', 0, 0, 0, 4};
+constexpr char flush_frame[]   = {'H', 0, 0, 0, 4};
+constexpr char execute_frame[] = {'E', 0, 0, 0, 9, 0, 0, 0, 0, 0};
+
+} // namespace
+
+/**
+ * @brief Write a Sync message
+ */
+void
+pipe_writer::sync() {
+    ++messages_;
+    out_.put(sync_frame, sizeof(sync_frame));
+}
+
+/**
+ * @brief Write a Flush message
+ */
+void
+pipe_writer::flush() {
+    ++messages_;
+    out_.put(flush_frame, sizeof(flush_frame));
+}
+
+/**
+ * @brief Write an Execute of the unnamed portal, without row limit
+ */
+void
+pipe_writer::execute() {
+    ++messages_;
+    out_.put(execute_frame, sizeof(execute_frame));
+}
+
+/**
+ * @brief Copy a prebuilt message to the pipe
+ *
+ * @param m Message to send
+ */
+void
+pipe_writer::put(message const &m) {
+    const auto r = m.buffer();
+    ++messages_;
+    if (r.first != r.second)
+        out_.put(&*r.first, static_cast<std::size_t>(r.second - r.first));
+}
+
+/**
+ * @brief Get the number of messages written so far
+ *
+ * @return std::size_t Messages started or copied by this writer
+ */
+std::size_t
+pipe_writer::messages() const noexcept {
+    return messages_;
+}
+
+/**
+ * @brief Write a char
+ *
+ * @param c The char to write
+ */
+void
+pipe_writer::write(char c) {
+    *out_.allocate_back(1) = c;
+}
+
+/**
+ * @brief Write a 2-byte integer in network byte order
+ *
+ * @param v The integer to write
+ */
+void
+pipe_writer::write(smallint v) {
+    v = qb::endian::to_big_endian(v);
+    std::memcpy(out_.allocate_back(sizeof(v)), &v, sizeof(v));
+}
+
+/**
+ * @brief Write a 4-byte integer in network byte order
+ *
+ * @param v The integer to write
+ */
+void
+pipe_writer::write(integer v) {
+    v = qb::endian::to_big_endian(v);
+    std::memcpy(out_.allocate_back(sizeof(v)), &v, sizeof(v));
+}
+
+/**
+ * @brief Write a string including terminating '\0'
+ *
+ * @param s The string to write
+ */
+void
+pipe_writer::write(std::string const &s) {
+    write_sv(s);
+    write('\0');
+}
+
+/**
+ * @brief Write raw bytes, without terminator
+ *
+ * @param s The bytes to write
+ */
+void
+pipe_writer::write_sv(std::string_view const &s) {
+    if (!s.empty())
+        out_.put(s.data(), s.size());
+}
+
 std::ostream &
 operator<<(std::ostream &out, notice_message const &msg) {
     std::ostream::sentry s(out);
@@ -666,6 +1075,44 @@ operator<<(std::ostream &out, notice_message const &msg) {
     return out;
 }
 
+/**
+ * @brief Copy the fields of a notice view into an owning notice message
+ *
+ * @return notice_message Notice holding a copy of every known field
+ */
+notice_message
+notice_view::to_notice() const {
+    notice_message notice;
+    for (auto const &f : notice_fields) {
+        const auto value = field(f.first);
+        if (!value.empty())
+            notice.*f.second = std::string(value);
+    }
+    return notice;
+}
+
+/**
+ * @brief Output stream operator for notice_view
+ *
+ * Formats the fields straight from the message, without copying them.
+ *
+ * @param out Output stream
+ * @param msg Notice view to output
+ * @return std::ostream& Reference to the output stream
+ */
+std::ostream &
+operator<<(std::ostream &out, notice_view const &msg) {
+    std::ostream::sentry s(out);
+    if (s) {
+        out << "severity: " << msg.severity() << " SQL code: " << msg.sqlstate()
+            << " message: '" << msg.message() << "'";
+        if (!msg.detail().empty()) {
+            out << " detail: '" << msg.detail() << "'";
+        }
+    }
+    return out;
+}
+
 } // namespace detail
 } // namespace pg
 } // namespace qb
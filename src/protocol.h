@@ -32,11 +32,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <iosfwd>
 #include <iterator>
+#include <qb/system/allocator/pipe.h>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "common.h"
 
@@ -95,7 +100,50 @@ enum message_tag {
     sync_tag             = 'S', /**< (F) Synchronize command sequence */
     terminate_tag        = 'X', /**< (F) Terminate session */
 };
-typedef std::set<message_tag> tag_set_type;
+
+/**
+ * @brief Constant set of message tags, one bit per tag value
+ */
+class tag_set {
+    std::array<std::uint64_t, 4> _bits{}; ///< Bit of each of the 256 tag values
+
+public:
+    /**
+     * @brief Constructs a set from its tags
+     *
+     * @param tags Tags of the set
+     */
+    constexpr tag_set(std::initializer_list<message_tag> tags) noexcept {
+        for (const auto tag : tags) {
+            const auto value = static_cast<unsigned char>(tag);
+            _bits[value / 64] |= std::uint64_t(1) << (value % 64);
+        }
+    }
+
+    /**
+     * @brief Checks whether a tag belongs to the set
+     *
+     * @param tag Message tag
+     * @return bool True if the tag is in the set
+     */
+    [[nodiscard]] constexpr bool
+    contains(message_tag tag) const noexcept {
+        const auto value = static_cast<unsigned char>(tag);
+        return (_bits[value / 64] >> (value % 64)) & 1;
+    }
+
+    /**
+     * @brief Counts the occurrences of a tag, like std::set::count
+     *
+     * @param tag Message tag
+     * @return std::size_t 1 if the tag is in the set, 0 otherwise
+     */
+    [[nodiscard]] constexpr std::size_t
+    count(message_tag tag) const noexcept {
+        return contains(tag) ? 1 : 0;
+    }
+};
+typedef tag_set tag_set_type;
 
 /**
  * @brief Authentication methods used by PostgreSQL
@@ -130,6 +178,198 @@ enum auth_states {
 
 struct row_data;
 struct notice_message;
+class notice_view;
+class message;
+
+/**
+ * @brief Non-owning, read-only view over an on-the-wire backend message
+ *
+ * The view points at bytes owned by someone else (typically the connection
+ * input pipe) and starts at the tag byte. It exposes the same read interface
+ * as message so handlers can decode the payload in place, without first
+ * copying it into a heap-allocated buffer.
+ *
+ * A view is only valid as long as the underlying storage is. When a handler
+ * needs to keep the message beyond the callback it was passed to, it must
+ * call to_message() to get an owning copy.
+ */
+class message_view {
+public:
+    /** Length type for the message */
+    typedef uinteger size_type;
+
+public:
+    /**
+     * @brief Construct an empty view
+     */
+    message_view() = default;
+
+    /**
+     * @brief Construct a view over a complete message
+     *
+     * @param data Pointer to the tag byte of the message
+     * @param size Total size of the message including the tag and length
+     */
+    message_view(const char *data, size_t size);
+
+    /**
+     * @brief Get the message tag
+     *
+     * @return message_tag PostgreSQL message tag
+     */
+    message_tag
+    tag() const {
+        return begin_ != end_ ? static_cast<message_tag>(*begin_) : empty_tag;
+    }
+
+    /**
+     * @brief Get the message length encoded in payload
+     *
+     * @return size_type Length in bytes (bytes 1-4)
+     */
+    size_type length() const;
+
+    /**
+     * @brief Get size of payload, minus 1 (for the tag)
+     *
+     * @return size_t Payload size in bytes
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of bytes after the read position
+     *
+     * Decoders check the bounds of a whole section against it once, then
+     * read it through input() and skip it with advance().
+     *
+     * @return size_t Unread bytes
+     */
+    size_t
+    available() const noexcept {
+        return static_cast<size_t>(end_ - curr_);
+    }
+
+    /**
+     * @brief Move the read position forward
+     *
+     * @param n Number of bytes read, at most available()
+     */
+    void
+    advance(size_t n) noexcept {
+        curr_ += n;
+    }
+
+    /**
+     * @brief Get full size of the viewed buffer including the tag
+     *
+     * @return size_t Total buffer size in bytes
+     */
+    size_t buffer_size() const;
+
+    /**
+     * @brief Get pointer to the first byte (the tag) of the message
+     *
+     * @return const char* Start of the viewed buffer
+     */
+    const char *data() const;
+
+    /**
+     * @brief Get pointer to current read position
+     *
+     * @return const char* Current read position
+     */
+    const char *input() const;
+
+    /**
+     * @brief Copy the viewed bytes into an owning message
+     *
+     * Use this when the message has to outlive the handler that received it.
+     *
+     * @return message Owning copy with the read position reset
+     */
+    message to_message() const;
+
+    //@{
+    /** @name Stream read interface */
+    /**
+     * Move the read position to the beginning of actual payload
+     */
+    void reset_read();
+
+    /**
+     * @brief Read a byte from the message buffer
+     * @return true if the operation was successful
+     */
+    bool read(char &);
+
+    /**
+     * @brief Read a 2-byte integer from the message buffer
+     * @return true if the operation was successful
+     */
+    bool read(smallint &);
+
+    /**
+     * @brief Read a 4-byte integer from the message buffer
+     * @return true if the operation was successful
+     */
+    bool read(integer &);
+
+    /**
+     * @brief Read a null-terminated string from the message buffer
+     * @return true if the operation was successful
+     */
+    bool read(std::string &);
+
+    /**
+     * @brief Read n bytes from message to the string
+     * @param n Number of bytes to read
+     * @return true if the operation was successful
+     */
+    bool read(std::string &, size_t n);
+
+    /**
+     * @brief Get a view over the next n bytes and move past them
+     * @param n Number of bytes to read
+     * @return true if the operation was successful
+     */
+    bool read(std::string_view &, size_t n);
+
+    /**
+     * @brief Get a view over a null-terminated string and move past it
+     * @return true if the operation was successful
+     */
+    bool read(std::string_view &);
+
+    /**
+     * @brief Read field description from the message buffer
+     * @return true if the operation was successful
+     */
+    bool read(field_description &fd);
+
+    /**
+     * @brief Read data row from the message buffer
+     * @return true if the operation was successful
+     */
+    bool read(row_data &row);
+
+    /**
+     * @brief Read notice message from the message buffer
+     * @return true if the operation was successful
+     */
+    bool read(notice_message &notice);
+
+    /**
+     * @brief Read the fields of a notice message without copying them
+     * @return true if the operation was successful
+     */
+    bool read(notice_view &notice);
+    //@}
+
+private:
+    const char *begin_ = nullptr; ///< First byte (tag) of the message
+    const char *end_   = nullptr; ///< Past-the-end of the message
+    const char *curr_  = nullptr; ///< Current read position
+};
 
 /**
  * @brief On-the-wire message of PostgreSQL protocol v3
@@ -171,6 +411,16 @@ public:
      */
     explicit message(message_tag tag);
 
+    /**
+     * @brief Construct message from already encoded frames
+     *
+     * The frames, e.g. written by pipe_writer, are sent as is.
+     *
+     * @param data First byte of the encoded frames
+     * @param size Total size of the frames
+     */
+    message(const char *data, std::size_t size);
+
     /**
      * @brief Message is noncopyable
      */
@@ -355,13 +605,85 @@ public:
 
 private:
     mutable buffer_type payload;
-    const_iterator      curr_;
+    message_view        reader_; ///< Read cursor over payload
     bool                packed_;
 };
 
 /** @brief Shared pointer to message */
 typedef std::shared_ptr<message> message_ptr;
 
+/**
+ * @brief Encoder of frontend messages straight into the output pipe
+ *
+ * Offers the write interface of message, but appends in place to the
+ * transport buffer: begin() writes the tag and a placeholder length,
+ * end() back-patches the length. Messages built this way are never
+ * copied before reaching the socket.
+ */
+class pipe_writer {
+public:
+    typedef qb::allocator::pipe<char> pipe_type;
+
+    /**
+     * @brief Construct a writer appending to a pipe
+     * @param out Output pipe of the connection
+     */
+    explicit pipe_writer(pipe_type &out) noexcept;
+
+    /**
+     * Start a message: writes the tag and reserves the length
+     * @param tag Message type tag
+     */
+    void begin(message_tag tag);
+
+    /**
+     * Terminate the current message by writing its length
+     */
+    void end();
+
+    /**
+     * Write a simple Query message
+     * @param sql SQL text, without terminator
+     */
+    void query(std::string_view sql);
+
+    //@{
+    /** @name Prebuilt fixed messages, copied in one block */
+    /** Sync */
+    void sync();
+    /** Flush */
+    void flush();
+    /** Execute on the unnamed portal, without row limit */
+    void execute();
+    //@}
+
+    /**
+     * Copy a prebuilt message to the pipe
+     * @param m Message to send
+     */
+    void put(message const &m);
+
+    //@{
+    /** @name Stream write interface, same as message */
+    void write(char);
+    void write(smallint);
+    void write(integer);
+    void write(std::string const &);
+    void write_sv(std::string_view const &);
+    //@}
+
+    /**
+     * Get the number of messages written so far
+     * @return std::size_t Messages started or copied by this writer
+     */
+    std::size_t messages() const noexcept;
+
+private:
+    pipe_type  &out_;
+    std::size_t start_{0};    ///< Offset of the current message from the pipe front
+    std::size_t messages_{0}; ///< Messages written
+};
+
 /**
  * @brief Data row from a query result
  *
@@ -523,6 +845,107 @@ struct notice_message {
  */
 std::ostream &operator<<(std::ostream &, notice_message const &);
 
+/**
+ * @brief Non-owning view over the fields of a notice or error message
+ *
+ * Reading records where each field lies in the message instead of copying
+ * it, so handling an expected error (unique violation, serialization
+ * failure...) does not allocate for fields nobody reads. The views are
+ * only valid as long as the message; to_notice() builds an owning copy.
+ */
+class notice_view {
+public:
+    /// Number of field codes known to the view
+    static constexpr std::size_t field_count = 17;
+
+private:
+    std::array<std::string_view, field_count> _fields{}; ///< Fields, by index()
+
+    /**
+     * @brief Gets the slot of a field code
+     *
+     * @return std::size_t Index in _fields, field_count for unknown codes
+     */
+    static constexpr std::size_t
+    index(char code) noexcept {
+        switch (code) {
+            case 'S': return 0;
+            case 'C': return 1;
+            case 'M': return 2;
+            case 'D': return 3;
+            case 'H': return 4;
+            case 'P': return 5;
+            case 'p': return 6;
+            case 'q': return 7;
+            case 'W': return 8;
+            case 's': return 9;
+            case 't': return 10;
+            case 'c': return 11;
+            case 'd': return 12;
+            case 'n': return 13;
+            case 'F': return 14;
+            case 'L': return 15;
+            case 'R': return 16;
+            default: return field_count;
+        }
+    }
+
+public:
+    /**
+     * @brief Records a field, ignoring unknown codes
+     *
+     * @param code Field code character
+     * @param value Field value, viewed in the message
+     */
+    void
+    set(char code, std::string_view value) noexcept {
+        if (const auto i = index(code); i < field_count)
+            _fields[i] = value;
+    }
+
+    /**
+     * @brief Gets a field by its code
+     *
+     * @param code Field code character (see PostgreSQL protocol docs)
+     * @return std::string_view Field value, empty if absent or unknown
+     */
+    [[nodiscard]] std::string_view
+    field(char code) const noexcept {
+        const auto i = index(code);
+        return i < field_count ? _fields[i] : std::string_view();
+    }
+
+    [[nodiscard]] std::string_view
+    severity() const noexcept {
+        return _fields[0];
+    }
+
+    [[nodiscard]] std::string_view
+    sqlstate() const noexcept {
+        return _fields[1];
+    }
+
+    [[nodiscard]] std::string_view
+    message() const noexcept {
+        return _fields[2];
+    }
+
+    [[nodiscard]] std::string_view
+    detail() const noexcept {
+        return _fields[3];
+    }
+
+    /**
+     * @brief Copies every field into a notice_message
+     */
+    [[nodiscard]] notice_message to_notice() const;
+};
+
+/**
+ * @brief Output stream operator for notice_view, same format as notice_message
+ */
+std::ostream &operator<<(std::ostream &, notice_view const &);
+
 /**
  * @brief Command completion message
  *
@@ -534,6 +957,18 @@ struct command_complete {
     std::string command_tag; /**< Command tag with completion info (e.g., "SELECT 10") */
 };
 
+/**
+ * @brief Asynchronous notification raised by NOTIFY
+ *
+ * The channel and payload are views over the received message, only valid
+ * for the duration of the listener call.
+ */
+struct notification {
+    integer          server_pid; /**< Process ID of the notifying backend */
+    std::string_view channel;    /**< Channel the notification was sent on */
+    std::string_view payload;    /**< Payload given to NOTIFY, may be empty */
+};
+
 } // namespace detail
 } // namespace pg
 } // namespace qb
@@ -58,21 +58,15 @@ convert_from_text(const char *data, size_t size) {
     if (!data || size == 0)
         throw std::runtime_error("Empty data for text conversion");
 
-    std::string text(data, size);
+    const std::string_view text(data, size);
 
-    if constexpr (std::is_same_v<T, smallint>) {
-        return static_cast<smallint>(std::stoi(text));
-    } else if constexpr (std::is_same_v<T, integer>) {
-        return std::stoi(text);
-    } else if constexpr (std::is_same_v<T, bigint>) {
-        return std::stoll(text);
-    } else if constexpr (std::is_same_v<T, float>) {
-        return std::stof(text);
-    } else if constexpr (std::is_same_v<T, double>) {
-        return std::stod(text);
+    if constexpr (std::is_same_v<T, smallint> || std::is_same_v<T, integer> ||
+                  std::is_same_v<T, bigint>) {
+        return pg::detail::TextCodec::parse_integer<T>(text);
+    } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+        return pg::detail::TextCodec::parse_float<T>(text);
     } else if constexpr (std::is_same_v<T, bool>) {
-        return (text == "t" || text == "true" || text == "y" || text == "yes" ||
-                text == "1");
+        return pg::detail::TextCodec::parse_bool(text);
     } else {
         throw std::runtime_error("Unsupported type for text conversion");
     }
@@ -130,21 +124,14 @@ protocol_read<pg::protocol_data_format::Text, qb::uuid>(
         return begin;
     }
 
-    try {
-        // Extract data into a temporary vector
-        auto data = detail::copy_to_vector(begin, end);
-
-        // Parse UUID from string
-        auto uuid_opt = qb::uuid::from_string(std::string(data.data(), data.size()));
-        if (!uuid_opt) {
-            return begin;
-        }
-
-        value = *uuid_opt;
-        return end;
-    } catch (const std::exception &) {
+    // Parse UUID from string, in place
+    std::array<uint8_t, 16> uuid_bytes;
+    if (!pg::detail::TextCodec::to_uuid(traits::text_view(begin, end), uuid_bytes)) {
         return begin;
     }
+
+    value = qb::uuid(uuid_bytes);
+    return end;
 }
 
 } // namespace io
@@ -29,10 +29,12 @@
 #include <optional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #include "./common.h"
 #include "./param_unserializer.h"
+#include "./text_codec.h"
 
 namespace qb {
 namespace pg {
@@ -495,6 +497,22 @@ struct binary_reader<qb::uuid> {
     }
 };
 
+/**
+ * @brief Views the bytes of a text value read from a contiguous buffer
+ *
+ * @tparam InputIterator Iterator over contiguous characters
+ * @param begin Start of the value
+ * @param last End of the value, before its null terminator
+ * @return std::string_view Text value, without copy
+ */
+template <typename InputIterator>
+std::string_view
+text_view(InputIterator begin, InputIterator last) {
+    return begin == last ? std::string_view{}
+                         : std::string_view(&*begin, static_cast<std::size_t>(
+                                                         std::distance(begin, last)));
+}
+
 /**
  * @brief Text data reader
  *
@@ -543,13 +561,10 @@ struct text_reader<smallint> {
         if (null_terminator == end)
             return begin;
 
-        std::string text_value(begin, null_terminator);
-        try {
-            value = std::stoi(text_value);
-            return null_terminator + 1; // Skip the \0
-        } catch (const std::exception &) {
+        const auto text = text_view(begin, null_terminator);
+        if (pg::detail::TextCodec::to_integer(text, value) != std::errc{})
             return begin;
-        }
+        return null_terminator + 1; // Skip the \0
     }
 };
 
@@ -575,13 +590,10 @@ struct text_reader<integer> {
         if (null_terminator == end)
             return begin;
 
-        std::string text_value(begin, null_terminator);
-        try {
-            value = std::stoi(text_value);
-            return null_terminator + 1; // Skip the \0
-        } catch (const std::exception &) {
+        const auto text = text_view(begin, null_terminator);
+        if (pg::detail::TextCodec::to_integer(text, value) != std::errc{})
             return begin;
-        }
+        return null_terminator + 1; // Skip the \0
     }
 };
 
@@ -607,13 +619,10 @@ struct text_reader<bigint> {
         if (null_terminator == end)
             return begin;
 
-        std::string text_value(begin, null_terminator);
-        try {
-            value = std::stoll(text_value);
-            return null_terminator + 1; // Skip the \0
-        } catch (const std::exception &) {
+        const auto text = text_view(begin, null_terminator);
+        if (pg::detail::TextCodec::to_integer(text, value) != std::errc{})
             return begin;
-        }
+        return null_terminator + 1; // Skip the \0
     }
 };
 
@@ -639,13 +648,10 @@ struct text_reader<float> {
         if (null_terminator == end)
             return begin;
 
-        std::string text_value(begin, null_terminator);
-        try {
-            value = std::stof(text_value);
-            return null_terminator + 1; // Skip the \0
-        } catch (const std::exception &) {
+        const auto text = text_view(begin, null_terminator);
+        if (pg::detail::TextCodec::to_float(text, value) != std::errc{})
             return begin;
-        }
+        return null_terminator + 1; // Skip the \0
     }
 };
 
@@ -671,13 +677,10 @@ struct text_reader<double> {
         if (null_terminator == end)
             return begin;
 
-        std::string text_value(begin, null_terminator);
-        try {
-            value = std::stod(text_value);
-            return null_terminator + 1; // Skip the \0
-        } catch (const std::exception &) {
+        const auto text = text_view(begin, null_terminator);
+        if (pg::detail::TextCodec::to_float(text, value) != std::errc{})
             return begin;
-        }
+        return null_terminator + 1; // Skip the \0
     }
 };
 
@@ -690,7 +693,7 @@ struct text_reader<bool> {
      * @brief Read text bool (null-terminated string)
      *
      * Recognizes various PostgreSQL text representations for boolean:
-     * 'true'/'false', 't'/'f', '1'/'0', 'yes'/'no', 'y'/'n'
+     * 'true'/'false', 't'/'f', '1'/'0', 'yes'/'no', 'y'/'n', 'on'/'off'
      *
      * @tparam InputIterator Iterator type
      * @param begin Start iterator
@@ -706,11 +709,8 @@ struct text_reader<bool> {
         if (null_terminator == end)
             return begin;
 
-        std::string text_value(begin, null_terminator);
-
         // PostgreSQL uses 'true'/'false' or 't'/'f'
-        value = (text_value == "true" || text_value == "t" || text_value == "1" ||
-                 text_value == "yes" || text_value == "y");
+        value = pg::detail::TextCodec::parse_bool(text_view(begin, null_terminator));
         return null_terminator + 1; // Skip the \0
     }
 };
@@ -768,19 +768,12 @@ struct text_reader<qb::uuid> {
         if (null_terminator == end)
             return begin;
 
-        std::string text_value(begin, null_terminator);
-        try {
-            // Parse UUID from standard format: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
-            auto uuid_opt = qb::uuid::from_string(text_value);
-            if (uuid_opt) {
-                value = *uuid_opt;
-                return null_terminator + 1; // Skip the \0
-            }
-        } catch (const std::exception &) {
-            // Parsing failed
-        }
-
-        return begin;
+        // Parse UUID from standard format: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+        std::array<uint8_t, 16> uuid_bytes;
+        if (!pg::detail::TextCodec::to_uuid(text_view(begin, null_terminator), uuid_bytes))
+            return begin;
+        value = qb::uuid(uuid_bytes);
+        return null_terminator + 1; // Skip the \0
     }
 };
 
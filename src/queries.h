@@ -6,6 +6,7 @@
  * and managing SQL queries for the PostgreSQL client, including:
  *
  * - Storage for prepared queries
+ * - Cache of statements prepared automatically for ad-hoc SQL
  * - Parameter binding for prepared statements
  * - SQL query execution with callbacks
  * - Various query types (BEGIN, COMMIT, ROLLBACK, etc.)
@@ -33,8 +34,13 @@
 
 #pragma once
 
+#include <chrono>
 #include <iomanip>
+#include <deque>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <optional>
 #include <qb/io.h>
 #include <qb/system/container/unordered_map.h>
 #include <qb/utility/branch_hints.h>
@@ -44,13 +50,159 @@
 
 #include "./common.h"
 #include "./error.h"
+#include "./metrics.h"
+#include "./node_pool.h"
 #include "./param_serializer.h"
 #include "./protocol.h"
+#include "./result_impl.h"
 #include "./type_mapping.h"
 
 namespace qb::pg::detail {
 using namespace qb::pg;
 
+/**
+ * @brief Result format requested for the columns of a prepared statement
+ *
+ * By default prepared statement results come back in text format. Binary
+ * results skip the text parsing step on decode and are usually smaller on
+ * the wire, but the values must then be read with a matching C++ type.
+ *
+ * - text: every column in text format (default)
+ * - binary: every column in binary format
+ * - automatic: binary for the columns whose type has a binary decoder
+ *   (integers, floats, bool, timestamps, uuid, bytea), text for the others
+ * - per column: explicit format for each column, in result order
+ */
+class ResultFormat {
+public:
+    /**
+     * @brief Format selection mode
+     */
+    enum class mode { text, binary, automatic, per_column };
+
+private:
+    mode                              _mode = mode::text; ///< Selection mode
+    std::vector<protocol_data_format> _columns; ///< Explicit per-column formats
+
+    explicit ResultFormat(mode m, std::vector<protocol_data_format> &&columns = {})
+        : _mode(m)
+        , _columns(std::move(columns)) {}
+
+public:
+    ResultFormat() = default;
+
+    /** @brief All columns in text format */
+    static ResultFormat
+    text() {
+        return ResultFormat(mode::text);
+    }
+
+    /** @brief All columns in binary format */
+    static ResultFormat
+    binary() {
+        return ResultFormat(mode::binary);
+    }
+
+    /** @brief Binary for columns with a binary decoder, text for the others */
+    static ResultFormat
+    automatic() {
+        return ResultFormat(mode::automatic);
+    }
+
+    /**
+     * @brief Explicit format for each column
+     *
+     * @param columns Formats in result column order
+     */
+    static ResultFormat
+    columns(std::vector<protocol_data_format> columns) {
+        return ResultFormat(mode::per_column, std::move(columns));
+    }
+
+    /** @brief Get the selection mode */
+    mode
+    get_mode() const {
+        return _mode;
+    }
+
+    /**
+     * @brief Checks if results of a type can be requested in binary format
+     *
+     * Only types whose binary representation is decoded by TypeConverter
+     * straight from the raw field value are selected in automatic mode.
+     *
+     * @param type Column type OID
+     * @return bool True if binary results are supported for the type
+     */
+    static bool
+    has_binary_decoder(oid type) {
+        switch (type) {
+            case oid::boolean:
+            case oid::bytea:
+            case oid::int2:
+            case oid::int4:
+            case oid::int8:
+            case oid::float4:
+            case oid::float8:
+            case oid::timestamp:
+            case oid::timestamptz:
+            case oid::uuid:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Resolves the format of each column of a row description
+     *
+     * Updates the format code of every field description to the format the
+     * server will use and returns the result format codes to send in Bind:
+     * none when every column is text, a single code when all columns share
+     * the same format, one code per column otherwise.
+     *
+     * @param desc Row description captured when the statement was prepared
+     * @return std::vector<smallint> Result format codes for the Bind message
+     */
+    std::vector<smallint>
+    resolve(row_description_type &desc) const {
+        bool any_binary = false;
+        bool any_text   = false;
+        for (size_t i = 0; i < desc.size(); ++i) {
+            auto fmt = protocol_data_format::Text;
+            switch (_mode) {
+                case mode::text:
+                    break;
+                case mode::binary:
+                    fmt = protocol_data_format::Binary;
+                    break;
+                case mode::automatic:
+                    if (has_binary_decoder(desc[i].type_oid))
+                        fmt = protocol_data_format::Binary;
+                    break;
+                case mode::per_column:
+                    if (i < _columns.size())
+                        fmt = _columns[i];
+                    break;
+            }
+            desc[i].format_code = fmt;
+            (fmt == protocol_data_format::Binary ? any_binary : any_text) = true;
+        }
+
+        std::vector<smallint> codes;
+        if (!any_binary)
+            return codes;
+        if (!any_text) {
+            codes.push_back(static_cast<smallint>(protocol_data_format::Binary));
+            return codes;
+        }
+        codes.reserve(desc.size());
+        for (auto const &fd : desc)
+            codes.push_back(static_cast<smallint>(fd.format_code));
+        return codes;
+    }
+};
+
 /**
  * @brief Structure for storing a prepared query definition
  *
@@ -62,21 +214,354 @@ struct PreparedQuery {
     std::string          expression;  ///< SQL expression
     std::vector<oid>     param_types; ///< Types of parameters (was type_oid_sequence)
     row_description_type row_description; ///< Description of result columns
+    ResultFormat          result_format{};       ///< Requested result column formats
+    std::vector<smallint> result_format_codes{}; ///< Result format codes sent in Bind
+
+    /**
+     * @brief Applies a result format to the statement
+     *
+     * Updates the row description format codes and the Bind result codes.
+     *
+     * @param format Requested result column formats
+     */
+    void
+    set_result_format(ResultFormat format) {
+        result_format       = std::move(format);
+        result_format_codes = result_format.resolve(row_description);
+    }
+};
+
+/**
+ * @brief Bounded LRU of statements prepared automatically for ad-hoc SQL
+ *
+ * Maps the SQL text of simple queries to server-side statements on one
+ * connection. Lookups happen when a query is sent, so the order in which
+ * statements are created, used and closed on the server always matches
+ * the order of the messages on the wire.
+ *
+ * An entry is trusted once a query using it has succeeded. Until then
+ * (and after any failure), it is prepared again under the same name,
+ * preceded by a Close, which the server accepts even if the statement
+ * does not exist.
+ */
+class StatementCache {
+    /**
+     * @brief Statement of the cache
+     */
+    struct Entry {
+        std::string sql;             ///< SQL text
+        std::string name;            ///< Server-side statement name
+        bool        prepared{false}; ///< Known to exist on the server
+    };
+
+    using entries_type = std::list<Entry>;
+
+    entries_type _entries; ///< Statements, most recently used first
+    qb::unordered_map<std::string_view, entries_type::iterator>
+                _index;         ///< Entries by SQL text
+    std::size_t _capacity{0};   ///< Maximum number of statements, 0 disables the cache
+    std::size_t _next_id{0};    ///< Suffix of the next statement name
+    std::vector<std::string> _evicted; ///< Statements evicted and not closed yet
+
+    /**
+     * @brief Evicts the least recently used statements down to a size
+     *
+     * @param size Number of statements kept
+     */
+    void
+    trim(std::size_t size) {
+        while (_entries.size() > size) {
+            auto &last = _entries.back();
+            _evicted.push_back(std::move(last.name));
+            _index.erase(last.sql);
+            _entries.pop_back();
+        }
+    }
+
+public:
+    /**
+     * @brief Result of a lookup
+     */
+    struct Lookup {
+        std::string_view         name;    ///< Statement to execute
+        bool                     prepare; ///< The statement must be parsed first
+        std::vector<std::string> evicted; ///< Statements to close first
+    };
+
+    /**
+     * @brief Sets the maximum number of cached statements
+     *
+     * Statements over a reduced capacity are evicted at once, the least
+     * recently used first; the connection closes them (see take_evicted()).
+     *
+     * @param capacity Maximum number of statements, 0 disables the cache
+     */
+    void
+    capacity(std::size_t capacity) {
+        _capacity = capacity;
+        trim(capacity);
+    }
+
+    /**
+     * @brief Gets the maximum number of cached statements
+     *
+     * @return std::size_t Capacity, 0 when disabled
+     */
+    [[nodiscard]] std::size_t
+    capacity() const noexcept {
+        return _capacity;
+    }
+
+    /**
+     * @brief Gets the number of cached statements
+     *
+     * @return std::size_t Cache size
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept {
+        return _entries.size();
+    }
+
+    /**
+     * @brief Checks if a query can be sent as a cached statement
+     *
+     * Only single statements qualify: the extended protocol rejects
+     * several statements in one Parse.
+     *
+     * @param sql SQL text
+     * @return bool True if the cache is enabled and the query qualifies
+     */
+    [[nodiscard]] bool
+    cacheable(std::string_view sql) const noexcept {
+        return _capacity && !sql.empty() && sql.find(';') == std::string_view::npos;
+    }
+
+    /**
+     * @brief Finds or creates the statement of a query
+     *
+     * Marks it as most recently used and evicts the least recently used
+     * statements over capacity.
+     *
+     * @param sql SQL text
+     * @return Lookup Statement name and the work needed before executing it
+     */
+    Lookup
+    acquire(std::string_view sql) {
+        Lookup     result{{}, false, {}};
+        const auto it = _index.find(sql);
+        if (it != _index.end()) {
+            _entries.splice(_entries.begin(), _entries, it->second);
+        } else {
+            trim(_capacity ? _capacity - 1 : 0);
+            _entries.push_front({std::string(sql), "__qb_auto_" + std::to_string(_next_id++)});
+            _index.emplace(_entries.front().sql, _entries.begin());
+        }
+        result.evicted = take_evicted();
+        auto &entry    = _entries.front();
+        result.name    = entry.name;
+        result.prepare = !entry.prepared;
+        return result;
+    }
+
+    /**
+     * @brief Records the outcome of a query using a statement
+     *
+     * @param sql SQL text
+     * @param name Statement the query used
+     * @param success True if the query succeeded
+     */
+    void
+    complete(std::string_view sql, std::string_view name, bool success) {
+        const auto it = _index.find(sql);
+        if (it != _index.end() && it->second->name == name)
+            it->second->prepared = success;
+    }
+
+    /**
+     * @brief Checks if evicted statements are waiting to be closed
+     */
+    [[nodiscard]] bool
+    has_evicted() const noexcept {
+        return !_evicted.empty();
+    }
+
+    /**
+     * @brief Takes the statements evicted since the last call, to close them
+     *
+     * @return std::vector<std::string> Names of the evicted statements
+     */
+    [[nodiscard]] std::vector<std::string>
+    take_evicted() noexcept {
+        return std::move(_evicted);
+    }
+
+    /**
+     * @brief Forgets every statement, when the server session is lost
+     */
+    void
+    clear() noexcept {
+        _index.clear();
+        _entries.clear();
+        _evicted.clear();
+    }
+};
+
+/**
+ * @brief Lightweight handle of a prepared statement
+ *
+ * Index of the statement in the storage of its connection. Executing
+ * through a handle skips the name lookup entirely. A handle is obtained
+ * with Transaction::statement() once prepare() has been called, stays
+ * valid for the lifetime of the connection (reconnections included), and
+ * only refers to the statement on the connection it was obtained from.
+ */
+class PreparedHandle {
+    static constexpr uinteger npos = ~uinteger(0);
+
+    uinteger _index{npos}; ///< Slot of the statement in its storage
+
+public:
+    constexpr PreparedHandle() noexcept = default;
+
+    /**
+     * @brief Constructs a handle from a storage slot
+     *
+     * @param index Slot of the statement
+     */
+    constexpr explicit PreparedHandle(std::size_t index) noexcept
+        : _index(static_cast<uinteger>(index)) {}
+
+    /**
+     * @brief Checks if the handle refers to a statement
+     *
+     * @return bool True for a handle obtained from a prepared statement
+     */
+    [[nodiscard]] constexpr bool
+    valid() const noexcept {
+        return _index != npos;
+    }
+
+    /**
+     * @brief Gets the slot of the statement
+     *
+     * @return std::size_t Index in the storage
+     */
+    [[nodiscard]] constexpr std::size_t
+    index() const noexcept {
+        return _index;
+    }
+
+    constexpr bool
+    operator==(PreparedHandle const &other) const noexcept {
+        return _index == other._index;
+    }
+
+    constexpr bool
+    operator!=(PreparedHandle const &other) const noexcept {
+        return _index != other._index;
+    }
 };
 
 /**
  * @brief Storage for prepared queries
  *
  * Provides a central repository for all prepared statements in the
- * database session, allowing them to be referenced by name.
+ * database session. Statements live in stable slots addressed by
+ * PreparedHandle; names are only resolved through a string_view index, so
+ * lookups never allocate. A slot is reserved as soon as a statement is
+ * declared (prepare() or result_format()), and holds the statement once
+ * the server prepared it.
  */
 class PreparedStorage {
-    qb::unordered_map<std::string, PreparedQuery>
-        _prepared_queries; ///< Map of query names to definitions
+    /**
+     * @brief Slot of a statement
+     */
+    struct Slot {
+        std::string                 name;            ///< Statement name, key of the index
+        PreparedQuery               query;           ///< Statement definition
+        bool                        prepared{false}; ///< Statement prepared on the server
+        std::optional<ResultFormat> format;          ///< Result format set by name
+        std::size_t                 recycle{0};      ///< Results kept for reuse, 0 to disable
+        std::size_t                 recycle_bytes{0}; ///< Larger results are not kept
+        std::vector<result_impl>    pool;            ///< Emptied results, with their capacity
+    };
+
+    /**
+     * @brief Checks if a result was described like the statement
+     *
+     * Compares the names, types and formats of the columns, without allocating.
+     */
+    static bool
+    same_columns(row_description_type const &lhs, row_description_type const &rhs) noexcept {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+            if (lhs[i].type_oid != rhs[i].type_oid ||
+                lhs[i].format_code != rhs[i].format_code || lhs[i].name != rhs[i].name)
+                return false;
+        return true;
+    }
+
+    std::deque<Slot> _slots; ///< Statements, in declaration order
+    qb::unordered_map<std::string_view, std::size_t>
+                   _index;      ///< Slots by statement name
+    StatementCache _statements; ///< Statements prepared automatically
 
 public:
     PreparedStorage() = default;
 
+    PreparedStorage(PreparedStorage const &)            = delete;
+    PreparedStorage &operator=(PreparedStorage const &) = delete;
+
+    /**
+     * @brief Finds the handle of a statement
+     *
+     * @param name Name of the statement
+     * @return PreparedHandle Handle of the statement, invalid if never declared
+     */
+    [[nodiscard]] PreparedHandle
+    find(std::string_view name) const {
+        const auto it = _index.find(name);
+        return it != _index.end() ? PreparedHandle(it->second) : PreparedHandle();
+    }
+
+    /**
+     * @brief Gets the handle of a statement, reserving its slot if needed
+     *
+     * @param name Name of the statement
+     * @return PreparedHandle Handle of the statement
+     */
+    PreparedHandle
+    reserve(std::string_view name) {
+        const auto handle = find(name);
+        if (handle.valid())
+            return handle;
+        auto &slot = _slots.emplace_back();
+        slot.name  = std::string(name);
+        _index.emplace(slot.name, _slots.size() - 1);
+        return PreparedHandle(_slots.size() - 1);
+    }
+
+    /**
+     * @brief Gets the cache of statements prepared for ad-hoc SQL
+     *
+     * @return StatementCache& Statement cache of the connection
+     */
+    StatementCache &
+    statements() noexcept {
+        return _statements;
+    }
+
+    /**
+     * @brief Gets the cache of statements prepared for ad-hoc SQL
+     *
+     * @return StatementCache const& Statement cache of the connection
+     */
+    StatementCache const &
+    statements() const noexcept {
+        return _statements;
+    }
+
     /**
      * @brief Checks if a prepared query exists
      *
@@ -85,18 +570,135 @@ public:
      */
     bool
     has(std::string_view name) const {
-        return _prepared_queries.find(std::string(name)) != _prepared_queries.cend();
+        return has(find(name));
+    }
+
+    /**
+     * @brief Checks if the statement of a handle is prepared
+     *
+     * @param handle Statement handle
+     * @return bool True if the statement is prepared on the server
+     */
+    bool
+    has(PreparedHandle handle) const noexcept {
+        return handle.valid() && handle.index() < _slots.size() &&
+               _slots[handle.index()].prepared;
     }
 
     /**
      * @brief Adds a prepared query to storage
      *
+     * Keeps the existing definition if the statement was already prepared.
+     *
      * @param query Prepared query to add
      * @return const PreparedQuery& Reference to the stored query
      */
     const PreparedQuery &
     push(PreparedQuery &&query) {
-        return _prepared_queries.emplace(query.name, std::move(query)).first->second;
+        auto &slot = _slots[reserve(query.name).index()];
+        if (!slot.prepared) {
+            if (slot.format)
+                query.set_result_format(*slot.format);
+            else
+                query.set_result_format(query.result_format);
+            slot.query    = std::move(query);
+            slot.prepared = true;
+        }
+        return slot.query;
+    }
+
+    /**
+     * @brief Sets the result format of a prepared query
+     *
+     * Applies immediately if the query is already prepared, and is kept for
+     * the next time a query with this name is prepared.
+     *
+     * @param name Name of the prepared query
+     * @param format Requested result column formats
+     */
+    void
+    set_result_format(std::string_view name, ResultFormat format) {
+        auto &slot = _slots[reserve(name).index()];
+        if (slot.prepared)
+            slot.query.set_result_format(format);
+        slot.format = std::move(format);
+        // Kept results carry the previous column formats
+        slot.pool.clear();
+    }
+
+    /**
+     * @brief Keeps the storage of the results of a statement for its next executions
+     *
+     * Can be set before the statement is prepared; a capacity of 0 disables
+     * the recycling and frees the kept results.
+     *
+     * @param name Name of the prepared query
+     * @param capacity Maximum number of results kept
+     * @param max_bytes Results using more memory are freed instead
+     */
+    void
+    recycle_results(std::string_view name, std::size_t capacity, std::size_t max_bytes) {
+        auto &slot         = _slots[reserve(name).index()];
+        slot.recycle       = capacity;
+        slot.recycle_bytes = max_bytes;
+        if (slot.pool.size() > capacity)
+            slot.pool.resize(capacity);
+    }
+
+    /**
+     * @brief Checks if the results of a statement are recycled
+     *
+     * @param handle Statement handle
+     */
+    [[nodiscard]] bool
+    recycles(PreparedHandle handle) const noexcept {
+        return handle.valid() && handle.index() < _slots.size() &&
+               _slots[handle.index()].recycle;
+    }
+
+    /**
+     * @brief Gets an empty result described like a prepared statement
+     *
+     * Takes a kept result when there is one, with its capacity and row
+     * description, and only copies the row description otherwise.
+     *
+     * @param handle Statement handle
+     * @return result_impl Empty result with the description of the statement
+     * @throws std::out_of_range If the statement is not prepared
+     */
+    result_impl
+    acquire(PreparedHandle handle) {
+        auto const &query = get(handle);
+        auto       &slot  = _slots[handle.index()];
+        result_impl out;
+        if (!slot.pool.empty()) {
+            out = std::move(slot.pool.back());
+            slot.pool.pop_back();
+        } else
+            out.row_description() = query.row_description;
+        return out;
+    }
+
+    /**
+     * @brief Gives back the storage of a result once it is no longer used
+     *
+     * The result is kept if the statement recycles its results, has a free
+     * slot, and the result has the columns of the statement and fits in its
+     * memory limit; it is freed otherwise.
+     *
+     * @param handle Statement handle
+     * @param result Result released by its owner
+     */
+    void
+    release(PreparedHandle handle, result_impl &&result) {
+        if (!has(handle))
+            return;
+        auto &slot = _slots[handle.index()];
+        if (slot.pool.size() >= slot.recycle || result.memory_size() > slot.recycle_bytes ||
+            !same_columns(result.row_description(), slot.query.row_description))
+            return;
+        result.clear_rows();
+        slot.pool.push_back(std::move(result));
     }
 
     /**
@@ -108,7 +710,88 @@ public:
      */
     PreparedQuery const &
     get(std::string_view name) const {
-        return _prepared_queries.at(std::string(name));
+        return get(find(name));
+    }
+
+    /**
+     * @brief Retrieves a prepared query by handle
+     *
+     * @param handle Statement handle
+     * @return PreparedQuery const& Reference to the prepared query
+     * @throws std::out_of_range If the statement is not prepared
+     */
+    PreparedQuery const &
+    get(PreparedHandle handle) const {
+        if (qb::unlikely(!has(handle)))
+            throw std::out_of_range("prepared statement not found");
+        return _slots[handle.index()].query;
+    }
+
+    /**
+     * @brief Visits every prepared query
+     *
+     * @tparam Func Type of visitor, void(PreparedQuery const &)
+     * @param func Visitor invoked for each query
+     */
+    template <typename Func>
+    void
+    for_each(Func &&func) const {
+        for (auto const &slot : _slots)
+            if (slot.prepared)
+                func(slot.query);
+    }
+};
+
+/**
+ * @brief Reference to a prepared statement, by name or by handle
+ *
+ * Held by the commands executing a statement. A name is resolved to its
+ * handle on first use only, so the following lookups are O(1).
+ */
+class PreparedRef {
+    std::string            _name;   ///< Statement name, empty for a handle
+    mutable PreparedHandle _handle; ///< Resolved statement
+
+public:
+    PreparedRef() = default;
+
+    /**
+     * @brief Refers to a statement by name
+     *
+     * @param name Statement name
+     */
+    PreparedRef(std::string name) noexcept
+        : _name(std::move(name)) {}
+
+    /**
+     * @brief Refers to a statement by handle
+     *
+     * @param handle Statement handle
+     */
+    PreparedRef(PreparedHandle handle) noexcept
+        : _handle(handle) {}
+
+    /**
+     * @brief Gets the handle of the statement
+     *
+     * @param storage Storage of the connection
+     * @return PreparedHandle Handle, invalid if the statement was never declared
+     */
+    PreparedHandle
+    resolve(PreparedStorage const &storage) const {
+        if (!_handle.valid())
+            _handle = storage.find(_name);
+        return _handle;
+    }
+
+    /**
+     * @brief Gets the statement name, for diagnostics
+     *
+     * @return std::string_view Name, empty when referred to by handle
+     */
+    [[nodiscard]] std::string_view
+    name() const noexcept {
+        return _name;
     }
 };
 
@@ -122,8 +805,9 @@ using PreparedQueryStorage = PreparedStorage;
  * type conversion and binary encoding according to PostgreSQL protocol.
  */
 class QueryParams {
-    std::vector<byte>    _params;      ///< Serialized parameters
-    std::vector<integer> _param_types; ///< OIDs for parameter types
+    std::vector<byte>          _params;      ///< Serialized parameters
+    std::vector<integer>       _param_types; ///< OIDs for parameter types
+    std::vector<ExternalSlice> _external;    ///< Values left out of _params, by position
 
 public:
     /**
@@ -149,9 +833,11 @@ public:
             ParamSerializer serializer;
             serializer.serialize_params(std::forward<T>(args)...);
 
-            // Retrieve serialized data
-            _params      = serializer.params_buffer();
-            _param_types = serializer.param_types();
+            // Take ownership of the serialized data, it is only copied once
+            // more: into the output pipe when the query is sent
+            _params      = serializer.release_params_buffer();
+            _param_types = serializer.release_param_types();
+            _external    = serializer.release_external();
 
             // Check if the beginning of the parameter buffer contains a 'B'
             if (!_params.empty() && _params.size() > sizeof(smallint) &&
@@ -162,9 +848,27 @@ public:
         }
     }
 
+    /**
+     * @brief Takes parameters already encoded, e.g. by a TypedStatement
+     *
+     * @param params Parameter count followed by the values, in the Bind format
+     * @param types OIDs of the parameters
+     * @return QueryParams Parameter set owning the buffer
+     */
+    static QueryParams
+    encoded(std::vector<byte> &&params, std::vector<integer> &&types = {}) {
+        QueryParams out;
+        out._params      = std::move(params);
+        out._param_types = std::move(types);
+        return out;
+    }
+
     /**
      * @brief Gets the serialized parameters
      *
+     * The values of external parameters are not part of the buffer, see
+     * gather() and inline_external().
+     *
      * @return std::vector<byte>& Reference to the serialized parameters
      */
     std::vector<byte> &
@@ -217,6 +921,69 @@ public:
     empty() const {
         return _params.empty();
     }
+
+    /**
+     * @brief Checks if some values reference caller-owned memory
+     */
+    bool
+    has_external() const noexcept {
+        return !_external.empty();
+    }
+
+    /**
+     * @brief Gets the size of the parameters, external values included
+     */
+    std::size_t
+    size() const noexcept {
+        std::size_t total = _params.size();
+        for (auto const &slice : _external)
+            total += slice.value.data().size();
+        return total;
+    }
+
+    /**
+     * @brief Hands the parameters to a sink as consecutive fragments
+     *
+     * Serialized fragments alternate with the external values, which are
+     * never copied here.
+     *
+     * @tparam Sink Callable taking a std::string_view
+     * @param sink Receiver of the fragments, in order
+     * @param from Offset of the first byte in the serialized parameters
+     */
+    template <typename Sink>
+    void
+    gather(Sink &&sink, std::size_t from = 0) const {
+        std::size_t pos = from;
+        for (auto const &slice : _external) {
+            if (slice.offset > pos)
+                sink(std::string_view(_params.data() + pos, slice.offset - pos));
+            if (!slice.value.data().empty())
+                sink(slice.value.data());
+            pos = slice.offset;
+        }
+        if (_params.size() > pos)
+            sink(std::string_view(_params.data() + pos, _params.size() - pos));
+    }
+
+    /**
+     * @brief Copies the external values into the serialized parameters
+     *
+     * Needed before merging parameter sets, or before keeping them beyond
+     * the lifetime of borrowed values.
+     */
+    void
+    inline_external() {
+        if (_external.empty())
+            return;
+        std::vector<byte> flat;
+        flat.reserve(size());
+        gather([&flat](std::string_view fragment) {
+            flat.insert(flat.end(), fragment.begin(), fragment.end());
+        });
+        _params = std::move(flat);
+        _external.clear();
+    }
 };
 
 /**
@@ -224,8 +991,9 @@ public:
  *
  * Base class for all SQL query implementations, providing a common
  * interface for getting the query message and handling callbacks.
+ * Queries are allocated from the NodePool freelists.
  */
-class ISqlQuery {
+class ISqlQuery : public PooledNode {
 public:
     ISqlQuery() = default;
 
@@ -237,16 +1005,71 @@ public:
      * @return bool True if the query is valid, false otherwise
      */
     virtual bool
-    is_valid() const {
-        return true;
+    is_valid() const {
+        return true;
+    }
+
+    /**
+     * @brief Encodes the query into the output pipe of the connection
+     *
+     * Messages are written in place into the reused transport buffer, so
+     * sending a query does not allocate once the buffer has grown.
+     *
+     * @param out Writer over the output pipe
+     */
+    virtual void encode(pipe_writer &out) const = 0;
+
+    /**
+     * @brief Gets the PostgreSQL protocol message for the query
+     *
+     * Builds a standalone copy of what encode() writes, for inspection.
+     *
+     * @return message Message to send to the server
+     */
+    [[nodiscard]] message
+    get() const {
+        pipe_writer::pipe_type buffer;
+        pipe_writer            out(buffer);
+        encode(out);
+        return message(buffer.begin(), buffer.size());
+    }
+
+    /**
+     * @brief Checks if the query can be sent before the previous ones complete
+     *
+     * Pipelinable queries carry their own Sync and do not depend on the
+     * outcome of the queries sent before them.
+     *
+     * @return bool True if the query can be pipelined
+     */
+    virtual bool
+    is_pipelinable() const {
+        return false;
+    }
+
+    /**
+     * @brief Checks if the query can be suspended by the server
+     *
+     * Suspendable queries are sent without a trailing Sync, so the
+     * connection must send one itself when the query fails.
+     *
+     * @return bool True if the query runs over a suspendable portal
+     */
+    virtual bool
+    is_suspendable() const {
+        return false;
     }
 
     /**
-     * @brief Gets the PostgreSQL protocol message for the query
+     * @brief Encodes the messages continuing a suspended query
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
+     * @param fetch True to request the next rows, false to close the query
      */
-    virtual message get() const = 0;
+    virtual void
+    resume(pipe_writer &out, bool) const {
+        out.sync();
+    }
 
     /**
      * @brief Called when the query succeeds
@@ -259,6 +1082,42 @@ public:
      * @param err Error information
      */
     virtual void on_error(error::db_error const &err) const = 0;
+
+    /**
+     * @brief Gets the kind of the query, for metrics
+     *
+     * @return query_kind Kind of query
+     */
+    [[nodiscard]] virtual query_kind
+    kind() const noexcept {
+        return query_kind::simple;
+    }
+
+    /**
+     * @brief Gets the prepared statement the query runs, for metrics
+     *
+     * @return std::string_view Statement name, empty if not prepared
+     */
+    [[nodiscard]] virtual std::string_view
+    statement() const noexcept {
+        return {};
+    }
+
+    /**
+     * @brief Gets the SQL text and the parameters of the query, for EXPLAIN
+     *
+     * @param params Set to the parameters of the query, if it has some
+     * @return std::string_view SQL text, empty if the query cannot be explained
+     */
+    [[nodiscard]] virtual std::string_view
+    explain_source(QueryParams const *&) const noexcept {
+        return {};
+    }
+
+    /// Time the query was queued, set only while metrics are collected
+    std::chrono::steady_clock::time_point queued_at{};
+    /// Time the query was sent, set only while metrics are collected
+    std::chrono::steady_clock::time_point sent_at{};
 };
 
 /**
@@ -332,19 +1191,22 @@ public:
         , _mode(mode) {}
 
     /**
-     * @brief Creates the BEGIN message
+     * @brief Writes the BEGIN message
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
      */
-    message
-    get() const final {
+    void
+    encode(pipe_writer &out) const final {
         ::std::ostringstream cmd;
         cmd << "BEGIN " << _mode;
 
         LOG_DEBUG("[pgsql] Send BEGIN: \"" << cmd.str() << "\"");
-        message m(query_tag);
-        m.write(cmd.str());
-        return m;
+        out.query(cmd.str());
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::transaction;
     }
 };
 
@@ -370,16 +1232,19 @@ public:
                                          std::forward<CB_ERROR>(error)) {}
 
     /**
-     * @brief Creates the COMMIT message
+     * @brief Writes the COMMIT message
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
      */
-    message
-    get() const final {
+    void
+    encode(pipe_writer &out) const final {
         LOG_DEBUG("[pgsql] Send COMMIT");
-        message m(query_tag);
-        m.write("commit");
-        return m;
+        out.query("commit");
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::transaction;
     }
 };
 
@@ -405,16 +1270,19 @@ public:
                                          std::forward<CB_ERROR>(error)) {}
 
     /**
-     * @brief Creates the ROLLBACK message
+     * @brief Writes the ROLLBACK message
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
      */
-    message
-    get() const final {
+    void
+    encode(pipe_writer &out) const final {
         LOG_DEBUG("[pgsql] Send ROLLBACK");
-        message m(query_tag);
-        m.write("rollback");
-        return m;
+        out.query("rollback");
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::transaction;
     }
 };
 
@@ -444,16 +1312,22 @@ public:
         , _name(name) {}
 
     /**
-     * @brief Creates the SAVEPOINT message
+     * @brief Writes the SAVEPOINT message
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
      */
-    message
-    get() const final {
+    void
+    encode(pipe_writer &out) const final {
         LOG_DEBUG("[pgsql] Send SAVEPOINT " << _name);
-        message m(query_tag);
-        m.write("savepoint " + _name);
-        return m;
+        out.begin(query_tag);
+        out.write_sv("savepoint ");
+        out.write(_name);
+        out.end();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::transaction;
     }
 };
 
@@ -484,16 +1358,22 @@ public:
         , _name(name) {}
 
     /**
-     * @brief Creates the RELEASE SAVEPOINT message
+     * @brief Writes the RELEASE SAVEPOINT message
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
      */
-    message
-    get() const final {
+    void
+    encode(pipe_writer &out) const final {
         LOG_DEBUG("[pgsql] Send RELEASE SAVEPOINT " << _name);
-        message m(query_tag);
-        m.write("release savepoint " + _name);
-        return m;
+        out.begin(query_tag);
+        out.write_sv("release savepoint ");
+        out.write(_name);
+        out.end();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::transaction;
     }
 };
 
@@ -524,16 +1404,22 @@ public:
         , _name(name) {}
 
     /**
-     * @brief Creates the ROLLBACK TO SAVEPOINT message
+     * @brief Writes the ROLLBACK TO SAVEPOINT message
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
      */
-    message
-    get() const final {
+    void
+    encode(pipe_writer &out) const final {
         LOG_DEBUG("[pgsql] Send ROLLBACK TO SAVEPOINT " << _name);
-        message m(query_tag);
-        m.write("rollback to savepoint " + _name);
-        return m;
+        out.begin(query_tag);
+        out.write_sv("rollback to savepoint ");
+        out.write(_name);
+        out.end();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::transaction;
     }
 };
 
@@ -562,18 +1448,237 @@ public:
                                          std::forward<CB_ERROR>(error))
         , _expression(std::move(expr)) {}
 
+    bool
+    is_pipelinable() const final {
+        return true;
+    }
+
     /**
-     * @brief Creates the query message
+     * @brief Writes the query message
      *
-     * @return message Message to send to the server
+     * @param out Writer over the output pipe
      */
-    message
-    get() const final {
+    void
+    encode(pipe_writer &out) const final {
         LOG_DEBUG("[pgsql] Send QUERY \"" << _expression << "\"");
-        message m(query_tag);
-        m.write(_expression);
+        out.query(_expression);
+    }
+    std::string_view
+    explain_source(QueryParams const *&) const noexcept final {
+        return _expression;
+    }
+};
+
+/**
+ * @brief Simple query sent as a cached prepared statement
+ *
+ * Uses the extended protocol with the statement of the connection cache:
+ * [Close] [Parse] Bind, Describe (portal), Execute, Sync in a single
+ * message. The portal description always precedes the rows and results
+ * come back in text format, so the command sees exactly the responses of
+ * a simple query.
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class CachedQuery final : public ISqlQuery {
+    StatementCache     &_cache;      ///< Statement cache of the connection
+    const std::string   _expression; ///< SQL expression
+    mutable std::string _name;       ///< Statement used when sent
+    CB_SUCCESS          _on_success; ///< Success callback
+    CB_ERROR            _on_error;   ///< Error callback
+
+public:
+    /**
+     * @brief Constructs a cached query
+     *
+     * @param cache Statement cache of the connection
+     * @param expr SQL expression
+     * @param success Success callback
+     * @param error Error callback
+     */
+    CachedQuery(StatementCache &cache, std::string &&expr, CB_SUCCESS &&success,
+                CB_ERROR &&error)
+        : _cache(cache)
+        , _expression(std::move(expr))
+        , _on_success(std::forward<CB_SUCCESS>(success))
+        , _on_error(std::forward<CB_ERROR>(error)) {}
+
+    bool
+    is_pipelinable() const final {
+        return true;
+    }
+
+    void
+    encode(pipe_writer &out) const final {
+        auto lookup = _cache.acquire(_expression);
+        _name.assign(lookup.name);
+
+        auto close = [&out](std::string const &name) {
+            out.begin(close_tag);
+            out.write('S');
+            out.write(name);
+            out.end();
+        };
+
+        for (auto const &evicted : lookup.evicted)
+            close(evicted);
+        if (lookup.prepare) {
+            LOG_DEBUG("[pgsql] Send PARSE QUERY \"" << _expression << "\" as " << _name);
+            close(_name);
+            out.begin(parse_tag);
+            out.write(_name);
+            out.write(_expression);
+            out.write((smallint) 0);
+            out.end();
+        }
+
+        out.begin(bind_tag);
+        out.write('\0');
+        out.write(_name);
+        out.write((smallint) 0); // No parameter formats
+        out.write((smallint) 0); // No parameters
+        out.write((smallint) 0); // All results in text
+        out.end();
+
+        out.begin(describe_tag);
+        out.write('P');
+        out.write('\0');
+        out.end();
+
+        out.execute();
+        out.sync();
+    }
+
+    void
+    on_success() const final {
+        _cache.complete(_expression, _name, true);
+        _on_success();
+    }
+
+    void
+    on_error(error::db_error const &err) const final {
+        _cache.complete(_expression, _name, false);
+        _on_error(err);
+    }
+    std::string_view
+    explain_source(QueryParams const *&) const noexcept final {
+        return _expression;
+    }
+};
+
+/**
+ * @brief Query closing the statements evicted from the statement cache
+ *
+ * Takes the evicted statements when sent, so those evicted while the query
+ * is queued are closed too: a Close for each of them, then Sync. Closing a
+ * statement the server does not know is not an error.
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class EvictQuery final : public SqlQuery<CB_SUCCESS, CB_ERROR> {
+    StatementCache &_cache; ///< Statement cache of the connection
+
+public:
+    /**
+     * @brief Constructs an evicting query
+     *
+     * @param cache Statement cache of the connection
+     * @param success Success callback
+     * @param error Error callback
+     */
+    EvictQuery(StatementCache &cache, CB_SUCCESS &&success, CB_ERROR &&error)
+        : SqlQuery<CB_SUCCESS, CB_ERROR>(std::forward<CB_SUCCESS>(success),
+                                         std::forward<CB_ERROR>(error))
+        , _cache(cache) {}
+
+    bool
+    is_pipelinable() const final {
+        return true;
+    }
+
+    void
+    encode(pipe_writer &out) const final {
+        for (auto const &name : _cache.take_evicted()) {
+            LOG_DEBUG("[pgsql] Send CLOSE " << name);
+            out.begin(close_tag);
+            out.write('S');
+            out.write(name);
+            out.end();
+        }
+        out.sync();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::prepare;
+    }
+};
+
+/**
+ * @brief Creates the query of an ad-hoc SQL expression
+ *
+ * A CachedQuery when automatic preparation is enabled on the connection
+ * and the expression qualifies, a SimpleQuery otherwise.
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ * @param storage Prepared statement storage of the connection
+ * @param expr SQL expression
+ * @param success Success callback
+ * @param error Error callback
+ * @return std::unique_ptr<ISqlQuery> Query to push
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+std::unique_ptr<ISqlQuery>
+make_simple_query(PreparedStorage &storage, std::string &&expr, CB_SUCCESS &&success,
+                  CB_ERROR &&error) {
+    if (storage.statements().cacheable(expr))
+        return std::unique_ptr<ISqlQuery>(new CachedQuery<CB_SUCCESS, CB_ERROR>(
+            storage.statements(), std::move(expr), std::forward<CB_SUCCESS>(success),
+            std::forward<CB_ERROR>(error)));
+    return std::unique_ptr<ISqlQuery>(new SimpleQuery<CB_SUCCESS, CB_ERROR>(
+        std::move(expr), std::forward<CB_SUCCESS>(success), std::forward<CB_ERROR>(error)));
+}
+
+/**
+ * @brief Query running a COPY statement
+ *
+ * Sent like a simple query, but never pipelined: once the server enters
+ * COPY mode, only COPY messages may follow until the copy completes.
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class CopyQuery final : public SqlQuery<CB_SUCCESS, CB_ERROR> {
+    const std::string _expression; ///< COPY statement
+
+public:
+    /**
+     * @brief Constructs a COPY query
+     *
+     * @param expr COPY statement
+     * @param success Success callback
+     * @param error Error callback
+     */
+    CopyQuery(std::string &&expr, CB_SUCCESS &&success, CB_ERROR &&error)
+        : SqlQuery<CB_SUCCESS, CB_ERROR>(std::forward<CB_SUCCESS>(success),
+                                         std::forward<CB_ERROR>(error))
+        , _expression(std::move(expr)) {}
+
+    void
+    encode(pipe_writer &out) const final {
+        LOG_DEBUG("[pgsql] Send COPY \"" << _expression << "\"");
+        out.query(_expression);
+    }
 
-        return m;
+    query_kind
+    kind() const noexcept final {
+        return query_kind::copy;
     }
 };
 
@@ -587,36 +1692,104 @@ public:
  */
 template <typename CB_SUCCESS, typename CB_ERROR>
 class ParseQuery final : public SqlQuery<CB_SUCCESS, CB_ERROR> {
-    PreparedQuery const &_query; ///< Prepared query definition
+    PreparedQuery const &_query;    ///< Prepared query definition
+    const bool           _describe; ///< Describe the statement after parsing it
 
 public:
-    ParseQuery(PreparedQuery const &query, CB_SUCCESS &&success, CB_ERROR &&error)
+    /**
+     * @brief Constructs a Parse query
+     *
+     * @param query Prepared query definition
+     * @param success Success callback
+     * @param error Error callback
+     * @param describe False to skip the Describe of a statement whose
+     * description is already known
+     */
+    ParseQuery(PreparedQuery const &query, CB_SUCCESS &&success, CB_ERROR &&error,
+               bool describe = true)
         : SqlQuery<CB_SUCCESS, CB_ERROR>(std::forward<CB_SUCCESS>(success),
                                          std::forward<CB_ERROR>(error))
-        , _query(query) {}
+        , _query(query)
+        , _describe(describe) {}
 
-    [[nodiscard]] message
-    get() const final {
+    bool
+    is_pipelinable() const final {
+        return true;
+    }
+
+    void
+    encode(pipe_writer &out) const final {
         LOG_DEBUG("[pgsql] Send PARSE QUERY \"" << _query.expression << "\"");
-        message cmd(parse_tag);
-        cmd.write(_query.name);
-        cmd.write(_query.expression);
-        cmd.write((smallint) _query.param_types.size());
+        out.begin(parse_tag);
+        out.write(_query.name);
+        out.write(_query.expression);
+        out.write((smallint) _query.param_types.size());
         for (auto oid_val : _query.param_types) {
-            cmd.write(
+            out.write(
                 static_cast<integer>(oid_val)); // déjà un integer, pas besoin de cast
         }
+        out.end();
+
+        if (_describe) {
+            out.begin(describe_tag);
+            out.write('S');
+            out.write(_query.name);
+            out.end();
+        }
+        out.sync();
+    }
 
-        message describe(describe_tag);
-        describe.write('S');
-        describe.write(_query.name);
-        cmd.pack(describe);
-        cmd.pack(message(sync_tag));
+    query_kind
+    kind() const noexcept final {
+        return query_kind::prepare;
+    }
 
-        return cmd;
+    std::string_view
+    statement() const noexcept final {
+        return _query.name;
     }
 };
 
+/**
+ * @brief Writes the Bind message of a prepared statement execution
+ *
+ * @param cmd Writer over the output pipe, positioned in a Bind message
+ * @param portal Destination portal name (empty for the unnamed portal)
+ * @param query Prepared statement definition
+ * @param params Query parameters
+ */
+inline void
+write_bind(pipe_writer &cmd, std::string_view portal, PreparedQuery const &query,
+           QueryParams const &params) {
+    // Exact format expected by PostgreSQL for a Bind message:
+    // 1. Portal name (empty = unnamed)
+    cmd.write_sv(portal);
+    cmd.write('\0');
+
+    // 2. Prepared statement name
+    cmd.write(query.name);
+
+    // 3. Format codes section - 1 code for all parameters
+    // Format 1 = binary
+    cmd.write((smallint) 1); // Number of format codes
+    cmd.write((smallint) 1); // Format = 1 (binary)
+
+    // 4. Total number of parameters
+    smallint param_count = params.param_count();
+    cmd.write(param_count);
+
+    // 5. Parameter values, skipping the count of the parameters buffer,
+    // gathered with the external values straight into the output pipe
+    if (!params.empty() && param_count > 0)
+        params.gather([&cmd](std::string_view fragment) { cmd.write_sv(fragment); },
+                      sizeof(smallint));
+
+    // 6. Result format codes (none = all text)
+    cmd.write(static_cast<smallint>(query.result_format_codes.size()));
+    for (auto code : query.result_format_codes)
+        cmd.write(code);
+}
+
 /**
  * @brief Prepared statement execution
  *
@@ -625,83 +1798,248 @@ public:
  */
 template <typename CB_SUCCESS, typename CB_ERROR>
 class ExecuteQuery final : public SqlQuery<CB_SUCCESS, CB_ERROR> {
-    const PreparedStorage &_storage;    ///< Prepared statement storage
-    std::string            _query_name; ///< Query name to execute
-    QueryParams            _params;     ///< Query parameters
+    const PreparedStorage &_storage;   ///< Prepared statement storage
+    PreparedRef const     &_statement; ///< Statement to execute
+    QueryParams            _params;    ///< Query parameters
 
 public:
     /**
      * @brief Constructs an execute query
      *
      * @param storage Prepared statement storage
-     * @param query_name Query name to execute
+     * @param statement Statement to execute
      * @param params Query parameters
      * @param success Success callback
      * @param error Error callback
      */
-    ExecuteQuery(const PreparedStorage &storage, std::string_view query_name,
+    ExecuteQuery(const PreparedStorage &storage, PreparedRef const &statement,
                  QueryParams &&params, CB_SUCCESS &&success, CB_ERROR &&error)
         : SqlQuery<CB_SUCCESS, CB_ERROR>(std::forward<CB_SUCCESS>(success),
                                          std::forward<CB_ERROR>(error))
         , _storage(storage)
-        , _query_name(query_name)
+        , _statement(statement)
         , _params(std::move(params)) {}
 
     bool
     is_valid() const final {
-        if (qb::likely(_storage.has(_query_name)))
+        if (qb::likely(_storage.has(_statement.resolve(_storage))))
             return true;
-        LOG_CRIT("[pgsql] Error prepared query " << _query_name << " not registered");
+        LOG_CRIT("[pgsql] Error prepared query " << _statement.name() << " not registered");
         return false;
     }
 
-    message
-    get() const final {
-        const auto &query = _storage.get(_query_name);
-        message     cmd(bind_tag);
+    bool
+    is_pipelinable() const final {
+        // Not before the statement it executes has been prepared
+        return _storage.has(_statement.resolve(_storage));
+    }
+
+    void
+    encode(pipe_writer &out) const final {
+        out.begin(bind_tag);
+        write_bind(out, "", _storage.get(_statement.resolve(_storage)), _params);
+        out.end();
+
+        // Execute on the unnamed portal without row limit, then Sync
+        out.execute();
+        out.sync();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::execute;
+    }
+
+    std::string_view
+    statement() const noexcept final {
+        const auto handle = _statement.resolve(_storage);
+        return _storage.has(handle) ? std::string_view(_storage.get(handle).name)
+                                    : _statement.name();
+    }
 
-        // Exact format expected by PostgreSQL for a Bind message:
-        // 1. Portal name (empty = unnamed)
-        cmd.write("");
+    std::string_view
+    explain_source(QueryParams const *&params) const noexcept final {
+        const auto handle = _statement.resolve(_storage);
+        if (!_storage.has(handle))
+            return {};
+        params = &_params;
+        return _storage.get(handle).expression;
+    }
+};
 
-        // 2. Prepared statement name
-        cmd.write(query.name);
+/**
+ * @brief Prepared statement execution over many parameter sets
+ *
+ * Encodes a Bind + Execute pair per parameter set into a single message
+ * followed by one Sync. The server runs the whole batch in one implicit
+ * transaction: either every execution is committed, or the first error
+ * discards the remaining ones and rolls the batch back.
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class BatchQuery final : public SqlQuery<CB_SUCCESS, CB_ERROR> {
+    const PreparedStorage   &_storage;   ///< Prepared statement storage
+    PreparedRef const       &_statement; ///< Statement to execute
+    std::vector<QueryParams> _params;    ///< Parameter sets, one per execution
 
-        // 3. Format codes section - 1 code for all parameters
-        // Format 1 = binary
-        cmd.write((smallint) 1); // Number of format codes
-        cmd.write((smallint) 1); // Format = 1 (binary)
+public:
+    /**
+     * @brief Constructs a batch query
+     *
+     * @param storage Prepared statement storage
+     * @param statement Statement to execute
+     * @param params Parameter sets, one per execution
+     * @param success Success callback
+     * @param error Error callback
+     */
+    BatchQuery(const PreparedStorage &storage, PreparedRef const &statement,
+               std::vector<QueryParams> &&params, CB_SUCCESS &&success,
+               CB_ERROR &&error)
+        : SqlQuery<CB_SUCCESS, CB_ERROR>(std::forward<CB_SUCCESS>(success),
+                                         std::forward<CB_ERROR>(error))
+        , _storage(storage)
+        , _statement(statement)
+        , _params(std::move(params)) {}
 
-        // 4. Total number of parameters
-        smallint param_count = _params.param_count();
-        cmd.write(param_count);
+    bool
+    is_valid() const final {
+        if (qb::likely(_storage.has(_statement.resolve(_storage))))
+            return true;
+        LOG_CRIT("[pgsql] Error prepared query " << _statement.name() << " not registered");
+        return false;
+    }
 
-        // 5. Parameter values
-        if (!_params.empty() && param_count > 0) {
-            // Skip the count in the parameters buffer
-            const std::vector<byte> &param_buffer = _params.get();
-            if (param_buffer.size() > sizeof(smallint)) {
-                const byte *data      = param_buffer.data() + sizeof(smallint);
-                size_t      data_size = param_buffer.size() - sizeof(smallint);
+    bool
+    is_pipelinable() const final {
+        return _storage.has(_statement.resolve(_storage));
+    }
 
-                // Copy the raw data
-                auto out = cmd.output();
-                std::copy(data, data + data_size, out);
+    void
+    encode(pipe_writer &out) const final {
+        if (!_params.empty()) {
+            auto const &query = _storage.get(_statement.resolve(_storage));
+            for (auto const &params : _params) {
+                out.begin(bind_tag);
+                write_bind(out, "", query, params);
+                out.end();
+                out.execute();
             }
         }
+        out.sync();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::batch;
+    }
+
+    std::string_view
+    statement() const noexcept final {
+        const auto handle = _statement.resolve(_storage);
+        return _storage.has(handle) ? std::string_view(_storage.get(handle).name)
+                                    : _statement.name();
+    }
+};
+
+/**
+ * @brief Prepared statement execution over a named portal, in chunks
+ *
+ * Binds the statement to a named portal and executes it with a row limit.
+ * The messages are followed by Flush instead of Sync, which keeps the
+ * implicit transaction (and therefore the portal) open while the server
+ * is suspended: each resume(true) fetches the next chunk, and resume(false)
+ * closes the portal and completes the query with a Sync.
+ *
+ * @tparam CB_SUCCESS Type of success callback
+ * @tparam CB_ERROR Type of error callback
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+class PortalQuery final : public SqlQuery<CB_SUCCESS, CB_ERROR> {
+    const PreparedStorage &_storage;    ///< Prepared statement storage
+    PreparedRef const     &_statement;  ///< Statement to execute
+    std::string            _portal;     ///< Portal name
+    QueryParams            _params;     ///< Query parameters
+    integer                _fetch_size; ///< Maximum number of rows per chunk
 
-        // 6. Result format = 0 (none)
-        cmd.write((smallint) 0);
+public:
+    /**
+     * @brief Constructs a portal query
+     *
+     * @param storage Prepared statement storage
+     * @param statement Statement to execute
+     * @param portal Portal name
+     * @param params Query parameters
+     * @param fetch_size Maximum number of rows per chunk
+     * @param success Success callback
+     * @param error Error callback
+     */
+    PortalQuery(const PreparedStorage &storage, PreparedRef const &statement,
+                std::string_view portal, QueryParams &&params, integer fetch_size,
+                CB_SUCCESS &&success, CB_ERROR &&error)
+        : SqlQuery<CB_SUCCESS, CB_ERROR>(std::forward<CB_SUCCESS>(success),
+                                         std::forward<CB_ERROR>(error))
+        , _storage(storage)
+        , _statement(statement)
+        , _portal(portal)
+        , _params(std::move(params))
+        , _fetch_size(fetch_size > 0 ? fetch_size : 0) {}
+
+    bool
+    is_valid() const final {
+        if (qb::likely(_storage.has(_statement.resolve(_storage))))
+            return true;
+        LOG_CRIT("[pgsql] Error prepared query " << _statement.name() << " not registered");
+        return false;
+    }
+
+    bool
+    is_suspendable() const final {
+        return true;
+    }
+
+    void
+    encode(pipe_writer &out) const final {
+        out.begin(bind_tag);
+        write_bind(out, _portal, _storage.get(_statement.resolve(_storage)), _params);
+        out.end();
+        resume(out, true);
+    }
 
-        // 7. Execute message (empty portal, no row limit)
-        message execute(execute_tag);
-        execute.write("");
-        execute.write(0);
-        cmd.pack(execute);
+    /**
+     * @brief Writes Execute + Flush for the next chunk, or Close + Sync
+     *
+     * @param out Writer over the output pipe
+     * @param fetch True to fetch the next chunk, false to close the portal
+     */
+    void
+    resume(pipe_writer &out, bool fetch) const final {
+        if (fetch) {
+            out.begin(execute_tag);
+            out.write(_portal);
+            out.write(_fetch_size);
+            out.end();
+            out.flush();
+            return;
+        }
+        out.begin(close_tag);
+        out.write('P');
+        out.write(_portal);
+        out.end();
+        out.sync();
+    }
+
+    query_kind
+    kind() const noexcept final {
+        return query_kind::portal;
+    }
 
-        // 8. Sync message
-        cmd.pack(message(sync_tag));
-        return cmd;
+    std::string_view
+    statement() const noexcept final {
+        const auto handle = _statement.resolve(_storage);
+        return _storage.has(handle) ? std::string_view(_storage.get(handle).name)
+                                    : _statement.name();
     }
 };
 
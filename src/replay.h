@@ -0,0 +1,201 @@
+/**
+ * @file replay.h
+ * @brief Offline replay of a wire protocol capture
+ *
+ * A WireReplay feeds the backend frames of a capture to a handler through
+ * the qb::protocol::pgsql framing, as if they were read from a socket. With
+ * a Database in replay mode as handler, the captured messages answer the
+ * commands queued on it, so the framing, the row decoding and the
+ * conversions done by the callbacks are measured without a server and
+ * without network noise:
+ *
+ * @code
+ * qb::pg::tcp::database db;
+ * db.replay(true);
+ * for (int i = 0; i < 1000; ++i)
+ *     db.execute("get_orders", qb::pg::params{i}, on_orders); // Requests of the capture
+ * qb::pg::wire_capture capture("orders.cap");
+ * qb::pg::tcp::replay replay(db);
+ * auto stats = replay.run(capture);
+ * @endcode
+ *
+ * Included by pgsql.h after the definition of the protocol and Database.
+ *
+ * @see qb::pg::detail::WireCapture
+ * @see qb::pg::detail::Database::replay
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Pace of a replay
+ */
+enum class replay_pacing : std::uint8_t {
+    fast,     ///< Frames are fed as fast as the handler consumes them
+    recorded, ///< Frames are fed at the times they were captured
+};
+
+/**
+ * @brief Outcome of a replay
+ */
+struct ReplayStats {
+    std::size_t              frames{0};   ///< Backend frames fed
+    std::size_t              messages{0}; ///< Messages handled, streamed DataRows included
+    std::size_t              bytes{0};    ///< Bytes fed
+    std::chrono::nanoseconds elapsed{0};  ///< Duration of the replay
+    bool                     ok{true};    ///< False if the framing failed on a frame
+
+    /**
+     * @brief Gets the replay throughput
+     *
+     * @return double Messages handled per second
+     */
+    [[nodiscard]] double
+    messages_per_second() const noexcept {
+        return elapsed.count() ? messages * 1e9 / static_cast<double>(elapsed.count()) : 0.;
+    }
+};
+
+/**
+ * @brief Feeds the backend frames of a capture to a message handler
+ *
+ * The handler is any type with the Database interface used by the
+ * protocol: on(message_view) and field_stream().
+ *
+ * @tparam Handler Type of the message handler
+ */
+template <typename Handler>
+class WireReplay {
+public:
+    /// Message type forwarded by the protocol
+    using message  = message_view;
+    using protocol  = qb::protocol::pgsql<WireReplay<Handler>>;
+
+private:
+    Handler                  &_handler;  ///< Receives the framed messages
+    qb::allocator::pipe<char> _in;       ///< Bytes fed and not framed yet
+    protocol                  _protocol; ///< Framing of the fed bytes
+    std::size_t               _messages{0}; ///< Messages forwarded
+
+public:
+    /**
+     * @brief Constructs a replay towards a handler
+     *
+     * @param handler Handler of the replayed messages, must outlive the replay
+     */
+    explicit WireReplay(Handler &handler)
+        : _handler(handler)
+        , _protocol(*this) {}
+
+    WireReplay(WireReplay const &)            = delete;
+    WireReplay &operator=(WireReplay const &) = delete;
+
+    /**
+     * @brief Gets the bytes fed and not framed yet, read by the protocol
+     */
+    qb::allocator::pipe<char> &
+    in() noexcept {
+        return _in;
+    }
+
+    /**
+     * @brief Forwards a framed message to the handler
+     */
+    void
+    on(message &msg) {
+        ++_messages;
+        _handler.on(msg);
+    }
+
+    /**
+     * @brief Gets the columns streamed by the handler, read by the protocol
+     */
+    FieldStream *
+    field_stream() {
+        return _handler.field_stream();
+    }
+
+    /**
+     * @brief Feeds bytes as if they were read from the socket
+     *
+     * @param data Bytes received
+     * @param size Number of bytes
+     * @return bool False if the framing failed
+     */
+    bool
+    feed(const char *data, std::size_t size) {
+        std::memcpy(_in.allocate_back(size), data, size);
+        while (const auto message_size = _protocol.getMessageSize()) {
+            _protocol.onMessage(message_size);
+            _in.free_front(message_size);
+        }
+        if (!_in.size())
+            _in.reset();
+        return _protocol.ok();
+    }
+
+    /**
+     * @brief Replays the backend frames of a capture, from its current frame
+     *
+     * @param capture Capture to replay
+     * @param pacing Pace of the replay
+     * @param skip_startup Skips the frames up to the first ReadyForQuery,
+     * which answer the startup and authentication of the captured session
+     * @return ReplayStats Frames, messages and time of the replay
+     */
+    ReplayStats
+    run(WireCapture &capture, replay_pacing pacing = replay_pacing::fast,
+        bool skip_startup = true) {
+        ReplayStats stats;
+        WireFrame   frame;
+        bool        started  = !skip_startup;
+        const auto  messages = _messages;
+        const auto  start    = std::chrono::steady_clock::now();
+        std::chrono::nanoseconds origin{-1};
+        while (capture.next(frame)) {
+            if (frame.direction != wire_direction::backend || frame.bytes.empty())
+                continue;
+            if (!started) {
+                started = frame.bytes.front() == ready_for_query_tag;
+                continue;
+            }
+            if (pacing == replay_pacing::recorded) {
+                if (origin.count() < 0)
+                    origin = frame.at;
+                std::this_thread::sleep_until(start + (frame.at - origin));
+            }
+            ++stats.frames;
+            stats.bytes += frame.bytes.size();
+            if (!feed(frame.bytes.data(), frame.bytes.size())) {
+                stats.ok = false;
+                break;
+            }
+        }
+        stats.elapsed  = std::chrono::steady_clock::now() - start;
+        stats.messages = _messages - messages;
+        return stats;
+    }
+};
+
+} // namespace qb::pg::detail
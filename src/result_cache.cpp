@@ -0,0 +1,132 @@
+/**
+ * @file result_cache.cpp
+ * @brief Read-through cache of the results of prepared statements
+ *
+ * @see result_cache.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include "./result_cache.h"
+
+namespace qb::pg::detail {
+
+void
+ResultCache::evict_expired(clock::time_point now) {
+    for (auto &[name, statement] : _statements) {
+        auto &entries = statement.entries;
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.expires <= now) {
+                it = entries.erase(it);
+                --_size;
+            } else
+                ++it;
+        }
+    }
+}
+
+void
+ResultCache::cache(std::string_view statement, std::chrono::milliseconds ttl,
+                   std::vector<std::string> tags) {
+    auto it = _statements.try_emplace(std::string(statement)).first;
+    _size -= it->second.entries.size();
+    it->second.entries.clear();
+    it->second.ttl  = ttl;
+    it->second.tags = std::move(tags);
+}
+
+void
+ResultCache::uncache(std::string_view statement) {
+    auto it = _statements.find(statement);
+    if (it == _statements.end())
+        return;
+    _size -= it->second.entries.size();
+    _statements.erase(it);
+}
+
+ResultCache::shared_result
+ResultCache::find(std::string_view statement, QueryParams const &params) {
+    auto it = _statements.find(statement);
+    if (it == _statements.end())
+        return {};
+    auto &entries = it->second.entries;
+    auto  entry   = entries.find(key(params));
+    if (entry != entries.end()) {
+        if (entry->second.expires > clock::now()) {
+            ++_hits;
+            return entry->second.result;
+        }
+        entries.erase(entry);
+        --_size;
+    }
+    ++_misses;
+    return {};
+}
+
+ResultCache::shared_result
+ResultCache::store(std::string_view statement, QueryParams const &params, result_impl &&result) {
+    auto it = _statements.find(statement);
+    if (it == _statements.end())
+        return {};
+
+    auto       shared = std::make_shared<const result_impl>(std::move(result));
+    const auto now    = clock::now();
+    auto      &entries = it->second.entries;
+    auto       entry   = entries.find(key(params));
+    if (entry == entries.end()) {
+        if (_size >= _capacity)
+            evict_expired(now);
+        if (_size >= _capacity)
+            return shared;
+        entry = entries.emplace(std::string(key(params)), Entry{}).first;
+        ++_size;
+    }
+    entry->second = Entry{shared, now + it->second.ttl};
+    return shared;
+}
+
+std::size_t
+ResultCache::invalidate_tag(std::string_view tag) {
+    std::size_t dropped = 0;
+    for (auto &[name, statement] : _statements) {
+        if (std::find(statement.tags.begin(), statement.tags.end(), tag) == statement.tags.end())
+            continue;
+        dropped += statement.entries.size();
+        statement.entries.clear();
+    }
+    _size -= dropped;
+    return dropped;
+}
+
+std::size_t
+ResultCache::invalidate(std::string_view statement) {
+    auto it = _statements.find(statement);
+    if (it == _statements.end())
+        return 0;
+    const auto dropped = it->second.entries.size();
+    it->second.entries.clear();
+    _size -= dropped;
+    return dropped;
+}
+
+void
+ResultCache::clear() noexcept {
+    for (auto &[name, statement] : _statements)
+        statement.entries.clear();
+    _size = 0;
+}
+
+} // namespace qb::pg::detail
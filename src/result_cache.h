@@ -0,0 +1,216 @@
+/**
+ * @file result_cache.h
+ * @brief Read-through cache of the results of prepared statements
+ *
+ * Lookups of rarely changing rows (configuration, profiles) are often
+ * executed thousands of times per second with the same parameters. The
+ * ResultCache of a connection keeps the results of the statements declared
+ * cacheable, keyed by statement name and serialized parameters:
+ *
+ * - a hit is served from memory without touching the socket, to the same
+ *   callback, over the cached rows shared by every hit and never copied
+ * - entries expire after the time-to-live of their statement
+ * - statements are tagged with notification channels; a NOTIFY on one of
+ *   them drops the entries of every statement carrying the tag
+ *
+ * Results are neither served nor stored inside transaction blocks, whose
+ * reads may see their own uncommitted writes.
+ *
+ * @see qb::pg::detail::Database::cache_results
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./queries.h"
+#include "./result_impl.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Results of cacheable prepared statements of one connection
+ *
+ * Not thread-safe: used from the thread running the I/O loop of its
+ * connection, like the connection itself.
+ */
+class ResultCache {
+public:
+    using clock = std::chrono::steady_clock;
+    /// Cached rows, shared by every hit and never modified
+    using shared_result = std::shared_ptr<const result_impl>;
+
+private:
+    /**
+     * @brief Cached result and its expiry
+     */
+    struct Entry {
+        shared_result     result;  ///< Rows of the result
+        clock::time_point expires; ///< End of validity
+    };
+
+    /**
+     * @brief Cacheable statement and its entries
+     */
+    struct Statement {
+        std::chrono::milliseconds ttl; ///< Time-to-live of the entries
+        std::vector<std::string>  tags; ///< Channels invalidating the entries
+        std::map<std::string, Entry, std::less<>> entries; ///< Entries, by serialized parameters
+    };
+
+    std::map<std::string, Statement, std::less<>> _statements; ///< Cacheable statements, by name
+    std::size_t _capacity{4096}; ///< Maximum number of entries
+    std::size_t _size{0};        ///< Number of entries
+    std::size_t _hits{0};        ///< Executions served from the cache
+    std::size_t _misses{0};      ///< Executions of cacheable statements sent to the server
+
+    /**
+     * @brief Gets the cache key of a parameter set
+     */
+    static std::string_view
+    key(QueryParams const &params) noexcept {
+        auto const &buffer = params.get();
+        return std::string_view(buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief Drops the expired entries of every statement
+     */
+    void evict_expired(clock::time_point now);
+
+public:
+    /**
+     * @brief Declares a statement cacheable
+     *
+     * Declaring a statement again replaces its time-to-live and tags and
+     * drops its entries.
+     *
+     * @param statement Name of the prepared statement
+     * @param ttl Time-to-live of its entries
+     * @param tags Notification channels invalidating its entries
+     */
+    void cache(std::string_view statement, std::chrono::milliseconds ttl,
+               std::vector<std::string> tags);
+
+    /**
+     * @brief Makes a statement uncacheable again, dropping its entries
+     *
+     * @param statement Name of the prepared statement
+     */
+    void uncache(std::string_view statement);
+
+    /**
+     * @brief Checks if the results of a statement are cached
+     *
+     * @param statement Name of the prepared statement
+     */
+    [[nodiscard]] bool
+    caches(std::string_view statement) const {
+        return !_statements.empty() && _statements.find(statement) != _statements.end();
+    }
+
+    /**
+     * @brief Looks up the result of an execution
+     *
+     * Counts a hit or a miss; expired entries are dropped.
+     *
+     * @param statement Name of a cacheable statement
+     * @param params Parameters of the execution
+     * @return shared_result Cached rows, empty on a miss
+     */
+    shared_result find(std::string_view statement, QueryParams const &params);
+
+    /**
+     * @brief Stores the result of an execution
+     *
+     * When the cache is full, expired entries are dropped first; if none
+     * expired, the result is not stored.
+     *
+     * @param statement Name of a cacheable statement
+     * @param params Parameters of the execution
+     * @param result Rows of the result
+     * @return shared_result Stored rows, empty if the statement is not cacheable
+     */
+    shared_result store(std::string_view statement, QueryParams const &params,
+                        result_impl &&result);
+
+    /**
+     * @brief Drops the entries of the statements carrying a tag
+     *
+     * @param tag Channel name given when declaring the statements
+     * @return std::size_t Number of dropped entries
+     */
+    std::size_t invalidate_tag(std::string_view tag);
+
+    /**
+     * @brief Drops the entries of a statement
+     *
+     * @param statement Name of the prepared statement
+     * @return std::size_t Number of dropped entries
+     */
+    std::size_t invalidate(std::string_view statement);
+
+    /**
+     * @brief Drops every entry, keeping the cacheable statements
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Sets the maximum number of entries
+     */
+    void
+    capacity(std::size_t entries) noexcept {
+        _capacity = entries;
+    }
+
+    [[nodiscard]] std::size_t
+    capacity() const noexcept {
+        return _capacity;
+    }
+
+    [[nodiscard]] std::size_t
+    size() const noexcept {
+        return _size;
+    }
+
+    [[nodiscard]] std::size_t
+    hits() const noexcept {
+        return _hits;
+    }
+
+    [[nodiscard]] std::size_t
+    misses() const noexcept {
+        return _misses;
+    }
+};
+
+/**
+ * @brief Execution of a cacheable statement, stored in the cache once answered
+ */
+struct CacheFill {
+    ResultCache *cache;     ///< Cache storing the result
+    std::string  statement; ///< Name of the statement
+    QueryParams  params;    ///< Parameters of the execution, keying the entry
+};
+
+} // namespace qb::pg::detail
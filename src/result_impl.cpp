@@ -7,6 +7,7 @@
  * used by the resultset class to handle PostgreSQL query results.
  *
  * Implementation details include:
+ * - Decoding of data rows into the compact row storage
  * - Row and field data access
  * - NULL value detection
  * - Buffer management for field values
@@ -31,22 +32,204 @@
  */
 
 #include "./result_impl.h"
+#include <algorithm>
+#include <cstring>
 #include <exception>
 #include <iostream>
+#include <qb/utility/branch_hints.h>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include "./byte_order.h"
 
 namespace qb {
 namespace pg {
 namespace detail {
 
+/**
+ * Starts a new row, fixing the result set width on the first one
+ * @param width Number of fields in the row
+ * @return true if the row width matches the previous rows
+ */
+bool
+result_impl::begin_row(usmallint width) {
+    if (row_count_ == 0)
+        columns_ = width;
+    else if (width != columns_)
+        return false;
+
+    // Geometric growth: an exact reservation would reallocate on every row
+    const size_t bits = slots_.size() + width;
+    if (slots_.capacity() < bits)
+        slots_.reserve(std::max(bits, 2 * slots_.capacity()));
+    if (nulls_.size() * 64 < bits)
+        nulls_.resize((bits + 63) / 64, 0);
+    return true;
+}
+
+/**
+ * Drops a partially appended row, restoring the previous state
+ * @param slots Slot table size before the row
+ * @param bytes Data slab size before the row
+ */
+void
+result_impl::rollback_row(size_t slots, size_t bytes) {
+    for (size_t i = slots; i < slots_.size(); ++i)
+        nulls_[i / 64] &= ~(uint64_t(1) << (i % 64));
+    slots_.resize(slots);
+    data_.resize(bytes);
+    if (row_count_ == 0)
+        columns_ = 0;
+}
+
+/**
+ * Decodes a DataRow message directly into the result set storage
+ * @param msg DataRow message positioned at the column count
+ * @return true if the row was appended
+ */
+bool
+result_impl::append_row(message_view &msg) {
+    // Read in place; each length and value is checked against the message end
+    const char *const start = msg.input();
+    const char *const end   = start + msg.available();
+    const char       *p     = start;
+    if (end - p < static_cast<std::ptrdiff_t>(sizeof(smallint)) ||
+        qb::unlikely(!fits(msg.available())))
+        return false;
+    const auto col_count = load_be<smallint>(p);
+    p += sizeof(smallint);
+    if (col_count < 0 || !begin_row(static_cast<usmallint>(col_count)))
+        return false;
+
+    const size_t slots = slots_.size();
+    const size_t bytes = data_.size();
+    for (smallint i = 0; i < col_count; ++i) {
+        if (end - p < static_cast<std::ptrdiff_t>(sizeof(integer))) {
+            rollback_row(slots, bytes);
+            return false;
+        }
+        const auto col_size = load_be<integer>(p);
+        p += sizeof(integer);
+        const size_t index = slots_.size();
+        if (col_size < 0) {
+            slots_.push_back({static_cast<uinteger>(data_.size()), -1});
+            nulls_[index / 64] |= uint64_t(1) << (index % 64);
+        } else {
+            if (end - p < col_size) {
+                rollback_row(slots, bytes);
+                return false;
+            }
+            slots_.push_back({static_cast<uinteger>(data_.size()), col_size});
+            data_.insert(data_.end(), p, p + col_size);
+            p += col_size;
+        }
+    }
+    msg.advance(static_cast<size_t>(p - start));
+    ++row_count_;
+    return true;
+}
+
+/**
+ * Copies an already decoded row into the result set storage
+ * @param row Row data to append
+ * @return true if the row was appended
+ */
+bool
+result_impl::append_row(row_data const &row) {
+    if (!begin_row(row.size()))
+        return false;
+
+    const size_t slots = slots_.size();
+    const size_t bytes = data_.size();
+
+    for (row_data::size_type i = 0; i < row.size(); ++i) {
+        const size_t index = slots_.size();
+        if (row.is_null(i)) {
+            slots_.push_back({static_cast<uinteger>(data_.size()), -1});
+            nulls_[index / 64] |= uint64_t(1) << (index % 64);
+        } else {
+            auto bounds = row.field_buffer_bounds(i);
+            if (qb::unlikely(!fits(static_cast<size_t>(bounds.second - bounds.first)))) {
+                rollback_row(slots, bytes);
+                return false;
+            }
+            slots_.push_back({static_cast<uinteger>(data_.size()),
+                              static_cast<integer>(bounds.second - bounds.first)});
+            data_.insert(data_.end(), bounds.first, bounds.second);
+        }
+    }
+    ++row_count_;
+    return true;
+}
+
+/**
+ * Constructs an empty result set over a memory resource
+ * @param resource Memory resource of the rows
+ */
+result_impl::result_impl(std::pmr::memory_resource *resource) noexcept
+    : data_(resource)
+    , slots_(resource)
+    , nulls_(resource) {}
+
+/**
+ * Returns the memory resource of the rows
+ * @return Memory resource shared by the three buffers
+ */
+std::pmr::memory_resource *
+result_impl::memory_resource() const noexcept {
+    return data_.get_allocator().resource();
+}
+
+/**
+ * Moves the rows to another memory resource
+ * @param resource New memory resource
+ */
+void
+result_impl::memory_resource(std::pmr::memory_resource *resource) {
+    const ResourceAllocator<byte> allocator(resource);
+    if (allocator.resource() == memory_resource())
+        return;
+    data_buffer data(data_.begin(), data_.end(), allocator);
+    slot_table  slots(slots_.begin(), slots_.end(), allocator);
+    null_bitmap nulls(nulls_.begin(), nulls_.end(), allocator);
+    data_.swap(data);
+    slots_.swap(slots);
+    nulls_.swap(nulls);
+}
+
+/**
+ * Reserves storage for an expected number of rows
+ * @param rows Number of rows
+ * @param data_bytes Expected total size of field data in bytes
+ */
+void
+result_impl::reserve(size_t rows, size_t data_bytes) {
+    const size_t width = columns_ ? columns_ : row_description_.size();
+    slots_.reserve(rows * width);
+    nulls_.reserve((rows * width + 63) / 64);
+    if (data_bytes)
+        data_.reserve(data_bytes);
+}
+
+/**
+ * Removes all rows, keeping the row description and allocated capacity
+ */
+void
+result_impl::clear_rows() {
+    data_.clear();
+    slots_.clear();
+    nulls_.clear();
+    row_count_ = 0;
+    columns_   = 0;
+}
+
 /**
  * Returns the number of rows in the result set
  * @return Row count
  */
 size_t
 result_impl::size() const {
-    return rows_.size();
+    return row_count_;
 }
 
 /**
@@ -55,7 +238,35 @@ result_impl::size() const {
  */
 bool
 result_impl::empty() const {
-    return rows_.empty();
+    return row_count_ == 0;
+}
+
+/**
+ * Returns the number of fields in each stored row
+ * @return Fields per row
+ */
+usmallint
+result_impl::columns() const {
+    return columns_;
+}
+
+/**
+ * Returns the total size of the field data slab
+ * @return Size in bytes
+ */
+size_t
+result_impl::data_size() const {
+    return data_.size();
+}
+
+/**
+ * Returns the memory used by the stored rows, as counted by result limits
+ * @return Size in bytes
+ */
+size_t
+result_impl::memory_size() const {
+    return data_.size() + slots_.size() * sizeof(field_slot) +
+           nulls_.size() * sizeof(uint64_t);
 }
 
 /**
@@ -65,11 +276,29 @@ result_impl::empty() const {
  */
 void
 result_impl::check_row_index(uinteger row) const {
-    if (row >= rows_.size()) {
+    if (row >= row_count_) {
+        std::ostringstream out;
+        out << "Row index " << row << " is out of bounds [0.." << row_count_ << ")";
+        throw std::out_of_range(out.str().c_str());
+    }
+}
+
+/**
+ * Computes the position of a field in the slot table
+ * @param row The row index
+ * @param col The column index
+ * @return Index in the slot table and null bitmap
+ * @throws std::out_of_range if either index is invalid
+ */
+size_t
+result_impl::slot_index(uinteger row, usmallint col) const {
+    check_row_index(row);
+    if (col >= columns_) {
         std::ostringstream out;
-        out << "Row index " << row << " is out of bounds [0.." << rows_.size() << ")";
+        out << "Field index " << col << " is out of range [0.." << columns_ << ")";
         throw std::out_of_range(out.str().c_str());
     }
+    return static_cast<size_t>(row) * columns_ + col;
 }
 
 /**
@@ -81,9 +310,9 @@ result_impl::check_row_index(uinteger row) const {
  */
 field_buffer
 result_impl::at(uinteger row, usmallint col) const {
-    check_row_index(row);
-    row_data const &rd = rows_[row];
-    return rd.field_data(col);
+    field_slot const &slot  = slots_[slot_index(row, col)];
+    const byte       *first = data_.data() + slot.offset;
+    return field_buffer(first, first + (slot.length > 0 ? slot.length : 0));
 }
 
 /**
@@ -95,9 +324,8 @@ result_impl::at(uinteger row, usmallint col) const {
  */
 bool
 result_impl::is_null(uinteger row, usmallint col) const {
-    check_row_index(row);
-    row_data const &rd = rows_[row];
-    return rd.is_null(col);
+    const size_t index = slot_index(row, col);
+    return (nulls_[index / 64] >> (index % 64)) & 1;
 }
 
 /**
@@ -107,11 +335,89 @@ result_impl::is_null(uinteger row, usmallint col) const {
  * @return Buffer boundaries for the specified field
  * @throws std::out_of_range if the row index is invalid
  */
-row_data::data_buffer_bounds
+result_impl::data_buffer_bounds
 result_impl::buffer_bounds(uinteger row, usmallint col) const {
-    check_row_index(row);
-    row_data const &rd = rows_[row];
-    return rd.field_buffer_bounds(col);
+    field_slot const &slot  = slots_[slot_index(row, col)];
+    auto              first = data_.begin() + slot.offset;
+    return std::make_pair(first, first + (slot.length > 0 ? slot.length : 0));
+}
+
+/**
+ * Gets a view over the bytes of a field value
+ * @param row The row index
+ * @param col The column index
+ * @return View over the field data (empty for NULL)
+ * @throws std::out_of_range if the row index is invalid
+ */
+std::string_view
+result_impl::view(uinteger row, usmallint col) const {
+    field_slot const &slot = slots_[slot_index(row, col)];
+    if (slot.length <= 0)
+        return {};
+    return std::string_view(data_.data() + slot.offset,
+                            static_cast<size_t>(slot.length));
+}
+
+namespace {
+
+template <size_t Width>
+size_t
+gather_values(result_impl::field_slot const *slot, size_t rows, usmallint stride,
+              byte const *data, byte *out, uint64_t *nulls) {
+    size_t null_count = 0;
+    for (size_t r = 0; r < rows; ++r, slot += stride, out += Width) {
+        if (slot->length < 0) {
+            std::memset(out, 0, Width);
+            if (nulls)
+                nulls[r / 64] |= uint64_t{1} << (r % 64);
+            ++null_count;
+        } else if (qb::likely(slot->length == static_cast<integer>(Width))) {
+            std::memcpy(out, data + slot->offset, Width);
+        } else {
+            throw std::runtime_error("Column value size does not match the requested type");
+        }
+    }
+    return null_count;
+}
+
+} // namespace
+
+/**
+ * Copies a binary fixed-width column into a contiguous buffer
+ * @param col The column index
+ * @param width Size of each value in bytes
+ * @param out Destination buffer of size() * width bytes
+ * @param nulls Null bitmap receiving one bit per NULL row, or nullptr
+ * @return Number of NULL values
+ * @throws std::out_of_range if the column index is invalid
+ * @throws std::runtime_error if a value has another size
+ */
+size_t
+result_impl::gather_column(usmallint col, size_t width, void *out, uint64_t *nulls) const {
+    if (!row_count_)
+        return 0;
+    const size_t first = slot_index(0, col);
+    const auto  *slot  = slots_.data() + first;
+    auto        *dest  = static_cast<byte *>(out);
+    size_t       null_count;
+    switch (width) {
+        case 1:
+            null_count = gather_values<1>(slot, row_count_, columns_, data_.data(), dest, nulls);
+            break;
+        case 2:
+            null_count = gather_values<2>(slot, row_count_, columns_, data_.data(), dest, nulls);
+            break;
+        case 4:
+            null_count = gather_values<4>(slot, row_count_, columns_, data_.data(), dest, nulls);
+            break;
+        case 8:
+            null_count = gather_values<8>(slot, row_count_, columns_, data_.data(), dest, nulls);
+            break;
+        default:
+            throw std::runtime_error("Unsupported column value size");
+    }
+    big_to_host(dest, row_count_, width);
+    return null_count;
 }
 
 } /* namespace detail */
@@ -34,9 +34,13 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <string_view>
 #include <vector>
 
 #include "./common.h"
+#include "./memory.h"
 #include "./protocol.h"
 
 namespace qb {
@@ -49,16 +53,51 @@ namespace detail {
  * Provides the storage and access mechanisms for PostgreSQL query results.
  * This class is used by the resultset class to implement its functionality
  * while hiding implementation details from public API users.
+ *
+ * Rows are stored in a compact layout shared by the whole result set:
+ * - one contiguous slab holding the bytes of every non-NULL field
+ * - a flat table of (offset, length) slots, one per field, row-major
+ * - a null bitmap with one bit per field
+ *
+ * Data rows are decoded straight from the wire message into this storage, so
+ * a result set only allocates when one of these three buffers grows. The
+ * buffers draw from the memory resource of the result set, which moves with
+ * them; copies are allocated from the default resource.
  */
 class result_impl {
 public:
-    /// Type definition for a collection of row data
-    typedef std::vector<row_data> row_set_type;
+    /// Type definition for the contiguous field data slab
+    typedef std::vector<byte, ResourceAllocator<byte>> data_buffer;
+    /// Range of iterators over a field's bytes in the slab
+    typedef std::pair<data_buffer::const_iterator, data_buffer::const_iterator>
+        data_buffer_bounds;
+
+    /**
+     * @brief Location of a field value in the data slab
+     */
+    struct field_slot {
+        uinteger offset; ///< Offset of the first byte in the slab
+        integer  length; ///< Length in bytes, -1 for NULL
+    };
+
+    /// Largest data slab whose offsets a field_slot can hold
+    static constexpr size_t max_data_size = std::numeric_limits<uinteger>::max();
+
+    /// Type definition for the flat field slot table
+    typedef std::vector<field_slot, ResourceAllocator<field_slot>> slot_table;
+    /// Type definition for the null bitmap
+    typedef std::vector<uint64_t, ResourceAllocator<uint64_t>> null_bitmap;
 
 public:
-    /// Default constructor
+    /// Default constructor, allocating from the default memory resource
     result_impl() = default;
 
+    /**
+     * @brief Constructs an empty result set allocating from a memory resource
+     * @param resource Memory resource of the rows, nullptr for the default one
+     */
+    explicit result_impl(std::pmr::memory_resource *resource) noexcept;
+
     /// Copy constructor
     result_impl(result_impl &) = default;
 
@@ -90,13 +129,54 @@ public:
     }
 
     /**
-     * @brief Get mutable reference to the rows collection
-     * @return Reference to rows collection
+     * @brief Decode a DataRow message and append it to the result set
+     *
+     * The field bytes are copied once, from the message straight into the
+     * data slab. On failure the result set is left unchanged.
+     *
+     * @param msg DataRow message positioned at the column count
+     * @return true if the row was appended, false if the message is malformed
+     *         or its width differs from the previous rows
      */
-    row_set_type &
-    rows() {
-        return rows_;
-    }
+    bool append_row(message_view &msg);
+
+    /**
+     * @brief Append an already decoded row to the result set
+     *
+     * @param row Row data to copy into the result set storage
+     * @return true if the row was appended, false if its width differs
+     *         from the previous rows
+     */
+    bool append_row(row_data const &row);
+
+    /**
+     * @brief Get the memory resource the rows are allocated from
+     * @return Memory resource, never null
+     */
+    std::pmr::memory_resource *memory_resource() const noexcept;
+
+    /**
+     * @brief Move the rows to another memory resource
+     *
+     * Rows already stored are copied into the new resource; the capacity of
+     * an empty result set is dropped. Does nothing if the resource is the
+     * current one.
+     *
+     * @param resource Memory resource of the rows, nullptr for the default one
+     */
+    void memory_resource(std::pmr::memory_resource *resource);
+
+    /**
+     * @brief Reserve storage for an expected number of rows
+     * @param rows Number of rows
+     * @param data_bytes Expected total size of field data in bytes
+     */
+    void reserve(size_t rows, size_t data_bytes = 0);
+
+    /**
+     * @brief Remove all rows, keeping the row description and capacity
+     */
+    void clear_rows();
 
     /**
      * @brief Get the number of rows in the result set
@@ -110,6 +190,38 @@ public:
      */
     bool empty() const;
 
+    /**
+     * @brief Get the number of fields in each stored row
+     * @return Number of fields per row
+     */
+    usmallint columns() const;
+
+    /**
+     * @brief Get the total size of field data held by the result set
+     * @return Size of the data slab in bytes
+     */
+    size_t data_size() const;
+
+    /**
+     * @brief Checks if a row still fits in the data slab
+     *
+     * Field offsets are 32-bit, so the slab of a result set stays under
+     * max_data_size bytes; rows past it are refused by append_row().
+     *
+     * @param row_bytes Size of the row, or an upper bound of it
+     * @return True if the offsets of the row cannot wrap
+     */
+    [[nodiscard]] bool
+    fits(size_t row_bytes) const noexcept {
+        return row_bytes <= max_data_size - data_.size();
+    }
+
+    /**
+     * @brief Get the memory used by the stored rows
+     * @return Size of the data slab, slot table and null bitmap in bytes
+     */
+    size_t memory_size() const;
+
     /**
      * @brief Get field value at the specified row and column
      * @param row Row index
@@ -124,7 +236,15 @@ public:
      * @param col Column index
      * @return Buffer bounds for the specified field
      */
-    row_data::data_buffer_bounds buffer_bounds(uinteger row, usmallint col) const;
+    data_buffer_bounds buffer_bounds(uinteger row, usmallint col) const;
+
+    /**
+     * @brief Get a non-owning view over a field value
+     * @param row Row index
+     * @param col Column index
+     * @return View over the field bytes, valid while the result set is alive
+     */
+    std::string_view view(uinteger row, usmallint col) const;
 
     /**
      * @brief Check if a field value is NULL
@@ -134,6 +254,23 @@ public:
      */
     bool is_null(uinteger row, usmallint col) const;
 
+    /**
+     * @brief Copy a binary fixed-width column into a contiguous buffer
+     *
+     * Values are converted to host byte order in bulk; NULL values are
+     * zeroed and flagged in the null bitmap.
+     *
+     * @param col Column index
+     * @param width Size of each value in bytes
+     * @param out Buffer of size() * width bytes
+     * @param nulls Bitmap of (size() + 63) / 64 zeroed words receiving one
+     *        bit per NULL row, or nullptr
+     * @return Number of NULL values
+     * @throws std::out_of_range if the column index is invalid
+     * @throws std::runtime_error if a value is not @p width bytes long
+     */
+    size_t gather_column(usmallint col, size_t width, void *out, uint64_t *nulls) const;
+
 private:
     /**
      * @brief Verify that a row index is valid
@@ -142,8 +279,35 @@ private:
      */
     void check_row_index(uinteger row) const;
 
+    /**
+     * @brief Get the slot of a field, checking both indexes
+     * @param row Row index
+     * @param col Column index
+     * @return Index of the field in the slot table and null bitmap
+     * @throws std::out_of_range if an index is invalid
+     */
+    size_t slot_index(uinteger row, usmallint col) const;
+
+    /**
+     * @brief Start a new row of the given width
+     * @param width Number of fields in the row
+     * @return true if the width matches the result set
+     */
+    bool begin_row(usmallint width);
+
+    /**
+     * @brief Drop a partially appended row
+     * @param slots Slot table size before the row
+     * @param bytes Data slab size before the row
+     */
+    void rollback_row(size_t slots, size_t bytes);
+
     row_description_type row_description_; ///< Metadata about the result columns
-    row_set_type         rows_;            ///< Collection of result rows
+    data_buffer          data_;            ///< Bytes of all non-NULL fields
+    slot_table           slots_;           ///< Field locations, row-major
+    null_bitmap          nulls_;           ///< One bit per field, set when NULL
+    size_t               row_count_ = 0;   ///< Number of stored rows
+    usmallint            columns_   = 0;   ///< Number of fields per row
 };
 
 } /* namespace detail */
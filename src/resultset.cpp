@@ -159,6 +159,11 @@ resultset::field::input_buffer() const {
     return result_->at(row_index_, field_index_);
 }
 
+std::string_view
+resultset::field::view() const {
+    return result_->view(row_index_, field_index_);
+}
+
 //----------------------------------------------------------------------------
 // resultset::const_field_iterator implementation - Bidirectional iterator for fields
 //----------------------------------------------------------------------------
@@ -282,7 +287,7 @@ resultset::index_of_name(std::string const &name) const {
     // Find the field description with the matching name
     auto f =
         std::find_if(descriptions.begin(), descriptions.end(),
-                     [name](field_description const &fd) { return fd.name == name; });
+                     [&name](field_description const &fd) { return fd.name == name; });
     if (f != descriptions.end()) {
         // Return the index (position) of the field in the result set
         return f - descriptions.begin();
@@ -320,12 +325,62 @@ resultset::at(size_type r, row::size_type c) const {
     return pimpl_->at(r, c);
 }
 
+std::string_view
+resultset::view(size_type r, row::size_type c) const {
+    // Get a view over the value at the specified row and column
+    return pimpl_->view(r, c);
+}
+
 bool
 resultset::is_null(size_type r, row::size_type c) const {
     // Check if the value at the specified row and column is NULL
     return pimpl_->is_null(r, c);
 }
 
+resultset::size_type
+resultset::gather(row::size_type c, std::size_t width, void *out, uint64_t *nulls) const {
+    // Copy a binary fixed-width column and convert it to host byte order
+    return static_cast<size_type>(pimpl_->gather_column(c, width, out, nulls));
+}
+
+namespace {
+
+/**
+ * @brief Converts a binary-format field to its JSON representation
+ *
+ * Text-format fields are exported as-is; binary fields are decoded by type
+ * OID so that numbers, booleans, timestamps and UUIDs do not leak raw wire bytes.
+ */
+qb::json
+binary_field_json(class resultset::field const &field) {
+    switch (field.description().type_oid) {
+        case oid::boolean:
+            return field.as<bool>();
+        case oid::int2:
+            return field.as<smallint>();
+        case oid::int4:
+            return field.as<integer>();
+        case oid::int8:
+            return field.as<bigint>();
+        case oid::float4:
+            return field.as<float>();
+        case oid::float8:
+            return field.as<double>();
+        case oid::timestamp:
+        case oid::timestamptz:
+            return detail::TypeConverter<qb::Timestamp>::to_text(
+                field.as<qb::Timestamp>());
+        case oid::uuid:
+            return detail::TypeConverter<qb::uuid>::to_text(field.as<qb::uuid>());
+        case oid::bytea:
+            return detail::TypeConverter<bytea>::to_text(field.as<bytea>());
+        default:
+            return field.as<std::string>();
+    }
+}
+
+} // namespace
+
 qb::json
 resultset::json() const {
     qb::json result = qb::json::array();
@@ -333,6 +388,11 @@ resultset::json() const {
     for (const auto row : *this) {
         qb::json row_obj = qb::json::object();
         for (const auto field : row) {
+            if (!field.is_null() &&
+                field.description().format_code == protocol_data_format::Binary) {
+                row_obj[field.name()] = binary_field_json(field);
+                continue;
+            }
             auto opt = field.as<std::optional<std::string>>();
             row_obj[field.name()] = opt;
         }
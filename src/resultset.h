@@ -44,7 +44,9 @@
 #include <istream>
 #include <iterator>
 #include <memory>
+#include <string_view>
 #include <tuple>
+#include <vector>
 #include <qb/json.h>
 #include "./common.h"
 #include "./data_iterator.h"
@@ -397,6 +399,13 @@ public:
 
         bool empty() const; /**< @brief Is field value empty (not null) */
 
+        /**
+         * Raw bytes of the field value in the wire format of the column.
+         * The view points into the result set storage and stays valid as long
+         * as the result set is alive. Empty for NULL values.
+         */
+        std::string_view view() const;
+
         /**
          * Parse the value buffer to the type specified by value passed as
          * target. Will throw a value_is_null exception if the field is null and
@@ -460,20 +469,21 @@ public:
                 }
             }
 
-            // 2. Retrieve the data and format
-            field_buffer buffer = input_buffer();
-            bool         is_binary =
+            // 2. Retrieve the data and format, decoding in place
+            std::string_view data = view();
+            bool             is_binary =
                 (description().format_code == pg::protocol_data_format::Binary);
-            auto data_vector = buffer.to_vector();
 
             // 3. Use the TypeConverter to convert according to format
             if (is_binary) {
-                return detail::TypeConverter<result_type>::from_binary(data_vector);
+                // Binary NUMERIC is formatted exactly instead of copied
+                if constexpr (std::is_same_v<result_type, std::string>) {
+                    if (description().type_oid == oid::numeric)
+                        return detail::NumericCodec::to_text(data);
+                }
+                return detail::TypeConverter<result_type>::from_binary(data);
             } else {
-                // For text format, we first need to read the string
-                static detail::ParamUnserializer unserializer;
-                std::string text_value = unserializer.read_string(data_vector);
-                return detail::TypeConverter<result_type>::from_text(text_value);
+                return detail::TypeConverter<result_type>::from_text(data);
             }
         }
 
@@ -653,6 +663,30 @@ public:
     std::string const &field_name(size_type col_index) const;
     //@}
 
+    //@{
+    /** @name Columnar interface */
+    /** One bit per row, set when the value is NULL */
+    typedef std::vector<uint64_t> null_bitmap;
+
+    /**
+     * Decode a whole column into a contiguous vector.
+     *
+     * Binary columns of smallint, integer, bigint, float and double are
+     * gathered in one pass and converted to host byte order with SIMD
+     * shuffles; other columns are decoded value by value. NULL values are
+     * stored as T{}.
+     * @tparam T value type, its size must match binary columns exactly
+     * @param col_index field index, must be in range of [0..columns_size)
+     * @param out receives one value per row
+     * @param nulls if not null, receives one bit per row set for NULL values
+     * @return number of NULL values
+     * @throws out_of_range exception
+     */
+    template <typename T>
+    size_type column(row::size_type col_index, std::vector<T> &out,
+                     null_bitmap *nulls = nullptr) const;
+    //@}
+
 private:
     friend class row;
 
@@ -663,7 +697,11 @@ private:
 
     field_buffer at(size_type r, row::size_type c) const;
 
+    std::string_view view(size_type r, row::size_type c) const;
+
     bool is_null(size_type r, row::size_type c) const;
+
+    size_type gather(row::size_type c, std::size_t width, void *out, uint64_t *nulls) const;
 }; // resultset
 
 inline resultset::row::difference_type
@@ -208,5 +208,37 @@ resultset::row::to(::std::initializer_list<::std::string> const &names,
     detail::row_data_by_name_extractor<T...>::get_values(*this, names, val...);
 }
 
+template <typename T>
+resultset::size_type
+resultset::column(row::size_type col_index, std::vector<T> &out, null_bitmap *nulls) const {
+    const auto rows = size();
+    out.resize(rows);
+    if (nulls)
+        nulls->assign((rows + 63) / 64, 0);
+
+    constexpr bool fixed_width =
+        std::is_same_v<T, smallint> || std::is_same_v<T, integer> ||
+        std::is_same_v<T, bigint> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+    if constexpr (fixed_width) {
+        if (field(col_index).format_code == protocol_data_format::Binary)
+            return gather(col_index, sizeof(T), out.data(), nulls ? nulls->data() : nullptr);
+    }
+
+    const bool binary = field(col_index).format_code == protocol_data_format::Binary;
+    size_type  null_count = 0;
+    for (size_type r = 0; r < rows; ++r) {
+        if (is_null(r, col_index)) {
+            out[r] = T{};
+            if (nulls)
+                (*nulls)[r / 64] |= uint64_t{1} << (r % 64);
+            ++null_count;
+        } else if (binary)
+            out[r] = detail::TypeConverter<T>::from_binary(view(r, col_index));
+        else
+            out[r] = detail::TypeConverter<T>::from_text(view(r, col_index));
+    }
+    return null_count;
+}
+
 } // namespace pg
 } // namespace qb
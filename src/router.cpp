@@ -0,0 +1,120 @@
+/**
+ * @file router.cpp
+ * @brief Classification of SQL statements for read/write routing
+ *
+ * The classifier is a single pass over the SQL text: it skips comments,
+ * string literals and quoted identifiers, and looks at the keywords only.
+ * It never proves more than the text shows, so anything unusual is routed
+ * to the primary.
+ *
+ * @see router.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cctype>
+#include "../pgsql.h"
+
+namespace qb::pg::detail {
+
+namespace {
+
+/// Keywords a read-only statement may start with
+constexpr std::array<std::string_view, 6> read_keywords = {"SELECT", "WITH", "VALUES",
+                                                           "TABLE",  "SHOW", "EXPLAIN"};
+
+/// Keywords or functions that make a statement write or lock rows
+constexpr std::array<std::string_view, 12> write_keywords = {
+    "INSERT", "UPDATE", "DELETE", "MERGE",   "INTO",   "SHARE",
+    "LOCK",   "CALL",   "COPY",   "NEXTVAL", "SETVAL", "PG_ADVISORY_LOCK"};
+
+bool
+is_word(char c) noexcept {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+/**
+ * @brief Compares a word of the SQL text to an upper-case keyword
+ */
+bool
+equals_keyword(std::string_view word, std::string_view keyword) noexcept {
+    if (word.size() != keyword.size())
+        return false;
+    for (std::size_t i = 0; i < word.size(); ++i)
+        if (std::toupper(static_cast<unsigned char>(word[i])) != keyword[i])
+            return false;
+    return true;
+}
+
+template <std::size_t N>
+bool
+is_one_of(std::string_view word, std::array<std::string_view, N> const &keywords) noexcept {
+    for (auto keyword : keywords)
+        if (equals_keyword(word, keyword))
+            return true;
+    return false;
+}
+
+} // namespace
+
+route
+classify_statement(std::string_view sql) noexcept {
+    bool        first = true;
+    std::size_t i     = 0;
+    while (i < sql.size()) {
+        const char c = sql[i];
+        if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+            // Line comment
+            while (i < sql.size() && sql[i] != '\n')
+                ++i;
+        } else if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*') {
+            // Block comment
+            const auto end = sql.find("*/", i + 2);
+            i              = end == std::string_view::npos ? sql.size() : end + 2;
+        } else if (c == '\'' || c == '"') {
+            // Literal or quoted identifier, quotes escaped by doubling
+            for (++i; i < sql.size(); ++i) {
+                if (sql[i] == c) {
+                    if (i + 1 < sql.size() && sql[i + 1] == c)
+                        ++i;
+                    else
+                        break;
+                }
+            }
+            ++i;
+        } else if (c == ';') {
+            // Several statements, the next ones may write
+            for (++i; i < sql.size(); ++i)
+                if (!std::isspace(static_cast<unsigned char>(sql[i])))
+                    return route::write;
+        } else if (is_word(c)) {
+            const auto start = i;
+            while (i < sql.size() && is_word(sql[i]))
+                ++i;
+            const auto word = sql.substr(start, i - start);
+            if (first) {
+                if (!is_one_of(word, read_keywords))
+                    return route::write;
+                first = false;
+            } else if (is_one_of(word, write_keywords))
+                return route::write;
+        } else
+            ++i;
+    }
+    return first ? route::write : route::read;
+}
+
+} // namespace qb::pg::detail
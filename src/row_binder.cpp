@@ -0,0 +1,43 @@
+/**
+ * @file row_binder.cpp
+ * @brief Resolution of the columns bound by row binders
+ *
+ * @see row_binder.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <string>
+#include "./row_binder.h"
+
+namespace qb::pg::detail {
+
+resultset::row::size_type
+resolve_column(row_description_type const &desc, std::string_view name,
+               std::size_t position) {
+    if (name.empty()) {
+        if (position >= desc.size())
+            throw error::db_error{"Not enough columns in row binding"};
+        return static_cast<resultset::row::size_type>(position);
+    }
+    const auto it = std::find_if(desc.begin(), desc.end(),
+                                 [name](field_description const &fd) { return fd.name == name; });
+    if (it == desc.end())
+        throw error::db_error{"Column not found in row binding: " + std::string(name)};
+    return static_cast<resultset::row::size_type>(it - desc.begin());
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,418 @@
+/**
+ * @file row_binder.h
+ * @brief Precomputed binding of result columns to tuples and structures
+ *
+ * row.to() and field.as<T>() resolve the column names and the column format
+ * again for each row. A binder resolves them once, from the row description
+ * of a result set or of a prepared statement, and then decodes each row
+ * with one indirect call per column:
+ *
+ * - RowBinder<T...> decodes rows into tuples, by position or by name
+ * - StructBinder<S, M...> decodes rows into the members of a structure,
+ *   described by column() descriptors that can be declared constexpr
+ *
+ * A binder built from a prepared statement serves every result set of that
+ * statement on the connection, as long as its result format is unchanged.
+ *
+ * @see qb::pg::detail::resultset
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "./resultset.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Finds the index of a bound column
+ *
+ * @param desc Row description of the result
+ * @param name Column name, empty to bind by position
+ * @param position Position used when the name is empty
+ * @return resultset::row::size_type Index of the column
+ * @throws error::db_error If the column does not exist
+ */
+resultset::row::size_type resolve_column(row_description_type const &desc,
+                                         std::string_view name, std::size_t position);
+
+/**
+ * @brief Column decoder resolved for one column of a result
+ */
+struct BoundColumn {
+    /// Decodes a field into the value pointed to by the second argument
+    using decoder_type = void (*)(resultset::row::reference const &, void *);
+
+    resultset::row::size_type index{0};         ///< Column index in the row
+    decoder_type              decoder{nullptr}; ///< Decoder for the column format
+
+    /**
+     * @brief Decodes a field into a value of type T
+     *
+     * @tparam T Destination type, std::optional for nullable columns
+     * @tparam Binary True for columns in the binary format
+     */
+    template <typename T, bool Binary>
+    static void
+    decode(resultset::row::reference const &field, void *out) {
+        auto &value = *static_cast<T *>(out);
+        if constexpr (io::traits::is_nullable<T>::value) {
+            if (field.is_null()) {
+                io::traits::nullable_traits<T>::set_null(value);
+                return;
+            }
+            using inner_type = typename T::value_type;
+            if constexpr (Binary)
+                value = TypeConverter<inner_type>::from_binary(field.view());
+            else
+                value = TypeConverter<inner_type>::from_text(field.view());
+        } else {
+            if (field.is_null())
+                throw error::value_is_null(field.name());
+            if constexpr (Binary)
+                value = TypeConverter<T>::from_binary(field.view());
+            else
+                value = TypeConverter<T>::from_text(field.view());
+        }
+    }
+
+    /**
+     * @brief Decodes a binary NUMERIC field into its exact text
+     *
+     * @tparam T std::string or std::optional<std::string>
+     */
+    template <typename T>
+    static void
+    decode_numeric_text(resultset::row::reference const &field, void *out) {
+        *static_cast<T *>(out) = field.as<T>();
+    }
+
+    /**
+     * @brief Resolves the column and decoder of a value of type T
+     *
+     * @param desc Row description of the result
+     * @param name Column name, empty to bind by position
+     * @param position Position used when the name is empty
+     * @return BoundColumn Resolved column
+     */
+    template <typename T>
+    static BoundColumn
+    resolve(row_description_type const &desc, std::string_view name,
+            std::size_t position) {
+        BoundColumn column;
+        column.index      = resolve_column(desc, name, position);
+        const bool binary = desc[column.index].format_code == protocol_data_format::Binary;
+        column.decoder    = binary ? &decode<T, true> : &decode<T, false>;
+        if constexpr (std::is_same_v<T, std::string> ||
+                      std::is_same_v<T, std::optional<std::string>>) {
+            if (binary && desc[column.index].type_oid == oid::numeric)
+                column.decoder = &decode_numeric_text<T>;
+        }
+        return column;
+    }
+};
+
+/**
+ * @brief Binder decoding rows into tuples
+ *
+ * @code
+ * qb::pg::row_binder<int, std::string> bind(result, {"id", "name"});
+ * for (auto const &row : result) {
+ *     auto [id, name] = bind(row);
+ * }
+ * @endcode
+ *
+ * @tparam T Types of the bound columns
+ */
+template <typename... T>
+class RowBinder {
+public:
+    using tuple_type = std::tuple<T...>;
+
+    static constexpr std::size_t size = sizeof...(T);
+
+private:
+    std::array<BoundColumn, size> _columns;
+
+    template <std::size_t... I>
+    void
+    resolve(row_description_type const &desc, std::string_view const *names,
+            std::index_sequence<I...>) {
+        ((_columns[I] = BoundColumn::resolve<T>(desc, names ? names[I] : std::string_view{},
+                                                I)),
+         ...);
+    }
+
+    template <std::size_t... I>
+    void
+    decode(resultset::row const &row, tuple_type &out, std::index_sequence<I...>) const {
+        ((_columns[I].decoder(row[_columns[I].index], &std::get<I>(out))), ...);
+    }
+
+    template <std::size_t... I>
+    void
+    decode(resultset::row const &row, std::tuple<T &...> out,
+           std::index_sequence<I...>) const {
+        ((_columns[I].decoder(row[_columns[I].index], &std::get<I>(out))), ...);
+    }
+
+public:
+    /**
+     * @brief Binds the first columns of a result, in order
+     *
+     * @param desc Row description, e.g. of a prepared statement
+     * @throws error::db_error If the result has fewer columns
+     */
+    explicit RowBinder(row_description_type const &desc) {
+        resolve(desc, nullptr, std::index_sequence_for<T...>{});
+    }
+
+    /**
+     * @brief Binds columns by name
+     *
+     * An empty name binds the column at the same position.
+     *
+     * @param desc Row description, e.g. of a prepared statement
+     * @param names Column names, one per bound type
+     * @throws error::db_error If a column does not exist
+     */
+    RowBinder(row_description_type const &desc, std::initializer_list<std::string_view> names) {
+        if (names.size() != size)
+            throw error::db_error{"Wrong number of names in row binding"};
+        resolve(desc, names.begin(), std::index_sequence_for<T...>{});
+    }
+
+    explicit RowBinder(resultset const &result)
+        : RowBinder(result.row_description()) {}
+
+    RowBinder(resultset const &result, std::initializer_list<std::string_view> names)
+        : RowBinder(result.row_description(), names) {}
+
+    /**
+     * @brief Decodes a row into a tuple
+     *
+     * @param row Row of a result with the bound description
+     * @param out Destination tuple
+     */
+    void
+    bind(resultset::row const &row, tuple_type &out) const {
+        decode(row, out, std::index_sequence_for<T...>{});
+    }
+
+    /**
+     * @brief Decodes a row into variables
+     *
+     * @param row Row of a result with the bound description
+     * @param out Destination variables
+     */
+    void
+    bind(resultset::row const &row, T &...out) const {
+        decode(row, std::tuple<T &...>(out...), std::index_sequence_for<T...>{});
+    }
+
+    /**
+     * @brief Decodes a row
+     *
+     * @param row Row of a result with the bound description
+     * @return tuple_type Decoded values
+     */
+    tuple_type
+    operator()(resultset::row const &row) const {
+        tuple_type out;
+        bind(row, out);
+        return out;
+    }
+
+    /**
+     * @brief Decodes every row of a result
+     *
+     * @param result Result with the bound description
+     * @return std::vector<tuple_type> Decoded rows
+     */
+    std::vector<tuple_type>
+    all(resultset const &result) const {
+        std::vector<tuple_type> rows(result.size());
+        for (auto const &row : result)
+            bind(row, rows[row.row_index()]);
+        return rows;
+    }
+};
+
+/**
+ * @brief Compile-time descriptor of a structure member bound to a column
+ *
+ * @tparam S Structure type
+ * @tparam M Member type
+ */
+template <typename S, typename M>
+struct Column {
+    std::string_view name;   ///< Column name, empty to bind by position
+    M S::*           member; ///< Bound member
+};
+
+/**
+ * @brief Describes a member bound to the column of the same name
+ *
+ * @param name Column name
+ * @param member Bound member
+ * @return Column<S, M> Column descriptor
+ */
+template <typename S, typename M>
+constexpr Column<S, M>
+column(std::string_view name, M S::*member) noexcept {
+    return {name, member};
+}
+
+/**
+ * @brief Describes a member bound to the column at the same position
+ *
+ * @param member Bound member
+ * @return Column<S, M> Column descriptor
+ */
+template <typename S, typename M>
+constexpr Column<S, M>
+column(M S::*member) noexcept {
+    return {{}, member};
+}
+
+/**
+ * @brief Binder decoding rows into structures
+ *
+ * @code
+ * struct user { int id; std::string name; std::optional<std::string> email; };
+ * static constexpr auto user_columns = std::make_tuple(
+ *     qb::pg::column("id", &user::id), qb::pg::column("name", &user::name),
+ *     qb::pg::column("email", &user::email));
+ *
+ * auto bind  = qb::pg::make_binder(result, user_columns);
+ * auto users = bind.all(result);
+ * @endcode
+ *
+ * @tparam S Structure type, default constructible
+ * @tparam M Types of the bound members
+ */
+template <typename S, typename... M>
+class StructBinder {
+public:
+    static constexpr std::size_t size = sizeof...(M);
+
+private:
+    std::tuple<M S::*...>         _members;
+    std::array<BoundColumn, size> _columns;
+
+    template <std::size_t... I>
+    void
+    decode(resultset::row const &row, S &out, std::index_sequence<I...>) const {
+        ((_columns[I].decoder(row[_columns[I].index], &(out.*std::get<I>(_members)))), ...);
+    }
+
+    template <std::size_t... I>
+    StructBinder(row_description_type const &desc, std::tuple<Column<S, M>...> const &columns,
+                 std::index_sequence<I...>)
+        : _members(std::get<I>(columns).member...)
+        , _columns{BoundColumn::resolve<M>(desc, std::get<I>(columns).name, I)...} {}
+
+public:
+    /**
+     * @brief Binds members to the columns of a row description
+     *
+     * @param desc Row description, e.g. of a prepared statement
+     * @param columns Column descriptors
+     * @throws error::db_error If a column does not exist
+     */
+    StructBinder(row_description_type const &desc, std::tuple<Column<S, M>...> const &columns)
+        : StructBinder(desc, columns, std::index_sequence_for<M...>{}) {}
+
+    /**
+     * @brief Decodes a row into a structure
+     *
+     * Members that are not bound keep their value.
+     *
+     * @param row Row of a result with the bound description
+     * @param out Destination structure
+     */
+    void
+    bind(resultset::row const &row, S &out) const {
+        decode(row, out, std::index_sequence_for<M...>{});
+    }
+
+    /**
+     * @brief Decodes a row
+     *
+     * @param row Row of a result with the bound description
+     * @return S Decoded structure
+     */
+    S
+    operator()(resultset::row const &row) const {
+        S out{};
+        bind(row, out);
+        return out;
+    }
+
+    /**
+     * @brief Decodes every row of a result
+     *
+     * @param result Result with the bound description
+     * @return std::vector<S> Decoded rows
+     */
+    std::vector<S>
+    all(resultset const &result) const {
+        std::vector<S> rows(result.size());
+        for (auto const &row : result)
+            bind(row, rows[row.row_index()]);
+        return rows;
+    }
+};
+
+/**
+ * @brief Builds a structure binder from column descriptors
+ *
+ * @param desc Row description, e.g. of a prepared statement
+ * @param columns Column descriptors
+ * @return StructBinder<S, M...> Binder
+ */
+template <typename S, typename... M>
+StructBinder<S, M...>
+make_binder(row_description_type const &desc, Column<S, M> const &...columns) {
+    return StructBinder<S, M...>(desc, std::make_tuple(columns...));
+}
+
+template <typename S, typename... M>
+StructBinder<S, M...>
+make_binder(row_description_type const &desc, std::tuple<Column<S, M>...> const &columns) {
+    return StructBinder<S, M...>(desc, columns);
+}
+
+template <typename S, typename... M>
+StructBinder<S, M...>
+make_binder(resultset const &result, Column<S, M> const &...columns) {
+    return StructBinder<S, M...>(result.row_description(), std::make_tuple(columns...));
+}
+
+template <typename S, typename... M>
+StructBinder<S, M...>
+make_binder(resultset const &result, std::tuple<Column<S, M>...> const &columns) {
+    return StructBinder<S, M...>(result.row_description(), columns);
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,114 @@
+/**
+ * @file scram.cpp
+ * @brief Implementation of the SCRAM-SHA-256 key cache
+ *
+ * @see scram.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./scram.h"
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <qb/io/crypto.h>
+
+namespace qb::pg::detail {
+
+namespace {
+
+std::mutex cache_mutex;
+std::unordered_map<std::string, std::shared_ptr<const ScramKeys>> cache;
+
+/**
+ * @brief Builds the cache key of a credential
+ *
+ * @param user Role name
+ * @param password Password of the role
+ * @param salt Salt sent by the server
+ * @param iterations Iteration count sent by the server
+ * @return std::string Key made of the user, password digest, sized salt and count
+ */
+std::string
+cache_key(std::string const &user, std::string const &password,
+          std::vector<unsigned char> const &salt, int iterations) {
+    const auto digest =
+        qb::crypto::sha256(std::vector<unsigned char>(password.begin(), password.end()));
+    std::string key;
+    key.reserve(user.size() + digest.size() + salt.size() + 16);
+    key.append(user).push_back('\0');
+    key.append(digest.begin(), digest.end());
+    // Length-prefixed: a salt ending in digits must not run into the count
+    key.append(std::to_string(salt.size())).push_back(':');
+    key.append(salt.begin(), salt.end());
+    key.append(std::to_string(iterations));
+    return key;
+}
+
+/**
+ * @brief Derives the keys of a credential with PBKDF2-HMAC-SHA256
+ */
+std::shared_ptr<const ScramKeys>
+derive(std::string const &password, std::vector<unsigned char> const &salt,
+       int iterations) {
+    std::vector<unsigned char> salted_password(32); // 32 bytes for SHA256
+    if (PKCS5_PBKDF2_HMAC(password.c_str(), static_cast<int>(password.size()),
+                          salt.data(), static_cast<int>(salt.size()), iterations,
+                          EVP_sha256(), 32, salted_password.data()) != 1) {
+        throw std::runtime_error("error during PBKDF2 computing");
+    }
+    auto keys        = std::make_shared<ScramKeys>();
+    keys->client_key = qb::crypto::hmac_sha256(salted_password, "Client Key");
+    keys->stored_key = qb::crypto::sha256(keys->client_key);
+    keys->server_key = qb::crypto::hmac_sha256(salted_password, "Server Key");
+    return keys;
+}
+
+} // namespace
+
+std::shared_ptr<const ScramKeys>
+ScramKeyCache::keys(std::string const &user, std::string const &password,
+                    std::vector<unsigned char> const &salt, int iterations) {
+    const auto key = cache_key(user, password, salt, iterations);
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto                        it = cache.find(key);
+        if (it != cache.end())
+            return it->second;
+    }
+
+    // Derived outside the lock: concurrent first handshakes of other
+    // credentials are not serialized behind PBKDF2
+    auto keys = derive(password, salt, iterations);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (cache.size() >= max_entries)
+        cache.clear();
+    return cache.emplace(key, std::move(keys)).first->second;
+}
+
+std::size_t
+ScramKeyCache::size() noexcept {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return cache.size();
+}
+
+void
+ScramKeyCache::clear() noexcept {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache.clear();
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,86 @@
+/**
+ * @file scram.h
+ * @brief Process-wide cache of SCRAM-SHA-256 client keys
+ *
+ * A SCRAM-SHA-256 handshake derives SaltedPassword with PBKDF2-HMAC-SHA256
+ * over the iteration count of the server (4096 by default), which costs far
+ * more than the rest of the handshake. The salt and iteration count of a
+ * role only change with its password, so the derived keys are reused by
+ * every later handshake of the process with the same credentials: pools
+ * warming up or recycling many connections only pay the per-nonce HMACs.
+ *
+ * @see RFC 5802, RFC 7677
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Keys derived from a password for SCRAM-SHA-256
+ */
+struct ScramKeys {
+    std::vector<unsigned char> client_key; ///< HMAC(SaltedPassword, "Client Key")
+    std::vector<unsigned char> stored_key; ///< SHA256(ClientKey)
+    std::vector<unsigned char> server_key; ///< HMAC(SaltedPassword, "Server Key")
+};
+
+/**
+ * @brief Thread-safe cache of the SCRAM keys of the process
+ *
+ * Entries are keyed by user, a digest of the password, salt and iteration
+ * count, so a changed password or a new salt on the server derives fresh
+ * keys. The password itself is never stored.
+ */
+class ScramKeyCache {
+public:
+    static constexpr std::size_t max_entries = 64; ///< Entries kept before flushing
+
+    /**
+     * @brief Gets the keys of a credential, deriving them on first use
+     *
+     * @param user Role name
+     * @param password Password of the role
+     * @param salt Salt sent by the server
+     * @param iterations Iteration count sent by the server
+     * @return std::shared_ptr<const ScramKeys> Derived keys
+     * @throws std::runtime_error if the key derivation fails
+     */
+    static std::shared_ptr<const ScramKeys> keys(std::string const &user,
+                                                 std::string const &password,
+                                                 std::vector<unsigned char> const &salt,
+                                                 int iterations);
+
+    /**
+     * @brief Gets the number of cached credentials
+     *
+     * @return std::size_t Cached entries
+     */
+    [[nodiscard]] static std::size_t size() noexcept;
+
+    /**
+     * @brief Drops every cached key
+     */
+    static void clear() noexcept;
+};
+
+} // namespace qb::pg::detail
@@ -0,0 +1,82 @@
+/**
+ * @file slow_query.cpp
+ * @brief Sampling of slow queries and capture of their plans
+ *
+ * @see slow_query.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cctype>
+#include <cmath>
+#include "./slow_query.h"
+
+namespace qb::pg::detail {
+
+SlowQuerySampler::SlowQuerySampler(SlowQueryOptions const &options) noexcept
+    : _threshold(options.threshold) {
+    if (options.sample_rate >= 1.)
+        _rate = UINT64_MAX;
+    else if (options.sample_rate > 0.)
+        _rate = static_cast<std::uint64_t>(std::ldexp(options.sample_rate, 64));
+}
+
+SlowQuerySampler::reason
+SlowQuerySampler::pick(std::chrono::nanoseconds server_time) noexcept {
+    if (_threshold.count() > 0 && server_time >= _threshold)
+        return reason::slow;
+    if (!_rate)
+        return reason::none;
+    _state ^= _state << 13;
+    _state ^= _state >> 7;
+    _state ^= _state << 17;
+    return _state <= _rate ? reason::sampled : reason::none;
+}
+
+bool
+explainable(std::string_view sql) noexcept {
+    // Skip blanks and comments
+    std::size_t pos = 0;
+    while (pos < sql.size()) {
+        if (std::isspace(static_cast<unsigned char>(sql[pos])))
+            ++pos;
+        else if (sql.compare(pos, 2, "--") == 0) {
+            const auto end = sql.find('\n', pos);
+            pos            = end == std::string_view::npos ? sql.size() : end + 1;
+        } else if (sql.compare(pos, 2, "/*") == 0) {
+            const auto end = sql.find("*/", pos + 2);
+            pos            = end == std::string_view::npos ? sql.size() : end + 2;
+        } else
+            break;
+    }
+
+    std::string keyword;
+    while (pos < sql.size() && std::isalpha(static_cast<unsigned char>(sql[pos])) &&
+           keyword.size() < 8)
+        keyword.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(sql[pos++]))));
+    return keyword == "SELECT" || keyword == "WITH" || keyword == "VALUES" ||
+           keyword == "TABLE" || keyword == "INSERT" || keyword == "UPDATE" ||
+           keyword == "DELETE" || keyword == "MERGE";
+}
+
+std::string
+explain_sql(std::string_view sql, explain_mode mode) {
+    std::string out = mode == explain_mode::analyze ? "EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) "
+                                                    : "EXPLAIN ";
+    out.append(sql);
+    return out;
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,180 @@
+/**
+ * @file slow_query.h
+ * @brief Sampling of slow queries and capture of their plans
+ *
+ * When the latency of a service spikes, the metrics tell which kind of
+ * query got slower, not which statement regressed nor why. A connection
+ * with a slow-query hook picks the queries slower than a threshold, plus
+ * a random sample of the others, and hands them to the hook with their
+ * SQL text, their parameters and their timings.
+ *
+ * explain() then runs EXPLAIN, or EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON)
+ * rolled back in a transaction block, of the same statement with the same
+ * parameters on another connection: the connection serving the live
+ * traffic never runs it. Pool::slow_queries picks an idle pooled
+ * connection for each sample.
+ *
+ * @see qb::pg::detail::Database::slow_queries
+ * @see qb::pg::detail::Pool::slow_queries
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "./commands.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Plan captured for a slow query
+ */
+enum class explain_mode : std::uint8_t {
+    plain,   ///< EXPLAIN: estimated plan, the query is not run again
+    analyze, ///< EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON), run in a rolled back block
+};
+
+/**
+ * @brief Settings of the slow-query sampler
+ */
+struct SlowQueryOptions {
+    std::chrono::microseconds threshold{100000}; ///< Slower queries are always picked, 0 for none
+    double       sample_rate{0.};       ///< Share of the other queries picked, in [0, 1]
+    explain_mode mode{explain_mode::plain}; ///< Plan captured for the picked queries
+    std::size_t  max_in_flight{1};      ///< Plans captured at once by a pool, more are dropped
+};
+
+/**
+ * @brief Query picked by the sampler, then its plan
+ */
+struct SlowQuery {
+    query_kind  kind{query_kind::simple}; ///< Kind of query
+    std::string statement;   ///< Prepared statement, empty for SQL text
+    std::string sql;         ///< SQL text of the query or of its statement
+    QueryParams params;      ///< Parameters of the execution, external values copied
+    std::chrono::nanoseconds queue_wait{0};  ///< Queued to sent
+    std::chrono::nanoseconds server_time{0}; ///< Answerable to completed
+    std::chrono::nanoseconds decode_time{0}; ///< Handling of the DataRow messages
+    bool        sampled{false}; ///< Picked by the sampling rate, not by the threshold
+    std::string plan;  ///< Output of EXPLAIN, one line per row
+    std::string error; ///< Error of the EXPLAIN, empty on success
+};
+
+/**
+ * @brief Decides which completed queries are sampled
+ */
+class SlowQuerySampler {
+    std::chrono::nanoseconds _threshold{0}; ///< Slower queries are picked
+    std::uint64_t            _rate{0};      ///< Sampling rate, scaled to 2^64
+    std::uint64_t            _state{0x9E3779B97F4A7C15ull}; ///< xorshift state
+
+public:
+    /// Answer of pick()
+    enum class reason : std::uint8_t { none, slow, sampled };
+
+    SlowQuerySampler() = default;
+
+    /**
+     * @brief Constructs a sampler from its settings
+     */
+    explicit SlowQuerySampler(SlowQueryOptions const &options) noexcept;
+
+    /**
+     * @brief Decides whether a completed query is picked
+     *
+     * @param server_time Server time of the query
+     * @return reason Why the query is picked, none if it is not
+     */
+    reason pick(std::chrono::nanoseconds server_time) noexcept;
+};
+
+/**
+ * @brief Checks if EXPLAIN accepts a statement
+ *
+ * Accepts SELECT, WITH, VALUES, TABLE, INSERT, UPDATE, DELETE and MERGE,
+ * after leading blanks and comments.
+ *
+ * @param sql SQL text of a single statement
+ */
+[[nodiscard]] bool explainable(std::string_view sql) noexcept;
+
+/**
+ * @brief Builds the EXPLAIN statement of a query
+ *
+ * @param sql SQL text of the query
+ * @param mode Plan to capture
+ */
+[[nodiscard]] std::string explain_sql(std::string_view sql, explain_mode mode);
+
+/**
+ * @brief Captures the plan of a picked query on a connection
+ *
+ * Queries with parameters are explained through a statement prepared once
+ * per connection, named after the original statement, so the parameters
+ * are bound exactly like the original execution. In analyze mode the
+ * query runs again, inside a transaction block that is rolled back.
+ *
+ * @param on Connection running the EXPLAIN, not the one that ran the query
+ * @param query Picked query
+ * @param mode Plan to capture
+ * @param done Callback receiving the query with its plan or error
+ */
+inline void
+explain(Transaction &on, SlowQuery &&query, explain_mode mode,
+        std::function<void(SlowQuery &)> done) {
+    auto sample = std::make_shared<SlowQuery>(std::move(query));
+    auto on_plan = [sample, done](Transaction &, resultset result) {
+        for (auto const &row : result) {
+            if (!sample->plan.empty())
+                sample->plan.push_back('\n');
+            sample->plan += row[0].as<std::string>();
+        }
+        done(*sample);
+    };
+    auto on_error = [sample, done](error::db_error const &err) {
+        sample->error = err.what();
+        done(*sample);
+    };
+
+    if (mode == explain_mode::analyze)
+        on.execute("BEGIN");
+    const auto sql = explain_sql(sample->sql, mode);
+    if (sample->params.empty())
+        on.execute(sql, std::move(on_plan), std::move(on_error));
+    else {
+        // Only prepared statements have parameters
+        const std::string name =
+            (mode == explain_mode::analyze ? "qb_explain_analyze_" : "qb_explain_") +
+            sample->statement;
+        if (!on.statement(name).valid()) {
+            type_oid_sequence types;
+            for (auto type : sample->params.param_types())
+                types.push_back(static_cast<oid>(type));
+            on.prepare(name, sql, std::move(types));
+        }
+        on.execute(name, QueryParams(sample->params), std::move(on_plan), std::move(on_error));
+    }
+    if (mode == explain_mode::analyze)
+        on.execute("ROLLBACK");
+}
+
+} // namespace qb::pg::detail
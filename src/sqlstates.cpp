@@ -32,7 +32,10 @@
  */
 
 #include "./sqlstates.h"
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <vector>
 
 namespace qb {
 namespace pg {
@@ -753,15 +756,44 @@ const std::map<code, std::string> STATE_TO_CODESTR{
     {index_corrupted, "XX002"},
 };
 
+/**
+ * @brief Packs a five-character SQLSTATE into an integer
+ *
+ * Preserves the order of the codes, so the index can be searched in order.
+ */
+constexpr std::uint64_t
+pack(std::string_view val) noexcept {
+    std::uint64_t key = 0;
+    for (const char c : val)
+        key = key << 8 | static_cast<unsigned char>(c);
+    return key;
+}
+
+/**
+ * @brief SQLSTATE codes packed as integers, sorted
+ */
+const std::vector<std::pair<std::uint64_t, code>> STATE_INDEX = [] {
+    std::vector<std::pair<std::uint64_t, code>> index;
+    index.reserve(CODESTR_TO_STATE.size());
+    for (auto const &entry : CODESTR_TO_STATE)
+        index.emplace_back(pack(entry.first), entry.second);
+    std::sort(index.begin(), index.end());
+    return index;
+}();
+
 } // namespace
 
 code
-code_to_state(std::string const &val) {
-    auto f = CODESTR_TO_STATE.find(val);
-    if (f != CODESTR_TO_STATE.end()) {
-        return f->second;
-    }
-    return unknown_code;
+code_to_state(std::string_view val) noexcept {
+    if (val.size() != 5)
+        return unknown_code;
+    const auto key = pack(val);
+    const auto it  = std::lower_bound(
+        STATE_INDEX.begin(), STATE_INDEX.end(), key,
+        [](std::pair<std::uint64_t, code> const &entry, std::uint64_t k) {
+            return entry.first < k;
+        });
+    return it != STATE_INDEX.end() && it->first == key ? it->second : unknown_code;
 }
 
 } // namespace sqlstate
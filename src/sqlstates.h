@@ -34,6 +34,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace qb {
 namespace pg {
@@ -397,7 +398,16 @@ enum code {
     index_corrupted, /**< XX002 */
 };
 
-code code_to_state(std::string const &val);
+/**
+ * @brief Converts a five-character SQLSTATE to its enumerator
+ *
+ * Looked up by binary search over the codes packed as integers, without
+ * building a string.
+ *
+ * @param val SQLSTATE, e.g. "23505"
+ * @return code Enumerator, unknown_code if the SQLSTATE is not known
+ */
+code code_to_state(std::string_view val) noexcept;
 
 } // namespace sqlstate
 } // namespace pg
@@ -0,0 +1,137 @@
+/**
+ * @file submission.cpp
+ * @brief Implementation of the lock-free submission queue
+ *
+ * Bounded MPSC ring where each slot carries a sequence number:
+ *
+ * - A slot is free for the producer claiming position `pos` when its
+ *   sequence equals `pos`
+ * - It holds a task for the consumer when its sequence equals `pos + 1`
+ * - Once consumed its sequence moves to `pos + capacity`, the next lap
+ *
+ * @see submission.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <qb/io.h>
+#include "./submission.h"
+
+namespace qb::pg::detail {
+
+SubmissionQueue::SubmissionQueue(std::size_t capacity) {
+    std::size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+    _cells = std::make_unique<Cell[]>(size);
+    _mask  = size - 1;
+    for (std::size_t i = 0; i < size; ++i)
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool
+SubmissionQueue::push(task_type &&task) {
+    std::size_t pos = _tail.load(std::memory_order_relaxed);
+    Cell       *cell;
+    for (;;) {
+        cell            = &_cells[pos & _mask];
+        const auto seq  = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0)
+            return false;
+        else
+            pos = _tail.load(std::memory_order_relaxed);
+    }
+    cell->task = std::move(task);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool
+SubmissionQueue::pop(task_type &task) {
+    Cell &cell = _cells[_head & _mask];
+    if (cell.sequence.load(std::memory_order_acquire) != _head + 1)
+        return false;
+    task      = std::move(cell.task);
+    cell.task = nullptr;
+    cell.sequence.store(_head + _mask + 1, std::memory_order_release);
+    ++_head;
+    return true;
+}
+
+bool
+SubmissionQueue::ready() const noexcept {
+    return _cells[_head & _mask].sequence.load(std::memory_order_acquire) == _head + 1;
+}
+
+std::size_t
+SubmissionQueue::capacity() const noexcept {
+    return _mask + 1;
+}
+
+Mailbox::Mailbox(std::function<void()> on_wakeup)
+    : _on_wakeup(std::move(on_wakeup))
+    , _inbox(std::make_shared<Inbox>()) {
+    _inbox->owner = this;
+    _watcher.set(qb::io::async::listener::current.loop());
+    _watcher.set<Mailbox, &Mailbox::on_async>(this);
+    _watcher.start();
+}
+
+Mailbox::~Mailbox() {
+    std::vector<task_type> dropped;
+    {
+        std::lock_guard lock(_inbox->mutex);
+        _inbox->owner = nullptr;
+        dropped.swap(_inbox->tasks);
+    }
+    _watcher.stop();
+}
+
+void
+Mailbox::on_async(ev::async &, int) {
+    {
+        std::lock_guard lock(_inbox->mutex);
+        _running.swap(_inbox->tasks);
+    }
+    for (auto &task : _running) {
+        try {
+            task();
+        } catch (std::exception const &e) {
+            LOG_WARN("[pgsql] Posted task failed: " << e.what());
+        }
+    }
+    _running.clear();
+    if (_on_wakeup)
+        _on_wakeup();
+}
+
+bool
+Mailbox::Sender::post(task_type task) const {
+    if (!_inbox)
+        return false;
+    std::lock_guard lock(_inbox->mutex);
+    if (!_inbox->owner)
+        return false;
+    _inbox->tasks.push_back(std::move(task));
+    // Under the lock: the owner cannot stop the watcher in the meantime
+    _inbox->owner->notify();
+    return true;
+}
+
+} // namespace qb::pg::detail
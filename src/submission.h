@@ -0,0 +1,228 @@
+/**
+ * @file submission.h
+ * @brief Lock-free queue of work submitted to a Database from other threads
+ *
+ * A Database can only be used from the thread running its I/O loop. The
+ * SubmissionQueue lets any thread hand it work without locks: producers
+ * claim a slot of a bounded ring with a single atomic operation, and the
+ * owning loop drains the ring and runs each task on the connection.
+ *
+ * A Mailbox carries work the other way: it wakes up the event loop of the
+ * thread owning it from any thread, and runs the tasks posted to it on
+ * that loop, e.g. the results of a query handed back to the submitter.
+ *
+ * @see qb::pg::detail::Database::submit
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <qb/io/async.h>
+
+namespace qb::pg::detail {
+
+class Transaction;
+
+/**
+ * @brief Bounded multi-producer single-consumer ring of tasks
+ *
+ * Each slot carries a sequence number telling producers and the consumer
+ * whose turn it is, so neither side ever waits on the other: a full ring
+ * rejects the task and an empty ring yields nothing.
+ */
+class SubmissionQueue {
+public:
+    /// Work run on the owning thread with the connection
+    using task_type = std::function<void(Transaction &)>;
+
+private:
+    /**
+     * @brief Slot of the ring
+     */
+    struct Cell {
+        std::atomic<std::size_t> sequence; ///< Turn of the slot
+        task_type                task;     ///< Task stored in the slot
+    };
+
+    std::unique_ptr<Cell[]> _cells;      ///< Ring storage
+    std::size_t             _mask;       ///< Capacity - 1, capacity is a power of two
+    alignas(64) std::atomic<std::size_t> _tail{0}; ///< Next slot claimed by producers
+    alignas(64) std::size_t _head{0};    ///< Next slot read by the consumer
+
+public:
+    /**
+     * @brief Constructs a ring
+     *
+     * @param capacity Maximum number of pending tasks, rounded up to a power of two
+     */
+    explicit SubmissionQueue(std::size_t capacity);
+
+    SubmissionQueue(SubmissionQueue const &)            = delete;
+    SubmissionQueue &operator=(SubmissionQueue const &) = delete;
+
+    /**
+     * @brief Adds a task, from any thread
+     *
+     * @param task Task to run on the owning thread
+     * @return bool False if the ring is full; the task is left untouched
+     */
+    bool push(task_type &&task);
+
+    /**
+     * @brief Takes the oldest task, from the owning thread only
+     *
+     * @param task Receives the task
+     * @return bool False if the ring is empty
+     */
+    bool pop(task_type &task);
+
+    /**
+     * @brief Checks if a task is waiting, from the owning thread only
+     *
+     * @return bool True if pop() would return a task
+     */
+    [[nodiscard]] bool ready() const noexcept;
+
+    /**
+     * @brief Gets the maximum number of pending tasks
+     *
+     * @return std::size_t Ring capacity
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept;
+};
+
+/**
+ * @brief Tasks posted from any thread to the event loop of the owning thread
+ *
+ * Wraps an async watcher of the loop of the thread constructing the
+ * mailbox: posting a task or calling notify() wakes up that loop, which
+ * runs the posted tasks in order, then the wake-up handler. Wake-ups are
+ * coalesced, a handler run covers every notification sent before it.
+ *
+ * Senders may outlive the mailbox: their posts are dropped once it is
+ * destroyed, so a worker finishing late never touches a freed owner.
+ */
+class Mailbox {
+public:
+    /// Work run on the owning loop
+    using task_type = std::function<void()>;
+
+private:
+    /**
+     * @brief Posted tasks, shared with the senders
+     */
+    struct Inbox {
+        std::mutex             mutex;           ///< Guards the tasks and the owner
+        std::vector<task_type> tasks;           ///< Tasks not run yet
+        Mailbox               *owner{nullptr};  ///< Owning mailbox, null once destroyed
+    };
+
+    ev::async              _watcher;   ///< Wakes up the owning loop
+    std::function<void()>  _on_wakeup; ///< Run after the posted tasks of each wake-up
+    std::shared_ptr<Inbox> _inbox;     ///< Posted tasks
+    std::vector<task_type> _running;   ///< Tasks of the current wake-up
+
+    /**
+     * @brief Runs the posted tasks, then the wake-up handler, on the owning loop
+     */
+    void on_async(ev::async &watcher, int revents);
+
+public:
+    /**
+     * @brief Handle posting tasks to a mailbox, from any thread
+     */
+    class Sender {
+        std::shared_ptr<Inbox> _inbox; ///< Tasks of the mailbox, none if empty
+
+    public:
+        Sender() = default;
+
+        /**
+         * @brief Constructs a sender of a mailbox
+         *
+         * @param inbox Tasks of the mailbox
+         */
+        explicit Sender(std::shared_ptr<Inbox> inbox) noexcept
+            : _inbox(std::move(inbox)) {}
+
+        /**
+         * @brief Posts a task and wakes up the owning loop
+         *
+         * @param task Task to run on the owning loop
+         * @return bool False if the mailbox is destroyed or the sender is empty
+         */
+        bool post(task_type task) const;
+
+        /**
+         * @brief Checks if the sender is bound to a mailbox
+         */
+        explicit operator bool() const noexcept {
+            return static_cast<bool>(_inbox);
+        }
+    };
+
+    /**
+     * @brief Constructs a mailbox on the event loop of the calling thread
+     *
+     * @param on_wakeup Handler run on each wake-up, after the posted tasks
+     */
+    explicit Mailbox(std::function<void()> on_wakeup = {});
+
+    Mailbox(Mailbox const &)            = delete;
+    Mailbox &operator=(Mailbox const &) = delete;
+
+    /**
+     * @brief Drops the pending tasks and stops the watcher, on the owning thread
+     */
+    ~Mailbox();
+
+    /**
+     * @brief Posts a task, from any thread while the mailbox lives
+     *
+     * @param task Task to run on the owning loop
+     * @return bool Always true
+     */
+    bool
+    post(task_type task) const {
+        return sender().post(std::move(task));
+    }
+
+    /**
+     * @brief Wakes up the owning loop to run the wake-up handler, from any thread
+     *
+     * Lock-free; the mailbox must outlive the call.
+     */
+    void
+    notify() noexcept {
+        _watcher.send();
+    }
+
+    /**
+     * @brief Gets a sender of the mailbox, which may outlive it
+     */
+    [[nodiscard]] Sender
+    sender() const noexcept {
+        return Sender(_inbox);
+    }
+};
+
+} // namespace qb::pg::detail
@@ -0,0 +1,178 @@
+/**
+ * @file text_codec.cpp
+ * @brief Allocation-free parsing of PostgreSQL text values
+ *
+ * @see text_codec.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./text_codec.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace qb::pg::detail {
+
+namespace {
+
+/**
+ * @brief Lowers an ASCII letter, leaving other characters unchanged
+ */
+constexpr char
+ascii_lower(char c) noexcept {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Compares a text to a lower-case word, ignoring the ASCII case
+ */
+constexpr bool
+iequals(std::string_view text, std::string_view word) noexcept {
+    if (text.size() != word.size())
+        return false;
+    for (std::size_t i = 0; i < text.size(); ++i)
+        if (ascii_lower(text[i]) != word[i])
+            return false;
+    return true;
+}
+
+/**
+ * @brief Value of a hexadecimal digit, or -1
+ */
+constexpr int
+hex_digit(char c) noexcept {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    c = ascii_lower(c);
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+template <typename T>
+std::errc
+parse_floating(std::string_view text, T &value) noexcept {
+    bool negative = false;
+    if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+        negative = text.front() == '-';
+        text.remove_prefix(1);
+    }
+    if (iequals(text, "infinity") || iequals(text, "inf")) {
+        value = negative ? -std::numeric_limits<T>::infinity()
+                         : std::numeric_limits<T>::infinity();
+        return {};
+    }
+    if (iequals(text, "nan")) {
+        value = std::numeric_limits<T>::quiet_NaN();
+        return {};
+    }
+    if (text.empty() || text.front() == '-' || text.front() == '+')
+        return std::errc::invalid_argument;
+
+    const char *last = text.data() + text.size();
+    T           parsed{};
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::from_chars(text.data(), last, parsed);
+    if (result.ec != std::errc{})
+        return result.ec;
+    if (result.ptr != last)
+        return std::errc::invalid_argument;
+#else
+    // Library without floating-point from_chars: strtod on a bounded local copy,
+    // the field bytes not being null-terminated
+    (void) last;
+    char buffer[128];
+    if (text.size() >= sizeof(buffer))
+        return std::errc::invalid_argument;
+    std::memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+    char *end           = nullptr;
+    errno               = 0;
+    if constexpr (std::is_same_v<T, float>)
+        parsed = std::strtof(buffer, &end);
+    else
+        parsed = std::strtod(buffer, &end);
+    if (end != buffer + text.size())
+        return std::errc::invalid_argument;
+    if (errno == ERANGE)
+        return std::errc::result_out_of_range;
+#endif
+    value = negative ? -parsed : parsed;
+    return {};
+}
+
+} // namespace
+
+std::errc
+TextCodec::to_float(std::string_view text, double &value) noexcept {
+    return parse_floating(text, value);
+}
+
+std::errc
+TextCodec::to_float(std::string_view text, float &value) noexcept {
+    return parse_floating(text, value);
+}
+
+bool
+TextCodec::parse_bool(std::string_view text) noexcept {
+    switch (text.size()) {
+        case 1: {
+            const char c = ascii_lower(text.front());
+            return c == 't' || c == 'y' || c == '1';
+        }
+        case 2:
+            return iequals(text, "on");
+        case 3:
+            return iequals(text, "yes");
+        case 4:
+            return iequals(text, "true");
+        default:
+            return false;
+    }
+}
+
+bool
+TextCodec::to_uuid(std::string_view text, std::array<std::uint8_t, 16> &bytes) noexcept {
+    if (text.size() >= 2 && text.front() == '{' && text.back() == '}')
+        text = text.substr(1, text.size() - 2);
+
+    std::array<std::uint8_t, 16> parsed{};
+    std::size_t                  digits         = 0;
+    bool                         hyphen_allowed = false;
+    for (const char c : text) {
+        if (c == '-') {
+            // After a group of four digits, not at the end
+            if (!hyphen_allowed || digits == 32)
+                return false;
+            hyphen_allowed = false;
+            continue;
+        }
+        const int nibble = hex_digit(c);
+        if (nibble < 0 || digits == 32)
+            return false;
+        parsed[digits / 2] = static_cast<std::uint8_t>(
+            digits % 2 ? parsed[digits / 2] | nibble : nibble << 4);
+        hyphen_allowed = ++digits % 4 == 0;
+    }
+    if (digits != 32)
+        return false;
+    bytes = parsed;
+    return true;
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,170 @@
+/**
+ * @file text_codec.h
+ * @brief Allocation-free parsing of PostgreSQL text values
+ *
+ * Results of simple queries are always in text format. Their numeric,
+ * boolean and UUID cells are parsed directly on the bytes of the field,
+ * without the std::string temporaries, streams and locale lookups of
+ * std::stoi, std::stod or std::istringstream:
+ *
+ * - Integers and floating-point values with std::from_chars
+ * - Booleans and UUIDs with hand-rolled scanners
+ *
+ * Texts must be complete values: leading spaces and trailing characters
+ * are rejected, as PostgreSQL never produces them.
+ *
+ * @see qb::pg::detail::TimestampCodec for the text timestamps
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Parsers of the PostgreSQL text format working on string views
+ *
+ * The to_* functions report failures with a std::errc and never throw; the
+ * parse_* functions throw the exceptions of their std::sto* counterparts.
+ */
+struct TextCodec {
+    /**
+     * @brief Parses a decimal integer, with an optional sign
+     *
+     * @tparam T Integer type
+     * @param text Text value
+     * @param value Receives the value on success
+     * @return std::errc std::errc{} on success, invalid_argument if the text
+     * is not an integer, result_out_of_range if it does not fit in T
+     */
+    template <typename T>
+    static std::errc
+    to_integer(std::string_view text, T &value) noexcept {
+        static_assert(std::is_integral_v<T>, "TextCodec::to_integer requires an integer type");
+        const char *first = text.data();
+        const char *last  = first + text.size();
+        // from_chars takes a '-' but no '+'
+        if (first != last && *first == '+' && ++first != last && *first == '-')
+            return std::errc::invalid_argument;
+        const auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc{} && result.ptr != last)
+            return std::errc::invalid_argument;
+        return result.ec;
+    }
+
+    /**
+     * @brief Parses a floating-point value
+     *
+     * Accepts the decimal and scientific notations and the special values
+     * 'NaN', 'Infinity' and '-Infinity', case-insensitively, with 'inf' as
+     * an abbreviation.
+     *
+     * @param text Text value
+     * @param value Receives the value on success
+     * @return std::errc std::errc{} on success, invalid_argument if the text
+     * is not a number, result_out_of_range if it overflows or underflows
+     */
+    static std::errc to_float(std::string_view text, double &value) noexcept;
+
+    /**
+     * @brief Parses a single-precision floating-point value
+     *
+     * @see to_float(std::string_view, double &)
+     */
+    static std::errc to_float(std::string_view text, float &value) noexcept;
+
+    /**
+     * @brief Parses a boolean
+     *
+     * @param text Text value
+     * @return bool True for 't', 'true', 'y', 'yes', 'on' and '1', in any
+     * case; false otherwise
+     */
+    static bool parse_bool(std::string_view text) noexcept;
+
+    /**
+     * @brief Parses a UUID
+     *
+     * Accepts the input forms of PostgreSQL: 32 hexadecimal digits, in any
+     * case, optionally surrounded by braces and with a hyphen after any
+     * group of four digits, e.g. `a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11`.
+     *
+     * @param text Text value
+     * @param bytes Receives the 16 bytes of the UUID on success
+     * @return bool False if the text is not a UUID
+     */
+    static bool to_uuid(std::string_view text, std::array<std::uint8_t, 16> &bytes) noexcept;
+
+    /**
+     * @brief Parses a decimal integer
+     *
+     * @tparam T Integer type
+     * @param text Text value
+     * @return T Value
+     * @throws std::invalid_argument If the text is not an integer
+     * @throws std::out_of_range If the value does not fit in T
+     */
+    template <typename T>
+    static T
+    parse_integer(std::string_view text) {
+        T value{};
+        check(to_integer(text, value), text);
+        return value;
+    }
+
+    /**
+     * @brief Parses a floating-point value
+     *
+     * @tparam T float or double
+     * @param text Text value
+     * @return T Value
+     * @throws std::invalid_argument If the text is not a number
+     * @throws std::out_of_range If the value is out of the range of T
+     */
+    template <typename T>
+    static T
+    parse_float(std::string_view text) {
+        T value{};
+        check(to_float(text, value), text);
+        return value;
+    }
+
+private:
+    /**
+     * @brief Throws the exception matching a parse failure
+     *
+     * @param ec Outcome of a to_* function
+     * @param text Text parsed, quoted in the message
+     */
+    static void
+    check(std::errc ec, std::string_view text) {
+        if (ec == std::errc::result_out_of_range)
+            throw std::out_of_range("value out of range: \"" + std::string(text) + '"');
+        if (ec != std::errc{})
+            throw std::invalid_argument("invalid numeric value: \"" + std::string(text) + '"');
+    }
+};
+
+} // namespace qb::pg::detail
@@ -0,0 +1,309 @@
+/**
+ * @file timestamp_codec.cpp
+ * @brief Arithmetic conversion of PostgreSQL timestamps
+ *
+ * @see timestamp_codec.h
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <limits>
+#include <qb/system/endian.h>
+#include <stdexcept>
+#include "./timestamp_codec.h"
+
+namespace qb::pg::detail {
+
+namespace {
+
+constexpr int64_t usecs_per_second = 1000000LL;
+constexpr int64_t usecs_per_day    = 86400LL * usecs_per_second;
+// Range of qb::Timestamp, in microseconds, kept clear of the nanosecond overflow
+constexpr int64_t max_unix_usecs =
+    std::numeric_limits<int64_t>::max() / 1000 - usecs_per_second;
+constexpr int64_t min_unix_usecs =
+    std::numeric_limits<int64_t>::min() / 1000 + usecs_per_second;
+
+/**
+ * @brief Days since 1970-01-01 of a date of the proleptic Gregorian calendar
+ */
+constexpr int64_t
+days_from_civil(int64_t year, unsigned month, unsigned day) noexcept {
+    year -= month <= 2;
+    const int64_t  era = (year >= 0 ? year : year - 399) / 400;
+    const auto     yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+static_assert(days_from_civil(1970, 1, 1) == 0);
+static_assert(days_from_civil(2000, 1, 1) == 10957);
+
+/**
+ * @brief Date of the proleptic Gregorian calendar from days since 1970-01-01
+ */
+constexpr void
+civil_from_days(int64_t days, int64_t &year, unsigned &month, unsigned &day) noexcept {
+    days += 719468;
+    const int64_t  era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto     doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp  = (5 * doy + 2) / 153;
+    day                = doy - (153 * mp + 2) / 5 + 1;
+    month              = mp < 10 ? mp + 3 : mp - 9;
+    year               = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+}
+
+constexpr unsigned
+days_in_month(int64_t year, unsigned month) noexcept {
+    if (month == 2)
+        return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+    return month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31;
+}
+
+int64_t
+floor_div(int64_t value, int64_t divisor) noexcept {
+    const int64_t quotient = value / divisor;
+    return quotient - ((value % divisor) < 0);
+}
+
+qb::Timestamp
+from_unix_usecs(int64_t usecs) noexcept {
+    if (usecs > max_unix_usecs)
+        usecs = max_unix_usecs;
+    else if (usecs < min_unix_usecs)
+        usecs = min_unix_usecs;
+    const int64_t seconds = floor_div(usecs, usecs_per_second);
+    return qb::Timestamp::from_seconds(seconds) +
+           qb::Timespan::from_microseconds(usecs - seconds * usecs_per_second);
+}
+
+int64_t
+to_unix_usecs(qb::Timestamp const &value) noexcept {
+    return floor_div(static_cast<int64_t>(value.nanoseconds()), 1000);
+}
+
+[[noreturn]] void
+invalid() {
+    throw std::runtime_error("Invalid timestamp format");
+}
+
+/**
+ * @brief Cursor over the text of a timestamp
+ */
+struct Scanner {
+    std::string_view text;
+    std::size_t      pos{0};
+
+    bool
+    done() const noexcept {
+        return pos >= text.size();
+    }
+
+    char
+    peek() const noexcept {
+        return done() ? '\0' : text[pos];
+    }
+
+    bool
+    accept(char c) noexcept {
+        if (peek() != c)
+            return false;
+        ++pos;
+        return true;
+    }
+
+    static bool
+    is_digit(char c) noexcept {
+        return c >= '0' && c <= '9';
+    }
+
+    /**
+     * @brief Reads between min and max digits
+     */
+    int64_t
+    number(std::size_t min, std::size_t max) {
+        int64_t     value = 0;
+        std::size_t count = 0;
+        for (; count < max && !done() && is_digit(text[pos]); ++count, ++pos)
+            value = value * 10 + (text[pos] - '0');
+        if (count < min)
+            invalid();
+        return value;
+    }
+};
+
+char *
+write_digits(char *out, unsigned value, int width) noexcept {
+    for (int i = width - 1; i >= 0; --i, value /= 10)
+        out[i] = static_cast<char>('0' + value % 10);
+    return out + width;
+}
+
+} // namespace
+
+int64_t
+TimestampCodec::to_pg(qb::Timestamp const &value) noexcept {
+    return to_unix_usecs(value) - pg_epoch_usecs;
+}
+
+qb::Timestamp
+TimestampCodec::from_pg(int64_t pg_usecs) noexcept {
+    // Saturate instead of overflowing, e.g. for 'infinity'
+    if (pg_usecs > max_unix_usecs - pg_epoch_usecs)
+        return from_unix_usecs(max_unix_usecs);
+    return from_unix_usecs(pg_usecs + pg_epoch_usecs);
+}
+
+qb::Timestamp
+TimestampCodec::read_binary(std::string_view buffer) {
+    if (buffer.size() < 8)
+        throw std::runtime_error("Buffer too small for timestamp");
+    int64_t pg_usecs;
+    // A larger buffer holds the 4-byte length prefix
+    std::memcpy(&pg_usecs, buffer.data() + (buffer.size() == 8 ? 0 : 4), sizeof(pg_usecs));
+    return from_pg(qb::endian::from_big_endian(pg_usecs));
+}
+
+qb::Timestamp
+TimestampCodec::parse(std::string_view text) {
+    while (!text.empty() && text.front() == ' ')
+        text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ')
+        text.remove_suffix(1);
+    if (text.empty())
+        throw std::runtime_error("Empty timestamp string");
+    if (text == "infinity" || text == "+infinity")
+        return from_unix_usecs(max_unix_usecs);
+    if (text == "-infinity")
+        return from_unix_usecs(min_unix_usecs);
+
+    bool bc = false;
+    if (text.size() > 3 && text.substr(text.size() - 3) == " BC") {
+        bc = true;
+        text.remove_suffix(3);
+    }
+
+    Scanner s{text};
+    int64_t year = s.number(4, 9);
+    if (!s.accept('-'))
+        invalid();
+    const auto month = static_cast<unsigned>(s.number(1, 2));
+    if (!s.accept('-'))
+        invalid();
+    const auto day = static_cast<unsigned>(s.number(1, 2));
+    if (bc)
+        year = 1 - year;
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month))
+        invalid();
+
+    int64_t hour = 0, minute = 0, second = 0, fraction = 0;
+    if (s.accept(' ') || s.accept('T')) {
+        hour = s.number(1, 2);
+        if (!s.accept(':'))
+            invalid();
+        minute = s.number(1, 2);
+        if (s.accept(':')) {
+            second = s.number(1, 2);
+            if (s.accept('.')) {
+                std::size_t digits = 0;
+                for (; Scanner::is_digit(s.peek()); ++s.pos, ++digits) {
+                    if (digits < 6)
+                        fraction = fraction * 10 + (s.peek() - '0');
+                }
+                if (!digits)
+                    invalid();
+                for (; digits < 6; ++digits)
+                    fraction *= 10;
+            }
+        }
+        // 24:00:00 is accepted by PostgreSQL as the end of the day
+        if (hour > 24 || minute > 59 || second > 60)
+            invalid();
+    }
+
+    int64_t offset = 0; // seconds east of UTC
+    if (s.accept('Z')) {
+    } else if (s.peek() == '+' || s.peek() == '-') {
+        const bool negative = s.text[s.pos++] == '-';
+        offset              = s.number(1, 2) * 3600;
+        s.accept(':');
+        if (Scanner::is_digit(s.peek())) {
+            offset += s.number(1, 2) * 60;
+            s.accept(':');
+            if (Scanner::is_digit(s.peek()))
+                offset += s.number(1, 2);
+        }
+        if (negative)
+            offset = -offset;
+    }
+    if (!s.done())
+        invalid();
+
+    const int64_t days = days_from_civil(year, month, day);
+    // Dates far out of the range of qb::Timestamp saturate
+    if (days > max_unix_usecs / usecs_per_day)
+        return from_unix_usecs(max_unix_usecs);
+    if (days < min_unix_usecs / usecs_per_day)
+        return from_unix_usecs(min_unix_usecs);
+    const int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second - offset;
+    return from_unix_usecs(seconds * usecs_per_second + fraction);
+}
+
+std::size_t
+TimestampCodec::format(qb::Timestamp const &value, char *out, bool utc) noexcept {
+    const int64_t usecs    = to_unix_usecs(value);
+    const int64_t days     = floor_div(usecs, usecs_per_day);
+    const int64_t time     = usecs - days * usecs_per_day;
+    const auto    seconds  = static_cast<unsigned>(time / usecs_per_second);
+    const auto    fraction = static_cast<unsigned>(time % usecs_per_second);
+
+    int64_t  year;
+    unsigned month, day;
+    civil_from_days(days, year, month, day);
+
+    // qb::Timestamp covers years 1677 to 2262
+    char *p = write_digits(out, static_cast<unsigned>(year), 4);
+    *p++    = '-';
+    p       = write_digits(p, month, 2);
+    *p++    = '-';
+    p       = write_digits(p, day, 2);
+    *p++    = ' ';
+    p       = write_digits(p, seconds / 3600, 2);
+    *p++    = ':';
+    p       = write_digits(p, seconds / 60 % 60, 2);
+    *p++    = ':';
+    p       = write_digits(p, seconds % 60, 2);
+    if (fraction) {
+        *p++ = '.';
+        p    = write_digits(p, fraction, 6);
+    }
+    if (utc) {
+        std::memcpy(p, "+00", 3);
+        p += 3;
+    }
+    return static_cast<std::size_t>(p - out);
+}
+
+std::string
+TimestampCodec::to_text(qb::Timestamp const &value, bool utc) {
+    char buffer[max_text_size];
+    return std::string(buffer, format(value, buffer, utc));
+}
+
+} // namespace qb::pg::detail
@@ -0,0 +1,109 @@
+/**
+ * @file timestamp_codec.h
+ * @brief Arithmetic conversion of PostgreSQL timestamps
+ *
+ * Timestamps are converted without struct tm, mktime, timegm, sscanf or
+ * strftime, which consult the time zone database and the locale:
+ *
+ * - Binary values, microseconds since 2000-01-01, are shifted to the Unix epoch
+ * - Text values are parsed and formatted with civil calendar arithmetic
+ *
+ * Values without a time zone are read and written as UTC wall-clock times,
+ * like the binary format. No allocation or global state is involved, so
+ * conversions are thread-safe.
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <qb/system/timestamp.h>
+#include <string>
+#include <string_view>
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Conversions between qb timestamps and the PostgreSQL formats
+ */
+struct TimestampCodec {
+    /// Microseconds between the Unix epoch and the PostgreSQL epoch (2000-01-01)
+    static constexpr int64_t pg_epoch_usecs = 946684800LL * 1000000LL;
+    /// Longest text produced by format(), with a time zone suffix
+    static constexpr std::size_t max_text_size = 32;
+
+    /**
+     * @brief Converts a timestamp to microseconds since 2000-01-01
+     *
+     * @param value Timestamp
+     * @return int64_t PostgreSQL binary value, rounded down to the microsecond
+     */
+    static int64_t to_pg(qb::Timestamp const &value) noexcept;
+
+    /**
+     * @brief Converts microseconds since 2000-01-01 to a timestamp
+     *
+     * Values out of the range of qb::Timestamp, such as 'infinity', saturate.
+     *
+     * @param pg_usecs PostgreSQL binary value
+     * @return qb::Timestamp Timestamp
+     */
+    static qb::Timestamp from_pg(int64_t pg_usecs) noexcept;
+
+    /**
+     * @brief Decodes the 8-byte binary value of a timestamp field
+     *
+     * @param buffer Field value, optionally preceded by its 4-byte length
+     * @return qb::Timestamp Timestamp
+     * @throws std::runtime_error If the buffer is too small
+     */
+    static qb::Timestamp read_binary(std::string_view buffer);
+
+    /**
+     * @brief Parses an ISO 8601 timestamp
+     *
+     * Accepts `YYYY-MM-DD[( |T)HH:MM[:SS[.fraction]]][Z|(+|-)HH[[:]MM[[:]SS]]][ BC]`
+     * as well as 'infinity' and '-infinity'. A time zone offset is applied to
+     * get the UTC time; digits beyond the microsecond are truncated.
+     *
+     * @param text Text value
+     * @return qb::Timestamp Timestamp
+     * @throws std::runtime_error If the text is not a valid timestamp
+     */
+    static qb::Timestamp parse(std::string_view text);
+
+    /**
+     * @brief Formats a timestamp as `YYYY-MM-DD HH:MM:SS[.ffffff]`
+     *
+     * @param value Timestamp
+     * @param out Destination, at least max_text_size bytes
+     * @param utc True to append the `+00` time zone
+     * @return std::size_t Number of characters written
+     */
+    static std::size_t format(qb::Timestamp const &value, char *out, bool utc) noexcept;
+
+    /**
+     * @brief Formats a timestamp into a string
+     *
+     * @param value Timestamp
+     * @param utc True to append the `+00` time zone
+     * @return std::string Text value
+     */
+    static std::string to_text(qb::Timestamp const &value, bool utc);
+};
+
+} // namespace qb::pg::detail
@@ -32,7 +32,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <memory>
+#include <random>
+#include <stdexcept>
 #include <utility>
 
 #include "./transaction.h"
@@ -40,10 +43,91 @@
 
 namespace qb::pg::detail {
 
+namespace {
+
+/**
+ * @brief Gets the value of a SQLSTATE character, -1 if not in [0-9A-Z]
+ */
+constexpr int
+state_digit(char c) noexcept {
+    return c >= '0' && c <= '9' ? c - '0' : c >= 'A' && c <= 'Z' ? c - 'A' + 10 : -1;
+}
+
+/**
+ * @brief Gets the index of the class of a SQLSTATE, -1 if malformed
+ */
+int
+state_class(std::string_view state) noexcept {
+    if (state.size() < 2)
+        return -1;
+    const int high = state_digit(state[0]);
+    const int low  = state_digit(state[1]);
+    return high < 0 || low < 0 ? -1 : high * 36 + low;
+}
+
+} // namespace
+
+RetryPolicy::RetryPolicy() {
+    retry_on(sqlstate::serialization_failure);
+    retry_on(sqlstate::deadlock_detected);
+}
+
+RetryPolicy &
+RetryPolicy::retry_on(std::string_view state) {
+    if (state.size() == 2) {
+        const int index = state_class(state);
+        if (index < 0)
+            throw std::invalid_argument("invalid SQLSTATE class: " + std::string(state));
+        _classes.set(static_cast<std::size_t>(index));
+        return *this;
+    }
+    const auto code = sqlstate::code_to_state(state);
+    if (code == sqlstate::unknown_code)
+        throw std::invalid_argument("unknown SQLSTATE: " + std::string(state));
+    return retry_on(code);
+}
+
+RetryPolicy &
+RetryPolicy::retry_on(sqlstate::code state) noexcept {
+    if (state != sqlstate::unknown_code)
+        _codes.set(static_cast<std::size_t>(state));
+    return *this;
+}
+
+RetryPolicy &
+RetryPolicy::clear() noexcept {
+    _classes.reset();
+    _codes.reset();
+    return *this;
+}
+
+bool
+RetryPolicy::retryable(error::db_error const &err) const noexcept {
+    if (err.sqlstate != sqlstate::unknown_code &&
+        _codes.test(static_cast<std::size_t>(err.sqlstate)))
+        return true;
+    const int index = state_class(err.code);
+    return index >= 0 && _classes.test(static_cast<std::size_t>(index));
+}
+
+double
+RetryPolicy::backoff(unsigned attempt) const {
+    thread_local std::minstd_rand generator{std::random_device{}()};
+    const double base  = std::chrono::duration<double>(base_delay).count();
+    const double limit = std::chrono::duration<double>(max_delay).count();
+    // Capped so that the shift cannot overflow on long retry chains
+    const unsigned doublings = std::min(attempt ? attempt - 1 : 0u, 30u);
+    const double   ceiling   = std::min(limit, base * static_cast<double>(1u << doublings));
+    if (ceiling <= 0)
+        return 0;
+    return std::uniform_real_distribution<double>(0, ceiling)(generator);
+}
+
 Transaction::Transaction(Transaction *parent) noexcept
     : _parent(parent)
     , _query_storage(parent->_query_storage)
-    , _error{"unknown error"} {}
+    , _error{"unknown error"}
+    , _memory(parent->_memory) {}
 
 Transaction::Transaction(PreparedQueryStorage &storage) noexcept
     : _parent(nullptr)
@@ -76,14 +160,21 @@ Transaction::parent() const {
 
 void
 Transaction::push_transaction(std::unique_ptr<Transaction> cmd) {
-    _sub_commands.push(std::move(cmd));
+    _sub_commands.push_back(std::move(cmd));
     on_new_command();
 }
 
+void
+Transaction::push_transaction_after(Transaction const *cmd, std::unique_ptr<Transaction> next) {
+    auto it = std::find_if(_sub_commands.begin(), _sub_commands.end(),
+                           [cmd](auto const &sub) { return sub.get() == cmd; });
+    _sub_commands.insert(it == _sub_commands.end() ? it : it + 1, std::move(next));
+}
+
 std::unique_ptr<Transaction>
 Transaction::pop_transaction() {
     auto ret = std::move(_sub_commands.front());
-    _sub_commands.pop();
+    _sub_commands.pop_front();
     on_sub_command_status(ret->_result);
     return ret;
 }
@@ -95,6 +186,8 @@ Transaction::next_transaction() {
 
 void
 Transaction::push_query(std::unique_ptr<ISqlQuery> qry) {
+    if (qb::unlikely(QueryMetrics::collecting()))
+        qry->queued_at = std::chrono::steady_clock::now();
     _queries.push(std::move(qry));
 }
 
@@ -125,7 +218,95 @@ void
 Transaction::on_new_row_description(row_description_type &&) {}
 
 void
-Transaction::on_new_data_row(row_data &&) {}
+Transaction::on_new_parameter_types(type_oid_sequence &&) {}
+
+bool
+Transaction::on_new_data_row(message_view &) {
+    return true;
+}
+
+void
+Transaction::on_new_command_complete(std::string_view) {}
+
+void
+Transaction::on_new_portal_suspended() {}
+
+void
+Transaction::on_new_copy_response(bool) {}
+
+bool
+Transaction::on_copy_in(message &data) {
+    message fail(copy_fail_tag);
+    fail.write(std::string("COPY FROM STDIN requires copy_in()"));
+    data.pack(fail);
+    return false;
+}
+
+void
+Transaction::on_new_copy_data(std::string_view) {}
+
+FieldStream *
+Transaction::field_stream() {
+    return nullptr;
+}
+
+void
+Transaction::resume_query(bool fetch) {
+    if (_parent)
+        _parent->resume_query(fetch);
+}
+
+void
+Transaction::cancel_query() {
+    if (_parent)
+        _parent->cancel_query();
+}
+
+void
+Transaction::on_query_error(error::db_error const &err) {
+    if (_parent)
+        _parent->on_query_error(err);
+}
+
+void
+Transaction::defer(std::function<void()> task, double delay) {
+    if (_parent) {
+        _parent->defer(std::move(task), delay);
+        return;
+    }
+    ++_deferred;
+    qb::io::async::callback(
+        [this, task = std::move(task)]() {
+            --_deferred;
+            task();
+        },
+        delay);
+}
+
+RetryPolicy const *
+Transaction::retry_policy() const {
+    return _parent ? _parent->retry_policy() : nullptr;
+}
+
+std::function<void()>
+Transaction::loop_poster(std::function<void()> task) {
+    return _parent ? _parent->loop_poster(std::move(task)) : std::function<void()>{};
+}
+
+ResultCache *
+Transaction::result_cache() {
+    return _parent ? _parent->result_cache() : nullptr;
+}
+
+bool
+Transaction::closes_block() const noexcept {
+    return false;
+}
+
+bool
+Transaction::holds_queue() const noexcept {
+    return false;
+}
 
 Transaction &
 Transaction::execute(std::string_view expr) {
@@ -150,6 +331,12 @@ Transaction::prepare_file(std::string_view query_name,
                        [](error::db_error const &) {});
 }
 
+Transaction &
+Transaction::atomic(AtomicBlock &&block, transaction_mode mode) {
+    return atomic(
+        std::move(block), [](Transaction &) {}, [](error::db_error const &) {}, mode);
+}
+
 Transaction &
 Transaction::execute(std::string_view query_name, QueryParams &&params) {
     return this->execute(
@@ -157,6 +344,43 @@ Transaction::execute(std::string_view query_name, QueryParams &&params) {
         [](error::db_error const &) {});
 }
 
+PreparedHandle
+Transaction::statement(std::string_view query_name) const {
+    return _query_storage.find(query_name);
+}
+
+row_description_type const &
+Transaction::row_description(PreparedHandle statement) const {
+    return _query_storage.get(statement).row_description;
+}
+
+Transaction &
+Transaction::execute(PreparedHandle statement, QueryParams &&params) {
+    return this->execute(
+        statement, std::move(params), [](Transaction &, auto) {},
+        [](error::db_error const &) {});
+}
+
+Transaction &
+Transaction::execute_batch(std::string_view query_name,
+                           std::vector<QueryParams> &&params) {
+    return this->execute_batch(query_name, std::move(params), [](Transaction &) {},
+                               [](error::db_error const &) {});
+}
+
+Transaction &
+Transaction::result_format(std::string_view query_name, ResultFormat format) {
+    _query_storage.set_result_format(query_name, std::move(format));
+    return *this;
+}
+
+Transaction &
+Transaction::recycle_results(std::string_view query_name, std::size_t capacity,
+                             std::size_t max_bytes) {
+    _query_storage.recycle_results(query_name, capacity, max_bytes);
+    return *this;
+}
+
 Transaction &
 Transaction::execute_file(const std::filesystem::path& file_path) {
     return execute_file(file_path, 
@@ -164,6 +388,62 @@ Transaction::execute_file(const std::filesystem::path& file_path) {
                        [](error::db_error const &) {});
 }
 
+Transaction &
+Transaction::timeout(std::chrono::milliseconds budget) noexcept {
+    _timeout  = budget;
+    _deadline = {};
+    return *this;
+}
+
+std::chrono::steady_clock::time_point
+Transaction::deadline() noexcept {
+    if (_timeout.count() <= 0)
+        return std::chrono::steady_clock::time_point::max();
+    if (_deadline == std::chrono::steady_clock::time_point{})
+        _deadline = std::chrono::steady_clock::now() + _timeout;
+    return _deadline;
+}
+
+Transaction &
+Transaction::result_limits(ResultLimits limits) {
+    _result_limits = std::move(limits);
+    return *this;
+}
+
+ResultLimits
+Transaction::result_limits() const {
+    auto tighter = [](std::size_t current, std::size_t limit) {
+        return limit && (!current || limit < current) ? limit : current;
+    };
+    ResultLimits limits;
+    for (auto cmd = this; cmd; cmd = cmd->_parent) {
+        limits.max_rows  = tighter(limits.max_rows, cmd->_result_limits.max_rows);
+        limits.max_bytes = tighter(limits.max_bytes, cmd->_result_limits.max_bytes);
+        if (!limits.on_overflow)
+            limits.on_overflow = cmd->_result_limits.on_overflow;
+    }
+    return limits;
+}
+
+Transaction &
+Transaction::memory_resource(std::pmr::memory_resource *resource) noexcept {
+    _memory = resource;
+    return *this;
+}
+
+std::pmr::memory_resource *
+Transaction::memory_resource() const noexcept {
+    return _memory ? _memory : std::pmr::get_default_resource();
+}
+
+bool
+Transaction::connection_memory() const noexcept {
+    auto root = this;
+    while (root->_parent)
+        root = root->_parent;
+    return memory_resource() == root->memory_resource();
+}
+
 bool
 Transaction::has_error() const {
     return _error.sqlstate != sqlstate::unknown_code;
@@ -183,10 +463,34 @@ Transaction::status
 Transaction::await() {
     results() = {};
 
-    while (!_sub_commands.empty() || !_queries.empty())
+    while (!_sub_commands.empty() || !_queries.empty() || _deferred)
         qb::io::async::run_once();
 
     return {std::move(results()), std::move(_error)};
 }
 
+Portal::Portal(Transaction *parent) noexcept
+    : Transaction(parent) {}
+
+bool
+Portal::suspended() const {
+    return _suspended;
+}
+
+void
+Portal::fetch() {
+    if (!_suspended)
+        return;
+    _suspended = false;
+    resume_query(true);
+}
+
+void
+Portal::close() {
+    if (!_suspended)
+        return;
+    _suspended = false;
+    resume_query(false);
+}
+
 } // namespace qb::pg::detail
\ No newline at end of file
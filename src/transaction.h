@@ -45,6 +45,10 @@
 
 #pragma once
 
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <qb/io/async.h>
 #include <queue>
@@ -52,14 +56,139 @@
 #include <type_traits>
 #include <utility>
 #include <filesystem>
+#include <functional>
 
+#include "./atomic_block.h"
+#include "./field_stream.h"
+#include "./node_pool.h"
+#include "./offload.h"
 #include "./queries.h"
+#include "./result_cache.h"
 #include "./result_impl.h"
 #include "./resultset.h"
+#include "./typed_statement.h"
 
 namespace qb::pg::detail {
 using namespace qb::pg;
 
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+class QueryAwaiter;
+#endif
+
+/**
+ * @brief Bounds on the rows a query keeps in memory
+ *
+ * Applies to the queries collecting a result set (execute() with a result
+ * callback). Limits set on a transaction cover its queries and those of its
+ * sub-transactions; set on the database they cover the whole connection.
+ * The tightest limit of the enclosing transactions applies.
+ *
+ * Once a query exceeds a limit, the rows it kept are released and either
+ * - handed to on_overflow, which then receives every following row while
+ *   the success callback gets an empty result set, or
+ * - without on_overflow, the query is cancelled on the server and fails
+ *   with error::result_limit_exceeded
+ */
+struct ResultLimits {
+    std::size_t max_rows{0};  ///< Rows kept by a query, 0 for no limit
+    std::size_t max_bytes{0}; ///< Memory used by the rows of a query, 0 for no limit
+    /// Receives the rows instead of failing; the row is only valid during the call
+    std::function<void(resultset::row)> on_overflow;
+
+    /**
+     * @brief Checks whether no limit is set
+     */
+    [[nodiscard]] bool
+    unlimited() const noexcept {
+        return !max_rows && !max_bytes;
+    }
+};
+
+/**
+ * @brief Automatic retry of transaction blocks failing on transient errors
+ *
+ * Serialization failures and deadlocks are expected under SERIALIZABLE or
+ * REPEATABLE READ isolation: the transaction is rolled back by the server and
+ * has to be replayed from the start. With a retry policy, a block begun with
+ * begin() is replayed when it fails on a retryable SQLSTATE, whether the
+ * error comes from one of its statements or from the COMMIT:
+ *
+ * - attempts are bounded by max_attempts, the first run included
+ * - each replay waits a random delay, up to base_delay * 2^(attempt - 1)
+ *   capped by max_delay, on the event loop timer
+ * - on_success runs again on each attempt and must queue the whole block;
+ *   statement callbacks see the errors of every attempt
+ * - once attempts are exhausted, or the error is not retryable, on_error
+ *   receives the error that failed the last attempt
+ *
+ * By default serialization_failure (40001) and deadlock_detected (40P01)
+ * are retried. Errors are classified in constant time, by class and by code.
+ */
+class RetryPolicy {
+    /// Number of SQLSTATE classes, two characters in [0-9A-Z]
+    static constexpr std::size_t class_count = 36 * 36;
+    /// Number of known SQLSTATE codes
+    static constexpr std::size_t code_count = sqlstate::index_corrupted + 1;
+
+    std::bitset<class_count> _classes; ///< Retried SQLSTATE classes
+    std::bitset<code_count>  _codes;   ///< Retried SQLSTATE codes
+
+public:
+    unsigned                  max_attempts{3};  ///< Attempts including the first, 1 to never retry
+    std::chrono::milliseconds base_delay{10};   ///< Upper bound of the first backoff
+    std::chrono::milliseconds max_delay{1000};  ///< Upper bound of every backoff
+
+    /**
+     * @brief Constructs a policy retrying serialization failures and deadlocks
+     */
+    RetryPolicy();
+
+    /**
+     * @brief Adds a retried SQLSTATE
+     *
+     * @param state Class of two characters (e.g. "40") or code of five (e.g. "55P03")
+     * @return RetryPolicy& Reference to this policy for chaining
+     * @throws std::invalid_argument If the state is not a known code or a valid class
+     */
+    RetryPolicy &retry_on(std::string_view state);
+
+    /**
+     * @brief Adds a retried SQLSTATE code
+     */
+    RetryPolicy &retry_on(sqlstate::code state) noexcept;
+
+    /**
+     * @brief Removes every retried SQLSTATE
+     */
+    RetryPolicy &clear() noexcept;
+
+    /**
+     * @brief Checks whether an error is worth replaying the transaction for
+     */
+    [[nodiscard]] bool retryable(error::db_error const &err) const noexcept;
+
+    /**
+     * @brief Draws the delay before an attempt, with full jitter
+     *
+     * @param attempt Index of the attempt about to run, from 1 for the first replay
+     * @return double Delay in seconds
+     */
+    [[nodiscard]] double backoff(unsigned attempt) const;
+};
+
+/**
+ * @brief Scheduling class of a root transaction
+ *
+ * Queued root transactions of a connection run by class, then in
+ * submission order. A waiting transaction is promoted one class per
+ * aging period, see Database::lane_aging().
+ */
+enum class priority : std::uint8_t {
+    critical, ///< Latency-critical work, runs before any queued work of the other classes
+    normal,   ///< Default class
+    bulk,     ///< Batch work, runs when no other work is queued
+};
+
 /**
  * @brief Base class for database transaction operations
  *
@@ -71,18 +200,33 @@ using namespace qb::pg;
  * - Handling success and error callbacks
  *
  * It uses a fluent interface to allow chaining operations together
- * in a natural and readable syntax.
+ * in a natural and readable syntax. Command nodes and their queues are
+ * allocated from the NodePool freelists of the connection thread.
  */
-class Transaction {
+class Transaction : public PooledNode {
 protected:
-    Transaction *_parent{nullptr}; ///< Parent transaction (for nested transactions)
-    std::queue<std::unique_ptr<Transaction>>
-                                           _sub_commands; ///< Queue of sub-transactions
-    std::queue<std::unique_ptr<ISqlQuery>> _queries; ///< Queue of SQL queries to execute
+    /// Queue of sub-transactions, drawing its storage from NodePool
+    using command_queue =
+        std::deque<std::unique_ptr<Transaction>, NodeAllocator<std::unique_ptr<Transaction>>>;
+    /// Queue of SQL queries, drawing its storage from NodePool
+    using query_queue = std::queue<
+        std::unique_ptr<ISqlQuery>,
+        std::deque<std::unique_ptr<ISqlQuery>, NodeAllocator<std::unique_ptr<ISqlQuery>>>>;
+
+    Transaction  *_parent{nullptr}; ///< Parent transaction (for nested transactions)
+    command_queue _sub_commands;    ///< Queue of sub-transactions
+    query_queue   _queries;         ///< Queue of SQL queries to execute
     PreparedQueryStorage &_query_storage;            ///< Storage for prepared queries
     bool                  _result{true}; ///< Result status of the transaction
     error::db_error       _error;        ///< Error message of the transaction
     result_impl           _results;      ///< Last results of the transaction
+    std::chrono::milliseconds _timeout{0}; ///< Time budget of the transaction, 0 for none
+    std::chrono::steady_clock::time_point _deadline{}; ///< Expiry of the started budget
+    ResultLimits _result_limits; ///< Bounds on the rows kept by the queries
+    unsigned     _deferred{0};   ///< Tasks deferred by defer() and not run yet, awaited by await()
+    priority     _lane{priority::normal}; ///< Scheduling class, for root transactions
+    std::pmr::memory_resource *_memory{nullptr}; ///< Resource of the rows, null for the default one
+    std::chrono::steady_clock::time_point _queued_at{}; ///< Queued on its connection, by class
 
     Transaction() = delete;
 
@@ -108,6 +252,31 @@ protected:
      */
     explicit Transaction(PreparedQueryStorage &storage) noexcept;
 
+    /**
+     * @brief Checks whether the rows of the transaction may outlive its queries
+     *
+     * Rows allocated from the resource of the connection, the root
+     * transaction, may be recycled by prepared statements or cached.
+     *
+     * @return bool True if memory_resource() is the one of the root transaction
+     */
+    [[nodiscard]] bool connection_memory() const noexcept;
+
+    /**
+     * @brief Queues the execution of a prepared query, by name or handle
+     *
+     * @tparam CB_SUCCESS Type of success callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param statement Prepared query
+     * @param params Parameters for the prepared query
+     * @param on_success Callback called when query executes successfully
+     * @param on_error Callback called if query execution fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_prepared(PreparedRef &&statement, QueryParams &&params,
+                                  CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
 public:
     /**
      * @brief Virtual destructor
@@ -144,6 +313,18 @@ public:
      */
     void push_transaction(std::unique_ptr<Transaction> cmd);
 
+    /**
+     * @brief Inserts a sub-transaction right behind another one of the queue
+     *
+     * The command takes the slot following cmd instead of the back of the
+     * queue, and is not scheduled: the commands queued behind cmd run after
+     * it. Appended if cmd is not in the queue.
+     *
+     * @param cmd Sub-transaction to insert behind
+     * @param next Pointer to the sub-transaction
+     */
+    void push_transaction_after(Transaction const *cmd, std::unique_ptr<Transaction> next);
+
     /**
      * @brief Removes and returns the next sub-transaction from the queue
      *
@@ -202,12 +383,164 @@ public:
      */
     virtual void on_new_row_description(row_description_type &&);
 
+    /**
+     * @brief Called when a prepared statement is described
+     *
+     * @param Types of the parameters, as inferred by the server
+     */
+    virtual void on_new_parameter_types(type_oid_sequence &&);
+
     /**
      * @brief Called when a query returns a data row
      *
-     * @param Row data from the result
+     * The message is a view over the connection input buffer, positioned at
+     * the column count. It is only valid for the duration of the call.
+     *
+     * @param DataRow message from the result
+     * @return false if the row could not be decoded
+     */
+    virtual bool on_new_data_row(message_view &);
+
+    /**
+     * @brief Called when the current query completes a command
+     *
+     * @param command_tag Command tag reported by the server (e.g. "INSERT 0 1")
+     */
+    virtual void on_new_command_complete(std::string_view command_tag);
+
+    /**
+     * @brief Called when the server suspends the portal of the current query
+     *
+     * Only queries executed with a row limit are suspended.
+     */
+    virtual void on_new_portal_suspended();
+
+    /**
+     * @brief Called when the server enters COPY mode for the current query
+     *
+     * @param binary True if the COPY data is in binary format
+     */
+    virtual void on_new_copy_response(bool binary);
+
+    /**
+     * @brief Called when the server is ready for more COPY FROM STDIN data
+     *
+     * Fills @p data with the next chunk. To end the copy, packs a CopyDone
+     * (or CopyFail) message after it and returns false. The default
+     * implementation fails the copy, since no data source is attached.
+     *
+     * @param data CopyData message to fill
+     * @return bool True if more data will follow
+     */
+    virtual bool on_copy_in(message &data);
+
+    /**
+     * @brief Called for each CopyData message of a COPY TO STDOUT
+     *
+     * @param data Payload of the message, only valid during the call
+     */
+    virtual void on_new_copy_data(std::string_view data);
+
+    /**
+     * @brief Gets the columns of the current query streamed to a sink
+     *
+     * Queried by the protocol when a DataRow message starts. Designated
+     * columns are then forwarded in chunks while the message is read, and
+     * on_new_data_row() receives the row without their bytes.
+     *
+     * @return FieldStream* Streamed columns, or nullptr to buffer whole rows
+     */
+    virtual FieldStream *field_stream();
+
+    /**
+     * @brief Continues the suspended query of the connection
+     *
+     * Forwarded up to the root transaction, which owns the connection.
+     *
+     * @param fetch True to fetch the next rows, false to close the portal
+     */
+    virtual void resume_query(bool fetch);
+
+    /**
+     * @brief Cancels the query in flight on the connection
+     *
+     * Forwarded up to the root transaction, which owns the connection.
+     */
+    virtual void cancel_query();
+
+    /**
+     * @brief Called when a query of the connection fails, before its error callback
+     *
+     * Forwarded up to the root transaction, so that enclosing blocks learn
+     * the server error that aborted them.
+     *
+     * @param err Error of the query
+     */
+    virtual void on_query_error(error::db_error const &err);
+
+    /**
+     * @brief Runs a task on the event loop after a delay
+     *
+     * Forwarded up to the root transaction, which drops the task if the
+     * connection is destroyed in the meantime. await() on the root waits
+     * for the pending tasks.
+     *
+     * @param task Task to run
+     * @param delay Delay in seconds
+     */
+    virtual void defer(std::function<void()> task, double delay);
+
+    /**
+     * @brief Binds a task to the event loop, to post it later from any thread
+     *
+     * Forwarded up to the root transaction. The returned poster, called once
+     * from any thread, wakes up the loop to run the task; await() on the
+     * root waits for it meanwhile. The task is dropped if the connection is
+     * destroyed first.
+     *
+     * @param task Task to run on the event loop
+     * @return std::function<void()> Poster of the task, empty if the root has no event loop
      */
-    virtual void on_new_data_row(row_data &&);
+    [[nodiscard]] virtual std::function<void()> loop_poster(std::function<void()> task);
+
+    /**
+     * @brief Gets the retry policy applied to the blocks begun on the connection
+     *
+     * Forwarded up to the root transaction.
+     *
+     * @return RetryPolicy const* Policy, nullptr if blocks are not retried
+     */
+    [[nodiscard]] virtual RetryPolicy const *retry_policy() const;
+
+    /**
+     * @brief Gets the result cache serving the prepared statements executed here
+     *
+     * Forwarded up to the root transaction; transaction blocks return
+     * nullptr, their reads may see their own uncommitted writes.
+     *
+     * @return ResultCache* Cache, nullptr if results are not cached here
+     */
+    [[nodiscard]] virtual ResultCache *result_cache();
+
+    /**
+     * @brief Checks if the command ends the transaction block queued before it
+     *
+     * A command closing a block stays right behind the command opening it;
+     * the scheduler never queues other work between them.
+     *
+     * @return bool True for the COMMIT/ROLLBACK command of a block
+     */
+    [[nodiscard]] virtual bool closes_block() const noexcept;
+
+    /**
+     * @brief Checks if the command, done with its work, still holds the queue
+     *
+     * The root keeps a holding command at the head of its queue, and runs
+     * nothing behind it, until a deferred task releases it.
+     *
+     * @return bool True while the command waits for a deferred task
+     */
+    [[nodiscard]] virtual bool holds_queue() const noexcept;
 
     /**
      * @brief Begins a new transaction with success and error callbacks
@@ -236,6 +569,23 @@ public:
     template <typename CB_SUCCESS>
     Transaction &begin(CB_SUCCESS &&on_success, transaction_mode mode = {});
 
+    /**
+     * @brief Begins a new transaction replayed on transient errors
+     *
+     * on_success is called again on each attempt, see RetryPolicy.
+     *
+     * @tparam CB_SUCCESS Type of success callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param on_success Callback queueing the statements of the block
+     * @param on_error Callback called once the block failed for good
+     * @param mode Transaction mode settings
+     * @param policy Retry policy of this block
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &begin(CB_SUCCESS &&on_success, CB_ERROR &&on_error,
+                       transaction_mode mode, RetryPolicy policy);
+
     /**
      * @brief Creates a savepoint within the current transaction
      *
@@ -449,6 +799,600 @@ public:
      */
     Transaction &execute(std::string_view query_name, QueryParams &&params);
 
+    /**
+     * @brief Gets the handle of a prepared query
+     *
+     * The handle is valid as soon as prepare() was called and skips the name
+     * lookup at every execution. Handles are bound to the connection that
+     * prepared the query.
+     *
+     * @param query_name Name of the prepared query
+     * @return PreparedHandle Handle, invalid if the name was never prepared
+     */
+    [[nodiscard]] PreparedHandle statement(std::string_view query_name) const;
+
+    /**
+     * @brief Gets the description of the rows returned by a prepared query
+     *
+     * Available once the query is prepared, with the format codes of its
+     * result format; used to build row binders once per statement.
+     *
+     * @param statement Handle of the prepared query
+     * @return row_description_type const& Description of the result columns
+     * @throws std::out_of_range If the statement is not prepared
+     */
+    [[nodiscard]] row_description_type const &
+    row_description(PreparedHandle statement) const;
+
+    /**
+     * @brief Executes a prepared query by handle with parameters and callbacks
+     *
+     * @tparam CB_SUCCESS Type of success callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param statement Handle of the prepared query
+     * @param params Parameters for the prepared query
+     * @param on_success Callback called when query executes successfully
+     * @param on_error Callback called if query execution fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS, typename CB_ERROR,
+              typename = std::enable_if<std::is_function_v<CB_SUCCESS> &&
+                                        std::is_function_v<CB_ERROR>>>
+    Transaction &execute(PreparedHandle statement, QueryParams &&params,
+                         CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a prepared query by handle with parameters and success callback
+     *
+     * @tparam CB_SUCCESS Type of success callback function
+     * @param statement Handle of the prepared query
+     * @param params Parameters for the prepared query
+     * @param on_success Callback called when query executes successfully
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS,
+              typename = std::enable_if<std::is_function_v<CB_SUCCESS>>>
+    Transaction &execute(PreparedHandle statement, QueryParams &&params,
+                         CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a prepared query by handle without callbacks
+     *
+     * @param statement Handle of the prepared query
+     * @param params Parameters for the prepared query
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &execute(PreparedHandle statement, QueryParams &&params);
+
+    /**
+     * @brief Prepares a statement typed at compile time
+     *
+     * Sends the parameter types derived from the statement signature.
+     *
+     * @tparam Ret Type of the rows of the statement
+     * @tparam Args Types of the parameters of the statement
+     * @tparam CB_SUCCESS Type of success callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param statement Statement definition
+     * @param on_success Callback called when the statement is prepared
+     * @param on_error Callback called if preparation fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Ret, typename... Args, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &prepare(TypedStatement<Ret(Args...)> const &statement,
+                         CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Prepares a statement typed at compile time without callbacks
+     *
+     * @param statement Statement definition
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Ret, typename... Args>
+    Transaction &prepare(TypedStatement<Ret(Args...)> const &statement);
+
+    /**
+     * @brief Executes a typed statement with its bound arguments
+     *
+     * @tparam Ret Type of the rows of the statement
+     * @tparam CB_SUCCESS Type of success callback, (Transaction &, std::vector<Ret>)
+     * or (Transaction &) when Ret is void
+     * @tparam CB_ERROR Type of error callback function
+     * @param statement Execution returned by the statement call operator
+     * @param on_success Callback receiving the decoded rows
+     * @param on_error Callback called if the execution fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Ret, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute(BoundStatement<Ret> &&statement, CB_SUCCESS &&on_success,
+                         CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a typed statement with its bound arguments and success callback
+     *
+     * @param statement Execution returned by the statement call operator
+     * @param on_success Callback receiving the decoded rows
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Ret, typename CB_SUCCESS>
+    Transaction &execute(BoundStatement<Ret> &&statement, CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a typed statement with its bound arguments without callbacks
+     *
+     * @param statement Execution returned by the statement call operator
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Ret>
+    Transaction &execute(BoundStatement<Ret> &&statement);
+
+    /**
+     * @brief Executes a prepared query and decodes its rows on worker threads
+     *
+     * Results of at least offload.min_rows rows are frozen in an immutable
+     * storage shared with the executor, which decodes ranges of
+     * offload.rows_per_task rows in parallel; the connection serves the
+     * next queries meanwhile. The callbacks run on the thread of the
+     * connection once every range is decoded, with the connection as
+     * transaction: an offloaded query inside a block completes after the
+     * block. Smaller results are decoded at once, like execute().
+     *
+     * @tparam Row Type of the rows: a column type, a std::tuple of column
+     * types or a structure with a static `columns` tuple
+     * @tparam CB_SUCCESS Type of success callback, (Transaction &, std::vector<Row>)
+     * @tparam CB_ERROR Type of error callback function
+     * @param query_name Name of the prepared query
+     * @param params Parameters for the prepared query
+     * @param offload Executor and ranges of the decoding
+     * @param on_success Callback receiving the decoded rows
+     * @param on_error Callback called if the query or the decoding fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Row, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_offload(std::string_view query_name, QueryParams &&params,
+                                 ResultOffload const &offload, CB_SUCCESS &&on_success,
+                                 CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a typed statement and decodes its rows on worker threads
+     *
+     * @tparam Ret Type of the rows of the statement
+     * @tparam CB_SUCCESS Type of success callback, (Transaction &, std::vector<Ret>)
+     * @tparam CB_ERROR Type of error callback function
+     * @param statement Execution returned by the statement call operator
+     * @param offload Executor and ranges of the decoding
+     * @param on_success Callback receiving the decoded rows
+     * @param on_error Callback called if the query or the decoding fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Ret, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_offload(BoundStatement<Ret> &&statement, ResultOffload const &offload,
+                                 CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a typed statement and decodes its rows on worker threads
+     * with success callback
+     *
+     * @tparam Ret Type of the rows of the statement
+     * @tparam CB_SUCCESS Type of success callback, (Transaction &, std::vector<Ret>)
+     * @param statement Execution returned by the statement call operator
+     * @param offload Executor and ranges of the decoding
+     * @param on_success Callback receiving the decoded rows
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Ret, typename CB_SUCCESS>
+    Transaction &execute_offload(BoundStatement<Ret> &&statement, ResultOffload const &offload,
+                                 CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a prepared query once per parameter set, in one round trip
+     *
+     * All Bind/Execute pairs are encoded into a single message with one
+     * trailing Sync. The batch is atomic: if one execution fails, none of
+     * them is committed.
+     *
+     * @tparam CB_SUCCESS Type of success callback ((Transaction &) or
+     * (Transaction &, std::size_t affected_rows))
+     * @tparam CB_ERROR Type of error callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameter sets, one per execution
+     * @param on_success Callback called once the whole batch succeeded
+     * @param on_error Callback called if the batch fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_batch(std::string_view query_name,
+                               std::vector<QueryParams> &&params,
+                               CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a transaction block in a single round trip
+     *
+     * BEGIN, the statements of the block and COMMIT are sent under one Sync.
+     * On the first error the server skips the remaining statements; the
+     * block is rolled back and the error reported with its step. Only
+     * available outside a transaction.
+     *
+     * @tparam CB_SUCCESS Type of success callback ((Transaction &) or
+     * (Transaction &, std::size_t affected_rows))
+     * @tparam CB_ERROR Type of error callback ((error::db_error const &) or
+     * (error::db_error const &, std::size_t step), step being the index of the
+     * failing statement or AtomicBlock::npos for BEGIN and COMMIT)
+     * @param block Statements of the block
+     * @param on_success Callback called once the block is committed
+     * @param on_error Callback called once the block is rolled back
+     * @param mode Transaction mode settings
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &atomic(AtomicBlock &&block, CB_SUCCESS &&on_success, CB_ERROR &&on_error,
+                        transaction_mode mode = {});
+
+    /**
+     * @brief Executes a transaction block in a single round trip with a success callback
+     *
+     * @param block Statements of the block
+     * @param on_success Callback called once the block is committed
+     * @param mode Transaction mode settings
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS>
+    Transaction &atomic(AtomicBlock &&block, CB_SUCCESS &&on_success,
+                        transaction_mode mode = {});
+
+    /**
+     * @brief Executes a transaction block in a single round trip without callbacks
+     *
+     * @param block Statements of the block
+     * @param mode Transaction mode settings
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &atomic(AtomicBlock &&block, transaction_mode mode = {});
+
+    /**
+     * @brief Executes a prepared query once per parameter set with success callback
+     *
+     * @tparam CB_SUCCESS Type of success callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameter sets, one per execution
+     * @param on_success Callback called once the whole batch succeeded
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SUCCESS>
+    Transaction &execute_batch(std::string_view query_name,
+                               std::vector<QueryParams> &&params,
+                               CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a prepared query once per parameter set without callbacks
+     *
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameter sets, one per execution
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &execute_batch(std::string_view query_name,
+                               std::vector<QueryParams> &&params);
+
+    /**
+     * @brief Bulk loads data with COPY FROM STDIN
+     *
+     * The producer is called with a CopyWriter each time the connection can
+     * send more data; everything it writes goes out as one CopyData message.
+     * It returns true while more data will follow and false once done.
+     * Text, CSV and binary COPY formats are supported, as announced by the
+     * server for @p expr.
+     *
+     * @tparam CB_PRODUCER Type of producer, bool(CopyWriter &)
+     * @tparam CB_SUCCESS Type of success callback ((Transaction &) or
+     * (Transaction &, std::size_t rows))
+     * @tparam CB_ERROR Type of error callback function
+     * @param expr COPY ... FROM STDIN statement
+     * @param producer Callback filling each chunk of data
+     * @param on_success Callback called once the data is committed
+     * @param on_error Callback called if the copy fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_PRODUCER, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &copy_in(std::string_view expr, CB_PRODUCER &&producer,
+                         CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Bulk loads data with COPY FROM STDIN with success callback
+     *
+     * @tparam CB_PRODUCER Type of producer, bool(CopyWriter &)
+     * @tparam CB_SUCCESS Type of success callback function
+     * @param expr COPY ... FROM STDIN statement
+     * @param producer Callback filling each chunk of data
+     * @param on_success Callback called once the data is committed
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_PRODUCER, typename CB_SUCCESS>
+    Transaction &copy_in(std::string_view expr, CB_PRODUCER &&producer,
+                         CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Exports data with COPY TO STDOUT
+     *
+     * Every CopyData message is handed to the sink as it arrives; nothing
+     * is buffered. The sink either takes raw chunks (std::string_view), in
+     * any COPY format, or decoded tuples (CopyRow const &), which requires
+     * a binary COPY (FORMAT binary).
+     *
+     * @tparam CB_SINK Type of sink, void(std::string_view) or void(CopyRow const &)
+     * @tparam CB_SUCCESS Type of success callback ((Transaction &) or
+     * (Transaction &, std::size_t rows))
+     * @tparam CB_ERROR Type of error callback function
+     * @param expr COPY ... TO STDOUT statement
+     * @param sink Callback receiving the exported data
+     * @param on_success Callback called once the export is complete
+     * @param on_error Callback called if the export fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SINK, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &copy_out(std::string_view expr, CB_SINK &&sink, CB_SUCCESS &&on_success,
+                          CB_ERROR &&on_error);
+
+    /**
+     * @brief Exports data with COPY TO STDOUT with success callback
+     *
+     * @tparam CB_SINK Type of sink, void(std::string_view) or void(CopyRow const &)
+     * @tparam CB_SUCCESS Type of success callback function
+     * @param expr COPY ... TO STDOUT statement
+     * @param sink Callback receiving the exported data
+     * @param on_success Callback called once the export is complete
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_SINK, typename CB_SUCCESS>
+    Transaction &copy_out(std::string_view expr, CB_SINK &&sink, CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a prepared query over a named portal, in chunks
+     *
+     * The statement is bound once and rows are fetched @p fetch_size at a time.
+     * Each chunk is handed to @p on_chunk together with the Portal; while
+     * Portal::suspended() is true the caller must eventually call
+     * Portal::fetch() for the next chunk or Portal::close() to stop, either
+     * from the callback or later. The connection processes no other query
+     * until the portal is exhausted or closed.
+     *
+     * @tparam CB_CHUNK Type of chunk callback (Portal &, resultset)
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameters for the prepared query
+     * @param fetch_size Maximum number of rows per chunk (0 = all rows)
+     * @param on_chunk Callback called for each chunk of rows
+     * @param on_success Callback called once the portal is exhausted or closed
+     * @param on_error Callback called if query execution fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_CHUNK, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_portal(std::string_view query_name, QueryParams &&params,
+                                integer fetch_size, CB_CHUNK &&on_chunk,
+                                CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a prepared query over a named portal, in chunks
+     *
+     * @tparam CB_CHUNK Type of chunk callback (Portal &, resultset)
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameters for the prepared query
+     * @param fetch_size Maximum number of rows per chunk (0 = all rows)
+     * @param on_chunk Callback called for each chunk of rows
+     * @param on_success Callback called once the portal is exhausted or closed
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_CHUNK, typename CB_SUCCESS>
+    Transaction &execute_portal(std::string_view query_name, QueryParams &&params,
+                                integer fetch_size, CB_CHUNK &&on_chunk,
+                                CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a SQL query, streaming each row to a callback
+     *
+     * Rows are handed to @p on_row as soon as they arrive and are not kept,
+     * so memory stays bounded for results of any size. The row passed to the
+     * callback is only valid for the duration of the call.
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param expr SQL query to execute
+     * @param on_row Callback called for each row
+     * @param on_success Callback called once every row was delivered
+     * @param on_error Callback called if query execution fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_stream(std::string_view expr, CB_ROW &&on_row,
+                                CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a SQL query, streaming each row to a callback
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @param expr SQL query to execute
+     * @param on_row Callback called for each row
+     * @param on_success Callback called once every row was delivered
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS>
+    Transaction &execute_stream(std::string_view expr, CB_ROW &&on_row,
+                                CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a prepared query, streaming each row to a callback
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameters for the prepared query
+     * @param on_row Callback called for each row
+     * @param on_success Callback called once every row was delivered
+     * @param on_error Callback called if query execution fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_stream(std::string_view query_name, QueryParams &&params,
+                                CB_ROW &&on_row, CB_SUCCESS &&on_success,
+                                CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a prepared query, streaming each row to a callback
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameters for the prepared query
+     * @param on_row Callback called for each row
+     * @param on_success Callback called once every row was delivered
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS>
+    Transaction &execute_stream(std::string_view query_name, QueryParams &&params,
+                                CB_ROW &&on_row, CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a SQL query, streaming large columns to a sink
+     *
+     * The values of the columns designated by @p fields are forwarded in
+     * chunks to its sink as their bytes arrive, without buffering the whole
+     * DataRow message; the other columns reach @p on_row as usual.
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param expr SQL query to execute
+     * @param fields Streamed columns and their sink
+     * @param on_row Callback called for each row, after its streamed values
+     * @param on_success Callback called once every row was delivered
+     * @param on_error Callback called if query execution or the sink fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_stream(std::string_view expr, FieldStream fields, CB_ROW &&on_row,
+                                CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a SQL query, streaming large columns to a sink
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @param expr SQL query to execute
+     * @param fields Streamed columns and their sink
+     * @param on_row Callback called for each row, after its streamed values
+     * @param on_success Callback called once every row was delivered
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS>
+    Transaction &execute_stream(std::string_view expr, FieldStream fields, CB_ROW &&on_row,
+                                CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Executes a prepared query, streaming large columns to a sink
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @tparam CB_ERROR Type of error callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameters for the prepared query
+     * @param fields Streamed columns and their sink
+     * @param on_row Callback called for each row, after its streamed values
+     * @param on_success Callback called once every row was delivered
+     * @param on_error Callback called if query execution or the sink fails
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+    Transaction &execute_stream(std::string_view query_name, QueryParams &&params,
+                                FieldStream fields, CB_ROW &&on_row,
+                                CB_SUCCESS &&on_success, CB_ERROR &&on_error);
+
+    /**
+     * @brief Executes a prepared query, streaming large columns to a sink
+     *
+     * @tparam CB_ROW Type of row callback function, invoked with a resultset::row
+     * @tparam CB_SUCCESS Type of completion callback function
+     * @param query_name Name of the prepared query to execute
+     * @param params Parameters for the prepared query
+     * @param fields Streamed columns and their sink
+     * @param on_row Callback called for each row, after its streamed values
+     * @param on_success Callback called once every row was delivered
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename CB_ROW, typename CB_SUCCESS>
+    Transaction &execute_stream(std::string_view query_name, QueryParams &&params,
+                                FieldStream fields, CB_ROW &&on_row,
+                                CB_SUCCESS &&on_success);
+
+    /**
+     * @brief Sets the result column formats of a prepared query
+     *
+     * Takes effect for every execution of the statement sent after this call.
+     * It can be set before the statement is prepared, and is applied again
+     * whenever a statement with this name is prepared.
+     *
+     * @param query_name Name of the prepared query
+     * @param format Requested result formats (text, binary, automatic or per column)
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &result_format(std::string_view query_name, ResultFormat format);
+
+    /**
+     * @brief Reuses the storage of the results of a prepared query
+     *
+     * Executions with a result callback then take an emptied result of the
+     * statement, keeping its capacity and row description, instead of
+     * allocating a new one; each result is given back once the next
+     * result of the connection replaces it. It can be set before the
+     * statement is prepared.
+     *
+     * @param query_name Name of the prepared query
+     * @param capacity Maximum number of results kept, 0 to stop recycling
+     * @param max_bytes Results holding more rows data are freed instead
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &recycle_results(std::string_view query_name, std::size_t capacity = 2,
+                                 std::size_t max_bytes = 1 << 20);
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+    /**
+     * @brief Queues a query awaited from a coroutine
+     *
+     * The query is sent at once; co_await on the returned awaiter suspends
+     * the coroutine until it completes and yields its rows or its error. A
+     * failure does not fail this transaction. See coroutine.h.
+     *
+     * @param expr SQL expression to execute
+     * @return QueryAwaiter Awaiter of the query, to keep until awaited
+     */
+    [[nodiscard]] QueryAwaiter async_execute(std::string_view expr);
+
+    /**
+     * @brief Queues the execution of a prepared query awaited from a coroutine
+     *
+     * @param query_name Name of the prepared query
+     * @param params Parameter values for the query
+     * @return QueryAwaiter Awaiter of the query, to keep until awaited
+     */
+    [[nodiscard]] QueryAwaiter async_execute(std::string_view query_name,
+                                             QueryParams     &&params);
+
+    /**
+     * @brief Queues the preparation of a statement awaited from a coroutine
+     *
+     * @param query_name Name to assign to the prepared statement
+     * @param expr SQL expression with parameter placeholders
+     * @param types Sequence of PostgreSQL OIDs for parameter types
+     * @return QueryAwaiter Awaiter of the preparation, yielding no rows
+     */
+    [[nodiscard]] QueryAwaiter async_prepare(std::string_view query_name,
+                                             std::string_view expr,
+                                             type_oid_sequence &&types = {});
+#endif
+
     /**
      * @brief Executes a SQL query from a file
      *
@@ -517,6 +1461,138 @@ public:
     template <typename CB_ERROR>
     Transaction &error(CB_ERROR &&on_error);
 
+    /**
+     * @brief Sets the time budget of the transaction
+     *
+     * The budget starts with the first query of the transaction sent after
+     * this call and covers every query queued on it and its sub-transactions.
+     * Once it expires, the query in flight is cancelled on the server and
+     * fails with error::query_timeout, which fails the transaction. Has no
+     * effect on the connection itself, see Database::query_timeout().
+     *
+     * @param budget Time budget, 0 for none
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &timeout(std::chrono::milliseconds budget) noexcept;
+
+    /**
+     * @brief Gets the expiry of the time budget, starting it if needed
+     *
+     * @return std::chrono::steady_clock::time_point Deadline of the
+     * transaction, time_point::max() if it has no budget
+     */
+    [[nodiscard]] std::chrono::steady_clock::time_point deadline() noexcept;
+
+    /**
+     * @brief Sets the scheduling class of a queued root transaction
+     *
+     * @param lane Scheduling class
+     * @param queued_at Time the transaction was queued
+     */
+    void
+    lane(priority lane, std::chrono::steady_clock::time_point queued_at) noexcept {
+        _lane      = lane;
+        _queued_at = queued_at;
+    }
+
+    /**
+     * @brief Gets the scheduling class of the transaction, after aging
+     *
+     * @param now Current time
+     * @param aging Waiting time promoting the transaction one class, 0 for none
+     * @return priority Scheduling class, critical if it was queued without one
+     */
+    [[nodiscard]] priority
+    lane(std::chrono::steady_clock::time_point now,
+         std::chrono::milliseconds aging) const noexcept {
+        if (_queued_at == std::chrono::steady_clock::time_point{})
+            return priority::critical;
+        auto level = static_cast<long long>(_lane);
+        if (aging.count() > 0)
+            level -= (now - _queued_at) / aging;
+        return level > 0 ? static_cast<priority>(level) : priority::critical;
+    }
+
+    /**
+     * @brief Sets the result limits of the transaction
+     *
+     * Takes effect for the queries that start receiving rows after this
+     * call, see ResultLimits.
+     *
+     * @param limits Row and memory limits, and optional overflow callback
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &result_limits(ResultLimits limits);
+
+    /**
+     * @brief Gets the limits applying to the queries of the transaction
+     *
+     * @return ResultLimits Tightest limits of this transaction and its
+     * parents, with the overflow callback of the innermost one that has one
+     */
+    [[nodiscard]] ResultLimits result_limits() const;
+
+    /**
+     * @brief Sets the memory resource of the rows of the queries queued afterwards
+     *
+     * Sub-transactions and queries take the resource of this transaction
+     * when they are queued, and allocate their result sets from it; set on
+     * the database it covers the whole connection. Rows allocated from
+     * another resource than the one of the enclosing transaction are only
+     * handed to the callbacks of their query: they are neither kept as
+     * results() of the enclosing transaction nor, unless they come from the
+     * resource of the connection, recycled or cached by prepared statements.
+     * Rows decoded on workers by execute_offload() stay on the default
+     * resource, since the workers release them.
+     *
+     * The resource must outlive the rows allocated from it, including the
+     * last results this transaction keeps until its next query.
+     *
+     * @param resource Memory resource, nullptr for the default one
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    Transaction &memory_resource(std::pmr::memory_resource *resource) noexcept;
+
+    /**
+     * @brief Gets the memory resource of the rows of the queries queued now
+     *
+     * @return std::pmr::memory_resource* Resource, never null
+     */
+    [[nodiscard]] std::pmr::memory_resource *memory_resource() const noexcept;
+
+    /**
+     * @brief Queues work allocating its rows from a memory resource
+     *
+     * The queries and sub-transactions queued by @p queue allocate their
+     * result sets from @p resource, see memory_resource(). The resource of
+     * this transaction is restored afterwards.
+     *
+     * @code
+     * std::pmr::monotonic_buffer_resource arena;
+     * db.with_memory_resource(&arena, [](qb::pg::Transaction &t) {
+     *     t.execute("SELECT * FROM orders", on_orders);
+     * });
+     * @endcode
+     *
+     * @tparam Func Type of the work, void(Transaction &)
+     * @param resource Memory resource, nullptr for the default one
+     * @param queue Work queueing commands on this transaction
+     * @return Transaction& Reference to this transaction for chaining
+     */
+    template <typename Func>
+    Transaction &
+    with_memory_resource(std::pmr::memory_resource *resource, Func &&queue) {
+        const auto prev = std::exchange(_memory, resource);
+        try {
+            queue(*this);
+        } catch (...) {
+            _memory = prev;
+            throw;
+        }
+        _memory = prev;
+        return *this;
+    }
+
     /**
      * @brief Checks if the transaction has an error
      *
@@ -585,6 +1661,47 @@ public:
     status await();
 };
 
+/**
+ * @brief Prepared query fetched in chunks over a named portal
+ *
+ * Passed to the chunk callback of Transaction::execute_portal(). While the
+ * portal is suspended, the caller decides when the next chunk is requested,
+ * which gives natural backpressure to slow consumers.
+ */
+class Portal : public Transaction {
+protected:
+    bool _suspended{false}; ///< Server is waiting for fetch() or close()
+
+    /**
+     * @brief Constructs a portal command
+     *
+     * @param parent Pointer to the parent transaction
+     */
+    explicit Portal(Transaction *parent) noexcept;
+
+public:
+    /**
+     * @brief Checks if more rows can be fetched
+     *
+     * @return bool True if the portal is suspended with rows left
+     */
+    [[nodiscard]] bool suspended() const;
+
+    /**
+     * @brief Requests the next chunk of rows
+     *
+     * Does nothing if the portal is not suspended.
+     */
+    void fetch();
+
+    /**
+     * @brief Closes the portal without fetching the remaining rows
+     *
+     * Does nothing if the portal is not suspended.
+     */
+    void close();
+};
+
 } // namespace qb::pg::detail
 
 namespace qb::pg {
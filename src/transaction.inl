@@ -67,6 +67,9 @@ Transaction &
 Transaction::begin(CB_SUCCESS &&on_success, CB_ERROR &&on_error, transaction_mode mode) {
     if (_parent) {
         on_error((error::db_error) error::query_error("already in transaction"));
+    } else if (auto policy = retry_policy()) {
+        return begin(std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error),
+                     mode, *policy);
     } else {
         auto end = new End<CB_ERROR>(this, std::forward<CB_ERROR>(on_error));
         push_transaction(std::unique_ptr<Transaction>(new Begin<CB_SUCCESS, CB_ERROR>(
@@ -76,6 +79,36 @@ Transaction::begin(CB_SUCCESS &&on_success, CB_ERROR &&on_error, transaction_mod
     return *this;
 }
 
+/**
+ * @brief Begins a new transaction replayed on transient errors
+ *
+ * The callbacks are moved into a RetryBlock shared by the commands of every
+ * attempt, which queues the next attempt after a backoff when the block
+ * fails on an error retried by the policy.
+ *
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param on_success Callback queueing the statements of the block
+ * @param on_error Callback invoked once the block failed for good
+ * @param mode Transaction isolation mode
+ * @param policy Retry policy of the block
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::begin(CB_SUCCESS &&on_success, CB_ERROR &&on_error, transaction_mode mode,
+                   RetryPolicy policy) {
+    if (_parent) {
+        on_error((error::db_error) error::query_error("already in transaction"));
+    } else {
+        std::make_shared<RetryBlock<std::decay_t<CB_SUCCESS>, std::decay_t<CB_ERROR>>>(
+            *this, std::move(policy), mode, std::forward<CB_SUCCESS>(on_success),
+            std::forward<CB_ERROR>(on_error))
+            ->start();
+    }
+    return *this;
+}
+
 /**
  * @brief Begins a new transaction with only success callback
  *
@@ -212,6 +245,8 @@ Transaction::prepare(std::string_view query_name, std::string_view expr,
     PreparedQuery query{
         std::string(query_name), std::string(expr), std::move(types), {}};
 
+    // Reserve the slot now so handles can be taken before the Parse completes
+    _query_storage.reserve(query_name);
     push_transaction(std::unique_ptr<Transaction>(new Prepare<CB_SUCCESS, CB_ERROR>(
         this, std::move(query), std::forward<CB_SUCCESS>(on_success),
         std::forward<CB_ERROR>(on_error))));
@@ -259,16 +294,101 @@ template <typename CB_SUCCESS, typename CB_ERROR, typename>
 Transaction &
 Transaction::execute(std::string_view query_name, QueryParams &&params,
                      CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
+    return execute_prepared(PreparedRef(std::string(query_name)), std::move(params),
+                            std::forward<CB_SUCCESS>(on_success),
+                            std::forward<CB_ERROR>(on_error));
+}
+
+/**
+ * @brief Executes a prepared statement by handle with parameters and callbacks
+ *
+ * Same as the by-name overload, without the name lookup.
+ *
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @tparam Dummy SFINAE enabler (not used in implementation)
+ * @param statement Handle obtained from statement()
+ * @param params Parameters to bind to the prepared statement
+ * @param on_success Callback invoked when execution succeeds
+ * @param on_error Callback invoked if execution fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SUCCESS, typename CB_ERROR, typename>
+Transaction &
+Transaction::execute(PreparedHandle statement, QueryParams &&params,
+                     CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
+    return execute_prepared(PreparedRef(statement), std::move(params),
+                            std::forward<CB_SUCCESS>(on_success),
+                            std::forward<CB_ERROR>(on_error));
+}
+
+/**
+ * @brief Executes a prepared statement by handle with only success callback
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam Dummy SFINAE enabler (not used in implementation)
+ * @param statement Handle obtained from statement()
+ * @param params Parameters to bind to the prepared statement
+ * @param on_success Callback invoked when execution succeeds
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SUCCESS, typename>
+Transaction &
+Transaction::execute(PreparedHandle statement, QueryParams &&params,
+                     CB_SUCCESS &&on_success) {
+    return execute(statement, std::move(params), std::forward<CB_SUCCESS>(on_success),
+                   [](error::db_error const &) {});
+}
+
+/**
+ * @brief Queues the execution of a prepared statement
+ *
+ * Automatically detects callback signature to determine if result data
+ * should be returned.
+ *
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param statement Prepared statement, by name or handle
+ * @param params Parameters to bind to the prepared statement
+ * @param on_success Callback invoked when execution succeeds
+ * @param on_error Callback invoked if execution fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_prepared(PreparedRef &&statement, QueryParams &&params,
+                              CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
     if constexpr (std::is_invocable_v<CB_SUCCESS, Transaction &, resultset>) {
-        push_transaction(std::unique_ptr<Transaction>(
-            new QueryPrepared<CB_SUCCESS, CB_ERROR>(this, std::string(query_name),
-                                                    std::move(params),
-                                                    std::forward<CB_SUCCESS>(on_success),
-                                                    std::forward<CB_ERROR>(on_error))));
+        std::unique_ptr<CacheFill> fill;
+        if (auto *cache = result_cache()) {
+            auto name = statement.name();
+            if (name.empty()) {
+                const auto handle = statement.resolve(_query_storage);
+                if (_query_storage.has(handle))
+                    name = _query_storage.get(handle).name;
+            }
+            // External values are neither copied nor hashed into a key
+            if (!params.has_external() && cache->caches(name)) {
+                if (auto hit = cache->find(name, params)) {
+                    // Served without I/O, in queue order
+                    push_transaction(std::unique_ptr<Transaction>(
+                        new CacheHit<CB_SUCCESS, CB_ERROR>(
+                            this, std::move(hit), std::forward<CB_SUCCESS>(on_success),
+                            std::forward<CB_ERROR>(on_error))));
+                    return *this;
+                }
+                fill.reset(new CacheFill{cache, std::string(name), params});
+            }
+        }
+        push_transaction(std::unique_ptr<Transaction>(new QueryPrepared<CB_SUCCESS, CB_ERROR>(
+            this, std::move(statement), std::move(params), std::forward<CB_SUCCESS>(on_success),
+            std::forward<CB_ERROR>(on_error), std::move(fill))));
     } else if constexpr (std::is_invocable_v<CB_SUCCESS, Transaction &>) {
         push_transaction(
             std::unique_ptr<Transaction>(new ExecutePrepared<CB_SUCCESS, CB_ERROR>(
-                this, std::string(query_name), std::move(params),
+                this, std::move(statement), std::move(params),
                 std::forward<CB_SUCCESS>(on_success),
                 std::forward<CB_ERROR>(on_error))));
     } else
@@ -297,6 +417,126 @@ Transaction::execute(std::string_view query_name, QueryParams &&params,
                    [](error::db_error const &) {});
 }
 
+/**
+ * @brief Prepares a statement typed at compile time
+ *
+ * @tparam Ret Type of the rows of the statement
+ * @tparam Args Types of the parameters of the statement
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param statement Statement definition
+ * @param on_success Callback invoked when preparation succeeds
+ * @param on_error Callback invoked if preparation fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename Ret, typename... Args, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::prepare(TypedStatement<Ret(Args...)> const &statement, CB_SUCCESS &&on_success,
+                     CB_ERROR &&on_error) {
+    return prepare(statement.name(), statement.expression(), statement.types(),
+                   std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error));
+}
+
+template <typename Ret, typename... Args>
+Transaction &
+Transaction::prepare(TypedStatement<Ret(Args...)> const &statement) {
+    return prepare(
+        statement, [](Transaction &, PreparedQuery const &) {},
+        [](error::db_error const &) {});
+}
+
+/**
+ * @brief Executes a typed statement with its bound arguments
+ *
+ * The rows are decoded into Ret before the success callback, with decoders
+ * resolved once for the whole result.
+ *
+ * @tparam Ret Type of the rows of the statement
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param statement Execution returned by the statement call operator
+ * @param on_success Callback receiving the decoded rows
+ * @param on_error Callback invoked if execution fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename Ret, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute(BoundStatement<Ret> &&statement, CB_SUCCESS &&on_success,
+                     CB_ERROR &&on_error) {
+    if constexpr (std::is_void_v<Ret>) {
+        // Without rows to decode, the result is not collected
+        return execute(statement.name(), std::move(statement.params()),
+                       std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error));
+    } else {
+        return execute(statement.name(), std::move(statement.params()),
+                       [on_success = std::forward<CB_SUCCESS>(on_success)](
+                           Transaction &tr, resultset result) mutable {
+                           on_success(tr, decode_rows<Ret>(result));
+                       },
+                       std::forward<CB_ERROR>(on_error));
+    }
+}
+
+template <typename Ret, typename CB_SUCCESS>
+Transaction &
+Transaction::execute(BoundStatement<Ret> &&statement, CB_SUCCESS &&on_success) {
+    return execute(std::move(statement), std::forward<CB_SUCCESS>(on_success),
+                   [](error::db_error const &) {});
+}
+
+template <typename Ret>
+Transaction &
+Transaction::execute(BoundStatement<Ret> &&statement) {
+    return execute(std::string_view(statement.name()), std::move(statement.params()));
+}
+
+/**
+ * @brief Executes a prepared statement whose rows are decoded on worker threads
+ *
+ * @tparam Row Type of the decoded rows
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameters to bind to the prepared statement
+ * @param offload Executor and ranges of the decoding
+ * @param on_success Callback receiving the decoded rows
+ * @param on_error Callback invoked if the execution or the decoding fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename Row, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_offload(std::string_view query_name, QueryParams &&params,
+                             ResultOffload const &offload, CB_SUCCESS &&on_success,
+                             CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_SUCCESS, Transaction &, std::vector<Row>>,
+                  "execute_offload callback requires -> [](qb::pg::transaction &tr, "
+                  "std::vector<Row> rows)");
+    static_assert(std::is_default_constructible_v<Row>,
+                  "offloaded rows are decoded into default-constructed slots");
+    push_transaction(std::unique_ptr<Transaction>(new OffloadPrepared<Row, CB_SUCCESS, CB_ERROR>(
+        this, PreparedRef(std::string(query_name)), std::move(params), offload,
+        std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+template <typename Ret, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_offload(BoundStatement<Ret> &&statement, ResultOffload const &offload,
+                             CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
+    static_assert(!std::is_void_v<Ret>, "execute_offload requires a statement returning rows");
+    return execute_offload<Ret>(statement.name(), std::move(statement.params()), offload,
+                                std::forward<CB_SUCCESS>(on_success),
+                                std::forward<CB_ERROR>(on_error));
+}
+
+template <typename Ret, typename CB_SUCCESS>
+Transaction &
+Transaction::execute_offload(BoundStatement<Ret> &&statement, ResultOffload const &offload,
+                             CB_SUCCESS &&on_success) {
+    return execute_offload(std::move(statement), offload, std::forward<CB_SUCCESS>(on_success),
+                           [](error::db_error const &) {});
+}
+
 /**
  * @brief Executes a prepared statement with parameters in different order
  *
@@ -317,6 +557,451 @@ Transaction::execute(std::string_view query_name, CB_SUCCESS &&on_success,
                    [](error::db_error const &) {});
 }
 
+/**
+ * @brief Executes a SQL query, streaming each row to a callback
+ *
+ * Each row is decoded and handed to the row callback as soon as it arrives,
+ * then dropped. The completion callback runs once every row was delivered.
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param expr SQL expression to execute
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @param on_error Callback invoked if the query or a row callback fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_stream(std::string_view expr, CB_ROW &&on_row,
+                            CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_ROW, resultset::row>,
+                  "execute_stream row callback requires -> [](qb::pg::row row)");
+    push_transaction(std::unique_ptr<Transaction>(
+        new StreamQuery<CB_ROW, CB_SUCCESS, CB_ERROR>(
+            this, std::string(expr), std::forward<CB_ROW>(on_row),
+            std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+/**
+ * @brief Executes a SQL query, streaming each row to a callback
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @param expr SQL expression to execute
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS>
+Transaction &
+Transaction::execute_stream(std::string_view expr, CB_ROW &&on_row,
+                            CB_SUCCESS &&on_success) {
+    return execute_stream(expr, std::forward<CB_ROW>(on_row),
+                          std::forward<CB_SUCCESS>(on_success),
+                          [](error::db_error const &) {});
+}
+
+/**
+ * @brief Executes a prepared statement, streaming each row to a callback
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameters to bind to the prepared statement
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @param on_error Callback invoked if the query or a row callback fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_stream(std::string_view query_name, QueryParams &&params,
+                            CB_ROW &&on_row, CB_SUCCESS &&on_success,
+                            CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_ROW, resultset::row>,
+                  "execute_stream row callback requires -> [](qb::pg::row row)");
+    push_transaction(std::unique_ptr<Transaction>(
+        new StreamQuery<CB_ROW, CB_SUCCESS, CB_ERROR>(
+            this, std::string(query_name), std::move(params),
+            std::forward<CB_ROW>(on_row), std::forward<CB_SUCCESS>(on_success),
+            std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+/**
+ * @brief Executes a prepared statement, streaming each row to a callback
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameters to bind to the prepared statement
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS>
+Transaction &
+Transaction::execute_stream(std::string_view query_name, QueryParams &&params,
+                            CB_ROW &&on_row, CB_SUCCESS &&on_success) {
+    return execute_stream(query_name, std::move(params), std::forward<CB_ROW>(on_row),
+                          std::forward<CB_SUCCESS>(on_success),
+                          [](error::db_error const &) {});
+}
+
+/**
+ * @brief Executes a SQL query, streaming large columns to a sink
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param expr SQL expression to execute
+ * @param fields Streamed columns and their sink
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @param on_error Callback invoked if the query, a row callback or the sink fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_stream(std::string_view expr, FieldStream fields, CB_ROW &&on_row,
+                            CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_ROW, resultset::row>,
+                  "execute_stream row callback requires -> [](qb::pg::row row)");
+    push_transaction(std::unique_ptr<Transaction>(
+        new StreamQuery<CB_ROW, CB_SUCCESS, CB_ERROR>(
+            this, std::string(expr), std::forward<CB_ROW>(on_row),
+            std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error),
+            std::move(fields))));
+    return *this;
+}
+
+/**
+ * @brief Executes a SQL query, streaming large columns to a sink
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @param expr SQL expression to execute
+ * @param fields Streamed columns and their sink
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS>
+Transaction &
+Transaction::execute_stream(std::string_view expr, FieldStream fields, CB_ROW &&on_row,
+                            CB_SUCCESS &&on_success) {
+    return execute_stream(expr, std::move(fields), std::forward<CB_ROW>(on_row),
+                          std::forward<CB_SUCCESS>(on_success),
+                          [](error::db_error const &) {});
+}
+
+/**
+ * @brief Executes a prepared statement, streaming large columns to a sink
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameters to bind to the prepared statement
+ * @param fields Streamed columns and their sink
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @param on_error Callback invoked if the query, a row callback or the sink fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_stream(std::string_view query_name, QueryParams &&params,
+                            FieldStream fields, CB_ROW &&on_row, CB_SUCCESS &&on_success,
+                            CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_ROW, resultset::row>,
+                  "execute_stream row callback requires -> [](qb::pg::row row)");
+    push_transaction(std::unique_ptr<Transaction>(
+        new StreamQuery<CB_ROW, CB_SUCCESS, CB_ERROR>(
+            this, std::string(query_name), std::move(params),
+            std::forward<CB_ROW>(on_row), std::forward<CB_SUCCESS>(on_success),
+            std::forward<CB_ERROR>(on_error), std::move(fields))));
+    return *this;
+}
+
+/**
+ * @brief Executes a prepared statement, streaming large columns to a sink
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_ROW Type of row callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameters to bind to the prepared statement
+ * @param fields Streamed columns and their sink
+ * @param on_row Callback invoked for each row
+ * @param on_success Callback invoked when the query completes
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_ROW, typename CB_SUCCESS>
+Transaction &
+Transaction::execute_stream(std::string_view query_name, QueryParams &&params,
+                            FieldStream fields, CB_ROW &&on_row, CB_SUCCESS &&on_success) {
+    return execute_stream(query_name, std::move(params), std::move(fields),
+                          std::forward<CB_ROW>(on_row), std::forward<CB_SUCCESS>(on_success),
+                          [](error::db_error const &) {});
+}
+
+/**
+ * @brief Executes a prepared statement once per parameter set
+ *
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameter sets, one per execution
+ * @param on_success Callback invoked once the whole batch succeeded
+ * @param on_error Callback invoked if the batch fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_batch(std::string_view query_name,
+                           std::vector<QueryParams> &&params, CB_SUCCESS &&on_success,
+                           CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_SUCCESS, Transaction &, std::size_t> ||
+                      std::is_invocable_v<CB_SUCCESS, Transaction &>,
+                  "execute_batch success callback requires -> [](qb::pg::transaction "
+                  "&tr, (optional) std::size_t affected_rows)");
+    push_transaction(std::unique_ptr<Transaction>(new ExecuteBatch<CB_SUCCESS, CB_ERROR>(
+        this, std::string(query_name), std::move(params),
+        std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+/**
+ * @brief Executes a prepared statement once per parameter set
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_SUCCESS Type of success callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameter sets, one per execution
+ * @param on_success Callback invoked once the whole batch succeeded
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SUCCESS>
+Transaction &
+Transaction::execute_batch(std::string_view query_name,
+                           std::vector<QueryParams> &&params, CB_SUCCESS &&on_success) {
+    return execute_batch(query_name, std::move(params),
+                         std::forward<CB_SUCCESS>(on_success),
+                         [](error::db_error const &) {});
+}
+
+/**
+ * @brief Executes a transaction block in a single round trip
+ *
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param block Statements of the block
+ * @param on_success Callback invoked once the block is committed
+ * @param on_error Callback invoked once the block is rolled back
+ * @param mode Transaction isolation mode
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::atomic(AtomicBlock &&block, CB_SUCCESS &&on_success, CB_ERROR &&on_error,
+                    transaction_mode mode) {
+    static_assert(std::is_invocable_v<CB_SUCCESS, Transaction &, std::size_t> ||
+                      std::is_invocable_v<CB_SUCCESS, Transaction &>,
+                  "atomic success callback requires -> [](qb::pg::transaction "
+                  "&tr, (optional) std::size_t affected_rows)");
+    static_assert(std::is_invocable_v<CB_ERROR, error::db_error const &, std::size_t> ||
+                      std::is_invocable_v<CB_ERROR, error::db_error const &>,
+                  "atomic error callback requires -> [](qb::pg::error::db_error const "
+                  "&err, (optional) std::size_t step)");
+    if (_parent) {
+        const auto err = (error::db_error) error::query_error("already in transaction");
+        if constexpr (std::is_invocable_v<CB_ERROR, error::db_error const &, std::size_t>)
+            on_error(err, AtomicBlock::npos);
+        else
+            on_error(err);
+        return *this;
+    }
+    push_transaction(std::unique_ptr<Transaction>(new ExecuteAtomic<CB_SUCCESS, CB_ERROR>(
+        this, std::move(block), mode, std::forward<CB_SUCCESS>(on_success),
+        std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+template <typename CB_SUCCESS>
+Transaction &
+Transaction::atomic(AtomicBlock &&block, CB_SUCCESS &&on_success, transaction_mode mode) {
+    return atomic(
+        std::move(block), std::forward<CB_SUCCESS>(on_success),
+        [](error::db_error const &) {}, mode);
+}
+
+/**
+ * @brief Bulk loads data with COPY FROM STDIN
+ *
+ * @tparam CB_PRODUCER Type of producer function
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param expr COPY ... FROM STDIN statement
+ * @param producer Callback filling each chunk of data
+ * @param on_success Callback invoked once the data is committed
+ * @param on_error Callback invoked if the copy fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_PRODUCER, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::copy_in(std::string_view expr, CB_PRODUCER &&producer,
+                     CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_r_v<bool, CB_PRODUCER, CopyWriter &>,
+                  "copy_in producer requires -> [](qb::pg::copy_writer &out) -> bool");
+    static_assert(std::is_invocable_v<CB_SUCCESS, Transaction &, std::size_t> ||
+                      std::is_invocable_v<CB_SUCCESS, Transaction &>,
+                  "copy_in success callback requires -> [](qb::pg::transaction &tr, "
+                  "(optional) std::size_t rows)");
+    push_transaction(std::unique_ptr<Transaction>(
+        new CopyIn<CB_PRODUCER, CB_SUCCESS, CB_ERROR>(
+            this, std::string(expr), std::forward<CB_PRODUCER>(producer),
+            std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+/**
+ * @brief Bulk loads data with COPY FROM STDIN
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_PRODUCER Type of producer function
+ * @tparam CB_SUCCESS Type of success callback function
+ * @param expr COPY ... FROM STDIN statement
+ * @param producer Callback filling each chunk of data
+ * @param on_success Callback invoked once the data is committed
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_PRODUCER, typename CB_SUCCESS>
+Transaction &
+Transaction::copy_in(std::string_view expr, CB_PRODUCER &&producer,
+                     CB_SUCCESS &&on_success) {
+    return copy_in(expr, std::forward<CB_PRODUCER>(producer),
+                   std::forward<CB_SUCCESS>(on_success), [](error::db_error const &) {});
+}
+
+/**
+ * @brief Exports data with COPY TO STDOUT
+ *
+ * @tparam CB_SINK Type of sink function
+ * @tparam CB_SUCCESS Type of success callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param expr COPY ... TO STDOUT statement
+ * @param sink Callback receiving the exported data
+ * @param on_success Callback invoked once the export is complete
+ * @param on_error Callback invoked if the export fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SINK, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::copy_out(std::string_view expr, CB_SINK &&sink, CB_SUCCESS &&on_success,
+                      CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_SINK, std::string_view> ||
+                      std::is_invocable_v<CB_SINK, CopyRow const &>,
+                  "copy_out sink requires -> [](std::string_view chunk) or "
+                  "[](qb::pg::copy_row const &row)");
+    static_assert(std::is_invocable_v<CB_SUCCESS, Transaction &, std::size_t> ||
+                      std::is_invocable_v<CB_SUCCESS, Transaction &>,
+                  "copy_out success callback requires -> [](qb::pg::transaction &tr, "
+                  "(optional) std::size_t rows)");
+    push_transaction(std::unique_ptr<Transaction>(
+        new CopyOut<CB_SINK, CB_SUCCESS, CB_ERROR>(
+            this, std::string(expr), std::forward<CB_SINK>(sink),
+            std::forward<CB_SUCCESS>(on_success), std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+/**
+ * @brief Exports data with COPY TO STDOUT
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_SINK Type of sink function
+ * @tparam CB_SUCCESS Type of success callback function
+ * @param expr COPY ... TO STDOUT statement
+ * @param sink Callback receiving the exported data
+ * @param on_success Callback invoked once the export is complete
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_SINK, typename CB_SUCCESS>
+Transaction &
+Transaction::copy_out(std::string_view expr, CB_SINK &&sink, CB_SUCCESS &&on_success) {
+    return copy_out(expr, std::forward<CB_SINK>(sink),
+                    std::forward<CB_SUCCESS>(on_success), [](error::db_error const &) {});
+}
+
+/**
+ * @brief Executes a prepared statement over a named portal, in chunks
+ *
+ * @tparam CB_CHUNK Type of chunk callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @tparam CB_ERROR Type of error callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameters to bind to the prepared statement
+ * @param fetch_size Maximum number of rows per chunk
+ * @param on_chunk Callback invoked for each chunk of rows
+ * @param on_success Callback invoked once the portal is released
+ * @param on_error Callback invoked if the query or a chunk callback fails
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_CHUNK, typename CB_SUCCESS, typename CB_ERROR>
+Transaction &
+Transaction::execute_portal(std::string_view query_name, QueryParams &&params,
+                            integer fetch_size, CB_CHUNK &&on_chunk,
+                            CB_SUCCESS &&on_success, CB_ERROR &&on_error) {
+    static_assert(std::is_invocable_v<CB_CHUNK, Portal &, resultset>,
+                  "execute_portal chunk callback requires -> [](qb::pg::portal &portal, "
+                  "qb::pg::results chunk)");
+    push_transaction(std::unique_ptr<Transaction>(
+        new FetchQuery<CB_CHUNK, CB_SUCCESS, CB_ERROR>(
+            this, std::string(query_name), std::move(params), fetch_size,
+            std::forward<CB_CHUNK>(on_chunk), std::forward<CB_SUCCESS>(on_success),
+            std::forward<CB_ERROR>(on_error))));
+    return *this;
+}
+
+/**
+ * @brief Executes a prepared statement over a named portal, in chunks
+ *
+ * Simplified version that uses an empty error callback.
+ *
+ * @tparam CB_CHUNK Type of chunk callback function
+ * @tparam CB_SUCCESS Type of completion callback function
+ * @param query_name Name of the prepared statement to execute
+ * @param params Parameters to bind to the prepared statement
+ * @param fetch_size Maximum number of rows per chunk
+ * @param on_chunk Callback invoked for each chunk of rows
+ * @param on_success Callback invoked once the portal is released
+ * @return Reference to this transaction for method chaining
+ */
+template <typename CB_CHUNK, typename CB_SUCCESS>
+Transaction &
+Transaction::execute_portal(std::string_view query_name, QueryParams &&params,
+                            integer fetch_size, CB_CHUNK &&on_chunk,
+                            CB_SUCCESS &&on_success) {
+    return execute_portal(query_name, std::move(params), fetch_size,
+                          std::forward<CB_CHUNK>(on_chunk),
+                          std::forward<CB_SUCCESS>(on_success),
+                          [](error::db_error const &) {});
+}
+
 /**
  * @brief Registers a callback to be executed upon successful operation
  *
@@ -52,7 +52,6 @@
 #include <optional>
 #include <qb/io.h>
 #include <qb/system/endian.h>
-#include <regex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -62,9 +61,12 @@
 #include <unordered_map>
 #include <vector>
 
+#include "./bytea_codec.h"
 #include "./common.h"
 #include "./param_unserializer.h"
 #include "./pg_types.h"
+#include "./text_codec.h"
+#include "./timestamp_codec.h"
 #include "./type_mapping.h"
 
 namespace qb::pg::detail {
@@ -86,8 +88,9 @@ namespace qb::pg::detail {
  * - Proper handling of network byte order and endianness
  *
  * @tparam T C++ type to convert to/from PostgreSQL formats
+ * @tparam Enable Optional SFINAE enabler for conditional specializations
  */
-template <typename T>
+template <typename T, typename Enable = void>
 class TypeConverter {
 public:
     using value_type = typename std::decay<T>::type;
@@ -195,28 +198,8 @@ public:
                              std::is_same_v<value_type, qb::LocalTimestamp>) {
             // PostgreSQL timestamp: length (8) + microseconds since 2000-01-01 00:00:00
             write_integer(buffer, 8);
-
-            // Convert timestamp to PostgreSQL format (microseconds since 2000-01-01)
-            // PostgreSQL epoch is 2000-01-01, Unix epoch is 1970-01-01
-            // Difference is 30 years = 946684800 seconds
-            constexpr int64_t POSTGRES_EPOCH_DIFF_SECONDS = 946684800;
-
-            // Get seconds since Unix epoch from the timestamp
-            double unix_seconds = value.seconds_float();
-
-            // Calculate the whole seconds and fractional part
-            int64_t whole_seconds = static_cast<int64_t>(unix_seconds);
-            double fractional_seconds = unix_seconds - whole_seconds;
-            int64_t microseconds = static_cast<int64_t>(fractional_seconds * 1000000);
-
-            // Convert to PostgreSQL timestamp (microseconds since 2000-01-01)
-            int64_t pg_timestamp =
-                (whole_seconds - POSTGRES_EPOCH_DIFF_SECONDS) * 1000000 + microseconds;
-
-            // Convert to network byte order using the endian utility
-            int64_t network_timestamp = qb::endian::to_big_endian(pg_timestamp);
-
-            // Copy the bytes to the buffer
+            const int64_t network_timestamp =
+                qb::endian::to_big_endian(TimestampCodec::to_pg(value));
             const byte *bytes = reinterpret_cast<const byte *>(&network_timestamp);
             buffer.insert(buffer.end(), bytes, bytes + sizeof(int64_t));
         } else if constexpr (detail::ParamUnserializer::is_optional<value_type>::value) {
@@ -269,34 +252,16 @@ public:
             return std::to_string(value);
         } else if constexpr (std::is_same_v<value_type, bytea> ||
                              std::is_same_v<value_type, std::vector<byte>>) {
-            std::string result = "\\x";
-            char        hex[3];
-
-            for (byte b : value) {
-                std::snprintf(hex, sizeof(hex), "%02x", static_cast<int>(b) & 0xFF);
-                result += hex;
-            }
-
-            return result;
+            // Hex format (\x...)
+            return ByteaCodec::to_text(value.data(), value.size());
         } else if constexpr (std::is_same_v<value_type, qb::uuid>) {
             // UUID to string in standard format: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
             return uuids::to_string(value);
         } else if constexpr (std::is_same_v<value_type, qb::Timestamp> ||
                              std::is_same_v<value_type, qb::UtcTimestamp> ||
                              std::is_same_v<value_type, qb::LocalTimestamp>) {
-            // Format: YYYY-MM-DD HH:MM:SS.MMMMMM
-            std::time_t timestamp = static_cast<std::time_t>(value.seconds());
-            std::tm    *tm_data   = std::gmtime(&timestamp);
-
-            std::ostringstream os;
-            os << std::setfill('0') << std::setw(4) << (tm_data->tm_year + 1900) << '-'
-               << std::setw(2) << (tm_data->tm_mon + 1) << '-' << std::setw(2)
-               << tm_data->tm_mday << ' ' << std::setw(2) << tm_data->tm_hour << ':'
-               << std::setw(2) << tm_data->tm_min << ':' << std::setw(2)
-               << tm_data->tm_sec << '.' << std::setw(6)
-               << (value.microseconds() % 1000000);
-
-            return os.str();
+            // Format: YYYY-MM-DD HH:MM:SS[.MMMMMM]
+            return TimestampCodec::to_text(value, false);
         } else if constexpr (detail::ParamUnserializer::is_optional<value_type>::value) {
             if (value.has_value()) {
                 return TypeConverter<typename value_type::value_type>::to_text(*value);
@@ -308,6 +273,17 @@ public:
         }
     }
 
+    /**
+     * @brief Converts an owned PostgreSQL binary buffer to a C++ type
+     *
+     * @param buffer Buffer containing the PostgreSQL binary format data
+     * @return value_type Deserialized C++ value
+     */
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
     /**
      * @brief Converts a PostgreSQL binary buffer to a C++ type
      *
@@ -324,7 +300,7 @@ public:
      * @throws std::runtime_error If the buffer contains invalid or malformed data
      */
     static value_type
-    from_binary(const std::vector<byte> &buffer) {
+    from_binary(std::string_view buffer) {
         static ParamUnserializer unserializer;
 
         if constexpr (std::is_same_v<value_type, std::string>) {
@@ -376,39 +352,7 @@ public:
         } else if constexpr (std::is_same_v<value_type, qb::Timestamp> ||
                              std::is_same_v<value_type, qb::UtcTimestamp> ||
                              std::is_same_v<value_type, qb::LocalTimestamp>) {
-            if (buffer.size() < 8) {
-                throw std::runtime_error("Buffer too small for timestamp");
-            }
-
-            // Difference between PostgreSQL epoch (2000-01-01) and Unix epoch
-            // (1970-01-01)
-            constexpr int64_t POSTGRES_EPOCH_DIFF = 946684800LL; // seconds
-
-            // Create a temporary variable to hold the timestamp
-            int64_t pg_usecs = 0;
-
-            // If buffer contains EXACTLY the timestamp (8 bytes), use it directly
-            if (buffer.size() == 8) {
-                std::memcpy(&pg_usecs, buffer.data(), 8);
-            } else {
-                // Otherwise, assume there's a 4-byte prefix
-                std::memcpy(&pg_usecs, buffer.data() + 4, 8);
-            }
-
-            // Convert big-endian to native order
-            pg_usecs = qb::endian::from_big_endian(pg_usecs);
-
-            // Convert to Unix seconds and microseconds
-            int64_t unix_secs  = (pg_usecs / 1000000) + POSTGRES_EPOCH_DIFF;
-            int64_t unix_usecs = pg_usecs % 1000000;
-
-            if (unix_usecs < 0) {
-                unix_secs--;
-                unix_usecs += 1000000;
-            }
-
-            return qb::Timestamp::from_seconds(unix_secs) +
-                   qb::Timespan::from_microseconds(unix_usecs);
+            return value_type(TimestampCodec::read_binary(buffer));
         } else if constexpr (detail::ParamUnserializer::is_optional<value_type>::value) {
             using inner_type = typename value_type::value_type;
 
@@ -438,109 +382,46 @@ public:
      * - UUID string parsing
      * - Proper numeric conversions with bounds checking
      *
+     * Numbers, booleans and UUIDs are parsed in place by TextCodec, without
+     * temporary strings.
+     *
      * @param text PostgreSQL text representation to convert
      * @return value_type Deserialized C++ value
      * @throws std::runtime_error If the text contains invalid or malformed data
+     * @throws std::invalid_argument If the text is not a number of the numeric type
      * @throws std::out_of_range If numeric values are outside the type's range
      */
     static value_type
-    from_text(const std::string &text) {
+    from_text(std::string_view text) {
         if constexpr (std::is_same_v<value_type, std::string>) {
-            return text;
+            return std::string(text);
         } else if constexpr (std::is_same_v<value_type, smallint>) {
-            return static_cast<smallint>(std::stoi(text));
+            return TextCodec::parse_integer<smallint>(text);
         } else if constexpr (std::is_same_v<value_type, integer>) {
-            return static_cast<integer>(std::stoi(text));
+            return TextCodec::parse_integer<integer>(text);
         } else if constexpr (std::is_same_v<value_type, bigint>) {
-            return static_cast<bigint>(std::stoll(text));
-        } else if constexpr (std::is_same_v<value_type, float>) {
-            // Special values
-            if (text == "NaN")
-                return std::numeric_limits<float>::quiet_NaN();
-            if (text == "Infinity" || text == "inf")
-                return std::numeric_limits<float>::infinity();
-            if (text == "-Infinity" || text == "-inf")
-                return -std::numeric_limits<float>::infinity();
-            return std::stof(text);
-        } else if constexpr (std::is_same_v<value_type, double>) {
-            // Special values
-            if (text == "NaN")
-                return std::numeric_limits<double>::quiet_NaN();
-            if (text == "Infinity" || text == "inf")
-                return std::numeric_limits<double>::infinity();
-            if (text == "-Infinity" || text == "-inf")
-                return -std::numeric_limits<double>::infinity();
-            return std::strtod(text.c_str(), nullptr);;
+            return TextCodec::parse_integer<bigint>(text);
+        } else if constexpr (std::is_same_v<value_type, float> ||
+                             std::is_same_v<value_type, double>) {
+            // Special values included: NaN, Infinity, -Infinity
+            return TextCodec::parse_float<value_type>(text);
         } else if constexpr (std::is_same_v<value_type, bool>) {
-            return (text == "t" || text == "true" || text == "1" || text == "yes" ||
-                    text == "y" || text == "on");
+            return TextCodec::parse_bool(text);
         } else if constexpr (std::is_same_v<value_type, bytea> ||
                              std::is_same_v<value_type, std::vector<byte>>) {
+            // Hexadecimal format (\x...) or escape format
             value_type result;
-
-            // Hexadecimal format (\x...)
-            if (text.length() >= 2 && text.substr(0, 2) == "\\x") {
-                std::string hex = text.substr(2);
-                for (size_t i = 0; i + 1 < hex.length(); i += 2) {
-                    byte byte_val =
-                        static_cast<byte>(std::stoi(hex.substr(i, 2), nullptr, 16));
-                    result.push_back(byte_val);
-                }
-            } else {
-                // Raw format
-                result.insert(result.end(), text.begin(), text.end());
-            }
-
+            ByteaCodec::from_text(text, result);
             return result;
         } else if constexpr (std::is_same_v<value_type, qb::uuid>) {
             // Parse UUID from standard format: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
-            return qb::uuid::from_string(text).value_or(qb::uuid{});
+            std::array<uint8_t, 16> uuid_bytes;
+            return TextCodec::to_uuid(text, uuid_bytes) ? qb::uuid(uuid_bytes) : qb::uuid{};
         } else if constexpr (std::is_same_v<value_type, qb::Timestamp> ||
                              std::is_same_v<value_type, qb::UtcTimestamp> ||
                              std::is_same_v<value_type, qb::LocalTimestamp>) {
             // Parse PostgreSQL timestamp format: YYYY-MM-DD HH:MM:SS[.MMMMMM]
-            std::tm tm   = {};
-            int     year, month, day, hour, minute, second, microsecond = 0;
-
-            // Regular expression to match PostgreSQL timestamp format
-            std::regex timestamp_regex(
-                R"((\d{4})-(\d{1,2})-(\d{1,2})\s+(\d{1,2}):(\d{1,2}):(\d{1,2})(?:\.(\d{1,6}))?)");
-
-            std::smatch matches;
-            if (std::regex_match(text, matches, timestamp_regex)) {
-                year   = std::stoi(matches[1]);
-                month  = std::stoi(matches[2]);
-                day    = std::stoi(matches[3]);
-                hour   = std::stoi(matches[4]);
-                minute = std::stoi(matches[5]);
-                second = std::stoi(matches[6]);
-
-                // Parse microseconds if present
-                if (matches.size() > 7 && matches[7].matched) {
-                    // Pad with zeros if less than 6 digits
-                    std::string micro_str = matches[7].str();
-                    micro_str.append(6 - micro_str.length(), '0');
-                    microsecond = std::stoi(micro_str);
-                }
-
-                // Set tm structure
-                tm.tm_year  = year - 1900; // Years since 1900
-                tm.tm_mon   = month - 1;   // Months since January (0-11)
-                tm.tm_mday  = day;         // Day of month (1-31)
-                tm.tm_hour  = hour;        // Hours (0-23)
-                tm.tm_min   = minute;      // Minutes (0-59)
-                tm.tm_sec   = second;      // Seconds (0-61)
-                tm.tm_isdst = -1;          // Let system determine DST
-
-                // Convert to Unix timestamp
-                std::time_t unix_timestamp = std::mktime(&tm);
-
-                // Create timestamp from seconds and microseconds
-                return value_type(qb::Timestamp::from_seconds(unix_timestamp) +
-                                  qb::Timespan::from_microseconds(microsecond));
-            }
-
-            throw std::runtime_error("Invalid timestamp format");
+            return value_type(TimestampCodec::parse(text));
         } else if constexpr (detail::ParamUnserializer::is_optional<value_type>::value) {
             using inner_type = typename value_type::value_type;
 
@@ -637,6 +518,17 @@ struct TypeConverter<qb::uuid> {
         return uuids::to_string(value);
     }
 
+    /**
+     * @brief Converts an owned PostgreSQL binary buffer to a C++ type
+     *
+     * @param buffer Buffer containing the PostgreSQL binary format data
+     * @return value_type Deserialized C++ value
+     */
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
     /**
      * @brief Converts PostgreSQL binary format to a UUID
      *
@@ -651,9 +543,9 @@ struct TypeConverter<qb::uuid> {
      * @throws std::runtime_error If the buffer is too small or malformed
      */
     static qb::uuid
-    from_binary(const std::vector<byte> &buffer) {
-        // Check buffer size with length prefix
-        if (buffer.size() < 4 + 16) { // 4 bytes length + 16 bytes UUID
+    from_binary(std::string_view buffer) {
+        // Either the raw 16 bytes or 4 bytes length + 16 bytes UUID
+        if (buffer.size() != 16 && buffer.size() < 4 + 16) {
             throw std::runtime_error("Buffer too small for UUID");
         }
 
@@ -687,13 +579,13 @@ struct TypeConverter<qb::uuid> {
      * @throws std::runtime_error If the text is not a valid UUID format
      */
     static qb::uuid
-    from_text(const std::string &text) {
+    from_text(std::string_view text) {
         // Expected format: "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"
-        auto uuid_result = qb::uuid::from_string(text);
-        if (!uuid_result) {
+        std::array<uint8_t, 16> uuid_bytes;
+        if (!TextCodec::to_uuid(text, uuid_bytes)) {
             throw std::runtime_error("Invalid UUID format");
         }
-        return uuid_result.value();
+        return qb::uuid(uuid_bytes);
     }
 };
 
@@ -725,11 +617,6 @@ struct TypeConverter<qb::Timestamp> {
      */
     static void
     to_binary(const qb::Timestamp &value, std::vector<byte> &buffer) {
-        // PostgreSQL binary format consists of:
-        // - 4-byte length prefix
-        // - 8-byte timestamp (microseconds since 2000-01-01)
-
-        // Resize buffer to hold length prefix and timestamp data
         buffer.resize(4 + 8);
 
         // Write length (8) in big-endian format
@@ -738,57 +625,33 @@ struct TypeConverter<qb::Timestamp> {
         buffer[2] = 0;
         buffer[3] = 8;
 
-        // Difference between PostgreSQL epoch (2000-01-01) and Unix epoch (1970-01-01)
-        constexpr int64_t POSTGRES_EPOCH_DIFF = 946684800LL; // seconds
-
-        // Convert Unix timestamp to PostgreSQL timestamp using float for higher precision
-        double unix_secs_float = value.seconds_float();
-        int64_t whole_seconds = static_cast<int64_t>(unix_secs_float);
-        double fractional_part = unix_secs_float - whole_seconds;
-        int64_t unix_usecs = static_cast<int64_t>(fractional_part * 1000000LL);
-        
-        int64_t pg_usecs = (whole_seconds - POSTGRES_EPOCH_DIFF) * 1000000LL + unix_usecs;
-
-        // Convert to network byte order (big-endian) using the endian utility
-        int64_t network_usecs = qb::endian::to_big_endian(pg_usecs);
-
-        // Write timestamp data after length prefix
-        const byte *bytes = reinterpret_cast<const byte *>(&network_usecs);
-        std::memcpy(buffer.data() + 4, bytes, sizeof(int64_t));
+        const int64_t network_usecs = qb::endian::to_big_endian(TimestampCodec::to_pg(value));
+        std::memcpy(buffer.data() + 4, &network_usecs, sizeof(int64_t));
     }
 
     /**
      * @brief Converts a Timestamp to PostgreSQL text format
      *
      * Creates a standard text representation of a timestamp in ISO 8601 format:
-     * YYYY-MM-DD HH:MM:SS.ssssss
+     * YYYY-MM-DD HH:MM:SS[.ssssss], as a UTC wall-clock time
      *
      * @param value The timestamp to convert
      * @return std::string The PostgreSQL text representation of the timestamp
      */
     static std::string
     to_text(const qb::Timestamp &value) {
-        // Get the whole seconds part
-        double unix_secs_float = value.seconds_float();
-        std::time_t unix_time = static_cast<std::time_t>(unix_secs_float);
-        std::tm    *time_info = std::localtime(&unix_time);
-        char        buf[32];
-
-        // Format the date and time parts
-        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", time_info);
-
-        // Add microseconds with higher precision using fractional part
-        std::string result(buf);
-        double fractional_part = unix_secs_float - std::floor(unix_secs_float);
-        int64_t microsecs = static_cast<int64_t>(fractional_part * 1000000);
-        if (microsecs > 0) {
-            char usec_buf[8];
-            std::snprintf(usec_buf, sizeof(usec_buf), ".%06ld",
-                         static_cast<long>(microsecs));
-            result += usec_buf;
-        }
+        return TimestampCodec::to_text(value, false);
+    }
 
-        return result;
+    /**
+     * @brief Converts an owned PostgreSQL binary buffer to a C++ type
+     *
+     * @param buffer Buffer containing the PostgreSQL binary format data
+     * @return value_type Deserialized C++ value
+     */
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
     }
 
     /**
@@ -807,40 +670,8 @@ struct TypeConverter<qb::Timestamp> {
      * @throws std::runtime_error If the buffer is too small or malformed
      */
     static qb::Timestamp
-    from_binary(const std::vector<byte> &buffer) {
-        // PostgreSQL timestamp is in microseconds since 2000-01-01
-        if (buffer.size() < 8) { // at least 8 bytes for timestamp
-            throw std::runtime_error("Buffer too small for timestamp");
-        }
-
-        // Difference between PostgreSQL epoch (2000-01-01) and Unix epoch (1970-01-01)
-        constexpr int64_t POSTGRES_EPOCH_DIFF = 946684800LL; // seconds
-
-        // Create a temporary variable to hold the timestamp
-        int64_t pg_usecs = 0;
-
-        // If buffer contains EXACTLY the timestamp (8 bytes), use it directly
-        if (buffer.size() == 8) {
-            std::memcpy(&pg_usecs, buffer.data(), 8);
-        } else {
-            // Otherwise, assume there's a 4-byte prefix
-            std::memcpy(&pg_usecs, buffer.data() + 4, 8);
-        }
-
-        // Convert big-endian to native order
-        pg_usecs = qb::endian::from_big_endian(pg_usecs);
-
-        // Convert to Unix seconds and microseconds
-        int64_t unix_secs  = (pg_usecs / 1000000) + POSTGRES_EPOCH_DIFF;
-        int64_t unix_usecs = pg_usecs % 1000000;
-
-        if (unix_usecs < 0) {
-            unix_secs--;
-            unix_usecs += 1000000;
-        }
-
-        return qb::Timestamp::from_seconds(unix_secs) +
-               qb::Timespan::from_microseconds(unix_usecs);
+    from_binary(std::string_view buffer) {
+        return TimestampCodec::read_binary(buffer);
     }
 
     /**
@@ -848,62 +679,15 @@ struct TypeConverter<qb::Timestamp> {
      *
      * Parses a PostgreSQL text representation of a timestamp into a qb::Timestamp
      * object. Handles the standard PostgreSQL timestamp format: "YYYY-MM-DD
-     * HH:MM:SS.ssssss"
+     * HH:MM:SS.ssssss", read as a UTC wall-clock time unless it has a time zone.
      *
-     * @param text Text representation of a timestamp
+     * @param text_view Text representation of a timestamp
      * @return qb::Timestamp Converted timestamp object
      * @throws std::runtime_error If the text is not a valid timestamp format
      */
     static qb::Timestamp
-    from_text(const std::string &text) {
-        // Expected format: "YYYY-MM-DD HH:MM:SS.ssssss" or "YYYY-MM-DD HH:MM:SS"
-        std::tm tm   = {};
-        int     usec = 0;
-
-        // Parse date and time
-        if (text.empty()) {
-            throw std::runtime_error("Empty timestamp string");
-        }
-
-        int year = 0, month = 0, day = 0, hour = 0, min = 0, sec = 0;
-
-        // Use sscanf which is more tolerant of formats
-        int matched = sscanf(text.c_str(), "%d-%d-%d %d:%d:%d", &year, &month, &day,
-                             &hour, &min, &sec);
-
-        if (matched != 6) {
-            throw std::runtime_error("Invalid timestamp format");
-        }
-
-        // Read fractional part if it exists
-        size_t dot_pos = text.find('.');
-        if (dot_pos != std::string::npos && dot_pos + 1 < text.length()) {
-            std::string usec_str = text.substr(dot_pos + 1);
-            usec                 = std::stoi(usec_str);
-
-            // Adjust to the correct scale (microseconds)
-            int digits = usec_str.length();
-            for (int i = digits; i < 6; i++) {
-                usec *= 10;
-            }
-        }
-
-        // Set up tm structure
-        tm.tm_year = year - 1900;
-        tm.tm_mon  = month - 1;
-        tm.tm_mday = day;
-        tm.tm_hour = hour;
-        tm.tm_min  = min;
-        tm.tm_sec  = sec;
-
-        // Convert to timestamp
-        std::time_t time_secs = std::mktime(&tm);
-        if (time_secs == -1) {
-            throw std::runtime_error("Invalid timestamp conversion");
-        }
-
-        return value_type(qb::Timestamp::from_seconds(time_secs) +
-                          qb::Timespan::from_microseconds(usec));
+    from_text(std::string_view text_view) {
+        return TimestampCodec::parse(text_view);
     }
 };
 
@@ -935,7 +719,6 @@ struct TypeConverter<qb::UtcTimestamp> {
      */
     static void
     to_binary(const qb::UtcTimestamp &value, std::vector<byte> &buffer) {
-        // Convert to regular Timestamp and then serialize
         // Use the value directly since UtcTimestamp is derived from Timestamp
         TypeConverter<qb::Timestamp>::to_binary(static_cast<qb::Timestamp>(value),
                                                 buffer);
@@ -945,7 +728,7 @@ struct TypeConverter<qb::UtcTimestamp> {
      * @brief Converts a UtcTimestamp to PostgreSQL text format
      *
      * Creates a standard text representation of a UTC timestamp in ISO 8601 format:
-     * YYYY-MM-DD HH:MM:SS.ssssss+00
+     * YYYY-MM-DD HH:MM:SS[.ssssss]+00
      *
      * @param value The UTC timestamp to convert
      * @return std::string The PostgreSQL text representation of the timestamp with
@@ -953,27 +736,18 @@ struct TypeConverter<qb::UtcTimestamp> {
      */
     static std::string
     to_text(const qb::UtcTimestamp &value) {
-        std::time_t unix_time = value.seconds();
-        std::tm    *time_info = std::gmtime(&unix_time);
-        char        buf[40];
-
-        // Format the date and time parts
-        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", time_info);
-
-        // Add microseconds
-        std::string result(buf);
-        int64_t     microsecs = value.microseconds() % 1000000;
-        if (microsecs > 0) {
-            char usec_buf[8];
-            std::snprintf(usec_buf, sizeof(usec_buf), ".%06ld",
-                          static_cast<long>(microsecs));
-            result += usec_buf;
-        }
-
-        // Add UTC timezone indicator
-        result += "+00";
+        return TimestampCodec::to_text(value, true);
+    }
 
-        return result;
+    /**
+     * @brief Converts an owned PostgreSQL binary buffer to a C++ type
+     *
+     * @param buffer Buffer containing the PostgreSQL binary format data
+     * @return value_type Deserialized C++ value
+     */
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
     }
 
     /**
@@ -989,110 +763,24 @@ struct TypeConverter<qb::UtcTimestamp> {
      * @throws std::runtime_error If the buffer is too small or malformed
      */
     static qb::UtcTimestamp
-    from_binary(const std::vector<byte> &buffer) {
-        // Convert from binary to Timestamp, then to UtcTimestamp
-        qb::Timestamp ts = TypeConverter<qb::Timestamp>::from_binary(buffer);
-        // Create a new UtcTimestamp and assign the epoch value from the timestamp
-        qb::UtcTimestamp result;
-        result = qb::UtcTimestamp(ts.nanoseconds());
-        return result;
+    from_binary(std::string_view buffer) {
+        return qb::UtcTimestamp(TimestampCodec::read_binary(buffer).nanoseconds());
     }
 
     /**
      * @brief Converts PostgreSQL text format to a UtcTimestamp
      *
      * Parses a PostgreSQL text representation of a timestamp with timezone into
-     * a qb::UtcTimestamp object. Handles formats with timezone information.
+     * a qb::UtcTimestamp object. The time zone offset sent by the server, e.g.
+     * "+02" or "-05:30", is applied to get the UTC time.
      *
-     * @param text Text representation of a timestamp with timezone
+     * @param text_view Text representation of a timestamp with timezone
      * @return qb::UtcTimestamp Converted UTC timestamp object
      * @throws std::runtime_error If the text is not a valid timestamptz format
      */
     static qb::UtcTimestamp
-    from_text(const std::string &text) {
-        // PostgreSQL will provide timestamps in various formats including timezone info
-        // We'll parse the basic timestamp part first
-
-        // Expected format: "YYYY-MM-DD HH:MM:SS.ssssss±TZ" or variations
-        std::tm tm   = {};
-        int     usec = 0;
-
-        if (text.empty()) {
-            throw std::runtime_error("Empty timestamp string");
-        }
-
-        int year = 0, month = 0, day = 0, hour = 0, min = 0, sec = 0;
-
-        // Use a simpler approach to extract the date/time portion
-        int matched = sscanf(text.c_str(), "%d-%d-%d %d:%d:%d", &year, &month, &day,
-                             &hour, &min, &sec);
-
-        if (matched != 6) {
-            throw std::runtime_error("Invalid timestamp format");
-        }
-
-        // Read fractional part if it exists (ignoring timezone for initial parsing)
-        size_t dot_pos = text.find('.');
-        if (dot_pos != std::string::npos && dot_pos + 1 < text.length()) {
-            // Find the first non-digit character after the dot
-            size_t end_pos = dot_pos + 1;
-            while (end_pos < text.length() && std::isdigit(text[end_pos])) {
-                end_pos++;
-            }
-
-            std::string usec_str = text.substr(dot_pos + 1, end_pos - (dot_pos + 1));
-            usec                 = std::stoi(usec_str);
-
-            // Adjust to the correct scale (microseconds)
-            int digits = usec_str.length();
-            for (int i = digits; i < 6; i++) {
-                usec *= 10;
-            }
-        }
-
-        // Set up tm structure as UTC
-        tm.tm_year  = year - 1900;
-        tm.tm_mon   = month - 1;
-        tm.tm_mday  = day;
-        tm.tm_hour  = hour;
-        tm.tm_min   = min;
-        tm.tm_sec   = sec;
-        tm.tm_isdst = 0; // No DST for UTC
-
-        // Convert to timestamp
-        // Use timegm (GMT/UTC version of mktime) if available, otherwise approximate
-#ifdef _WIN32
-        // Windows doesn't have timegm, use _mkgmtime
-        std::time_t time_secs = _mkgmtime(&tm);
-#else
-        std::time_t time_secs;
-        // Check if we have timegm available
-#ifdef __APPLE__
-        // macOS doesn't have timegm in the standard library
-        time_secs = std::mktime(&tm);
-        // Adjust for local timezone offset
-        std::time_t local_time = std::mktime(&tm);
-        std::tm    *gm_tm      = std::gmtime(&local_time);
-        std::time_t gm_time    = std::mktime(gm_tm);
-        time_secs += (local_time - gm_time);
-#else
-        // Linux and others might have timegm
-        time_secs = timegm(&tm);
-#endif
-#endif
-
-        if (time_secs == -1) {
-            throw std::runtime_error("Invalid timestamp conversion");
-        }
-
-        // Create a timestamp with the seconds and microseconds
-        auto ts = qb::Timestamp::from_seconds(time_secs) +
-                  qb::Timespan::from_microseconds(usec);
-                  
-        // Create a new UtcTimestamp and assign the epoch value from the timestamp
-        qb::UtcTimestamp result;
-        result = qb::UtcTimestamp(ts.nanoseconds());
-        return result;
+    from_text(std::string_view text_view) {
+        return qb::UtcTimestamp(TimestampCodec::parse(text_view).nanoseconds());
     }
 };
 
@@ -1149,6 +837,17 @@ struct TypeConverter<qb::json> {
         return value.dump();
     }
 
+    /**
+     * @brief Converts an owned PostgreSQL binary buffer to a C++ type
+     *
+     * @param buffer Buffer containing the PostgreSQL binary format data
+     * @return value_type Deserialized C++ value
+     */
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
     /**
      * @brief Converts a PostgreSQL binary buffer to a JSON object
      *
@@ -1162,7 +861,7 @@ struct TypeConverter<qb::json> {
      * @throws std::runtime_error If the buffer contains invalid or malformed data
      */
     static value_type
-    from_binary(const std::vector<byte> &buffer) {
+    from_binary(std::string_view buffer) {
         try {
             if (buffer.size() <= 4) {
                 throw std::runtime_error("Invalid JSON binary format: buffer too small");
@@ -1218,7 +917,7 @@ struct TypeConverter<qb::json> {
      * @throws std::runtime_error If the text contains invalid or malformed JSON
      */
     static value_type
-    from_text(const std::string &text) {
+    from_text(std::string_view text) {
         try {
             return qb::json::parse(text);
         } catch (const std::exception &e) {
@@ -1300,6 +999,17 @@ struct TypeConverter<qb::jsonb> {
         return value.dump();
     }
 
+    /**
+     * @brief Converts an owned PostgreSQL binary buffer to a C++ type
+     *
+     * @param buffer Buffer containing the PostgreSQL binary format data
+     * @return value_type Deserialized C++ value
+     */
+    static value_type
+    from_binary(const std::vector<byte> &buffer) {
+        return from_binary(std::string_view(buffer.data(), buffer.size()));
+    }
+
     /**
      * @brief Converts a PostgreSQL binary buffer to a JSONB object
      *
@@ -1314,7 +1024,7 @@ struct TypeConverter<qb::jsonb> {
      * @throws std::runtime_error If the buffer contains invalid or malformed data
      */
     static value_type
-    from_binary(const std::vector<byte> &buffer) {
+    from_binary(std::string_view buffer) {
         try {
             if (buffer.size() <= 5) {
                 throw std::runtime_error(
@@ -1378,7 +1088,7 @@ struct TypeConverter<qb::jsonb> {
      * @throws std::runtime_error If the text contains invalid or malformed JSON
      */
     static value_type
-    from_text(const std::string &text) {
+    from_text(std::string_view text) {
         try {
             return qb::jsonb(nlohmann::json::parse(text));
         } catch (const std::exception &e) {
@@ -1397,4 +1107,8 @@ private:
     }
 };
 
-} // namespace qb::pg::detail
\ No newline at end of file
+} // namespace qb::pg::detail
+
+#include "./array_converter.h"
+#include "./json_view.h"
+#include "./numeric.h"
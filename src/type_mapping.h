@@ -9,6 +9,7 @@
  * - Support for QB-specific types like UUID and Timestamp
  * - Handling of binary data with bytea type
  * - Support for std::optional types
+ * - Array OIDs of vectors of scalar types
  * - Utility functions for OID type retrieval and vector population
  *
  * The type mapping system enables automatic parameter type deduction when binding
@@ -161,6 +162,56 @@ struct type_mapping<std::optional<T>> {
     static constexpr integer type_oid = type_mapping<T>::type_oid;
 };
 
+/**
+ * @brief Gets the OID of the one-dimensional array of a PostgreSQL type
+ *
+ * @param element_oid OID of the element type
+ * @return integer OID of the array type, or 0 to let the server infer it
+ */
+constexpr integer
+array_type_oid(integer element_oid) noexcept {
+    switch (element_oid) {
+        case 16:
+            return 1000; // bool[]
+        case 17:
+            return 1001; // bytea[]
+        case 20:
+            return 1016; // int8[]
+        case 21:
+            return 1005; // int2[]
+        case 23:
+            return 1007; // int4[]
+        case 25:
+            return 1009; // text[]
+        case 114:
+            return 199; // json[]
+        case 700:
+            return 1021; // float4[]
+        case 701:
+            return 1022; // float8[]
+        case 1114:
+            return 1115; // timestamp[]
+        case 1184:
+            return 1185; // timestamptz[]
+        case 1700:
+            return 1231; // numeric[]
+        case 2950:
+            return 2951; // uuid[]
+        case 3802:
+            return 3807; // jsonb[]
+        default:
+            return 0;
+    }
+}
+
+// Vectors other than byte buffers map to the array of their element type
+template <typename T, typename Alloc>
+struct type_mapping<std::vector<T, Alloc>,
+                    std::enable_if_t<!std::is_same_v<T, char> &&
+                                     !std::is_same_v<T, unsigned char>>> {
+    static constexpr integer type_oid = array_type_oid(type_mapping<T>::type_oid);
+};
+
 /**
  * @brief Get the PostgreSQL OID for a C++ type
  *
@@ -0,0 +1,360 @@
+/**
+ * @file typed_statement.h
+ * @brief Prepared statements typed at compile time
+ *
+ * A TypedStatement<Ret(Args...)> couples a statement name and SQL text with
+ * the C++ types of its parameters and rows:
+ *
+ * - the parameter OIDs sent in the Parse message are a constexpr array
+ *   derived from type_mapping, so the server checks the statement against
+ *   the types used to execute it
+ * - arguments are checked by the compiler and encoded by a codec selected
+ *   per type, into a single buffer reserved once, fixed-width values
+ *   without any intermediate buffer
+ * - rows are decoded into Ret with decoders resolved once per result
+ *
+ * @code
+ * static const qb::pg::prepared<std::tuple<int, std::string>(int)> find_user{
+ *     "find_user", "SELECT id, name FROM users WHERE id = $1"};
+ *
+ * db.prepare(find_user)
+ *   .execute(find_user(42), [](auto &tr, std::vector<std::tuple<int, std::string>> rows) {
+ *   });
+ * @endcode
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <qb/system/endian.h>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./queries.h"
+#include "./row_binder.h"
+
+namespace qb::pg::detail {
+
+/**
+ * @brief Encoder of a statement parameter in the Bind format
+ *
+ * The primary template delegates to TypeConverter and estimates the size of
+ * values it cannot measure; specializations write fixed-width and string
+ * values in place.
+ *
+ * @tparam T Parameter type, without reference or qualifiers
+ */
+template <typename T, typename Enable = void>
+struct ParamCodec {
+    /// Encoded size including the length prefix, 0 if it depends on the value
+    static constexpr std::size_t fixed_size = 0;
+
+    static std::size_t
+    size(T const &) noexcept {
+        return sizeof(integer) + 16;
+    }
+
+    static void
+    write(std::vector<byte> &buffer, T const &value) {
+        TypeConverter<T>::to_binary(value, buffer);
+    }
+};
+
+/**
+ * @brief Codec of the integer types, written in network byte order
+ */
+template <typename T>
+struct ParamCodec<T, std::enable_if_t<std::is_same_v<T, bool> || std::is_same_v<T, smallint> ||
+                                      std::is_same_v<T, integer> || std::is_same_v<T, bigint>>> {
+    static constexpr std::size_t fixed_size = sizeof(integer) + sizeof(T);
+
+    static constexpr std::size_t
+    size(T const &) noexcept {
+        return fixed_size;
+    }
+
+    static void
+    write(std::vector<byte> &buffer, T value) {
+        const auto length = qb::endian::to_big_endian(static_cast<integer>(sizeof(T)));
+        const auto data   = [value] {
+            if constexpr (std::is_same_v<T, bool>)
+                return static_cast<byte>(value);
+            else
+                return qb::endian::to_big_endian(value);
+        }();
+        const auto offset = buffer.size();
+        buffer.resize(offset + fixed_size);
+        std::memcpy(buffer.data() + offset, &length, sizeof(length));
+        std::memcpy(buffer.data() + offset + sizeof(length), &data, sizeof(data));
+    }
+};
+
+/**
+ * @brief Codec of the text and bytea types, copied once after their length
+ */
+template <typename T>
+struct ParamCodec<T, std::enable_if_t<std::is_same_v<T, std::string> ||
+                                      std::is_same_v<T, std::string_view> ||
+                                      std::is_same_v<T, bytea>>> {
+    static constexpr std::size_t fixed_size = 0;
+
+    static std::size_t
+    size(T const &value) noexcept {
+        return sizeof(integer) + value.size();
+    }
+
+    static void
+    write(std::vector<byte> &buffer, T const &value) {
+        const auto length = qb::endian::to_big_endian(static_cast<integer>(value.size()));
+        const auto offset = buffer.size();
+        buffer.resize(offset + sizeof(length) + value.size());
+        std::memcpy(buffer.data() + offset, &length, sizeof(length));
+        if (!value.empty())
+            std::memcpy(buffer.data() + offset + sizeof(length), value.data(), value.size());
+    }
+};
+
+/**
+ * @brief Codec of nullable parameters
+ */
+template <typename T>
+struct ParamCodec<std::optional<T>> {
+    static constexpr std::size_t fixed_size = 0;
+
+    static std::size_t
+    size(std::optional<T> const &value) noexcept {
+        return value ? ParamCodec<T>::size(*value) : sizeof(integer);
+    }
+
+    static void
+    write(std::vector<byte> &buffer, std::optional<T> const &value) {
+        if (value) {
+            ParamCodec<T>::write(buffer, *value);
+        } else {
+            const auto null  = qb::endian::to_big_endian(integer{-1});
+            const auto bytes = reinterpret_cast<const byte *>(&null);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(null));
+        }
+    }
+};
+
+/**
+ * @brief Decoder of the rows of a typed statement
+ *
+ * Ret is either a single column type, a std::tuple of column types, or a
+ * structure with a static `columns` tuple of column() descriptors.
+ */
+template <typename Ret, typename Enable = void>
+class RowDecoder {
+    RowBinder<Ret> _binder;
+
+public:
+    explicit RowDecoder(row_description_type const &desc)
+        : _binder(desc) {}
+
+    Ret
+    operator()(resultset::row const &row) const {
+        return std::get<0>(_binder(row));
+    }
+};
+
+template <typename... T>
+class RowDecoder<std::tuple<T...>> {
+    RowBinder<T...> _binder;
+
+public:
+    explicit RowDecoder(row_description_type const &desc)
+        : _binder(desc) {}
+
+    std::tuple<T...>
+    operator()(resultset::row const &row) const {
+        return _binder(row);
+    }
+};
+
+template <typename S>
+class RowDecoder<S, std::void_t<decltype(S::columns)>> {
+    decltype(make_binder(std::declval<row_description_type const &>(), S::columns)) _binder;
+
+public:
+    explicit RowDecoder(row_description_type const &desc)
+        : _binder(make_binder(desc, S::columns)) {}
+
+    S
+    operator()(resultset::row const &row) const {
+        return _binder(row);
+    }
+};
+
+/**
+ * @brief Decodes the rows of a result of a typed statement
+ *
+ * @tparam Ret Type of the rows
+ * @param result Result of an execution
+ * @return std::vector<Ret> Decoded rows
+ * @throws error::db_error If the result lacks a bound column
+ */
+template <typename Ret>
+std::vector<Ret>
+decode_rows(resultset const &result) {
+    std::vector<Ret> rows;
+    if (!result.size())
+        return rows;
+    const RowDecoder<Ret> decoder(result.row_description());
+    rows.reserve(result.size());
+    for (auto const &row : result)
+        rows.push_back(decoder(row));
+    return rows;
+}
+
+/**
+ * @brief Execution of a typed statement with its encoded arguments
+ *
+ * Returned by TypedStatement::operator() and consumed by
+ * Transaction::execute().
+ *
+ * @tparam Ret Type of the rows
+ */
+template <typename Ret>
+class BoundStatement {
+    std::string_view _name;   ///< Name of the statement
+    QueryParams      _params; ///< Encoded arguments
+
+public:
+    using row_type = Ret;
+
+    BoundStatement(std::string_view name, QueryParams &&params) noexcept
+        : _name(name)
+        , _params(std::move(params)) {}
+
+    [[nodiscard]] std::string_view
+    name() const noexcept {
+        return _name;
+    }
+
+    QueryParams &
+    params() noexcept {
+        return _params;
+    }
+};
+
+template <typename Signature>
+class TypedStatement;
+
+/**
+ * @brief Prepared statement with compile-time parameter and row types
+ *
+ * Holds the definition only: prepare it on each connection with
+ * Transaction::prepare(), then execute the result of operator().
+ *
+ * @tparam Ret Type of the rows, void for statements returning none
+ * @tparam Args Types of the parameters
+ */
+template <typename Ret, typename... Args>
+class TypedStatement<Ret(Args...)> {
+    template <typename T>
+    using param_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+    std::string _name;       ///< Name of the statement
+    std::string _expression; ///< SQL text
+
+public:
+    using row_type = Ret;
+
+    /// Number of parameters
+    static constexpr std::size_t arity = sizeof...(Args);
+
+    /// Types of the parameters, sent in the Parse message
+    static constexpr std::array<oid, arity> param_types{
+        static_cast<oid>(type_mapping<param_t<Args>>::type_oid)...};
+
+    /// Encoded size of the parameters when they are all fixed-width, 0 otherwise
+    static constexpr std::size_t fixed_size =
+        ((ParamCodec<param_t<Args>>::fixed_size && ...)
+             ? sizeof(smallint) + (std::size_t{0} + ... + ParamCodec<param_t<Args>>::fixed_size)
+             : 0);
+
+    static_assert(arity <= 0x7FFF, "Too many parameters for a statement");
+
+    /**
+     * @brief Defines a statement
+     *
+     * @param name Name of the statement, unique per connection
+     * @param expression SQL text, with $1..$n placeholders
+     */
+    TypedStatement(std::string name, std::string expression)
+        : _name(std::move(name))
+        , _expression(std::move(expression)) {}
+
+    [[nodiscard]] std::string const &
+    name() const noexcept {
+        return _name;
+    }
+
+    [[nodiscard]] std::string const &
+    expression() const noexcept {
+        return _expression;
+    }
+
+    /**
+     * @brief Gets the parameter types for Transaction::prepare()
+     */
+    [[nodiscard]] static type_oid_sequence
+    types() {
+        return type_oid_sequence(param_types.begin(), param_types.end());
+    }
+
+    /**
+     * @brief Encodes the arguments of an execution
+     *
+     * @param args Arguments, converted to the declared parameter types
+     * @return QueryParams Parameter set in the Bind format
+     */
+    static QueryParams
+    encode(param_t<Args> const &...args) {
+        std::vector<byte> buffer;
+        if constexpr (fixed_size != 0)
+            buffer.reserve(fixed_size);
+        else
+            buffer.reserve(sizeof(smallint) +
+                           (std::size_t{0} + ... + ParamCodec<param_t<Args>>::size(args)));
+        const auto count = qb::endian::to_big_endian(static_cast<smallint>(arity));
+        const auto bytes = reinterpret_cast<const byte *>(&count);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(count));
+        (ParamCodec<param_t<Args>>::write(buffer, args), ...);
+        return QueryParams::encoded(std::move(buffer));
+    }
+
+    /**
+     * @brief Binds the arguments of an execution
+     *
+     * @param args Arguments, converted to the declared parameter types
+     * @return BoundStatement<Ret> Execution for Transaction::execute()
+     */
+    BoundStatement<Ret>
+    operator()(param_t<Args> const &...args) const {
+        return {_name, encode(args...)};
+    }
+};
+
+} // namespace qb::pg::detail
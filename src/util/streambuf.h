@@ -3,9 +3,9 @@
  * @brief Custom streambuf implementation for iterator-based buffers
  *
  * This file provides a specialized streambuf implementation that works with
- * iterator ranges from containers. It allows creating stream buffers directly
- * from container iterators, facilitating streaming operations on container data
- * without copying the underlying data.
+ * ranges of contiguous characters. It allows creating stream buffers directly
+ * over container storage, whatever its allocator, facilitating streaming
+ * operations on container data without copying the underlying data.
  *
  * @author zmij
  * @copyright Originally from project: https://github.com/zmij/pg_async.git
@@ -31,11 +31,12 @@ namespace qb {
 namespace util {
 
 /**
- * @brief Stream buffer implementation based on container iterators
+ * @brief Stream buffer implementation over contiguous container data
  *
- * This class implements a streambuf that operates directly on data referenced
- * by container iterators. It allows streaming operations (like reading) on
- * container data without having to copy the data to a separate buffer.
+ * This class implements a streambuf that operates directly on the characters
+ * of a container, referenced by pointers so that the storage of any container
+ * and allocator can be viewed. It allows streaming operations (like reading)
+ * on container data without having to copy the data to a separate buffer.
  *
  * @tparam charT The character type of the stream
  * @tparam container The container type that holds the data
@@ -47,7 +48,7 @@ class basic_input_iterator_buffer : public std::basic_streambuf<charT, traits> {
 public:
     typedef charT                                   char_type;      ///< Character type
     typedef container                               container_type; ///< Container type
-    typedef typename container_type::const_iterator const_iterator; ///< Iterator type
+    typedef const charT                            *const_iterator; ///< Iterator type
     typedef std::ios_base                           ios_base; ///< Base IO class type
 
     typedef std::basic_streambuf<charT, traits> base;     ///< Base streambuf type
@@ -56,19 +57,19 @@ public:
 
 public:
     /**
-     * @brief Constructor from iterator range
+     * @brief Constructor from a range of contiguous characters
      *
-     * Creates a stream buffer from the range defined by the iterators [s, e).
-     * The data is not copied; the buffer operates directly on the original data.
+     * Creates a stream buffer from the range [s, e), e.g. a field in the
+     * storage of a result set. The data is not copied; the buffer operates
+     * directly on the original data.
      *
-     * @param s Iterator pointing to the start of the range
-     * @param e Iterator pointing to the end of the range
+     * @param s Pointer to the start of the range
+     * @param e Pointer to the end of the range
      */
     basic_input_iterator_buffer(const_iterator s, const_iterator e)
         : base()
-        , s_(s)
-        , start_(const_cast<char_type *>(&*s))
-        , count_(e - s) {
+        , start_(const_cast<char_type *>(s))
+        , count_(static_cast<size_t>(e - s)) {
         base::setg(start_, start_, start_ + count_);
     }
 
@@ -81,7 +82,6 @@ public:
      */
     basic_input_iterator_buffer(basic_input_iterator_buffer &&rhs)
         : base()
-        , s_(rhs.s_)
         , start_(rhs.start_)
         , count_(rhs.count_) {
         auto n = rhs.gptr();
@@ -95,7 +95,7 @@ public:
      */
     const_iterator
     begin() const {
-        return s_;
+        return start_;
     }
 
     /**
@@ -105,7 +105,7 @@ public:
      */
     const_iterator
     end() const {
-        return s_ + count_;
+        return start_ + count_;
     }
 
     /**
@@ -192,9 +192,8 @@ protected:
     }
 
 private:
-    const_iterator s_;     ///< Iterator to the start of the range
-    char_type     *start_; ///< Pointer to the start of the buffer
-    size_t         count_; ///< Number of elements in the buffer
+    char_type *start_; ///< Pointer to the start of the buffer
+    size_t     count_; ///< Number of elements in the buffer
 };
 
 /**
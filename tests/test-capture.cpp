@@ -0,0 +1,744 @@
+/**
+ * @file test-capture.cpp
+ * @brief Unit tests for the capture and replay of the wire protocol
+ *
+ * This file tests the recording of the traffic of a connection and its
+ * offline replay, without a server:
+ *
+ * - Round trip of frames through a capture file
+ * - Rejection of truncated and foreign files
+ * - Replay of backend messages answering the commands queued on a connection
+ * - Recording of the sends and receptions of a connection
+ *
+ * @see qb::pg::detail::WireRecorder
+ * @see qb::pg::detail::WireReplay
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../pgsql.h"
+
+using namespace qb::pg;
+
+namespace {
+
+/**
+ * @brief Builds a backend message from its tag and payload
+ */
+std::string
+backend_message(char tag, std::string const &payload) {
+    const auto    length = static_cast<std::uint32_t>(payload.size() + 4);
+    std::string   msg(1, tag);
+    for (int shift = 24; shift >= 0; shift -= 8)
+        msg.push_back(static_cast<char>((length >> shift) & 0xFF));
+    return msg + payload;
+}
+
+/**
+ * @brief Encodes a big-endian integer
+ */
+template <typename T>
+std::string
+be(T value) {
+    std::string out;
+    for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8)
+        out.push_back(static_cast<char>((static_cast<std::uint64_t>(value) >> shift) & 0xFF));
+    return out;
+}
+
+/**
+ * @brief Backend answer of a simple query returning one int4 row
+ */
+std::vector<std::string>
+int_answer(std::string const &name, std::string const &value) {
+    const std::string field = name + std::string(1, '\0') + be<std::int32_t>(0) +
+                              be<std::int16_t>(0) + be<std::int32_t>(23) +
+                              be<std::int16_t>(4) + be<std::int32_t>(-1) + be<std::int16_t>(0);
+    return {backend_message('T', be<std::int16_t>(1) + field),
+            backend_message('D', be<std::int16_t>(1) +
+                                     be<std::int32_t>(static_cast<std::int32_t>(value.size())) +
+                                     value),
+            backend_message('C', std::string("SELECT 1") + '\0'),
+            backend_message('Z', "I")};
+}
+
+/**
+ * @brief Backend answer of a command without rows
+ */
+std::vector<std::string>
+command_answer(std::string const &tag, char status) {
+    return {backend_message('C', tag + '\0'), backend_message('Z', std::string(1, status))};
+}
+
+/**
+ * @brief Gets the first word of the simple queries sent by the frontend
+ */
+std::vector<std::string>
+sent_commands(std::string const &path) {
+    std::vector<std::string> sent;
+    wire_capture             capture(path);
+    detail::WireFrame        frame;
+    while (capture.next(frame))
+        if (frame.direction == detail::wire_direction::frontend && !frame.bytes.empty() &&
+            frame.bytes.front() == 'Q') {
+            const std::string text(frame.bytes.substr(5));
+            sent.push_back(text.substr(0, text.find_first_of(std::string(" \0", 2))));
+        }
+    return sent;
+}
+
+/**
+ * @brief Temporary capture file, removed with the fixture
+ */
+class WireCaptureTest : public ::testing::Test {
+protected:
+    std::filesystem::path path_ =
+        std::filesystem::temp_directory_path() /
+        ("qb-pgsql-capture-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+         ".cap");
+
+    void
+    TearDown() override {
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+    }
+
+    /**
+     * @brief Writes a capture of backend messages, after a captured startup
+     */
+    void
+    write_backend(std::vector<std::string> const &messages) {
+        wire_recorder recorder(path_);
+        for (auto const &msg : {backend_message('R', be<std::int32_t>(0)),
+                                backend_message('Z', "I")})
+            recorder.record(detail::wire_direction::backend, msg.data(), msg.size());
+        for (auto const &msg : messages)
+            recorder.record(detail::wire_direction::backend, msg.data(), msg.size());
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Test that frames are read back in order with their direction and time
+ */
+TEST_F(WireCaptureTest, RoundTrip) {
+    const std::string big(300, 'x');
+    {
+        wire_recorder recorder(path_);
+        recorder.record(detail::wire_direction::frontend, "Q", 1);
+        recorder.record(detail::wire_direction::backend, big.data(), big.size());
+        recorder.record(detail::wire_direction::backend, "", 0);
+        EXPECT_EQ(recorder.frames(), 3u);
+        EXPECT_EQ(recorder.bytes(), 301u);
+    }
+
+    wire_capture      capture(path_);
+    detail::WireFrame frame;
+    ASSERT_TRUE(capture.next(frame));
+    EXPECT_EQ(frame.direction, detail::wire_direction::frontend);
+    EXPECT_EQ(frame.bytes, "Q");
+    EXPECT_EQ(frame.at.count(), 0);
+    ASSERT_TRUE(capture.next(frame));
+    EXPECT_EQ(frame.direction, detail::wire_direction::backend);
+    EXPECT_EQ(frame.bytes, big);
+    const auto at = frame.at;
+    ASSERT_TRUE(capture.next(frame));
+    EXPECT_TRUE(frame.bytes.empty());
+    EXPECT_GE(frame.at, at);
+    EXPECT_FALSE(capture.next(frame));
+
+    capture.rewind();
+    ASSERT_TRUE(capture.next(frame));
+    EXPECT_EQ(frame.bytes, "Q");
+}
+
+/**
+ * @brief Test that truncated captures and other files are rejected
+ */
+TEST_F(WireCaptureTest, MalformedFiles) {
+    {
+        std::ofstream file(path_, std::ios::binary);
+        file << "not a capture";
+    }
+    EXPECT_THROW(wire_capture{path_}, error::client_error);
+
+    {
+        wire_recorder recorder(path_);
+        recorder.record(detail::wire_direction::backend, "abcdef", 6);
+    }
+    std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 2);
+    wire_capture      capture(path_);
+    detail::WireFrame frame;
+    EXPECT_THROW(capture.next(frame), error::client_error);
+    EXPECT_THROW(wire_capture{path_.string() + ".missing"}, error::client_error);
+}
+
+/**
+ * @brief Test that a replayed capture answers the commands queued on a connection
+ */
+TEST_F(WireCaptureTest, ReplayAnswersQueuedCommands) {
+    auto messages = int_answer("n", "41");
+    auto second   = int_answer("n", "42");
+    messages.insert(messages.end(), second.begin(), second.end());
+    write_backend(messages);
+
+    tcp::database db;
+    db.replay(true);
+    std::vector<int> values;
+    for (int i = 0; i < 2; ++i)
+        db.execute("SELECT n FROM t", [&values](transaction &, results result) {
+            values.push_back(result[0][0].as<int>());
+        });
+
+    wire_capture capture(path_);
+    tcp::replay  replay(db);
+    const auto   stats = replay.run(capture);
+    EXPECT_TRUE(stats.ok);
+    EXPECT_EQ(stats.frames, 8u);
+    EXPECT_EQ(stats.messages, 8u);
+    EXPECT_EQ(values, (std::vector<int>{41, 42}));
+    EXPECT_EQ(db.load(), 0u);
+    db.replay(false);
+}
+
+/**
+ * @brief Test that pipelined commands complete in queue order
+ *
+ * The first command queues new work from its callback: it is held at the
+ * head of the queue while the second one, already in flight, completes.
+ */
+TEST_F(WireCaptureTest, ReplayPipelinesQueuedCommands) {
+    std::vector<std::string> messages;
+    for (auto const &value : {"1", "2", "3", "4"}) {
+        auto answer = int_answer("n", value);
+        messages.insert(messages.end(), answer.begin(), answer.end());
+    }
+    write_backend(messages);
+
+    tcp::database db;
+    db.replay(true);
+    db.pipeline(2);
+    const auto recorded = path_.string() + ".out";
+    db.capture(std::make_shared<wire_recorder>(recorded));
+    std::vector<int> values;
+    db.execute("SELECT n FROM t", [&values](transaction &tr, results result) {
+        values.push_back(result[0][0].as<int>());
+        tr.execute("SELECT n FROM t", [&values](transaction &, results nested) {
+            values.push_back(nested[0][0].as<int>());
+        });
+    });
+    for (int i = 0; i < 2; ++i)
+        db.execute("SELECT n FROM t", [&values](transaction &, results result) {
+            values.push_back(result[0][0].as<int>());
+        });
+
+    wire_capture source(path_);
+    EXPECT_TRUE(tcp::replay(db).run(source).ok);
+    db.capture(nullptr);
+    db.replay(false);
+    EXPECT_EQ(values, (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_EQ(db.load(), 0u);
+
+    std::string       order;
+    wire_capture      capture(recorded);
+    detail::WireFrame frame;
+    while (capture.next(frame))
+        order.push_back(frame.direction == detail::wire_direction::frontend ? 'F' : 'B');
+    std::filesystem::remove(recorded);
+    // Two queries in flight, the nested one once they are answered, then the last
+    EXPECT_EQ(order, "FF" "BBBB" "BBBB" "F" "BBBB" "F" "BBBB");
+}
+
+/**
+ * @brief Test that a retried block keeps its place ahead of the commands queued behind it
+ */
+TEST_F(WireCaptureTest, ReplayRetriedBlockKeepsItsSlot) {
+    std::vector<std::string> first = command_answer("BEGIN", 'T');
+    const std::string serialization = std::string("SERROR") + '\0' + "C40001" + '\0' +
+                                      "Mcould not serialize access" + '\0' + '\0';
+    first.push_back(backend_message('E', serialization));
+    first.push_back(backend_message('Z', "E"));
+    for (auto const &msg : command_answer("ROLLBACK", 'I'))
+        first.push_back(msg);
+    write_backend(first);
+
+    // The answers of the second attempt, then of the command queued behind it
+    const auto second_path = path_.string() + ".2";
+    {
+        wire_recorder recorder(second_path);
+        auto          messages = command_answer("BEGIN", 'T');
+        for (auto const &answer :
+             {int_answer("n", "41"), command_answer("COMMIT", 'I'), int_answer("n", "42")})
+            messages.insert(messages.end(), answer.begin(), answer.end());
+        for (auto const &msg : messages)
+            recorder.record(detail::wire_direction::backend, msg.data(), msg.size());
+    }
+
+    tcp::database db;
+    db.replay(true);
+    const auto recorded = path_.string() + ".out";
+    db.capture(std::make_shared<wire_recorder>(recorded));
+    retry_policy policy;
+    policy.base_delay = std::chrono::milliseconds(0);
+    policy.max_delay  = std::chrono::milliseconds(0);
+    std::vector<std::string> events;
+    db.begin(
+        [&events](transaction &tr) {
+            tr.execute("SELECT n FROM t",
+                       [&events](transaction &, results result) {
+                           events.push_back("block " + result[0][0].as<std::string>());
+                       },
+                       [&events](error::db_error const &) { events.push_back("conflict"); });
+        },
+        [&events](error::db_error const &err) { events.push_back(err.what()); }, {}, policy);
+    db.execute("SELECT n FROM t", [&events](transaction &, results result) {
+        events.push_back("queued " + result[0][0].as<std::string>());
+    });
+
+    wire_capture source(path_);
+    EXPECT_TRUE(tcp::replay(db).run(source).ok);
+    EXPECT_EQ(events, (std::vector<std::string>{"conflict"}));
+    // The backoff holds the queue, then the next attempt takes the slot of the block
+    qb::io::async::run(EVRUN_ONCE);
+    wire_capture rest(second_path);
+    EXPECT_TRUE(tcp::replay(db).run(rest, replay_pacing::fast, false).ok);
+    db.capture(nullptr);
+    db.replay(false);
+    EXPECT_EQ(events, (std::vector<std::string>{"conflict", "block 41", "queued 42"}));
+    EXPECT_EQ(db.load(), 0u);
+    EXPECT_EQ(sent_commands(recorded),
+              (std::vector<std::string>{"BEGIN", "SELECT", "rollback", "BEGIN", "SELECT",
+                                        "commit", "SELECT"}));
+    std::filesystem::remove(second_path);
+    std::filesystem::remove(recorded);
+}
+
+/**
+ * @brief Test that a block losing its session fails as a whole, and the commands behind it resume
+ */
+TEST_F(WireCaptureTest, ReplayDisconnectionFailsTheStartedBlock) {
+    // BEGIN and the first statement are answered, then the session is lost
+    std::vector<std::string> messages = command_answer("BEGIN", 'T');
+    auto                     first    = int_answer("n", "41");
+    messages.insert(messages.end(), first.begin(), first.end());
+    write_backend(messages);
+    const auto next_path = path_.string() + ".2";
+    {
+        wire_recorder recorder(next_path);
+        for (auto const &msg : int_answer("n", "42"))
+            recorder.record(detail::wire_direction::backend, msg.data(), msg.size());
+    }
+
+    tcp::database db;
+    db.replay(true);
+    const auto recorded = path_.string() + ".out";
+    db.capture(std::make_shared<wire_recorder>(recorded));
+    std::vector<std::string> events;
+    db.begin(
+        [&events](transaction &tr) {
+            for (auto const &name : {"first", "second", "third"})
+                tr.execute("SELECT n FROM t",
+                           [&events, name](transaction &, results result) {
+                               events.push_back(name + (" " + result[0][0].as<std::string>()));
+                           },
+                           [&events, name](error::db_error const &err) {
+                               events.push_back(name + (" " + std::string(err.what())));
+                           });
+        },
+        [&events](error::db_error const &err) {
+            events.push_back("block " + std::string(err.what()));
+        });
+    db.execute("SELECT n FROM t", [&events](transaction &, results result) {
+        events.push_back("queued " + result[0][0].as<std::string>());
+    });
+
+    wire_capture source(path_);
+    EXPECT_TRUE(tcp::replay(db).run(source).ok);
+    db.on(qb::io::async::event::disconnected{});
+    EXPECT_EQ(events, (std::vector<std::string>{"first 41", "second database disconnected",
+                                                "third database disconnected",
+                                                "block database disconnected"}));
+    EXPECT_EQ(db.load(), 1u);
+
+    // The next session runs the command that was never sent
+    db.replay(false);
+    db.replay(true);
+    wire_capture next(next_path);
+    EXPECT_TRUE(tcp::replay(db).run(next, replay_pacing::fast, false).ok);
+    db.capture(nullptr);
+    db.replay(false);
+    EXPECT_EQ(events.back(), "queued 42");
+    EXPECT_EQ(db.load(), 0u);
+    EXPECT_EQ(sent_commands(recorded), (std::vector<std::string>{"BEGIN", "SELECT", "SELECT",
+                                                                 "SELECT"}));
+    std::filesystem::remove(next_path);
+    std::filesystem::remove(recorded);
+}
+
+/**
+ * @brief Test that rows are allocated from the resource of their query
+ *
+ * Rows of a scoped resource are released with their query; those of the
+ * connection are kept as its last results.
+ */
+TEST_F(WireCaptureTest, ReplayAllocatesRowsFromTheQueryResource) {
+    auto messages = int_answer("n", "41");
+    auto second   = int_answer("n", "42");
+    messages.insert(messages.end(), second.begin(), second.end());
+    write_backend(messages);
+
+    memory_tracker connection;
+    memory_tracker request;
+    tcp::database  db;
+    db.replay(true);
+    db.memory_resource(&connection);
+    std::size_t scoped = 0;
+    db.with_memory_resource(&request, [&scoped, &request](transaction &tr) {
+        tr.execute("SELECT n FROM t", [&scoped, &request](transaction &, results result) {
+            scoped = request.in_use();
+            EXPECT_EQ(result[0][0].as<int>(), 41);
+        });
+    });
+    EXPECT_EQ(db.memory_resource(), &connection);
+    db.execute("SELECT n FROM t", [](transaction &, results result) {
+        EXPECT_EQ(result[0][0].as<int>(), 42);
+    });
+
+    wire_capture capture(path_);
+    tcp::replay  replay(db);
+    EXPECT_TRUE(replay.run(capture).ok);
+    EXPECT_GT(scoped, 0u);
+    EXPECT_EQ(request.in_use(), 0u);
+    EXPECT_EQ(request.peak(), scoped);
+    EXPECT_GT(connection.in_use(), 0u);
+    EXPECT_EQ(db.results().size(), 1u);
+    db.results() = {};
+    EXPECT_EQ(connection.in_use(), 0u);
+    db.replay(false);
+}
+
+/**
+ * @brief Test that a statement with per-column result formats decodes each column
+ *
+ * The Bind must request one format code per column, and each column is
+ * read back in the format it was requested in.
+ */
+TEST_F(WireCaptureTest, ReplayDecodesMixedResultFormats) {
+    auto field = [](std::string const &name, std::int32_t type, std::int16_t size) {
+        return name + std::string(1, '\0') + be<std::int32_t>(0) + be<std::int16_t>(0) +
+               be<std::int32_t>(type) + be<std::int16_t>(size) + be<std::int32_t>(-1) +
+               be<std::int16_t>(0);
+    };
+    auto value = [](std::string const &bytes) {
+        return be<std::int32_t>(static_cast<std::int32_t>(bytes.size())) + bytes;
+    };
+    const std::int64_t big = std::int64_t(1) << 40;
+    write_backend(
+        {backend_message('1', ""), backend_message('t', be<std::int16_t>(0)),
+         backend_message('T', be<std::int16_t>(3) + field("id", 23, 4) + field("name", 25, -1) +
+                                  field("total", 20, 8)),
+         backend_message('Z', "I"), backend_message('2', ""),
+         backend_message('D', be<std::int16_t>(3) + value(be<std::int32_t>(7)) + value("abc") +
+                                  value(be<std::int64_t>(big))),
+         backend_message('C', std::string("SELECT 1") + '\0'), backend_message('Z', "I")});
+    const auto recorded = path_.string() + ".out";
+
+    tcp::database db;
+    db.replay(true);
+    auto recorder = std::make_shared<wire_recorder>(recorded);
+    db.capture(recorder);
+    int          id = 0;
+    std::string  name;
+    std::int64_t total = 0;
+    db.result_format("mixed", result_format::columns({protocol_data_format::Binary,
+                                                      protocol_data_format::Text,
+                                                      protocol_data_format::Binary}))
+        .prepare("mixed", "SELECT id, name, total FROM t", {})
+        .execute("mixed", params{}, [&](transaction &, results result) {
+            ASSERT_EQ(result.size(), 1u);
+            EXPECT_EQ(result.field(0).format_code, protocol_data_format::Binary);
+            EXPECT_EQ(result.field(1).format_code, protocol_data_format::Text);
+            id    = result[0][0].as<int>();
+            name  = result[0][1].as<std::string>();
+            total = result[0][2].as<std::int64_t>();
+        });
+    wire_capture source(path_);
+    EXPECT_TRUE(tcp::replay(db).run(source).ok);
+    db.capture(nullptr);
+    db.replay(false);
+    EXPECT_EQ(id, 7);
+    EXPECT_EQ(name, "abc");
+    EXPECT_EQ(total, big);
+
+    std::string       sent;
+    wire_capture      capture(recorded);
+    detail::WireFrame frame;
+    while (capture.next(frame))
+        if (frame.direction == detail::wire_direction::frontend)
+            sent.append(frame.bytes.data(), frame.bytes.size());
+    std::filesystem::remove(recorded);
+    // Bind ends with the result format codes: three of them, binary, text, binary
+    const auto bind = sent.find('B');
+    ASSERT_NE(bind, std::string::npos);
+    std::uint32_t length = 0;
+    for (int i = 1; i <= 4; ++i)
+        length = (length << 8) | static_cast<unsigned char>(sent[bind + i]);
+    EXPECT_EQ(sent.substr(bind + 1 + length - 8, 8),
+              be<std::int16_t>(3) + be<std::int16_t>(1) + be<std::int16_t>(0) +
+                  be<std::int16_t>(1));
+}
+
+/**
+ * @brief Test that rows decoded on workers are posted back to the loop
+ */
+TEST_F(WireCaptureTest, ReplayPostsOffloadedRowsBack) {
+    const auto description = int_answer("n", "0").front();
+    std::vector<std::string> messages{backend_message('1', ""),
+                                      backend_message('t', be<std::int16_t>(0)), description,
+                                      backend_message('Z', "I"), backend_message('2', "")};
+    for (int i = 0; i < 10; ++i) {
+        const auto value = std::to_string(i);
+        messages.push_back(backend_message(
+            'D', be<std::int16_t>(1) + be<std::int32_t>(static_cast<std::int32_t>(value.size())) +
+                     value));
+    }
+    messages.push_back(backend_message('C', std::string("SELECT 10") + '\0'));
+    messages.push_back(backend_message('Z', "I"));
+    write_backend(messages);
+
+    decode_pool    workers(2);
+    result_offload offload(workers);
+    offload.rows_per_task = 3;
+    offload.min_rows      = 2;
+
+    tcp::database db;
+    db.replay(true);
+    const auto       loop = std::this_thread::get_id();
+    std::vector<int> rows;
+    bool             on_loop = false;
+    db.prepare("offload_n", "SELECT n FROM t", {})
+        .execute_offload<int>(
+            "offload_n", params{}, offload,
+            [&](transaction &, std::vector<int> decoded) {
+                on_loop = std::this_thread::get_id() == loop;
+                rows    = std::move(decoded);
+            },
+            [](error::db_error const &err) { ADD_FAILURE() << err.what(); });
+
+    wire_capture capture(path_);
+    EXPECT_TRUE(tcp::replay(db).run(capture).ok);
+    // await() waits for the workers to post the rows back
+    db.await();
+    EXPECT_TRUE(on_loop);
+    EXPECT_EQ(rows, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    db.replay(false);
+}
+
+/**
+ * @brief Test that an error after closing a portal sends no second Sync
+ *
+ * The Close of the portal is already followed by a Sync: another one would
+ * be answered by a ReadyForQuery matching no query.
+ */
+TEST_F(WireCaptureTest, PortalErrorAfterCloseSendsOneSync) {
+    const auto description = int_answer("n", "0");
+    const auto error = backend_message('E', std::string("SERROR") + '\0' + "C55000" + '\0' +
+                                                "Mportal failed" + '\0' + '\0');
+    write_backend({backend_message('1', ""), backend_message('t', be<std::int16_t>(0)),
+                   description[0], backend_message('Z', "I"), backend_message('2', ""),
+                   description[1], backend_message('s', ""), error,
+                   backend_message('Z', "I")});
+    const auto recorded = path_.string() + ".out";
+
+    tcp::database db;
+    db.replay(true);
+    auto recorder = std::make_shared<wire_recorder>(recorded);
+    db.capture(recorder);
+    bool failed = false;
+    db.prepare("portal_n", "SELECT n FROM t", {})
+        .execute_portal(
+            "portal_n", params{}, 1, [](portal &cursor, results) { cursor.close(); },
+            [](transaction &) { ADD_FAILURE(); },
+            [&failed](error::db_error const &) { failed = true; });
+    wire_capture source(path_);
+    EXPECT_TRUE(tcp::replay(db).run(source).ok);
+    db.capture(nullptr);
+    db.replay(false);
+    EXPECT_TRUE(failed);
+
+    std::string       tags;
+    wire_capture      capture(recorded);
+    detail::WireFrame frame;
+    while (capture.next(frame))
+        if (frame.direction == detail::wire_direction::frontend)
+            for (std::size_t pos = 0; pos + 5 <= frame.bytes.size();) {
+                std::uint32_t length = 0;
+                for (int i = 1; i <= 4; ++i)
+                    length = (length << 8) | static_cast<unsigned char>(frame.bytes[pos + i]);
+                tags.push_back(frame.bytes[pos]);
+                pos += 1 + length;
+            }
+    std::filesystem::remove(recorded);
+    EXPECT_EQ(tags.substr(tags.find('C')), "CS");
+}
+
+/**
+ * @brief Test that a connection records what it sends and receives
+ */
+TEST_F(WireCaptureTest, RecordsTraffic) {
+    write_backend(int_answer("n", "1"));
+    const auto recorded = path_.string() + ".out";
+
+    tcp::database db;
+    db.replay(true);
+    auto recorder = std::make_shared<wire_recorder>(recorded);
+    db.capture(recorder);
+    db.execute("SELECT 1");
+    wire_capture source(path_);
+    tcp::replay(db).run(source);
+    db.capture(nullptr);
+    db.replay(false);
+    EXPECT_EQ(recorder->frames(), 5u);
+
+    // The sent query, then the four answered messages
+    wire_capture      capture(recorded);
+    detail::WireFrame frame;
+    ASSERT_TRUE(capture.next(frame));
+    EXPECT_EQ(frame.direction, detail::wire_direction::frontend);
+    EXPECT_EQ(frame.bytes.front(), 'Q');
+    EXPECT_NE(frame.bytes.find("SELECT 1"), std::string_view::npos);
+    std::string tags;
+    while (capture.next(frame)) {
+        EXPECT_EQ(frame.direction, detail::wire_direction::backend);
+        tags.push_back(frame.bytes.front());
+    }
+    EXPECT_EQ(tags, "TDCZ");
+    std::filesystem::remove(recorded);
+}
+
+/**
+ * @brief Test that an atomic block sends the external values of its statements
+ *
+ * Every sent message must match its length prefix, and the Bind of the
+ * statement must carry the borrowed value.
+ */
+TEST_F(WireCaptureTest, AtomicBlockSendsExternalParams) {
+    const auto parsed = backend_message('1', "");
+    const auto bound  = backend_message('2', "");
+    write_backend({parsed, bound, backend_message('C', std::string("BEGIN") + '\0'), parsed,
+                   bound, backend_message('C', std::string("INSERT 0 1") + '\0'), parsed,
+                   bound, backend_message('C', std::string("COMMIT") + '\0'),
+                   backend_message('Z', "I")});
+    const auto recorded = path_.string() + ".out";
+
+    const std::string borrowed(300, 'x');
+    atomic_block      block;
+    block.execute("INSERT INTO t (a, b) VALUES ($1, $2)",
+                  params{integer{7}, external_param::text(borrowed)});
+
+    tcp::database db;
+    db.replay(true);
+    auto recorder = std::make_shared<wire_recorder>(recorded);
+    db.capture(recorder);
+    std::size_t affected = 0;
+    db.atomic(std::move(block), [&affected](transaction &, std::size_t rows) { affected = rows; },
+              [](error::db_error const &) { ADD_FAILURE(); });
+    wire_capture source(path_);
+    EXPECT_TRUE(tcp::replay(db).run(source).ok);
+    db.capture(nullptr);
+    db.replay(false);
+    EXPECT_EQ(affected, 1u);
+
+    std::string       sent;
+    wire_capture      capture(recorded);
+    detail::WireFrame frame;
+    while (capture.next(frame))
+        if (frame.direction == detail::wire_direction::frontend)
+            sent.append(frame.bytes.data(), frame.bytes.size());
+    std::filesystem::remove(recorded);
+
+    std::string tags;
+    std::size_t binds_with_value = 0;
+    for (std::size_t pos = 0; pos < sent.size();) {
+        ASSERT_LE(pos + 5, sent.size());
+        std::uint32_t length = 0;
+        for (int i = 1; i <= 4; ++i)
+            length = (length << 8) | static_cast<unsigned char>(sent[pos + i]);
+        ASSERT_LE(pos + 1 + length, sent.size());
+        const std::string_view payload(sent.data() + pos + 5, length - 4);
+        if (sent[pos] == 'B' && payload.find(borrowed) != std::string_view::npos)
+            ++binds_with_value;
+        tags.push_back(sent[pos]);
+        pos += 1 + length;
+    }
+    EXPECT_EQ(tags, "PBEPBEPBES");
+    EXPECT_EQ(binds_with_value, 1u);
+}
+
+/**
+ * @brief Test that a session sends the whole catalog in one flight
+ *
+ * Pipelining is disabled, yet every catalog statement is sent before the
+ * server answers the first one.
+ */
+TEST_F(WireCaptureTest, CatalogWarmUpInOneFlight) {
+    {
+        // Authenticated, then the answers of the statements
+        wire_recorder recorder(path_);
+        const auto    ok = backend_message('R', be<std::int32_t>(0));
+        recorder.record(detail::wire_direction::backend, ok.data(), ok.size());
+        for (int i = 0; i < 3; ++i)
+            for (auto const &msg :
+                 {backend_message('1', ""), backend_message('t', be<std::int16_t>(0)),
+                  backend_message('n', ""), backend_message('Z', "I")})
+                recorder.record(detail::wire_direction::backend, msg.data(), msg.size());
+    }
+    const auto recorded = path_.string() + ".out";
+
+    auto catalog = std::make_shared<statement_catalog>();
+    for (auto const &name : {"warm_a", "warm_b", "warm_c"})
+        catalog->add(name, "SELECT 1");
+    tcp::database db;
+    db.replay(true);
+    db.catalog(catalog);
+    auto recorder = std::make_shared<wire_recorder>(recorded);
+    db.capture(recorder);
+    wire_capture source(path_);
+    // The captured authentication starts the session and its warm-up
+    EXPECT_TRUE(tcp::replay(db).run(source, replay_pacing::fast, false).ok);
+    db.capture(nullptr);
+    db.replay(false);
+
+    std::string       order;
+    wire_capture      capture(recorded);
+    detail::WireFrame frame;
+    while (capture.next(frame))
+        order.push_back(frame.direction == detail::wire_direction::frontend ? 'F' : 'B');
+    std::filesystem::remove(recorded);
+    // Authentication, the three statements, then their answers
+    EXPECT_EQ(order.substr(0, 4), "BFFF");
+    EXPECT_EQ(order.find('F', 4), std::string::npos);
+    for (auto const &statement : *catalog->snapshot())
+        EXPECT_TRUE(statement.described);
+}
@@ -165,6 +165,80 @@ TEST_F(PostgreSQLConnectionTest, ConnectionPool) {
     }
 }
 
+/**
+ * @brief Test non-blocking connection establishment
+ *
+ * Verifies that several connections opened with async_connect() progress
+ * in parallel on the event loop and can run queries once ready, while
+ * connection failures are reported to the error callback.
+ */
+TEST_F(PostgreSQLConnectionTest, AsyncConnect) {
+    constexpr int                                       num_connections = 5;
+    std::vector<std::unique_ptr<qb::pg::tcp::database>> connections;
+    int                                                 ready  = 0;
+    int                                                 failed = 0;
+
+    for (int i = 0; i < num_connections; ++i) {
+        auto conn = std::make_unique<qb::pg::tcp::database>(std::string(PGSQL_CONNECTION_STR));
+        conn->async_connect([&ready](qb::pg::tcp::database &) { ++ready; },
+                            [&failed](qb::pg::tcp::database &, qb::pg::error::db_error const &) {
+                                ++failed;
+                            });
+        ASSERT_TRUE(conn->is_connecting());
+        connections.push_back(std::move(conn));
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ready + failed < num_connections && std::chrono::steady_clock::now() < deadline)
+        qb::io::async::run_once();
+    ASSERT_EQ(ready, num_connections);
+    ASSERT_EQ(failed, 0);
+
+    for (const auto &conn : connections) {
+        ASSERT_FALSE(conn->is_connecting());
+        ASSERT_TRUE(conn->execute("SELECT 1").await());
+    }
+
+    // Authentication failures reach the error callback
+    qb::pg::tcp::database invalid_db{std::string("tcp://billy@localhost:5432[invalid]")};
+    bool                  invalid_failed = false;
+    invalid_db.async_connect(
+        [](qb::pg::tcp::database &) { ASSERT_TRUE(false) << "Connection should fail"; },
+        [&invalid_failed](qb::pg::tcp::database &, qb::pg::error::db_error const &) {
+            invalid_failed = true;
+        });
+    while (invalid_db.is_connecting() && std::chrono::steady_clock::now() < deadline)
+        qb::io::async::run_once();
+    ASSERT_TRUE(invalid_failed);
+}
+
+/**
+ * @brief Test that SCRAM keys are derived once per credential
+ *
+ * The same user, password, salt and iteration count share their keys,
+ * while any other password or salt derives new ones.
+ */
+TEST(ScramKeyCacheTest, ReuseByCredential) {
+    using qb::pg::detail::ScramKeyCache;
+    ScramKeyCache::clear();
+    const std::vector<unsigned char> salt{'s', 'a', 'l', 't'};
+
+    auto first = ScramKeyCache::keys("test", "test", salt, 4096);
+    ASSERT_EQ(first->client_key.size(), 32);
+    ASSERT_EQ(ScramKeyCache::keys("test", "test", salt, 4096), first);
+    ASSERT_EQ(ScramKeyCache::size(), 1);
+
+    auto other = ScramKeyCache::keys("test", "changed", salt, 4096);
+    ASSERT_NE(other, first);
+    ASSERT_NE(other->client_key, first->client_key);
+    ASSERT_NE(ScramKeyCache::keys("test", "test", {'p', 'e', 'p', 'p', 'e', 'r'}, 4096),
+              first);
+    ASSERT_EQ(ScramKeyCache::size(), 3);
+
+    ScramKeyCache::clear();
+    ASSERT_EQ(ScramKeyCache::size(), 0);
+}
+
 int
 main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
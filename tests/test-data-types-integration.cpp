@@ -2103,6 +2103,193 @@ TEST_F(PostgreSQLDataTypesIntegrationTest, JSONResultSetConversion) {
     ASSERT_TRUE(success);
 }
 
+/**
+ * @brief Test key lookups with a single array parameter
+ *
+ * Verifies that WHERE id = ANY($1) matches the keys of a vector, sent as
+ * one binary int8[] parameter, and that NULL elements and as_array() views
+ * are accepted.
+ */
+TEST_F(PostgreSQLDataTypesIntegrationTest, ArrayAnyLookup) {
+    auto status = db_->execute("INSERT INTO data_types_test (bigint_val, text_val) "
+                               "SELECT i, 'key_' || i FROM generate_series(1, 10) i")
+                      .prepare("lookup_bigint",
+                               "SELECT bigint_val FROM data_types_test "
+                               "WHERE bigint_val = ANY($1) ORDER BY bigint_val",
+                               {})
+                      .await();
+    ASSERT_TRUE(status);
+
+    std::vector<bigint> found;
+    const std::vector<std::optional<bigint>> keys = {2, std::nullopt, 5, 42, 9};
+    status = db_->execute(
+                    "lookup_bigint", QueryParams(keys),
+                    [&found](Transaction &, results result) {
+                        for (auto const &row : result)
+                            found.push_back(row[0].as<bigint>());
+                    },
+                    [](error::db_error error) { FAIL() << "Lookup failed: " << error.code; })
+                 .await();
+    ASSERT_TRUE(status);
+    EXPECT_EQ(found, (std::vector<bigint>{2, 5, 9}));
+
+    std::size_t count = 0;
+    const std::vector<std::string> names = {"key_1", "key_3", "missing"};
+    status = db_->execute(
+                    "SELECT id FROM data_types_test WHERE text_val = ANY($1)",
+                    QueryParams(as_array(names)),
+                    [&count](Transaction &, results result) { count = result.size(); },
+                    [](error::db_error error) { FAIL() << "Lookup failed: " << error.code; })
+                 .await();
+    ASSERT_TRUE(status);
+    EXPECT_EQ(count, 2);
+}
+
+/**
+ * @brief Test decoding of array results in the text and binary formats
+ */
+TEST_F(PostgreSQLDataTypesIntegrationTest, ArrayResults) {
+    constexpr auto query = "SELECT ARRAY[1, NULL, 3]::int4[], "
+                           "ARRAY['a,b', 'say \"hi\"', NULL]::text[], "
+                           "ARRAY[1.5, -2.25]::float8[], '{}'::int8[]";
+    auto check = [](results const &result) {
+        ASSERT_EQ(result.size(), 1);
+        auto ints = result[0][0].as<std::vector<std::optional<integer>>>();
+        ASSERT_EQ(ints.size(), 3);
+        EXPECT_EQ(ints[0], 1);
+        EXPECT_FALSE(ints[1].has_value());
+        EXPECT_EQ(ints[2], 3);
+
+        auto texts = result[0][1].as<std::vector<std::optional<std::string>>>();
+        ASSERT_EQ(texts.size(), 3);
+        EXPECT_EQ(texts[0], "a,b");
+        EXPECT_EQ(texts[1], "say \"hi\"");
+        EXPECT_FALSE(texts[2].has_value());
+
+        EXPECT_EQ(result[0][2].as<std::vector<double>>(), (std::vector<double>{1.5, -2.25}));
+        EXPECT_TRUE(result[0][3].as<std::vector<bigint>>().empty());
+        EXPECT_THROW(result[0][0].as<std::vector<integer>>(), std::runtime_error);
+    };
+
+    auto status = db_->execute(query, [&](Transaction &, results result) { check(result); })
+                      .result_format("array_binary", result_format::binary())
+                      .prepare("array_binary", query, {})
+                      .execute("array_binary",
+                               [&](Transaction &, results result) { check(result); })
+                      .await();
+    ASSERT_TRUE(status);
+}
+
+/**
+ * @brief Test the extraction of whole columns
+ *
+ * Verifies that resultset::column() gathers binary fixed-width columns and
+ * decodes text columns into the same values, with NULLs in the bitmap.
+ */
+TEST_F(PostgreSQLDataTypesIntegrationTest, ColumnExtraction) {
+    constexpr auto query =
+        "SELECT i::int4, i::int8 * 10000000000, i / 4.0::float8, "
+        "CASE WHEN i % 5 = 0 THEN NULL ELSE i::int2 END FROM generate_series(1, 100) i "
+        "ORDER BY i";
+    auto check = [](results const &result) {
+        ASSERT_EQ(result.size(), 100);
+        std::vector<integer>    ints;
+        std::vector<bigint>     bigs;
+        std::vector<double>     doubles;
+        std::vector<smallint>   smalls;
+        results::null_bitmap    nulls;
+        EXPECT_EQ(result.column(0, ints), 0);
+        EXPECT_EQ(result.column(1, bigs), 0);
+        EXPECT_EQ(result.column(2, doubles), 0);
+        EXPECT_EQ(result.column(3, smalls, &nulls), 20);
+        ASSERT_EQ(nulls.size(), 2);
+        for (integer i = 0; i < 100; ++i) {
+            const integer value = i + 1;
+            EXPECT_EQ(ints[i], value);
+            EXPECT_EQ(bigs[i], value * 10000000000LL);
+            EXPECT_DOUBLE_EQ(doubles[i], value / 4.0);
+            const bool null = value % 5 == 0;
+            EXPECT_EQ((nulls[i / 64] >> (i % 64)) & 1, null ? 1u : 0u);
+            EXPECT_EQ(smalls[i], null ? 0 : value);
+        }
+    };
+
+    auto status = db_->execute(query, [&](Transaction &, results result) { check(result); })
+                      .result_format("column_binary", result_format::binary())
+                      .prepare("column_binary", query, {})
+                      .execute("column_binary",
+                               [&](Transaction &, results result) {
+                                   check(result);
+                                   std::vector<bigint> wrong;
+                                   EXPECT_THROW(result.column(0, wrong), std::runtime_error);
+                               })
+                      .await();
+    ASSERT_TRUE(status);
+}
+
+/**
+ * @brief Test pass-through JSON parameters and fields
+ *
+ * Verifies that pre-encoded JSON is accepted by the server and that json
+ * and jsonb fields are exposed as text, in both result formats, without
+ * parsing them.
+ */
+TEST_F(PostgreSQLDataTypesIntegrationTest, JSONPassThrough) {
+    const std::string payload = R"({"id": 1, "tags": ["a", "b"]})";
+    constexpr auto    query   = "SELECT $1::json, $2::jsonb";
+
+    auto check = [&](results const &result) {
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result[0][0].as<json_view>().text, payload);
+        // jsonb is normalized by the server, without the version byte
+        EXPECT_EQ(result[0][1].as<jsonb_view>().text, payload);
+        auto lazy = result[0][1].as<lazy_json>();
+        EXPECT_FALSE(lazy.parsed());
+        EXPECT_EQ(lazy.raw(), payload);
+    };
+
+    auto status = db_->execute(query, params{json_view{payload}, jsonb_view{payload}},
+                               [&](Transaction &, results result) { check(result); })
+                      .result_format("json_views", result_format::binary())
+                      .prepare("json_views", query, {})
+                      .execute("json_views", params{json_view{payload}, jsonb_view{payload}},
+                               [&](Transaction &, results result) { check(result); })
+                      .await();
+    ASSERT_TRUE(status);
+}
+
+/**
+ * @brief Test NUMERIC values as fixed-point decimals
+ *
+ * Verifies binary and text decoding into decimal, decimal parameters and
+ * the exact text of binary NUMERIC fields beyond the decimal precision.
+ */
+TEST_F(PostgreSQLDataTypesIntegrationTest, NumericDecimal) {
+    constexpr auto query = "SELECT $1::numeric, -1234567.891::numeric(12, 3), "
+                           "(10::numeric ^ 45 + 0.5)::numeric(60, 2)";
+    const decimal  amount(1234500, 4); // 123.4500
+
+    auto check = [&](results const &result) {
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result[0][0].as<decimal>(), amount);
+        EXPECT_EQ(result[0][0].as<decimal>().scale(), 4);
+        EXPECT_EQ(result[0][1].as<decimal>().to_string(), "-1234567.891");
+        EXPECT_EQ(result[0][1].as<std::string>(), "-1234567.891");
+        EXPECT_EQ(result[0][2].as<std::string>(),
+                  "1000000000000000000000000000000000000000000000.50");
+        EXPECT_THROW(result[0][2].as<decimal>(), std::runtime_error);
+    };
+
+    auto status = db_->execute(query, params{amount},
+                               [&](Transaction &, results result) { check(result); })
+                      .result_format("numeric_decimal", result_format::binary())
+                      .prepare("numeric_decimal", query, {})
+                      .execute("numeric_decimal", params{amount},
+                               [&](Transaction &, results result) { check(result); })
+                      .await();
+    ASSERT_TRUE(status);
+}
+
 int
 main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
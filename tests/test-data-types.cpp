@@ -9,7 +9,7 @@
  *
  * - Numeric types (smallint, integer, bigint, float, double, numeric)
  * - Character types (char, varchar, text)
- * - Binary data types (bytea)
+ * - Binary data types (bytea), in the binary, hex and escape formats
  * - Date/time types (date, time, timestamp, interval)
  * - Boolean type
  * - Network address types (inet, cidr)
@@ -51,6 +51,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <random>
@@ -1153,6 +1154,55 @@ TEST_F(PostgreSQLDataTypesTest, JSONTextFormatDeserialization) {
     ASSERT_THROW(TypeConverter<qb::jsonb>::from_text(invalid_json), std::runtime_error);
 }
 
+/**
+ * @brief Test bytea values in the hex and escape text formats
+ *
+ * Sizes around the SIMD block widths exercise the vectorized paths and
+ * their scalar tails.
+ */
+TEST_F(PostgreSQLDataTypesTest, ByteaTextFormat) {
+    std::mt19937 random(42);
+    for (std::size_t size : {0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 100, 1000}) {
+        bytea value;
+        for (std::size_t i = 0; i < size; ++i)
+            value.push_back(static_cast<byte>(random()));
+
+        std::string expected = "\\x";
+        char        hex[3];
+        for (byte b : value) {
+            std::snprintf(hex, sizeof(hex), "%02x", static_cast<int>(b) & 0xFF);
+            expected += hex;
+        }
+        const std::string text = TypeConverter<bytea>::to_text(value);
+        ASSERT_EQ(text, expected) << size;
+        ASSERT_EQ(TypeConverter<bytea>::from_text(text), value) << size;
+
+        std::string upper = text;
+        std::transform(upper.begin() + 2, upper.end(), upper.begin() + 2, ::toupper);
+        ASSERT_EQ(TypeConverter<bytea>::from_text(upper), value) << size;
+
+        // An invalid digit is detected wherever it is
+        for (std::size_t i = 2; i < text.size(); i += 5) {
+            for (char invalid : {'g', 'G', '/', ':', '@', '`', ' ', '\xc1'}) {
+                std::string corrupted = text;
+                corrupted[i]          = invalid;
+                EXPECT_THROW(TypeConverter<bytea>::from_text(corrupted), std::runtime_error)
+                    << size << " at " << i;
+            }
+        }
+    }
+    EXPECT_THROW(TypeConverter<bytea>::from_text("\\xabc"), std::runtime_error);
+
+    // Escape format: octal escapes and doubled backslashes
+    const bytea escaped = TypeConverter<bytea>::from_text("a\\000b\\\\c\\377\\047");
+    EXPECT_EQ(std::string(escaped.begin(), escaped.end()),
+              std::string("a\0b\\c\xff'", 7));
+    EXPECT_EQ(TypeConverter<bytea>::from_text("plain text").size(), 10u);
+    EXPECT_TRUE(TypeConverter<bytea>::from_text("").empty());
+    for (auto invalid : {"\\", "a\\0", "\\08", "\\400", "\\n"})
+        EXPECT_THROW(TypeConverter<bytea>::from_text(invalid), std::runtime_error) << invalid;
+}
+
 int
 main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -269,6 +269,147 @@ TEST_F(PostgreSQLErrorHandlingTest, PreparedStatementParameterError) {
     EXPECT_TRUE(error_caught);
 }
 
+// Test that a query outliving the connection query timeout is cancelled
+TEST_F(PostgreSQLErrorHandlingTest, QueryTimeout) {
+    db_->query_timeout(std::chrono::milliseconds(50));
+    bool timed_out = false;
+    db_->execute(
+           "SELECT pg_sleep(2)",
+           [](Transaction &, results) { FAIL() << "Query should have timed out"; },
+           [&timed_out](error::db_error const &err) {
+               timed_out = dynamic_cast<error::query_timeout const *>(&err) != nullptr;
+               EXPECT_EQ(err.sqlstate, sqlstate::query_canceled);
+           })
+        .await();
+    ASSERT_TRUE(timed_out);
+
+    // The connection keeps serving the queue, fast queries are unaffected
+    ASSERT_TRUE(db_->execute("SELECT 1").await());
+    db_->query_timeout(std::chrono::milliseconds(0));
+}
+
+// Test that the time budget of a transaction covers all of its queries
+TEST_F(PostgreSQLErrorHandlingTest, TransactionTimeout) {
+    int  done        = 0;
+    bool timed_out   = false;
+    bool rolled_back = false;
+    db_->begin(
+           [&](Transaction &tr) {
+               tr.timeout(std::chrono::milliseconds(150));
+               for (int i = 0; i < 5; ++i)
+                   tr.execute(
+                       "SELECT pg_sleep(0.1)", [&done](Transaction &, results) { ++done; },
+                       [&timed_out](error::db_error const &err) {
+                           timed_out |=
+                               dynamic_cast<error::query_timeout const *>(&err) != nullptr;
+                       });
+           },
+           [&rolled_back](error::db_error const &) { rolled_back = true; })
+        .await();
+    ASSERT_TRUE(timed_out);
+    ASSERT_TRUE(rolled_back);
+    ASSERT_EQ(done, 1);
+    ASSERT_TRUE(db_->execute("SELECT 1").await());
+}
+
+// Test that the query in flight can be cancelled explicitly
+TEST_F(PostgreSQLErrorHandlingTest, Cancel) {
+    ASSERT_FALSE(db_->cancel());
+
+    bool canceled = false;
+    db_->execute(
+        "SELECT pg_sleep(2)",
+        [](Transaction &, results) { FAIL() << "Query should have been cancelled"; },
+        [&canceled](error::db_error const &err) {
+            canceled = err.sqlstate == sqlstate::query_canceled;
+        });
+    ASSERT_TRUE(db_->cancel());
+    db_->await();
+    ASSERT_TRUE(canceled);
+    ASSERT_TRUE(db_->execute("SELECT 1").await());
+}
+
+// Test reading error fields as views into the ErrorResponse message
+TEST(NoticeViewTest, ReadErrorResponse) {
+    using namespace std::string_literals;
+    const std::string fields = "SERROR\0C23505\0Mduplicate key value\0"
+                               "DKey (id)=(1) already exists.\0nusers_pkey\0Zignored\0\0"s;
+    std::string message(1, 'E');
+    const auto  length = qb::endian::to_big_endian(static_cast<integer>(4 + fields.size()));
+    message.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    message += fields;
+
+    message_view view(message.data(), message.size());
+    view.reset_read();
+    notice_view notice;
+    ASSERT_TRUE(view.read(notice));
+    EXPECT_EQ(notice.severity(), "ERROR");
+    EXPECT_EQ(notice.sqlstate(), "23505");
+    EXPECT_EQ(notice.message(), "duplicate key value");
+    EXPECT_EQ(notice.detail(), "Key (id)=(1) already exists.");
+    EXPECT_EQ(notice.field('n'), "users_pkey");
+    EXPECT_TRUE(notice.field('H').empty());
+    EXPECT_TRUE(notice.field('Z').empty());
+    // Views point into the message, nothing was copied
+    EXPECT_GE(notice.message().data(), message.data());
+    EXPECT_LT(notice.message().data(), message.data() + message.size());
+
+    const auto owned = notice.to_notice();
+    EXPECT_EQ(owned.constraint_name, "users_pkey");
+    EXPECT_EQ(owned.detail, "Key (id)=(1) already exists.");
+
+    EXPECT_EQ(sqlstate::code_to_state(notice.sqlstate()), sqlstate::unique_violation);
+    EXPECT_EQ(sqlstate::code_to_state("40001"), sqlstate::serialization_failure);
+    EXPECT_EQ(sqlstate::code_to_state("XX002"), sqlstate::index_corrupted);
+    EXPECT_EQ(sqlstate::code_to_state("ZZZZZ"), sqlstate::unknown_code);
+    EXPECT_EQ(sqlstate::code_to_state("2350"), sqlstate::unknown_code);
+}
+
+// Test decoding field descriptions in place and rejecting truncated ones
+TEST(MessageViewTest, ReadFieldDescription) {
+    constexpr tag_set backend{row_description_tag, data_row_tag};
+    static_assert(backend.contains(row_description_tag));
+    static_assert(!backend.contains(query_tag));
+    static_assert(backend.count(data_row_tag) == 1);
+
+    std::string body("id\0", 3);
+    const auto  append = [&body](auto value) {
+        const auto be = qb::endian::to_big_endian(value);
+        body.append(reinterpret_cast<const char *>(&be), sizeof(be));
+    };
+    append(static_cast<integer>(16384)); // table OID
+    append(static_cast<smallint>(1));    // attribute number
+    append(static_cast<integer>(23));    // type OID
+    append(static_cast<smallint>(4));    // type size
+    append(static_cast<integer>(-1));    // type modifier
+    append(static_cast<smallint>(1));    // binary format
+
+    for (size_t size = body.size(); size + 1 > 0; --size) {
+        std::string message(1, 'T');
+        const auto  length = qb::endian::to_big_endian(static_cast<integer>(4 + size));
+        message.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        message.append(body, 0, size);
+
+        message_view view(message.data(), message.size());
+        view.reset_read();
+        field_description fd{};
+        if (size < body.size()) {
+            EXPECT_FALSE(view.read(fd)) << "truncated to " << size << " bytes";
+            continue;
+        }
+        ASSERT_TRUE(view.read(fd));
+        EXPECT_EQ(view.tag(), row_description_tag);
+        EXPECT_EQ(fd.name, "id");
+        EXPECT_EQ(fd.table_oid, 16384);
+        EXPECT_EQ(fd.attribute_number, 1);
+        EXPECT_EQ(fd.type_oid, oid::int4);
+        EXPECT_EQ(fd.type_size, 4);
+        EXPECT_EQ(fd.type_mod, -1);
+        EXPECT_EQ(fd.format_code, protocol_data_format::Binary);
+        EXPECT_EQ(view.available(), 0u);
+    }
+}
+
 int
 main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,125 @@
+/**
+ * @file test-memory.cpp
+ * @brief Unit tests for the memory resources of result sets
+ *
+ * This file tests the memory tracker and the resource of the rows:
+ *
+ * - Bytes in use, high-water mark and allocations of the tracker
+ * - Rows keeping their resource when moved, copies on the default one
+ *
+ * @see qb::pg::detail::MemoryTracker
+ * @see qb::pg::detail::ResourceAllocator
+ *
+ * @author qb - C++ Actor Framework
+ * @copyright Copyright (c) 2011-2025 qb - isndev (cpp.actor)
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include "../pgsql.h"
+
+using namespace qb::pg;
+using namespace qb::pg::detail;
+
+/**
+ * @brief Test that the tracker records the bytes in use and their high-water mark
+ */
+TEST(MemoryTrackerTest, CountsUsage) {
+    memory_tracker tracker;
+    EXPECT_EQ(tracker.upstream(), std::pmr::get_default_resource());
+    void *first  = tracker.allocate(100);
+    void *second = tracker.allocate(50, 16);
+    EXPECT_EQ(tracker.in_use(), 150u);
+    EXPECT_EQ(tracker.allocations(), 2u);
+    tracker.deallocate(first, 100);
+    EXPECT_EQ(tracker.in_use(), 50u);
+    EXPECT_EQ(tracker.peak(), 150u);
+    tracker.reset_peak();
+    EXPECT_EQ(tracker.peak(), 50u);
+    tracker.deallocate(second, 50, 16);
+    EXPECT_EQ(tracker.in_use(), 0u);
+
+    memory_tracker other;
+    EXPECT_TRUE(tracker.is_equal(tracker));
+    EXPECT_FALSE(tracker.is_equal(other));
+}
+
+/**
+ * @brief Test that rows stay on their resource when moved, and copies do not
+ */
+TEST(MemoryTrackerTest, ResultRowsFollowTheirResource) {
+    std::string row(1, 'D');
+    std::string body;
+    const auto  append = [&body](auto value) {
+        const auto be = qb::endian::to_big_endian(value);
+        body.append(reinterpret_cast<const char *>(&be), sizeof(be));
+    };
+    append(static_cast<smallint>(2));
+    append(static_cast<integer>(2));
+    body += "41";
+    append(static_cast<integer>(-1));
+    const auto length = qb::endian::to_big_endian(static_cast<integer>(4 + body.size()));
+    row.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    row += body;
+
+    memory_tracker tracker;
+    result_impl    rows(&tracker);
+    EXPECT_EQ(rows.memory_resource(), &tracker);
+    for (int i = 0; i < 3; ++i) {
+        message_view view(row.data(), row.size());
+        view.reset_read();
+        ASSERT_TRUE(rows.append_row(view));
+    }
+    const auto used        = tracker.in_use();
+    const auto allocations = tracker.allocations();
+    EXPECT_GE(used, rows.memory_size());
+
+    // Moving hands the storage over, with its resource
+    result_impl kept;
+    kept = std::move(rows);
+    EXPECT_EQ(kept.memory_resource(), &tracker);
+    EXPECT_EQ(tracker.in_use(), used);
+    EXPECT_EQ(tracker.allocations(), allocations);
+
+    // Copies are allocated from the default resource
+    const result_impl copy(kept);
+    EXPECT_EQ(copy.memory_resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(tracker.allocations(), allocations);
+    EXPECT_EQ(copy.view(2, 0), "41");
+
+    // Moving the rows to another resource releases the tracked memory
+    kept.memory_resource(nullptr);
+    EXPECT_EQ(kept.memory_resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(tracker.in_use(), 0u);
+    ASSERT_EQ(kept.size(), 3u);
+    EXPECT_EQ(kept.view(1, 0), "41");
+    EXPECT_TRUE(kept.is_null(1, 1));
+}
+
+/**
+ * @brief Test that the data slab refuses rows its 32-bit field offsets cannot address
+ */
+TEST(MemoryTrackerTest, ResultRowsStayAddressable) {
+    const result_impl rows;
+    EXPECT_TRUE(rows.fits(0));
+    EXPECT_TRUE(rows.fits(result_impl::max_data_size));
+    EXPECT_FALSE(rows.fits(result_impl::max_data_size + 1));
+}
+
+int
+main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -10,6 +10,7 @@
  * - Vector/array types (numeric arrays, string arrays)
  * - Empty values/NULL handling
  * - Special value representations (NaN, Infinity)
+ * - In-place parsing of text numbers, booleans and UUIDs
  * - Mixed parameter collections
  *
  * The implementation validates parameter serialization by checking proper OID
@@ -22,6 +23,7 @@
  * - Proper handling of array dimensions and boundaries
  * - NULL value serialization
  * - Vector/array type serialization for various element types
+ * - Array NULL elements, as_array() views and the array text format
  * - Interaction between different parameter types in mixed collections
  *
  * @see qb::pg::detail::param_serializer
@@ -1405,6 +1407,101 @@ TEST_F(ParamSerializerTest, DifferentNumericVectorTypes) {
     ASSERT_EQ(serializer->param_types()[0], 1021); // float4[] OID
 }
 
+/**
+ * @brief Tests the binary layout of arrays with NULL elements
+ *
+ * Verifies the array header (dimensions, has-null flag, element OID,
+ * size, lower bound) and that std::nullopt elements are sent as NULL.
+ */
+TEST_F(ParamSerializerTest, ArrayWithNullElements) {
+    std::vector<std::optional<integer>> values = {7, std::nullopt, 9};
+    serializer->serialize_params(values);
+    ASSERT_EQ(serializer->param_count(), 1);
+    ASSERT_EQ(serializer->param_types()[0], 1007); // int4[] OID
+
+    auto &buffer = serializer->params_buffer();
+    // 20 bytes of header, two 8 bytes elements and one NULL element
+    ASSERT_EQ(extractIntFromBuffer<integer>(buffer, 2), 20 + 8 + 4 + 8);
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 6), 1);   // dimensions
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 10), 1);  // has nulls
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 14), 23); // element OID
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 18), 3);  // size
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 22), 1);  // lower bound
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 26), 4);
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 30), 7);
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 34), -1);
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 38), 4);
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, 42), 9);
+
+    // The encoding decodes back to the same elements
+    std::string_view data(buffer.data() + 6, buffer.size() - 6);
+    EXPECT_EQ(TypeConverter<decltype(values)>::from_binary(data), values);
+}
+
+/**
+ * @brief Tests that array dimensions whose product overflows are rejected
+ *
+ * Four dimensions of 65536 elements wrap a 64-bit count to zero, which
+ * would read as an empty array.
+ */
+TEST_F(ParamSerializerTest, ArrayDimensionsOverflow) {
+    std::string data;
+    auto        put = [&data](integer value) {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            data.push_back(static_cast<char>((static_cast<uinteger>(value) >> shift) & 0xFF));
+    };
+    put(4);  // dimensions
+    put(0);  // has nulls
+    put(23); // element OID
+    for (int i = 0; i < 4; ++i) {
+        put(65536); // size
+        put(1);     // lower bound
+    }
+    EXPECT_THROW(TypeConverter<std::vector<integer>>::from_binary(data), std::runtime_error);
+}
+
+/**
+ * @brief Tests arrays sent through as_array() views
+ *
+ * Verifies that a string vector is sent as a single text[] parameter and
+ * that an empty view is sent as an empty array rather than NULL.
+ */
+TEST_F(ParamSerializerTest, ArrayViews) {
+    std::vector<std::string> names = {"one", "two"};
+    std::vector<double>      empty;
+    serializer->serialize_params(as_array(names), as_array(empty));
+    ASSERT_EQ(serializer->param_count(), 2);
+    ASSERT_EQ(serializer->param_types()[0], 1009); // text[] OID
+    ASSERT_EQ(serializer->param_types()[1], 1022); // float8[] OID
+
+    auto &buffer = serializer->params_buffer();
+    const auto first = extractIntFromBuffer<integer>(buffer, 2);
+    ASSERT_EQ(first, 20 + 7 + 7);
+    // Empty array: no dimension, no nulls, element OID
+    const size_t second = 2 + 4 + first;
+    ASSERT_EQ(extractIntFromBuffer<integer>(buffer, second), 12);
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, second + 4), 0);
+    EXPECT_EQ(extractIntFromBuffer<integer>(buffer, second + 12), 701);
+}
+
+/**
+ * @brief Tests the text format of arrays
+ */
+TEST_F(ParamSerializerTest, ArrayTextFormat) {
+    using text_array = std::vector<std::optional<std::string>>;
+    const text_array values = {"a,b", "say \"hi\"", std::nullopt, ""};
+    const auto       text   = TypeConverter<text_array>::to_text(values);
+    EXPECT_EQ(text, R"({"a,b","say \"hi\"",NULL,""})");
+    EXPECT_EQ(TypeConverter<text_array>::from_text(text), values);
+
+    EXPECT_EQ(TypeConverter<std::vector<integer>>::from_text("[0:3]={{1, 2},{3,4}}"),
+              (std::vector<integer>{1, 2, 3, 4}));
+    EXPECT_TRUE(TypeConverter<std::vector<integer>>::from_text("{}").empty());
+    EXPECT_THROW(TypeConverter<std::vector<integer>>::from_text("{1,NULL}"),
+                 std::runtime_error);
+    EXPECT_THROW(TypeConverter<std::vector<integer>>::from_text("{1,2"), std::runtime_error);
+}
+
 /**
  * @brief Test binary data serialization with UUID-related data
  *
@@ -1578,6 +1675,218 @@ TEST_F(ParamSerializerTest, TimestampTextFormat) {
     ASSERT_EQ(result, timestampStr);
 }
 
+/**
+ * @brief Test the arithmetic timestamp conversions
+ *
+ * Verifies text parsing with fractions and time zones, text formatting as
+ * UTC wall-clock times and exact binary round trips, independent of TZ.
+ */
+TEST_F(ParamSerializerTest, TimestampConversions) {
+    // 2023-01-15 12:34:56.789 UTC
+    const auto expected = qb::Timestamp::from_seconds(1673786096) +
+                          qb::Timespan::from_microseconds(789000);
+
+    EXPECT_EQ(TypeConverter<qb::Timestamp>::from_text("2023-01-15 12:34:56.789"), expected);
+    EXPECT_EQ(TypeConverter<qb::Timestamp>::to_text(expected), "2023-01-15 12:34:56.789000");
+    EXPECT_EQ(qb::Timestamp(TypeConverter<qb::UtcTimestamp>::from_text(
+                  "2023-01-15 14:34:56.789+02")),
+              expected);
+    EXPECT_EQ(qb::Timestamp(TypeConverter<qb::UtcTimestamp>::from_text(
+                  "2023-01-15T07:04:56.789-05:30")),
+              expected);
+    EXPECT_EQ(TypeConverter<qb::UtcTimestamp>::to_text(qb::UtcTimestamp(expected)),
+              "2023-01-15 12:34:56.789000+00");
+
+    // Dates before the Unix epoch and the PostgreSQL epoch
+    const auto before = TypeConverter<qb::Timestamp>::from_text("1969-12-31 23:59:59.5");
+    EXPECT_EQ(before.nanoseconds(), -500000000LL);
+    EXPECT_EQ(TypeConverter<qb::Timestamp>::to_text(before), "1969-12-31 23:59:59.500000");
+    EXPECT_EQ(TypeConverter<qb::Timestamp>::from_text("2000-01-01"),
+              qb::Timestamp::from_seconds(946684800));
+    EXPECT_EQ(TypeConverter<qb::Timestamp>::to_text(
+                  TypeConverter<qb::Timestamp>::from_text("2024-02-29 00:00:00")),
+              "2024-02-29 00:00:00");
+
+    std::vector<byte> buffer;
+    TypeConverter<qb::Timestamp>::to_binary(before, buffer);
+    ASSERT_EQ(buffer.size(), 12);
+    EXPECT_EQ(extractIntFromBuffer<int64_t>(buffer, 4), -946684800500000LL);
+    EXPECT_EQ(TypeConverter<qb::Timestamp>::from_binary(buffer), before);
+
+    for (auto invalid : {"2023-02-29 00:00:00", "2023-13-01", "2023-01-15 12:34:56.",
+                         "2023-01-15 25:00:00", "2023-01-15 12:34:56 UTC", "now"})
+        EXPECT_THROW(TypeConverter<qb::Timestamp>::from_text(invalid), std::runtime_error)
+            << invalid;
+}
+
+/**
+ * @brief Test the in-place parsing of text numbers, booleans and UUIDs
+ *
+ * Verifies the values and limits of each type, the special floating-point
+ * values and the rejection of partial or out-of-range texts.
+ */
+TEST_F(ParamSerializerTest, TextDecoding) {
+    EXPECT_EQ(TypeConverter<smallint>::from_text("-32768"), -32768);
+    EXPECT_EQ(TypeConverter<integer>::from_text("+2147483647"), 2147483647);
+    EXPECT_EQ(TypeConverter<bigint>::from_text("-9223372036854775808"),
+              std::numeric_limits<bigint>::min());
+    EXPECT_THROW(TypeConverter<smallint>::from_text("32768"), std::out_of_range);
+    EXPECT_THROW(TypeConverter<integer>::from_text("2147483648"), std::out_of_range);
+    for (auto invalid : {"", "+", "+-1", "12abc", " 12", "1.5", "0x10"})
+        EXPECT_THROW(TypeConverter<integer>::from_text(invalid), std::invalid_argument)
+            << invalid;
+
+    EXPECT_DOUBLE_EQ(TypeConverter<double>::from_text("-1.25e-3"), -0.00125);
+    EXPECT_DOUBLE_EQ(TypeConverter<double>::from_text("123456.789"), 123456.789);
+    EXPECT_FLOAT_EQ(TypeConverter<float>::from_text("3.14159"), 3.14159f);
+    EXPECT_TRUE(std::isnan(TypeConverter<double>::from_text("NaN")));
+    EXPECT_EQ(TypeConverter<double>::from_text("Infinity"),
+              std::numeric_limits<double>::infinity());
+    EXPECT_EQ(TypeConverter<float>::from_text("-Infinity"),
+              -std::numeric_limits<float>::infinity());
+    EXPECT_THROW(TypeConverter<double>::from_text("1e999"), std::out_of_range);
+    for (auto invalid : {"", "-", "1.5x", "--1", "abc"})
+        EXPECT_THROW(TypeConverter<double>::from_text(invalid), std::invalid_argument)
+            << invalid;
+
+    for (auto truthy : {"t", "true", "TRUE", "y", "yes", "on", "1"})
+        EXPECT_TRUE(TypeConverter<bool>::from_text(truthy)) << truthy;
+    for (auto falsy : {"f", "false", "n", "no", "off", "0", ""})
+        EXPECT_FALSE(TypeConverter<bool>::from_text(falsy)) << falsy;
+
+    const std::array<uint8_t, 16> expected{0xa0, 0xee, 0xbc, 0x99, 0x9c, 0x0b, 0x4e, 0xf8,
+                                           0xbb, 0x6d, 0x6b, 0xb9, 0xbd, 0x38, 0x0a, 0x11};
+    for (auto text : {"a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11",
+                      "A0EEBC99-9C0B-4EF8-BB6D-6BB9BD380A11",
+                      "{a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11}",
+                      "a0eebc999c0b4ef8bb6d6bb9bd380a11",
+                      "a0ee-bc99-9c0b-4ef8-bb6d-6bb9-bd38-0a11"}) {
+        std::array<uint8_t, 16> bytes{};
+        EXPECT_TRUE(TextCodec::to_uuid(text, bytes)) << text;
+        EXPECT_EQ(bytes, expected) << text;
+        EXPECT_EQ(TypeConverter<qb::uuid>::from_text(text).as_bytes(), expected) << text;
+    }
+    for (auto invalid : {"", "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a1",
+                         "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11-",
+                         "-a0eebc999c0b4ef8bb6d6bb9bd380a11",
+                         "a0eebc99--9c0b-4ef8-bb6d-6bb9bd380a11",
+                         "a0eeb-c999c0b4ef8bb6d6bb9bd380a11",
+                         "g0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11",
+                         "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11aa"}) {
+        std::array<uint8_t, 16> bytes{};
+        EXPECT_FALSE(TextCodec::to_uuid(invalid, bytes)) << invalid;
+    }
+    EXPECT_THROW(TypeConverter<qb::uuid>::from_text("not-a-uuid"), std::runtime_error);
+}
+
+/**
+ * @brief Test pre-encoded JSON parameters and unparsed JSON fields
+ *
+ * Verifies that JSON text is sent without re-encoding, with the jsonb
+ * version byte for jsonb, and read back from both binary encodings.
+ */
+TEST_F(ParamSerializerTest, JSONViews) {
+    const std::string payload = R"({"id":1,"tags":["a","b"]})";
+
+    serializer->add_param(json_view{payload});
+    serializer->add_param(jsonb_view{payload});
+    ASSERT_EQ(serializer->param_count(), 2);
+    ASSERT_EQ(serializer->param_types()[0], static_cast<integer>(oid::json));
+    ASSERT_EQ(serializer->param_types()[1], static_cast<integer>(oid::jsonb));
+
+    auto &buffer = serializer->params_buffer();
+    ASSERT_EQ(extractIntFromBuffer<integer>(buffer, 0), payload.size());
+    EXPECT_EQ(extractStringFromBuffer(buffer, sizeof(integer), payload.size()), payload);
+    const auto jsonb_offset = sizeof(integer) + payload.size();
+    ASSERT_EQ(extractIntFromBuffer<integer>(buffer, jsonb_offset), payload.size() + 1);
+    EXPECT_EQ(buffer[jsonb_offset + sizeof(integer)], 1);
+    EXPECT_EQ(extractStringFromBuffer(buffer, jsonb_offset + sizeof(integer) + 1,
+                                      payload.size()),
+              payload);
+
+    const std::string binary_jsonb = std::string(1, '\x01') + payload;
+    EXPECT_EQ(TypeConverter<jsonb_view>::from_binary(std::string_view(binary_jsonb)).text,
+              payload);
+    EXPECT_EQ(TypeConverter<json_view>::from_binary(std::string_view(payload)).text, payload);
+    EXPECT_EQ(TypeConverter<json_view>::from_text(payload).text, payload);
+
+    lazy_json lazy = TypeConverter<lazy_json>::from_text(payload);
+    EXPECT_EQ(lazy.raw(), payload);
+    EXPECT_FALSE(lazy.parsed());
+}
+
+namespace {
+
+/**
+ * @brief Builds a binary NUMERIC value, without its length
+ */
+std::string
+numeric_binary(int16_t weight, uint16_t sign, uint16_t dscale, std::vector<uint16_t> digits) {
+    std::string out;
+    auto put = [&out](uint16_t value) {
+        out += static_cast<char>(value >> 8);
+        out += static_cast<char>(value & 0xFF);
+    };
+    put(static_cast<uint16_t>(digits.size()));
+    put(static_cast<uint16_t>(weight));
+    put(sign);
+    put(dscale);
+    for (auto digit : digits)
+        put(digit);
+    return out;
+}
+
+} // namespace
+
+/**
+ * @brief Test the binary NUMERIC codec
+ *
+ * Verifies decoding of base-10000 digit groups into fixed-point decimals,
+ * encoding back to the same groups and the exact text fallback.
+ */
+TEST_F(ParamSerializerTest, NumericBinaryFormat) {
+    struct Case {
+        std::string text;
+        std::string binary;
+    };
+    const std::vector<Case> cases = {
+        {"123.45", numeric_binary(0, 0x0000, 2, {123, 4500})},
+        {"0.0001", numeric_binary(-1, 0x0000, 4, {1})},
+        {"10000", numeric_binary(1, 0x0000, 0, {1})},
+        {"-1234567.891", numeric_binary(1, 0x4000, 3, {123, 4567, 8910})},
+        {"0.00", numeric_binary(0, 0x0000, 2, {})},
+        {"0.000000012", numeric_binary(-2, 0x0000, 9, {1, 2000})},
+    };
+    for (auto const &c : cases) {
+        const auto value = TypeConverter<decimal>::from_binary(std::string_view(c.binary));
+        EXPECT_EQ(value.to_string(), c.text);
+        EXPECT_EQ(value, decimal::parse(c.text));
+        EXPECT_EQ(NumericCodec::to_text(c.binary), c.text);
+
+        std::vector<byte> buffer;
+        TypeConverter<decimal>::to_binary(value, buffer);
+        ASSERT_EQ(extractIntFromBuffer<integer>(buffer, 0), c.binary.size()) << c.text;
+        EXPECT_EQ(std::string(buffer.data() + 4, buffer.size() - 4), c.binary) << c.text;
+    }
+
+    EXPECT_EQ(decimal(12345, 2).rescale(1), decimal(1235, 1));
+    EXPECT_EQ(decimal(-12345, 2).rescale(0), decimal(-123, 0));
+    EXPECT_EQ(decimal(15, 1).rescale(3).unscaled(), 1500);
+    EXPECT_DOUBLE_EQ(decimal(-12345, 2).to_double(), -123.45);
+
+    // Non-finite values and precision beyond the Decimal representation
+    EXPECT_EQ(NumericCodec::to_text(numeric_binary(0, 0xC000, 0, {})), "NaN");
+    EXPECT_THROW(TypeConverter<decimal>::from_binary(
+                     std::string_view(numeric_binary(0, 0xD000, 0, {}))),
+                 std::runtime_error);
+    const auto huge = numeric_binary(12, 0x0000, 0, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13});
+    EXPECT_THROW(TypeConverter<decimal>::from_binary(std::string_view(huge)),
+                 std::runtime_error);
+    EXPECT_EQ(NumericCodec::to_text(huge),
+              "1000200030004000500060007000800090010001100120013");
+    EXPECT_THROW(decimal::parse("12a"), std::runtime_error);
+}
+
 /**
  * @brief Test serialization of JSON objects
  *
@@ -1741,6 +2050,84 @@ TEST_F(ParamSerializerTest, ComplexJSONSerialization) {
     }
 }
 
+/**
+ * @brief Tests the compile-time encoding of typed statement parameters
+ *
+ * The typed encoder produces the same Bind parameters as QueryParams, from
+ * parameter OIDs known at compile time.
+ */
+TEST_F(ParamSerializerTest, TypedStatementEncoding) {
+    using insert_type = qb::pg::prepared<void(qb::pg::integer, std::string_view,
+                                              std::optional<qb::pg::bigint>, bool, double)>;
+    static_assert(insert_type::arity == 5);
+    static_assert(insert_type::param_types[0] == qb::pg::oid::int4);
+    static_assert(insert_type::param_types[1] == qb::pg::oid::text);
+    static_assert(insert_type::param_types[2] == qb::pg::oid::int8);
+    static_assert(insert_type::param_types[3] == qb::pg::oid::boolean);
+    static_assert(insert_type::fixed_size == 0);
+
+    auto typed = insert_type::encode(42, "John Doe", std::nullopt, true, 95.5);
+    qb::pg::detail::QueryParams generic(qb::pg::integer{42}, std::string("John Doe"),
+                                        std::optional<qb::pg::bigint>{}, true, 95.5);
+    ASSERT_EQ(typed.param_count(), 5);
+    ASSERT_EQ(typed.get(), generic.get());
+
+    // Fixed-width parameters are sized at compile time
+    using fixed_type = qb::pg::prepared<void(qb::pg::smallint, qb::pg::bigint)>;
+    static_assert(fixed_type::fixed_size == 2 + (4 + 2) + (4 + 8));
+    auto fixed = fixed_type::encode(-7, 1234567890123LL);
+    ASSERT_EQ(fixed.get().size(), fixed_type::fixed_size);
+    ASSERT_EQ(fixed.get(), qb::pg::detail::QueryParams(qb::pg::smallint{-7},
+                                                       qb::pg::bigint{1234567890123LL})
+                               .get());
+}
+
+/**
+ * @brief Tests parameters referencing caller-owned memory
+ *
+ * External values are left out of the serialized buffer, and gathered back
+ * into the exact layout of the same values serialized by copy.
+ */
+TEST_F(ParamSerializerTest, ExternalParams) {
+    auto blob = std::make_shared<std::vector<unsigned char>>(100000);
+    for (size_t i = 0; i < blob->size(); ++i)
+        (*blob)[i] = static_cast<unsigned char>(i * 7);
+    std::string const text = "borrowed text";
+
+    qb::pg::detail::QueryParams external(qb::pg::integer{1}, qb::pg::external_param::bytea(blob),
+                                         qb::pg::external_param::text(text), true);
+    qb::pg::detail::QueryParams copied(
+        qb::pg::integer{1}, std::vector<unsigned char>(*blob), std::string_view(text), true);
+
+    ASSERT_TRUE(external.has_external());
+    ASSERT_FALSE(copied.has_external());
+    ASSERT_EQ(external.param_count(), 4);
+    ASSERT_EQ(external.param_types(), copied.param_types());
+    // Only the length prefixes of the external values are serialized
+    ASSERT_EQ(external.get().size() + blob->size() + text.size(), copied.get().size());
+    ASSERT_EQ(external.size(), copied.get().size());
+
+    // The large value is handed to the sink as is, without any copy
+    std::vector<byte> gathered;
+    bool              referenced = false;
+    external.gather([&](std::string_view fragment) {
+        referenced |= fragment.data() == reinterpret_cast<const byte *>(blob->data());
+        gathered.insert(gathered.end(), fragment.begin(), fragment.end());
+    });
+    ASSERT_TRUE(referenced);
+    ASSERT_EQ(gathered, copied.get());
+
+    // The shared value is kept alive by the parameter set
+    std::weak_ptr<std::vector<unsigned char>> alive = blob;
+    blob.reset();
+    ASSERT_FALSE(alive.expired());
+
+    external.inline_external();
+    ASSERT_FALSE(external.has_external());
+    ASSERT_EQ(external.get(), copied.get());
+    ASSERT_TRUE(alive.expired());
+}
+
 int
 main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
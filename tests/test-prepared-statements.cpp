@@ -45,8 +45,12 @@
  */
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string_view>
+#include <thread>
 #include "../pgsql.h"
 #include <filesystem>
 #include <fstream>
@@ -786,7 +790,7 @@ TEST_F(PostgreSQLPreparedStatementsTest, AsyncPerformanceComparison) {
     int row_count = 0;
     status        = db_->execute("SELECT COUNT(*) FROM test_prepared",
                                  [&row_count](Transaction &tr, results result) {
-                              row_count = result[0][0].as<int>();
+                              row_count = result[0][0].as<int64_t>();
                           })
                  .await();
     ASSERT_TRUE(status);
@@ -1258,6 +1262,393 @@ TEST_F(PostgreSQLPreparedStatementsTest, PrepareFromFile) {
     std::filesystem::remove(temp_file3);
 }
 
+/**
+ * @brief Test chunked fetch of a prepared statement over a named portal
+ *
+ * Verifies that rows are delivered in chunks of the requested size, that
+ * the next chunk is only fetched on demand and that closing the portal
+ * early leaves the connection usable.
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, PortalChunkedFetch) {
+    auto status = db_->prepare("test_series", "SELECT generate_series(1, $1)",
+                               {oid::int4})
+                      .await();
+    ASSERT_TRUE(status);
+
+    std::vector<std::size_t> chunks;
+    int                      expected = 1;
+    bool                     done     = false;
+    status                            = db_->execute_portal(
+                         "test_series", params{25}, 10,
+                         [&](portal &p, results chunk) {
+                             chunks.push_back(chunk.size());
+                             for (auto const &row : chunk)
+                                 ASSERT_EQ(row[0].as<int>(), expected++);
+                             p.fetch();
+                         },
+                         [&done](Transaction &) { done = true; },
+                         [](error::db_error error) {
+                             ASSERT_TRUE(false) << "Portal fetch failed: " << error.what();
+                         })
+                      .await();
+    ASSERT_TRUE(status);
+    ASSERT_TRUE(done);
+    ASSERT_EQ(chunks, (std::vector<std::size_t>{10, 10, 5}));
+
+    // Closing after the first chunk stops the fetch
+    int delivered = 0;
+    done          = false;
+    status        = db_->execute_portal(
+                    "test_series", params{1000}, 100,
+                    [&delivered](portal &p, results chunk) {
+                        delivered += static_cast<int>(chunk.size());
+                        ASSERT_TRUE(p.suspended());
+                        p.close();
+                    },
+                    [&done](Transaction &) { done = true; })
+                 .execute("SELECT 1")
+                 .await();
+    ASSERT_TRUE(status);
+    ASSERT_TRUE(done);
+    ASSERT_EQ(delivered, 100);
+}
+
+/**
+ * @brief Test batch execution of a prepared statement
+ *
+ * Verifies that every parameter set is executed in one round trip, that the
+ * affected row count is reported and that a failing batch is rolled back.
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, ExecuteBatch) {
+    auto status = db_->prepare("test_batch_insert",
+                               "INSERT INTO test_prepared (value) VALUES ($1)",
+                               {oid::text})
+                      .await();
+    ASSERT_TRUE(status);
+
+    std::vector<params> batch;
+    for (int i = 0; i < 100; ++i)
+        batch.emplace_back(std::string("batch_") + std::to_string(i));
+
+    std::size_t affected = 0;
+    status               = db_->execute_batch(
+                     "test_batch_insert", std::move(batch),
+                     [&affected](Transaction &, std::size_t rows) { affected = rows; },
+                     [](error::db_error error) {
+                         ASSERT_TRUE(false) << "Batch failed: " << error.what();
+                     })
+                  .await();
+    ASSERT_TRUE(status);
+    ASSERT_EQ(affected, 100);
+
+    // A failing execution rolls back the whole batch
+    status = db_->prepare("test_batch_id",
+                          "INSERT INTO test_prepared (id, value) VALUES ($1, 'dup')",
+                          {oid::int4})
+                 .await();
+    ASSERT_TRUE(status);
+
+    std::vector<params> failing;
+    failing.emplace_back(100000);
+    failing.emplace_back(100000);
+    bool error_called = false;
+    db_->execute_batch(
+           "test_batch_id", std::move(failing),
+           [](Transaction &) { ASSERT_TRUE(false) << "Batch should have failed"; },
+           [&error_called](error::db_error const &) { error_called = true; })
+        .await();
+    ASSERT_TRUE(error_called);
+
+    int64_t count = -1;
+    status    = db_->execute("SELECT count(*) FROM test_prepared WHERE value = 'dup'",
+                             [&count](Transaction &, results result) {
+                                 count = result[0][0].as<int64_t>();
+                             })
+                 .await();
+    ASSERT_TRUE(status);
+    ASSERT_EQ(count, 0);
+}
+
+/**
+ * @brief Test execution of a prepared statement by handle
+ *
+ * Verifies that a handle can be taken right after prepare(), that it
+ * executes the statement like its name does and that an unknown name
+ * yields an invalid handle which fails to execute.
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, ExecuteByHandle) {
+    db_->prepare("test_handle_insert", "INSERT INTO test_prepared (value) VALUES ($1)",
+                 {oid::text});
+    const statement insert = db_->statement("test_handle_insert");
+    ASSERT_TRUE(insert.valid());
+    ASSERT_EQ(db_->statement("test_handle_insert"), insert);
+
+    auto status = db_->execute(insert, params{std::string("handle1")})
+                      .execute(insert, params{std::string("handle2")})
+                      .await();
+    ASSERT_TRUE(status);
+
+    int64_t count = -1;
+    status        = db_->execute("SELECT count(*) FROM test_prepared WHERE value LIKE 'handle%'",
+                                 [&count](Transaction &, results result) {
+                                     count = result[0][0].as<int64_t>();
+                                 })
+                 .await();
+    ASSERT_TRUE(status);
+    ASSERT_EQ(count, 2);
+
+    const statement unknown = db_->statement("test_handle_unknown");
+    ASSERT_FALSE(unknown.valid());
+    bool error_called = false;
+    db_->execute(
+           unknown, params{},
+           [](Transaction &) { ASSERT_TRUE(false) << "Unknown handle should fail"; },
+           [&error_called](error::db_error const &) { error_called = true; })
+        .await();
+    ASSERT_TRUE(error_called);
+}
+
+/**
+ * @brief Test statements shared through a catalog
+ *
+ * The first connection describes the statement and records its types and
+ * row description; the next one prepares it at connection time without
+ * Describe and executes it without preparing it itself.
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, SharedCatalog) {
+    auto catalog = std::make_shared<statement_catalog>();
+    catalog->add("test_catalog_next", "SELECT $1::int + 1 AS next");
+    ASSERT_THROW(catalog->add("test_catalog_next", "SELECT 1"), std::runtime_error);
+
+    ASSERT_TRUE(db_->catalog(catalog).await());
+    auto learned = catalog->snapshot();
+    ASSERT_EQ(learned->size(), 1u);
+    ASSERT_TRUE(learned->front().described);
+    ASSERT_EQ(learned->front().query.param_types, type_oid_sequence{oid::int4});
+    ASSERT_EQ(learned->front().query.row_description.size(), 1u);
+
+    qb::pg::tcp::database other;
+    other.catalog(catalog);
+    ASSERT_TRUE(other.connect(PGSQL_CONNECTION_STR.data()));
+    int next = 0;
+    auto status = other.execute("test_catalog_next", params{41},
+                                [&next](Transaction &, results result) {
+                                    next = result[0][0].as<int>();
+                                })
+                      .await();
+    ASSERT_TRUE(status);
+    ASSERT_EQ(next, 42);
+    ASSERT_EQ(catalog->snapshot(), learned);
+    other.disconnect();
+}
+
+/**
+ * @brief Row of the typed statement test, bound to its columns by name
+ */
+struct typed_row {
+    int                        id{0};
+    std::optional<std::string> value;
+
+    static constexpr auto columns =
+        std::make_tuple(column("id", &typed_row::id), column("value", &typed_row::value));
+};
+
+/**
+ * @brief Test statements typed at compile time
+ *
+ * Parameter types are sent with the Parse message and rows decode into
+ * tuples, single columns or structures.
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, TypedStatements) {
+    static const prepared<void(std::string_view)> insert{
+        "test_typed_insert", "INSERT INTO test_prepared (value) VALUES ($1)"};
+    static const prepared<std::tuple<int, std::string>(std::string_view)> find{
+        "test_typed_find", "SELECT id, value FROM test_prepared WHERE value = $1"};
+    static const prepared<int64_t()> count{"test_typed_count",
+                                           "SELECT count(*) FROM test_prepared"};
+    static const prepared<typed_row(int)> by_id{
+        "test_typed_by_id", "SELECT id, value FROM test_prepared WHERE id = $1"};
+
+    std::vector<std::tuple<int, std::string>> found;
+    int64_t                                   total = -1;
+    std::vector<typed_row>                    rows;
+    auto status = db_->prepare(insert)
+                      .prepare(find)
+                      .prepare(count)
+                      .prepare(by_id)
+                      .execute(insert("typed1"))
+                      .execute(insert("typed2"))
+                      .execute(find("typed2"),
+                               [&](Transaction &tr, std::vector<std::tuple<int, std::string>> r) {
+                                   found = std::move(r);
+                                   ASSERT_EQ(found.size(), 1u);
+                                   tr.execute(by_id(std::get<0>(found[0])),
+                                              [&](Transaction &, std::vector<typed_row> r) {
+                                                  rows = std::move(r);
+                                              });
+                               })
+                      .execute(count(), [&](Transaction &, std::vector<int64_t> r) {
+                          ASSERT_EQ(r.size(), 1u);
+                          total = r[0];
+                      })
+                      .await();
+    ASSERT_TRUE(status);
+    ASSERT_EQ(std::get<1>(found[0]), "typed2");
+    ASSERT_EQ(rows.size(), 1u);
+    ASSERT_EQ(rows[0].id, std::get<0>(found[0]));
+    ASSERT_EQ(rows[0].value, "typed2");
+    ASSERT_GE(total, 2);
+    ASSERT_EQ(db_->row_description(db_->statement("test_typed_find")).size(), 2u);
+}
+
+/**
+ * @brief Test the read-through result cache of prepared statements
+ *
+ * Hits are served without a round trip until a NOTIFY on a tag of the
+ * statement or the expiry of the entry; transaction blocks bypass the cache.
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, ResultCache) {
+    auto status = db_->execute("INSERT INTO test_prepared (value) VALUES ('cached')")
+                      .prepare("test_cached", "SELECT value FROM test_prepared WHERE id = $1",
+                               {oid::int4})
+                      .await();
+    ASSERT_TRUE(status);
+    db_->cache_results("test_cached", std::chrono::seconds(60), {"test_cache_tag"});
+    ASSERT_TRUE(db_->await());
+
+    std::string value;
+    auto        lookup = [&](Transaction &, results result) {
+        value = result[0][0].as<std::string>();
+    };
+    auto const &cache = *db_->result_cache();
+
+    ASSERT_TRUE(db_->execute("test_cached", params{1}, lookup).await());
+    EXPECT_EQ(value, "cached");
+    EXPECT_EQ(cache.misses(), 1u);
+    EXPECT_EQ(cache.size(), 1u);
+
+    // Served at once, without waiting for the server
+    value.clear();
+    db_->execute("test_cached", params{1}, lookup);
+    EXPECT_EQ(value, "cached");
+    EXPECT_EQ(cache.hits(), 1u);
+
+    // Served in queue order, after the commands queued before it
+    std::vector<int> order;
+    db_->execute("SELECT 1", [&order](Transaction &, results) { order.push_back(1); });
+    db_->execute("test_cached", params{1},
+                 [&order](Transaction &, results) { order.push_back(2); });
+    EXPECT_TRUE(order.empty());
+    ASSERT_TRUE(db_->await());
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    EXPECT_EQ(cache.hits(), 2u);
+
+    // Stale until invalidated
+    ASSERT_TRUE(db_->execute("UPDATE test_prepared SET value = 'updated' WHERE id = 1").await());
+    db_->execute(db_->statement("test_cached"), params{1}, lookup);
+    EXPECT_EQ(value, "cached");
+    EXPECT_EQ(cache.hits(), 3u);
+
+    // The notification of the session itself arrives before its ReadyForQuery
+    ASSERT_TRUE(db_->execute("NOTIFY test_cache_tag").await());
+    EXPECT_EQ(cache.size(), 0u);
+    ASSERT_TRUE(db_->execute("test_cached", params{1}, lookup).await());
+    EXPECT_EQ(value, "updated");
+    EXPECT_EQ(cache.misses(), 2u);
+
+    // Transaction blocks always read from the server
+    ASSERT_TRUE(db_->begin([&](Transaction &tr) {
+                       tr.execute("UPDATE test_prepared SET value = 'in block' WHERE id = 1")
+                           .execute("test_cached", params{1}, lookup);
+                   })
+                    .await());
+    EXPECT_EQ(value, "in block");
+    EXPECT_EQ(cache.hits(), 3u);
+    EXPECT_EQ(cache.misses(), 2u);
+
+    // Entries expire after their time-to-live
+    db_->cache_results("test_cached", std::chrono::milliseconds(1), {"test_cache_tag"});
+    ASSERT_TRUE(db_->execute("test_cached", params{1}, lookup).await());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(db_->execute("test_cached", params{1}, lookup).await());
+    EXPECT_EQ(cache.hits(), 3u);
+    EXPECT_EQ(cache.misses(), 4u);
+}
+
+/**
+ * @brief Test the reuse of result storage across executions of a statement
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, RecycledResults) {
+    auto status = db_->execute("INSERT INTO test_prepared (value) VALUES ('recycled')")
+                      .recycle_results("test_recycled")
+                      .prepare("test_recycled", "SELECT value FROM test_prepared WHERE id = $1",
+                               {oid::int4})
+                      .await();
+    ASSERT_TRUE(status);
+
+    // The connection keeps the last result, the statement the previous one:
+    // executions alternate between the same two buffers
+    std::set<const char *> buffers;
+    std::string            value;
+    auto lookup = [&](Transaction &, results result) {
+        ASSERT_EQ(result.size(), 1u);
+        buffers.insert(result[0][0].view().data());
+        value = result[0][0].as<std::string>();
+    };
+    for (int i = 0; i < 10; ++i) {
+        value.clear();
+        status = db_->execute("test_recycled", params{1}, lookup).await();
+        ASSERT_TRUE(status);
+        EXPECT_EQ(value, "recycled");
+        EXPECT_EQ(status.results()[0][0].as<std::string>(), "recycled");
+    }
+    EXPECT_LE(buffers.size(), 2u);
+
+    // Results of other queries replacing a recycled one are not kept
+    ASSERT_TRUE(db_->execute("SELECT 1, 2").await());
+    ASSERT_TRUE(db_->execute("test_recycled", params{1}, lookup).await());
+    EXPECT_EQ(value, "recycled");
+}
+
+/**
+ * @brief Test the decoding of large results on worker threads
+ */
+TEST_F(PostgreSQLPreparedStatementsTest, OffloadedDecoding) {
+    const prepared<std::tuple<int, std::string>(int)> series{
+        "test_offload_series", "SELECT g, 'row' || g FROM generate_series(1, $1) g"};
+    const prepared<int(int)> nulls{"test_offload_nulls",
+                                   "SELECT NULLIF(g, 7) FROM generate_series(1, $1) g"};
+
+    decode_pool    workers(3);
+    result_offload offload(workers);
+    offload.rows_per_task = 1000;
+    offload.min_rows      = 100;
+
+    std::vector<std::tuple<int, std::string>> large, small;
+    std::optional<error::db_error>            error;
+    auto status = db_->prepare(series)
+                      .prepare(nulls)
+                      .execute_offload(series(10000), offload,
+                                       [&](Transaction &, auto rows) { large = std::move(rows); })
+                      .execute_offload(series(10), offload,
+                                       [&](Transaction &, auto rows) { small = std::move(rows); })
+                      .execute_offload(
+                          nulls(2000), offload,
+                          [](Transaction &, std::vector<int>) { ASSERT_TRUE(false); },
+                          [&](error::db_error const &err) { error = err; })
+                      .await();
+    ASSERT_TRUE(status);
+
+    // await() also waits for the workers
+    ASSERT_EQ(large.size(), 10000u);
+    for (std::size_t i = 0; i < large.size(); ++i) {
+        ASSERT_EQ(std::get<0>(large[i]), static_cast<int>(i + 1));
+        ASSERT_EQ(std::get<1>(large[i]), "row" + std::to_string(i + 1));
+    }
+    ASSERT_EQ(small.size(), 10u);
+    ASSERT_TRUE(error.has_value());
+}
+
 int
 main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
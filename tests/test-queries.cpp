@@ -604,6 +604,381 @@ TEST_F(PostgreSQLQueryTest, ExecuteFromFile) {
     std::filesystem::remove(temp_file);
 }
 
+/**
+ * @brief Test streaming query results row by row
+ *
+ * Verifies that execute_stream delivers every row to the row callback,
+ * for both simple and prepared queries, before the completion callback runs.
+ */
+TEST_F(PostgreSQLQueryTest, StreamRows) {
+    std::vector<std::string> names;
+    bool                     done   = false;
+    auto                     status = db_->execute_stream(
+                         "SELECT name, age FROM test_users ORDER BY id",
+                         [&names](row r) { names.push_back(r[0].as<std::string>()); },
+                         [&names, &done](transaction &) {
+                             ASSERT_EQ(names.size(), 3);
+                             done = true;
+                         },
+                         [](error::db_error error) {
+                             ASSERT_TRUE(false) << "Stream failed: " << error.code;
+                         })
+                      .await();
+    ASSERT_TRUE(done);
+    ASSERT_EQ(names[0], "John Doe");
+
+    int rows = 0;
+    done     = false;
+    status   = db_->prepare("stream_users_by_age",
+                            "SELECT name, age FROM test_users WHERE age >= $1 ORDER BY id",
+                            {oid::int4})
+                 .execute_stream(
+                     "stream_users_by_age", {30},
+                     [&rows](row r) {
+                         ASSERT_GE(r[1].as<int>(), 30);
+                         ++rows;
+                     },
+                     [&rows, &done](transaction &) {
+                         ASSERT_GT(rows, 0);
+                         done = true;
+                     },
+                     [](error::db_error error) {
+                         ASSERT_TRUE(false) << "Prepared stream failed: " << error.code;
+                     })
+                 .await();
+    ASSERT_TRUE(done);
+
+    // An exception in the row callback reports an error once the query completes
+    bool error_called = false;
+    status            = db_->execute_stream(
+                         "SELECT id FROM test_users",
+                         [](row) { throw std::runtime_error("stop"); },
+                         [](transaction &) { ASSERT_TRUE(false) << "Should have failed"; },
+                         [&error_called](error::db_error const &) { error_called = true; })
+                      .await();
+    ASSERT_TRUE(error_called);
+}
+
+/**
+ * @brief Test incremental reading of a DataRow with streamed columns
+ *
+ * Feeds a DataRow message byte by byte, as if each byte arrived in its own
+ * read, and verifies that the streamed column reaches the sink in order while
+ * the reduced row keeps the other columns.
+ */
+TEST(FieldStreamTest, SplitDataRow) {
+    auto field = [](std::string &out, std::optional<std::string_view> value) {
+        const auto size = qb::endian::to_big_endian(
+            static_cast<integer>(value ? static_cast<integer>(value->size()) : -1));
+        out.append(reinterpret_cast<const char *>(&size), sizeof(size));
+        if (value)
+            out.append(*value);
+    };
+    std::string body;
+    const auto  columns = qb::endian::to_big_endian(static_cast<smallint>(4));
+    body.append(reinterpret_cast<const char *>(&columns), sizeof(columns));
+    field(body, "id-1");
+    field(body, std::string(1000, 'x'));
+    field(body, std::nullopt);
+    field(body, "");
+    std::string message(1, 'D');
+    const auto  length = qb::endian::to_big_endian(static_cast<integer>(body.size() + 4));
+    message.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    message += body;
+
+    std::map<usmallint, std::string> values;
+    int                              last_chunks = 0;
+    detail::FieldStream              stream({1, 2, 3}, [&](field_chunk const &chunk) {
+        ASSERT_EQ(chunk.row, 0);
+        ASSERT_EQ(chunk.offset, values[chunk.column].size());
+        values[chunk.column].append(chunk.data);
+        last_chunks += chunk.last;
+    });
+    detail::DataRowStreamer streamer;
+    streamer.start(stream);
+
+    std::size_t received = 0;
+    auto        status   = detail::DataRowStreamer::status::incomplete;
+    for (std::size_t available = 1; available <= message.size(); ++available) {
+        std::size_t consumed = 0;
+        status = streamer.feed(message.data() + received, available - received, consumed);
+        received += consumed;
+        if (status != detail::DataRowStreamer::status::incomplete)
+            break;
+    }
+    ASSERT_EQ(status, detail::DataRowStreamer::status::complete);
+    ASSERT_EQ(received, message.size());
+    ASSERT_FALSE(streamer.active());
+    ASSERT_EQ(stream.rows(), 1);
+    ASSERT_EQ(values[1], std::string(1000, 'x'));
+    ASSERT_EQ(values.count(2), 0); // NULL values are not streamed
+    ASSERT_EQ(values[3], "");
+    ASSERT_EQ(last_chunks, 2);
+
+    // The reduced row keeps the other columns, with empty streamed values
+    std::string expected;
+    expected.append(reinterpret_cast<const char *>(&columns), sizeof(columns));
+    field(expected, "id-1");
+    field(expected, "");
+    field(expected, std::nullopt);
+    field(expected, "");
+    const auto row = streamer.row();
+    ASSERT_EQ(row.tag(), detail::data_row_tag);
+    ASSERT_EQ(row.length(), expected.size() + 4);
+    ASSERT_EQ(std::string(row.data() + 5, row.buffer_size() - 5), expected);
+
+    // A value longer than its message is a protocol error
+    message[3] = static_cast<char>(message[3] - 1);
+    streamer.start(stream);
+    std::size_t consumed = 0;
+    ASSERT_EQ(streamer.feed(message.data(), message.size(), consumed),
+              detail::DataRowStreamer::status::error);
+    ASSERT_FALSE(streamer.active());
+}
+
+/**
+ * @brief Test streaming large column values to a sink
+ *
+ * Verifies that the designated column of each row reaches the sink in
+ * chunks, that the other columns reach the row callback, and that a sink
+ * error fails the query.
+ */
+TEST_F(PostgreSQLQueryTest, StreamLargeFields) {
+    constexpr std::size_t      value_size = 4 * 1024 * 1024;
+    std::vector<std::size_t>   sizes;
+    std::vector<int>           ids;
+    std::size_t                chunks = 0;
+    bool                       done   = false;
+    auto                       status = db_->execute_stream(
+        "SELECT g, repeat('x', " + std::to_string(value_size) +
+            ") FROM generate_series(1, 3) AS g",
+        field_stream({1},
+                     [&](field_chunk const &chunk) {
+                         if (chunk.offset == 0)
+                             sizes.push_back(0);
+                         sizes.back() += chunk.data.size();
+                         ASSERT_EQ(chunk.data.find_first_not_of('x'), std::string_view::npos);
+                         ++chunks;
+                     }),
+        [&ids](row r) {
+            ids.push_back(r[0].as<int>());
+            ASSERT_EQ(r[1].as<std::string>(), "");
+        },
+        [&done](transaction &) { done = true; },
+        [](error::db_error error) {
+            ASSERT_TRUE(false) << "Field stream failed: " << error.code;
+        })
+                      .await();
+    ASSERT_TRUE(done);
+    ASSERT_EQ(ids, (std::vector<int>{1, 2, 3}));
+    ASSERT_EQ(sizes, (std::vector<std::size_t>(3, value_size)));
+    ASSERT_GT(chunks, 3); // values larger than a read arrive in several chunks
+
+    // A sink exception fails the query once it completes
+    bool error_called = false;
+    status            = db_->execute_stream(
+                         "SELECT repeat('x', 100000) FROM generate_series(1, 3)",
+                         field_stream({0}, [](field_chunk const &) {
+                             throw std::runtime_error("sink full");
+                         }),
+                         [](row) { ASSERT_TRUE(false) << "Row after a sink error"; },
+                         [](transaction &) { ASSERT_TRUE(false) << "Should have failed"; },
+                         [&error_called](error::db_error const &) { error_called = true; })
+                      .await();
+    ASSERT_TRUE(error_called);
+}
+
+/**
+ * @brief Test result limits of queries collecting a result set
+ *
+ * Verifies that a query exceeding the row or memory limit of the connection
+ * fails with result_limit_exceeded without blocking the next queries, that
+ * an overflow callback receives the rows instead, and that a transaction
+ * applies the tightest limit.
+ */
+TEST_F(PostgreSQLQueryTest, ResultLimits) {
+    result_limits limits;
+    limits.max_rows = 1000;
+    db_->result_limits(limits);
+
+    bool limit_error = false;
+    auto status      = db_->execute(
+                         "SELECT g FROM generate_series(1, 1000000) AS g",
+                         [](transaction &, results) { ASSERT_TRUE(false) << "Should have failed"; },
+                         [&limit_error](error::db_error const &err) {
+                             limit_error =
+                                 dynamic_cast<error::result_limit_exceeded const *>(&err) != nullptr;
+                         })
+                      .await();
+    ASSERT_TRUE(limit_error);
+
+    // The connection stays usable, and results within the limits are complete
+    std::size_t rows = 0;
+    status           = db_->execute("SELECT g FROM generate_series(1, 1000) AS g",
+                                    [&rows](transaction &, results result) { rows = result.size(); })
+                 .await();
+    ASSERT_EQ(rows, 1000);
+
+    limits.max_rows  = 0;
+    limits.max_bytes = 64 * 1024;
+    db_->result_limits(limits);
+    limit_error = false;
+    status      = db_->execute("SELECT repeat('x', 1000) FROM generate_series(1, 1000)",
+                               [](transaction &, results) {},
+                               [&limit_error](error::db_error const &err) {
+                                   limit_error = err.code == "54000";
+                               })
+                 .await();
+    ASSERT_TRUE(limit_error);
+
+    // With an overflow callback, the rows are streamed instead
+    std::size_t streamed = 0;
+    limits.max_bytes     = 0;
+    limits.max_rows      = 100;
+    limits.on_overflow   = [&streamed](row) { ++streamed; };
+    db_->result_limits(limits);
+    std::size_t kept = 1;
+    status           = db_->execute("SELECT g FROM generate_series(1, 5000) AS g",
+                                    [&kept](transaction &, results result) { kept = result.size(); })
+                 .await();
+    ASSERT_EQ(streamed, 5000);
+    ASSERT_EQ(kept, 0);
+
+    // A transaction applies the tightest limit of its parents
+    db_->result_limits({});
+    limit_error = false;
+    status      = db_->begin([&limit_error](transaction &tr) {
+                     result_limits inner;
+                     inner.max_rows = 10;
+                     tr.result_limits(inner).execute(
+                         "SELECT g FROM generate_series(1, 100) AS g",
+                         [](transaction &, results) { ASSERT_TRUE(false) << "Should have failed"; },
+                         [&limit_error](error::db_error const &) { limit_error = true; });
+                 })
+                 .await();
+    ASSERT_TRUE(limit_error);
+}
+
+/**
+ * @brief Test pipelined execution of queued queries
+ *
+ * Verifies that with a pipeline depth above 1 the callbacks still run in
+ * submission order and that a failing statement only fails itself.
+ */
+TEST_F(PostgreSQLQueryTest, PipelinedQueries) {
+    db_->pipeline(8);
+
+    std::vector<int> order;
+    bool             error_called = false;
+    for (int i = 0; i < 4; ++i)
+        db_->execute("SELECT " + std::to_string(i),
+                     [&order, i](transaction &, results result) {
+                         ASSERT_EQ(result[0][0].as<int>(), i);
+                         order.push_back(i);
+                     },
+                     [](error::db_error error) {
+                         ASSERT_TRUE(false) << "Pipelined query failed: " << error.code;
+                     });
+    db_->execute("SELECT * FROM missing_table", [](transaction &, results) {
+        ASSERT_TRUE(false) << "Should have failed";
+    }, [&error_called](error::db_error const &) { error_called = true; });
+    db_->execute("SELECT count(*) FROM test_users",
+                 [&order](transaction &, results result) {
+                     ASSERT_EQ(result[0][0].as<int64_t>(), 3);
+                     order.push_back(4);
+                 });
+    db_->await();
+
+    ASSERT_TRUE(error_called);
+    ASSERT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+    db_->pipeline(1);
+}
+
+/**
+ * @brief Test automatic preparation of ad-hoc SQL
+ *
+ * Verifies that repeated queries reuse one server-side statement, that the
+ * least recently used statement is closed beyond the capacity, and that
+ * failing and multi-statement queries behave as simple queries.
+ */
+TEST_F(PostgreSQLQueryTest, AutoPrepare) {
+    db_->auto_prepare(2);
+    auto count_statements = [this]() {
+        int64_t count = -1;
+        db_->execute("SELECT count(*) FROM pg_prepared_statements WHERE name LIKE "
+                     "'\\_\\_qb\\_auto\\_%'",
+                     [&count](transaction &, results result) {
+                         count = result[0][0].as<int64_t>();
+                     })
+            .await();
+        return count;
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        std::string name;
+        auto        status = db_->execute("SELECT name FROM test_users WHERE id = 1",
+                                          [&name](transaction &, results result) {
+                                              ASSERT_EQ(result.size(), 1);
+                                              name = result[0][0].as<std::string>();
+                                          })
+                          .await();
+        ASSERT_TRUE(status);
+        ASSERT_FALSE(name.empty());
+    }
+    // The counting query itself is cached too
+    ASSERT_EQ(count_statements(), 2);
+    ASSERT_TRUE(db_->execute("SELECT 42").await());
+    ASSERT_EQ(count_statements(), 2);
+
+    bool error_called = false;
+    db_->execute("SELECT * FROM missing_table", [](transaction &, results) {
+        ASSERT_TRUE(false) << "Should have failed";
+    }, [&error_called](error::db_error const &) { error_called = true; }).await();
+    ASSERT_TRUE(error_called);
+
+    int64_t sum = 0;
+    ASSERT_TRUE(db_->execute("SELECT 1; SELECT 2",
+                             [&sum](transaction &, results result) {
+                                 sum += result[0][0].as<int64_t>();
+                             })
+                    .await());
+    ASSERT_GT(sum, 0);
+
+    // Shrinking the cache closes the statements over the new capacity
+    db_->auto_prepare(1);
+    ASSERT_EQ(count_statements(), 1);
+    db_->auto_prepare(0);
+    ASSERT_EQ(count_statements(), 0);
+}
+
+/**
+ * @brief Test that shrinking the statement cache evicts the least recently used statements
+ */
+TEST(StatementCacheTest, ShrinkingEvictsTheExcess) {
+    detail::StatementCache cache;
+    cache.capacity(3);
+    std::vector<std::string> names;
+    for (auto sql : {"SELECT 1", "SELECT 2", "SELECT 3"})
+        names.emplace_back(cache.acquire(sql).name);
+    cache.acquire("SELECT 1");
+    ASSERT_FALSE(cache.has_evicted());
+
+    cache.capacity(1);
+    ASSERT_EQ(cache.size(), 1u);
+    ASSERT_EQ(cache.take_evicted(), (std::vector<std::string>{names[1], names[2]}));
+    ASSERT_FALSE(cache.has_evicted());
+
+    cache.capacity(0);
+    ASSERT_EQ(cache.size(), 0u);
+    ASSERT_EQ(cache.take_evicted(), std::vector<std::string>{names[0]});
+
+    // At capacity, a lookup evicts the least recently used statement itself
+    cache.capacity(1);
+    const auto first = std::string(cache.acquire("SELECT 4").name);
+    ASSERT_EQ(cache.acquire("SELECT 5").evicted, std::vector<std::string>{first});
+    ASSERT_FALSE(cache.has_evicted());
+}
+
 int
 main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
@@ -436,6 +436,196 @@ TEST_F(PostgreSQLTransactionTest, CommitMultipleChanges) {
     ASSERT_TRUE(select_success);
 }
 
+/**
+ * @brief Test the replay of transaction blocks failing on transient errors
+ *
+ * The first two attempts raise a serialization failure and are replayed;
+ * a block failing on another SQLSTATE is reported at once.
+ */
+TEST_F(PostgreSQLTransactionTest, RetrySerializationFailure) {
+    constexpr std::string_view conflict =
+        "DO $$ BEGIN RAISE EXCEPTION 'conflict' USING ERRCODE = 'serialization_failure'; "
+        "END $$";
+
+    retry_policy policy;
+    policy.max_attempts = 5;
+    policy.base_delay   = std::chrono::milliseconds(1);
+
+    int  attempts = 0;
+    bool failed   = false;
+    db_->begin(
+           [&](Transaction &t) {
+               ++attempts;
+               t.execute("INSERT INTO test_transactions (value) VALUES ('retried')");
+               if (attempts < 3)
+                   t.execute(conflict);
+           },
+           [&](error::db_error const &) { failed = true; }, {}, policy)
+        .await();
+    EXPECT_EQ(attempts, 3);
+    EXPECT_FALSE(failed);
+
+    auto status = db_->execute("SELECT * FROM test_transactions").await();
+    ASSERT_TRUE(status);
+    EXPECT_EQ(status.results().size(), 1);
+
+    // Exhausted attempts report the last serialization failure
+    attempts = 0;
+    std::optional<error::db_error> error;
+    db_->retry_policy(policy.clear().retry_on("40"));
+    db_->begin([&](Transaction &t) {
+           ++attempts;
+           t.execute(conflict);
+       },
+       [&](error::db_error const &err) { error = err; })
+        .await();
+    EXPECT_EQ(attempts, 5);
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error->sqlstate, sqlstate::serialization_failure);
+
+    // Other errors are not retried
+    attempts = 0;
+    error.reset();
+    db_->begin([&](Transaction &t) {
+           ++attempts;
+           t.execute("INSERT INTO nonexistent (value) VALUES (1)");
+       },
+       [&](error::db_error const &err) { error = err; })
+        .await();
+    db_->no_retry();
+    EXPECT_EQ(attempts, 1);
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error->sqlstate, sqlstate::undefined_table);
+}
+
+/**
+ * @brief Test transaction blocks sent in a single round trip
+ *
+ * A committed block keeps every row; a failing statement is reported with
+ * its step and rolls the whole block back.
+ */
+TEST_F(PostgreSQLTransactionTest, AtomicBlock) {
+    atomic_block committed;
+    committed
+        .execute("INSERT INTO test_transactions (value) VALUES ($1)",
+                 params{std::string("atomic1")})
+        .execute("INSERT INTO test_transactions (value) VALUES ($1), ($2)",
+                 params{std::string("atomic2"), std::string("atomic3")});
+
+    std::size_t affected = 0;
+    auto        status   = db_->atomic(std::move(committed),
+                              [&affected](Transaction &, std::size_t rows) { affected = rows; },
+                              [](error::db_error const &) { ASSERT_TRUE(false); })
+                      .await();
+    ASSERT_TRUE(status);
+    EXPECT_EQ(affected, 3u);
+
+    std::size_t step = 0;
+    std::optional<error::db_error> error;
+    atomic_block failing;
+    failing.execute("INSERT INTO test_transactions (value) VALUES ('lost')")
+        .execute("INSERT INTO nonexistent (value) VALUES (1)")
+        .execute("INSERT INTO test_transactions (value) VALUES ('skipped')");
+
+    status = db_->atomic(std::move(failing), [](Transaction &) { ASSERT_TRUE(false); },
+                         [&](error::db_error const &err, std::size_t failed) {
+                             error = err;
+                             step  = failed;
+                         },
+                         transaction_mode{isolation_level::serializable})
+                 .await();
+    ASSERT_FALSE(status);
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error->sqlstate, sqlstate::undefined_table);
+    EXPECT_EQ(step, 1u);
+
+    status = db_->execute("SELECT value FROM test_transactions ORDER BY id").await();
+    ASSERT_TRUE(status);
+    ASSERT_EQ(status.results().size(), 3);
+    EXPECT_EQ(status.results()[0][0].as<std::string>(), "atomic1");
+
+    // The connection is usable, outside of any transaction block
+    ASSERT_TRUE(db_->begin([](Transaction &t) { t.execute("SELECT 1"); }).await());
+}
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+/**
+ * @brief Test awaiting queries from a coroutine
+ *
+ * Both queries are queued before the first co_await and pipelined.
+ */
+TEST_F(PostgreSQLTransactionTest, CoroutineQueries) {
+    std::vector<std::string> values;
+    bool                     failed = false;
+
+    auto run = [&](qb::pg::tcp::database &db) -> task<int> {
+        auto insert = db.async_execute(
+            "INSERT INTO test_transactions (value) VALUES ('a'), ('b')");
+        auto select = db.async_execute("SELECT value FROM test_transactions ORDER BY id");
+        if (!co_await insert)
+            co_return -1;
+        auto rows = co_await select;
+        for (auto row : rows.results())
+            values.push_back(row[0].as<std::string>());
+
+        if (!co_await db.async_prepare("count_values", "SELECT count(*) FROM "
+                                                       "test_transactions WHERE value = $1"))
+            co_return -1;
+        auto count = co_await db.async_execute("count_values", params{std::string("a")});
+        failed     = !co_await db.async_execute("SELECT * FROM missing_table");
+        co_return count ? count.results()[0][0].as<int>() : -1;
+    };
+
+    auto counted = run(*db_);
+    ASSERT_FALSE(counted.done());
+    db_->await();
+    ASSERT_TRUE(counted.done());
+    EXPECT_EQ(counted.get(), 1);
+    EXPECT_EQ(values, (std::vector<std::string>{"a", "b"}));
+    EXPECT_TRUE(failed);
+}
+
+/**
+ * @brief Test transaction blocks driven by a coroutine
+ *
+ * A committed block keeps its rows; a block with a failed statement rolls
+ * back and its commit reports the failure.
+ */
+TEST_F(PostgreSQLTransactionTest, CoroutineTransaction) {
+    bool committed = false;
+    bool rejected  = false;
+
+    auto run = [&](qb::pg::tcp::database &db) -> task<> {
+        {
+            co_transaction tx(db);
+            if (!co_await tx.begin())
+                co_return;
+            co_await tx.execute("INSERT INTO test_transactions (value) VALUES ('kept')");
+            committed = static_cast<bool>(co_await tx.commit());
+        }
+        {
+            co_transaction tx(db);
+            co_await tx.begin();
+            co_await tx.execute("INSERT INTO test_transactions (value) VALUES ('lost')");
+            co_await tx.execute("SELECT * FROM missing_table");
+            rejected = !co_await tx.commit();
+        }
+    };
+
+    auto done = run(*db_);
+    db_->await();
+    ASSERT_TRUE(done.done());
+    done.get();
+    EXPECT_TRUE(committed);
+    EXPECT_TRUE(rejected);
+
+    auto status = db_->execute("SELECT value FROM test_transactions").await();
+    ASSERT_TRUE(status);
+    ASSERT_EQ(status.results().size(), 1);
+    EXPECT_EQ(status.results()[0][0].as<std::string>(), "kept");
+}
+#endif
+
 int
 main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);